@@ -24,6 +24,7 @@ extern "C" {
 
 /* Forward declarations */
 struct ninep_client;
+struct ninep_client_req;
 
 /**
  * @brief Client FID entry (tracks opened files)
@@ -33,7 +34,25 @@ struct ninep_client_fid {
 	struct ninep_qid qid;
 	bool in_use;
 	uint32_t iounit;
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+	uint8_t path_origin;  /* Path cache entry + 1 it was cloned from, or 0 */
+#endif
+};
+
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+/**
+ * @brief Path cache entry: a walked, never-opened FID for one path
+ */
+struct ninep_client_path_entry {
+	uint32_t base;      /* FID the path was walked from */
+	uint32_t fid;       /* FID standing at the path; cloned for each use */
+	uint32_t hash;      /* FNV-1a of base and path */
+	uint32_t last_use;  /* LRU stamp */
+	bool in_use;
+	bool stale;         /* Invalidated; clunked at the next reap */
+	char path[CONFIG_NINEP_CLIENT_PATH_CACHE_PATH_LEN];  /* Normalized */
 };
+#endif
 
 /**
  * @brief Lightweight tag tracking structure
@@ -51,8 +70,9 @@ struct ninep_tag_entry {
 	bool in_use;            /* Tag is allocated */
 	bool complete;          /* Response received */
 	int error;              /* Error code (0 = success) */
-	void *user_ctx;         /* Caller-provided context for result */
+	struct ninep_client_req *req;  /* Request this tag carries, or NULL */
 	uint8_t *tx;            /* This tag's TX buffer (buf_size bytes) */
+	uint32_t tx_len;        /* Length of the request in tx */
 	uint8_t *rx;            /* This tag's RX buffer (buf_size bytes) */
 	uint32_t rx_len;        /* Length of the response in rx */
 };
@@ -97,6 +117,16 @@ struct ninep_client_config {
 	const char *version;
 	uint32_t timeout_ms;  /* Request timeout in milliseconds */
 
+	/**
+	 * The server executes this session's requests one at a time, in the
+	 * order they were sent.  Only then do path operations and path cache
+	 * misses send a request on a fid before the walk creating it has been
+	 * answered.  Leave false for a server that may dispatch requests
+	 * concurrently (e.g. this tree's with CONFIG_NINEP_SERVER_TX_BUFS > 1
+	 * behind a multi-threaded transport).
+	 */
+	bool in_order;
+
 	/**
 	 * Optional: caller-provided memory pools.
 	 * If NULL, the client uses embedded arrays (placed in this struct).
@@ -125,6 +155,8 @@ struct ninep_client_config {
  *   cross-deliver concurrent responses).
  * - Lightweight tag tracking; single condvar for all waiters (broadcast on
  *   response arrival -- each waiter checks its own tag's completion).
+ * - Every request is a struct ninep_client_req bound to its tag; the
+ *   blocking calls submit one and wait, the *_async calls return at once.
  *
  * Memory cost is max_tags * buf_size * 2 (one TX + one RX buffer per tag).
  * For small msize / few tags this is modest; place the buffers in PSRAM via
@@ -165,6 +197,16 @@ struct ninep_client {
 	 * than reading this directly. */
 	char last_ename[64];
 
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+	/* Path-to-fid cache, off until ninep_client_path_cache_enable() */
+	struct ninep_client_path_entry path_cache[CONFIG_NINEP_CLIENT_PATH_CACHE];
+	uint32_t path_cache_clock;
+	bool path_cache_enabled;
+	uint32_t path_cache_hits;
+	uint32_t path_cache_misses;
+	uint32_t path_cache_evictions;
+#endif
+
 	/* Synchronization */
 	struct k_mutex lock;       /* Protects TX and tag table */
 	struct k_condvar resp_cv;  /* Signaled when any response arrives */
@@ -310,6 +352,244 @@ int ninep_client_remove(struct ninep_client *client, uint32_t fid);
  */
 int ninep_client_clunk(struct ninep_client *client, uint32_t fid);
 
+/**
+ * @brief Completion callback for an asynchronous request
+ *
+ * Called once for each submitted request, from the transport's receive
+ * path -- on a synchronous transport, possibly before the submitting call
+ * has returned -- or from ninep_client_cancel().  It may submit further
+ * requests but must not wait for one.
+ *
+ * @param client Client instance
+ * @param req The completed request; req->result holds the outcome
+ */
+typedef void (*ninep_client_done_t)(struct ninep_client *client,
+                                    struct ninep_client_req *req);
+
+/**
+ * @brief Asynchronous request
+ *
+ * One outstanding 9P request.  The caller owns the memory and must not
+ * touch it between a successful submit and completion.  Initialize it with
+ * ninep_client_req_init() before each submit.  Completion is reported
+ * through done, signal (needs CONFIG_POLL), both, or neither.
+ *
+ * Async requests have no timeout; abandon one with ninep_client_cancel().
+ */
+struct ninep_client_req {
+	/* Set by the caller */
+	ninep_client_done_t done;      /**< Completion callback, or NULL */
+	struct k_poll_signal *signal;  /**< Raised with result, or NULL */
+	void *user_data;               /**< For the caller */
+
+	/* Results, valid once complete */
+	bool complete;
+	int result;             /**< Bytes for read/write, else 0; or -errno */
+	uint32_t fid;           /**< Request's fid; the new one for auth/attach/walk */
+	struct ninep_qid qid;   /**< From Rauth/Rattach/Rwalk/Ropen/Rcreate */
+	uint32_t iounit;        /**< From Ropen/Rcreate */
+
+	/* Internal */
+	struct ninep_tag_entry *entry;
+	uint8_t type;
+	uint16_t nwname;
+	uint32_t walk_from;  /* Twalk's source fid; fid is the new one */
+	uint8_t *buf;
+	uint32_t count;
+	struct ninep_stat *stat;
+	bool hold;  /* Keep the tag, data in its RX buffer, after a read */
+};
+
+/**
+ * @brief Prepare a request for submission
+ *
+ * @param req Request to initialize
+ * @param done Completion callback (NULL for none)
+ * @param user_data Caller context, available as req->user_data
+ */
+void ninep_client_req_init(struct ninep_client_req *req,
+                           ninep_client_done_t done, void *user_data);
+
+/**
+ * @name Asynchronous operations
+ *
+ * Each call sends one T-message without waiting for the reply, taking the
+ * same arguments as its blocking counterpart; results land in req.  Any
+ * number may be outstanding, up to the client's tag count.  Read data is
+ * copied into buf when the reply arrives, so buf must stay valid until
+ * then; write data is copied before the call returns.
+ *
+ * Each returns the request's tag on success, or a negative error code if
+ * nothing was sent (and done will not be called).
+ * @{
+ */
+int ninep_client_version_async(struct ninep_client *client,
+                               struct ninep_client_req *req);
+int ninep_client_auth_async(struct ninep_client *client, const char *uname,
+                            const char *aname, struct ninep_client_req *req);
+int ninep_client_attach_async(struct ninep_client *client, uint32_t afid,
+                              const char *uname, const char *aname,
+                              struct ninep_client_req *req);
+int ninep_client_walk_async(struct ninep_client *client, uint32_t fid,
+                            const char *path, struct ninep_client_req *req);
+int ninep_client_open_async(struct ninep_client *client, uint32_t fid,
+                            uint8_t mode, struct ninep_client_req *req);
+int ninep_client_read_async(struct ninep_client *client, uint32_t fid,
+                            uint64_t offset, uint8_t *buf, uint32_t count,
+                            struct ninep_client_req *req);
+int ninep_client_write_async(struct ninep_client *client, uint32_t fid,
+                             uint64_t offset, const uint8_t *buf, uint32_t count,
+                             struct ninep_client_req *req);
+int ninep_client_stat_async(struct ninep_client *client, uint32_t fid,
+                            struct ninep_stat *stat, struct ninep_client_req *req);
+int ninep_client_create_async(struct ninep_client *client, uint32_t fid,
+                              const char *name, uint32_t perm, uint8_t mode,
+                              struct ninep_client_req *req);
+int ninep_client_remove_async(struct ninep_client *client, uint32_t fid,
+                              struct ninep_client_req *req);
+int ninep_client_clunk_async(struct ninep_client *client, uint32_t fid,
+                             struct ninep_client_req *req);
+/** @} */
+
+/**
+ * @brief Abandon an outstanding asynchronous request
+ *
+ * Sends Tflush and waits briefly for Rflush.  If the reply wins the race
+ * the request completes normally; otherwise it completes with -ECANCELED.
+ *
+ * @param client Client instance
+ * @param req Request to cancel
+ * @return 0 if cancelled, -EALREADY if it had already completed
+ */
+int ninep_client_cancel(struct ninep_client *client, struct ninep_client_req *req);
+
+/**
+ * @brief Consumer of a streaming read
+ *
+ * Called from the reading thread, once per chunk in offset order, with no
+ * client lock held.
+ *
+ * @param data Chunk data, valid only during the call
+ * @param len Chunk length
+ * @param offset File offset of data[0]
+ * @param user_data Caller context
+ * @return 0 to continue, or a negative error code to stop the read
+ */
+typedef int (*ninep_client_sink_t)(const uint8_t *data, uint32_t len,
+                                   uint64_t offset, void *user_data);
+
+/**
+ * @brief Read a large range with up to window Treads in flight
+ *
+ * Splits [offset, offset + len) into iounit-sized Treads (or msize-sized
+ * if the open gave no iounit), keeps up to window of them outstanding,
+ * and hands the data to sink in offset order.  The first short read is
+ * taken as end of file: the read stops there and the rest are discarded.
+ *
+ * Each reply stays in its tag's RX buffer until sink has it, so the
+ * window costs no memory beyond the tags.  It is capped at
+ * CONFIG_NINEP_CLIENT_MAX_WINDOW and one less than the tag count.
+ *
+ * @param client Client instance
+ * @param fid Open FID to read
+ * @param offset Starting file offset
+ * @param len Bytes to read at most (capped at INT_MAX)
+ * @param sink Consumer of the data
+ * @param user_data Passed to sink
+ * @param window Treads to keep in flight (1 behaves like a read loop)
+ * @return Bytes delivered on success, negative error code on failure
+ *         (the first failed Tread in offset order, or sink's error)
+ */
+int ninep_client_read_stream_sink(struct ninep_client *client, uint32_t fid,
+                                  uint64_t offset, uint32_t len,
+                                  ninep_client_sink_t sink, void *user_data,
+                                  unsigned int window);
+
+/**
+ * @brief Read a large range into buf with up to window Treads in flight
+ *
+ * As ninep_client_read_stream_sink(), reassembling into buf.
+ *
+ * @param client Client instance
+ * @param fid Open FID to read
+ * @param offset Starting file offset
+ * @param buf Destination, at least len bytes
+ * @param len Bytes to read at most
+ * @param window Treads to keep in flight
+ * @return Bytes read (less than len at end of file), or negative error code
+ */
+int ninep_client_read_stream(struct ninep_client *client, uint32_t fid,
+                             uint64_t offset, uint8_t *buf, uint32_t len,
+                             unsigned int window);
+
+/**
+ * @brief Write a large range with up to window Twrites in flight
+ *
+ * Splits buf into iounit-sized Twrites (or msize-sized if the open gave no
+ * iounit) and keeps up to window of them outstanding.  A short Rwrite has
+ * its tail sent again; an Rwrite of zero bytes is an error.  Replies are
+ * retired in offset order, so the failure seen is always the one at the
+ * lowest offset.  Everything below that offset was written, and as with
+ * write(2) that many bytes are returned if there are any; the error itself
+ * is returned only when nothing was written.  Twrites already in flight
+ * beyond the failure may or may not have landed.  The window is capped as
+ * for ninep_client_read_stream_sink().
+ *
+ * Twrites are never re-sent on timeout.
+ *
+ * @param client Client instance
+ * @param fid Open FID to write
+ * @param offset Starting file offset
+ * @param buf Data to write
+ * @param len Bytes to write (capped at INT_MAX)
+ * @param window Twrites to keep in flight (1 behaves like a write loop)
+ * @return Bytes written (fewer than len if a Twrite failed part way),
+ *         negative error code if nothing was written
+ */
+int ninep_client_write_stream(struct ninep_client *client, uint32_t fid,
+                              uint64_t offset, const uint8_t *buf, uint32_t len,
+                              unsigned int window);
+
+/**
+ * @brief Read a small file by path in one burst
+ *
+ * Sends Twalk of a new fid from fid to path, Topen, Tread at offset 0 and
+ * Tclunk back to back, then waits for the four replies: one round trip
+ * instead of four.  The new fid is clunked whichever link fails.  Reads
+ * at most one message (msize less the Rread header); use
+ * ninep_client_read_stream() on an open fid for more.
+ *
+ * The burst needs config->in_order: the open, read and clunk name the fid
+ * the walk creates.  Without it each request waits for the reply to the
+ * one before it, and the call costs the four round trips.
+ *
+ * @param client Client instance
+ * @param fid Directory FID the path is relative to (e.g. the root)
+ * @param path Path to walk
+ * @param buf Buffer for the data
+ * @param count Bytes to read
+ * @return Bytes read, or the first error in chain order (a failed walk
+ *         gives -ENOENT)
+ */
+int ninep_client_read_path(struct ninep_client *client, uint32_t fid,
+                           const char *path, uint8_t *buf, uint32_t count);
+
+/**
+ * @brief Write a small file by path in one burst
+ *
+ * As ninep_client_read_path(), with Topen for writing (no truncation) and
+ * one Twrite at offset 0 in place of the Tread.
+ *
+ * @param client Client instance
+ * @param fid Directory FID the path is relative to (e.g. the root)
+ * @param path Path to walk
+ * @param buf Data to write
+ * @param count Bytes to write (at most one message's worth is sent)
+ * @return Bytes written, or the first error in chain order
+ */
+int ninep_client_write_path(struct ninep_client *client, uint32_t fid,
+                            const char *path, const uint8_t *buf, uint32_t count);
+
 /**
  * @brief Set max retries on timeout
  *
@@ -390,6 +670,40 @@ struct ninep_client_stats {
 void ninep_client_get_stats(struct ninep_client *client,
 			    struct ninep_client_stats *out);
 
+/**
+ * @brief Turn the path-to-fid cache on or off
+ *
+ * With the cache on, ninep_client_walk() keeps one walked, never-opened
+ * FID per (fid, path) pair it has walked, and answers later walks of the
+ * same path with a zero-element Twalk clone of it: one element-free walk
+ * instead of a walk from the root.  Paths are normalized ("a//./b/" is
+ * "a/b"); paths with ".." or longer than
+ * CONFIG_NINEP_CLIENT_PATH_CACHE_PATH_LEN are walked as usual.
+ *
+ * Cached FIDs count against the FID pool.  The least recently used is
+ * clunked when the pool runs low or the cache is full.  An entry is
+ * dropped when its clone fails, when a clone of it gets an Rerror or is
+ * removed, and when the FID it was walked from is clunked.  The cache
+ * holds no negative entries, so new files are always found.
+ *
+ * Needs CONFIG_NINEP_CLIENT_PATH_CACHE > 0.  Turning it off clunks every
+ * cached FID.
+ *
+ * @param client Client instance
+ * @param enable true to turn the cache on
+ * @return 0 on success, -ENOTSUP if the cache is not built in
+ */
+int ninep_client_path_cache_enable(struct ninep_client *client, bool enable);
+
+/**
+ * @brief Clunk every cached FID, leaving the cache on
+ *
+ * For when files may have changed behind the client's back.
+ *
+ * @param client Client instance
+ */
+void ninep_client_path_cache_flush(struct ninep_client *client);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -325,6 +325,21 @@ int ninep_build_rwrite(uint8_t *buf, size_t buf_len, uint16_t tag, uint32_t coun
  */
 int ninep_build_rread(uint8_t *buf, size_t buf_len, uint16_t tag, uint32_t count);
 
+/**
+ * @brief Build only the 11-byte header of an Rread message
+ *
+ * For sending the header and the data from separate buffers (see the
+ * transport sendv op).
+ *
+ * @param buf Output buffer (at least 11 bytes)
+ * @param buf_len Buffer length
+ * @param tag Message tag
+ * @param count Number of data bytes that will follow the header
+ * @return Header size (11), or negative error code
+ */
+int ninep_build_rread_hdr(uint8_t *buf, size_t buf_len, uint16_t tag,
+                          uint32_t count);
+
 /**
  * @brief Build an Rremove message
  *
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ZEPHYR_INCLUDE_9P_NODE_ALLOC_H_
+#define ZEPHYR_INCLUDE_9P_NODE_ALLOC_H_
+
+#include <zephyr/9p/server.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup ninep_node_alloc 9P Filesystem Node Allocator
+ * @ingroup ninep_server
+ * @{
+ */
+
+#ifndef CONFIG_NINEP_NODE_BLOCK_SIZE
+#define CONFIG_NINEP_NODE_BLOCK_SIZE 128
+#endif
+
+#ifndef CONFIG_NINEP_NODE_BLOCKS_SMALL
+#define CONFIG_NINEP_NODE_BLOCKS_SMALL 16
+#endif
+
+#ifndef CONFIG_NINEP_NODE_BLOCKS_MEDIUM
+#define CONFIG_NINEP_NODE_BLOCKS_MEDIUM 8
+#endif
+
+#ifndef CONFIG_NINEP_NODE_BLOCKS_LARGE
+#define CONFIG_NINEP_NODE_BLOCKS_LARGE 4
+#endif
+
+/** Size classes: CONFIG_NINEP_NODE_BLOCK_SIZE times 1, 2 and 4 */
+#define NINEP_NODE_ALLOC_CLASSES 3
+
+/** Longest node name backends accept */
+#define NINEP_NODE_NAME_MAX 255
+
+/**
+ * @brief Node allocator statistics
+ */
+struct ninep_node_alloc_stats {
+	struct {
+		size_t block_size;   /**< Bytes per block */
+		uint32_t blocks;     /**< Blocks in the class */
+		uint32_t in_use;     /**< Blocks allocated now */
+		uint32_t high_water; /**< Most blocks ever allocated at once */
+	} classes[NINEP_NODE_ALLOC_CLASSES];
+	uint32_t heap_in_use;       /**< Nodes that did not fit a slab */
+	uint32_t heap_high_water;
+	uint32_t failures;          /**< Allocations that returned NULL */
+};
+
+/**
+ * @brief Allocate a filesystem node
+ *
+ * Takes one block for @p size bytes plus a copy of @p name from the
+ * smallest size class that fits, or from the heap when that class is full
+ * or the node is larger than any class (unless
+ * CONFIG_NINEP_NODE_HEAP_FALLBACK is off). The object must start with a
+ * struct ninep_fs_node; backends embed it first in their own node struct
+ * and may put variable-length data (e.g. a path) at the end of @p size.
+ *
+ * @param size Bytes for the backend's node struct, at least
+ *             sizeof(struct ninep_fs_node)
+ * @param name Node name, need not be NUL-terminated
+ * @param name_len Length of @p name
+ * @return Zeroed node with name set, or NULL
+ */
+struct ninep_fs_node *ninep_node_alloc(size_t size, const char *name,
+                                       size_t name_len);
+
+/**
+ * @brief Free a node from ninep_node_alloc()
+ *
+ * @param node Node to free, may be NULL
+ */
+void ninep_node_free(struct ninep_fs_node *node);
+
+/**
+ * @brief Get allocator statistics
+ *
+ * @param stats Filled with current figures
+ */
+void ninep_node_alloc_get_stats(struct ninep_node_alloc_stats *stats);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_9P_NODE_ALLOC_H_ */
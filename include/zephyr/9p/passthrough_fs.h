@@ -7,6 +7,8 @@
 #define ZEPHYR_INCLUDE_9P_PASSTHROUGH_FS_H_
 
 #include <zephyr/9p/server.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,16 +20,113 @@ extern "C" {
  * @{
  */
 
+#ifndef CONFIG_NINEP_FS_PASSTHROUGH_OPEN_FILES
+#define CONFIG_NINEP_FS_PASSTHROUGH_OPEN_FILES 4
+#endif
+
+#ifndef CONFIG_NINEP_FS_PASSTHROUGH_OPEN_DIRS
+#define CONFIG_NINEP_FS_PASSTHROUGH_OPEN_DIRS 2
+#endif
+
+#ifndef CONFIG_NINEP_FS_PASSTHROUGH_QID_SLOTS
+#define CONFIG_NINEP_FS_PASSTHROUGH_QID_SLOTS 64
+#endif
+
+#ifndef CONFIG_NINEP_FS_PASSTHROUGH_QID_VERSIONS
+#define CONFIG_NINEP_FS_PASSTHROUGH_QID_VERSIONS 16
+#endif
+
+#ifndef CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE
+#define CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE 4
+#endif
+
+/** Buckets in the path-to-node table */
+#define NINEP_PASSTHROUGH_NODE_BUCKETS 32
+
+/**
+ * @brief Open file handle kept between reads and writes
+ * @internal
+ */
+struct ninep_passthrough_handle {
+	struct fs_file_t file;
+	struct ninep_fs_node *node;  /* Node using this handle, NULL if free */
+	off_t pos;                   /* Current file position */
+	fs_mode_t flags;             /* Flags the file was opened with */
+	bool dirty;                  /* Written since last sync */
+	uint32_t last_use;           /* For LRU eviction */
+};
+
+/**
+ * @brief Open directory kept between reads of a directory fid
+ * @internal
+ */
+struct ninep_passthrough_dir {
+	struct fs_dir_t dir;
+	struct ninep_dir_cursor *cur; /* Cursor using this slot, NULL if free */
+	struct fs_dirent pending;    /* Read from dir but not yet returned */
+	bool has_pending;
+	uint32_t last_use;           /* For LRU eviction */
+};
+
+/**
+ * @brief Recently issued qid.path, for collision detection
+ * @internal
+ */
+struct ninep_passthrough_qid_slot {
+	uint64_t qid_path;           /* 0 if unused */
+	uint32_t check;              /* Second hash of the path */
+};
+
+/**
+ * @brief qid.version of a file changed through 9P
+ * @internal
+ */
+struct ninep_passthrough_qid_version {
+	uint64_t qid_path;           /* 0 if unused */
+	uint32_t version;
+	uint32_t last_use;           /* For LRU eviction */
+};
+
 /**
  * @brief Passthrough filesystem instance
  *
  * This filesystem backend exposes any mounted Zephyr filesystem via 9P.
  * Supports LittleFS, FAT, and any other Zephyr-compatible filesystem.
+ *
+ * A file opened over 9P keeps its fs_file_t open until it is clunked,
+ * drawing from a fixed set of CONFIG_NINEP_FS_PASSTHROUGH_OPEN_FILES
+ * handles; the least recently used one is closed when they run out.
+ * A directory being listed likewise keeps its fs_dir_t open from one
+ * Tread to the next, in one of CONFIG_NINEP_FS_PASSTHROUGH_OPEN_DIRS
+ * slots, until the listing ends; an evicted listing is rescanned up to
+ * where it left off.
+ *
+ * qid.path is a hash of the path below the mount point, so a file keeps
+ * its qid across walks, stats and directory listings, and qid.version
+ * changes whenever the file is written through 9P. Clients can use them
+ * to cache.
+ *
+ * Nodes are interned by path: every fid on a path shares one node, and
+ * up to CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE nodes no fid holds are
+ * kept so that walking the same path again costs neither an allocation
+ * nor an fs_stat(). A node's type and length are trusted until it is
+ * written, created or removed through 9P.
  */
 struct ninep_passthrough_fs {
 	const char *mount_point;   /* Mount point (e.g., "/lfs1", "/SD:") */
-	uint64_t next_qid_path;    /* Next QID path value */
 	struct ninep_fs_node *root; /* Root node */
+	struct k_mutex lock;       /* Protects handles, dirs and qid tables */
+	uint32_t handle_clock;     /* LRU clock */
+	struct ninep_passthrough_handle handles[CONFIG_NINEP_FS_PASSTHROUGH_OPEN_FILES];
+	struct ninep_passthrough_dir dirs[CONFIG_NINEP_FS_PASSTHROUGH_OPEN_DIRS];
+	struct ninep_passthrough_qid_slot qid_slots[CONFIG_NINEP_FS_PASSTHROUGH_QID_SLOTS];
+	struct ninep_passthrough_qid_version versions[CONFIG_NINEP_FS_PASSTHROUGH_QID_VERSIONS];
+	uint32_t version_seq;      /* Last qid.version handed out */
+	uint32_t version_floor;    /* qid.version of untracked files */
+	struct ninep_fs_node *nodes[NINEP_PASSTHROUGH_NODE_BUCKETS]; /* By path */
+	uint32_t idle_nodes;       /* Nodes in nodes[] that no fid holds */
+	uint32_t node_hits;        /* Walks answered from nodes[] */
+	uint32_t node_misses;      /* Walks that needed fs_stat() */
 };
 
 /**
@@ -7,6 +7,7 @@
 #define ZEPHYR_INCLUDE_9P_RAMFS_H_
 
 #include <zephyr/9p/server.h>
+#include <zephyr/kernel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,12 +19,50 @@ extern "C" {
  * @{
  */
 
+#ifndef CONFIG_NINEP_RAMFS_CHUNK_SIZE
+#define CONFIG_NINEP_RAMFS_CHUNK_SIZE 256
+#endif
+
+#ifndef CONFIG_NINEP_RAMFS_CHUNKS
+#define CONFIG_NINEP_RAMFS_CHUNKS 16
+#endif
+
+#ifndef CONFIG_NINEP_RAMFS_DIR_INDEX_MIN
+#define CONFIG_NINEP_RAMFS_DIR_INDEX_MIN 16
+#endif
+
 /**
  * @brief RAM filesystem context
+ *
+ * Clients can create, write, truncate (open with OTRUNC) and remove files
+ * and directories. Content written over 9P lives in
+ * CONFIG_NINEP_RAMFS_CHUNK_SIZE chunks from a slab shared by every
+ * instance; writes that would exceed the slab or @p max_bytes fail with
+ * -ENOSPC. Removed nodes are freed once no fid refers to them.
+ *
+ * Directories with at least @p dir_index_min children get a hash index
+ * for walk on their next lookup; listings keep the order of the child
+ * list either way.
  */
 struct ninep_ramfs {
 	struct ninep_fs_node *root;
 	uint64_t next_qid_path;
+	size_t max_bytes;        /**< Chunk bytes this instance may hold, 0 = no limit */
+	uint32_t dir_index_min;  /**< Children before a directory is indexed, 0 = never */
+	size_t chunk_bytes;      /**< Chunk bytes held */
+	size_t meta_bytes;       /**< Node structures and chunk tables */
+	uint32_t nodes;          /**< Allocated nodes, removed ones included */
+	struct k_mutex lock;
+	struct k_condvar borrows_done;  /**< Signalled when read_ref data is returned */
+};
+
+/**
+ * @brief ramfs memory use, see ninep_ramfs_get_stats()
+ */
+struct ninep_ramfs_stats {
+	uint32_t nodes;          /**< Files and directories */
+	size_t chunk_bytes;      /**< Chunk storage held by files */
+	size_t meta_bytes;       /**< Node structures and chunk tables */
 };
 
 /**
@@ -37,6 +76,10 @@ int ninep_ramfs_init(struct ninep_ramfs *ramfs);
 /**
  * @brief Create a file node
  *
+ * The content is copied into one heap allocation and read in place. It
+ * moves to chunk storage the first time the file is written or
+ * truncated.
+ *
  * @param ramfs RAM filesystem context
  * @param parent Parent directory
  * @param name File name
@@ -50,6 +93,26 @@ struct ninep_fs_node *ninep_ramfs_create_file(struct ninep_ramfs *ramfs,
                                                 const void *content,
                                                 size_t length);
 
+/**
+ * @brief Create a read-only file node backed by caller-owned content
+ *
+ * Unlike ninep_ramfs_create_file(), the content is not copied: the node
+ * points at @p content, which must stay valid (typically a const array in
+ * flash). Reads are served from it without an intermediate copy.
+ *
+ * @param ramfs RAM filesystem context
+ * @param parent Parent directory
+ * @param name File name
+ * @param content File content (can be NULL)
+ * @param length Content length
+ * @return Pointer to new node, or NULL on failure
+ */
+struct ninep_fs_node *ninep_ramfs_create_static_file(struct ninep_ramfs *ramfs,
+                                                       struct ninep_fs_node *parent,
+                                                       const char *name,
+                                                       const void *content,
+                                                       size_t length);
+
 /**
  * @brief Create a directory node
  *
@@ -62,6 +125,31 @@ struct ninep_fs_node *ninep_ramfs_create_dir(struct ninep_ramfs *ramfs,
                                                struct ninep_fs_node *parent,
                                                const char *name);
 
+/**
+ * @brief Set the length of a file
+ *
+ * Shrinking frees whole chunks past the new end; growing leaves a hole
+ * that reads as zeros and takes no chunks until written. Static files
+ * cannot be truncated.
+ *
+ * @param ramfs RAM filesystem context
+ * @param node File node
+ * @param length New length in bytes
+ * @return 0 on success, -EISDIR, -EACCES (static file), -ENOENT (removed)
+ *         or -ENOSPC
+ */
+int ninep_ramfs_truncate(struct ninep_ramfs *ramfs, struct ninep_fs_node *node,
+                         uint64_t length);
+
+/**
+ * @brief Get memory use
+ *
+ * @param ramfs RAM filesystem context
+ * @param stats Filled with current figures
+ */
+void ninep_ramfs_get_stats(struct ninep_ramfs *ramfs,
+                           struct ninep_ramfs_stats *stats);
+
 /**
  * @brief Get filesystem operations
  *
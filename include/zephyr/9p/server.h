@@ -50,11 +50,40 @@ struct ninep_read_handle {
 	uint32_t gen;   /**< Generation token captured at parking time */
 };
 
+/**
+ * @brief Borrowed file data returned by the read_ref fs op.
+ *
+ * @p data must stay valid and unchanged until @p release is called (or,
+ * when @p release is NULL, for as long as the node exists).
+ */
+struct ninep_read_ref {
+	const uint8_t *data;            /**< Start of the data at the read offset */
+	uint32_t len;                   /**< Bytes available (0 = end of file) */
+	void (*release)(void *arg);     /**< Called once the Rread is sent; may be NULL */
+	void *release_arg;              /**< Argument passed to release */
+};
+
+/**
+ * @brief Per-fid read position, kept by the server for readdir and
+ * read_cursor.
+ *
+ * The server zeroes it when the fid is opened and records in @p offset
+ * where the previous read ended. @p pos, @p gen and @p state belong to the
+ * filesystem; @p state is handed to releasedir when the fid goes away.
+ */
+struct ninep_dir_cursor {
+	uint64_t offset;  /**< Directory offset at which pos/state are valid */
+	uintptr_t pos;    /**< Backend position (entry index, next node, ...) */
+	uint32_t gen;     /**< Backend directory generation pos was taken at */
+	void *state;      /**< Backend resource held between reads, or NULL */
+};
+
 /**
  * @brief One parked Tread awaiting completion.
  *
- * Protected by server->tx_buf_mutex (same lock that serializes dispatch
- * and response transmission).
+ * Protected by server->tx_mutex (same lock that serializes response
+ * transmission), so parking, cancelling and completing a read are ordered
+ * with respect to every other reply on the session.
  */
 struct ninep_pending_read {
 	bool in_use;
@@ -74,9 +103,12 @@ enum ninep_node_type {
 
 /**
  * @brief File system node
+ *
+ * Backends allocate nodes with ninep_node_alloc(), which stores the name
+ * in the same block.
  */
 struct ninep_fs_node {
-	char name[64];
+	const char *name;
 	enum ninep_node_type type;
 	uint32_t mode;
 	uint64_t length;
@@ -186,6 +218,9 @@ struct ninep_fs_ops {
 
 	/**
 	 * @brief Create file/directory
+	 *
+	 * On success the fid moves from @p parent to @p *new_node; @p parent
+	 * is not clunked.
 	 */
 	int (*create)(struct ninep_fs_node *parent, const char *name,
 	              uint16_t name_len, uint32_t perm, uint8_t mode,
@@ -194,6 +229,9 @@ struct ninep_fs_ops {
 
 	/**
 	 * @brief Remove file/directory
+	 *
+	 * On success the fid is released without a clunk, so this also drops
+	 * the fid's hold on @p node.
 	 */
 	int (*remove)(struct ninep_fs_node *node, void *fs_ctx);
 
@@ -210,6 +248,16 @@ struct ninep_fs_ops {
 	 */
 	int (*clunk)(struct ninep_fs_node *node, void *fs_ctx);
 
+	/**
+	 * @brief Take another reference to a node (OPTIONAL)
+	 *
+	 * Called when a second fid starts sharing @p node (Twalk with
+	 * nwname == 0). Each call is balanced by a clunk. Filesystems that
+	 * free nodes once no fid holds them count references here and in
+	 * walk; others leave it NULL.
+	 */
+	void (*ref)(struct ninep_fs_node *node, void *fs_ctx);
+
 	/**
 	 * @brief Read from node with deferred-response support (OPTIONAL)
 	 *
@@ -244,6 +292,78 @@ struct ninep_fs_ops {
 	                     uint8_t *buf, uint32_t count, const char *uname,
 	                     const struct ninep_read_handle *h, void *fs_ctx);
 
+	/**
+	 * @brief Borrow file data for a read without copying it (OPTIONAL)
+	 *
+	 * For files whose contents already sit in RAM or flash, fill @p ref
+	 * with a pointer to the bytes at @p offset (at most @p count of them)
+	 * instead of copying them. The server sends the Rread straight from
+	 * that storage when the transport supports scatter-gather sends, and
+	 * otherwise copies it into the response buffer once. ref->release, if
+	 * set, is called exactly once after the reply has been sent (or
+	 * dropped because the request was flushed).
+	 *
+	 * Return -ENOTSUP for nodes that cannot be borrowed (directories,
+	 * generated content); the server then falls back to read_deferred()
+	 * or read() for that request. Any other negative value fails the
+	 * Tread.
+	 *
+	 * When this op is NULL, every read goes through read().
+	 */
+	int (*read_ref)(struct ninep_fs_node *node, uint64_t offset,
+	                uint32_t count, const char *uname,
+	                struct ninep_read_ref *ref, void *fs_ctx);
+
+	/**
+	 * @brief Read directory entries from a per-fid cursor (OPTIONAL)
+	 *
+	 * Directory reads return whole stat records, and a conformant client
+	 * only ever reads at offset 0 or where its previous read ended. When
+	 * @p offset equals cur->offset (and is not 0), continue from
+	 * cur->pos / cur->state instead of rescanning from the first entry;
+	 * otherwise start over, skipping @p offset bytes of records. Either
+	 * way, leave the cursor describing the first record not returned.
+	 * The server advances cur->offset by the returned byte count.
+	 *
+	 * Requests on one fid never run concurrently, so the cursor needs no
+	 * locking of its own.
+	 *
+	 * When this op is NULL, directories are read with read().
+	 *
+	 * @return Bytes of stat records written to @p buf, or negative error
+	 */
+	int (*readdir)(struct ninep_fs_node *node, uint64_t offset,
+	               uint8_t *buf, uint32_t count,
+	               struct ninep_dir_cursor *cur, const char *uname,
+	               void *fs_ctx);
+
+	/**
+	 * @brief Release a directory cursor's backend state (OPTIONAL)
+	 *
+	 * Called before clunk/remove of a fid whose cursor has a non-NULL
+	 * cur->state. Only needed by filesystems that keep resources (e.g. an
+	 * open directory handle) in the cursor.
+	 */
+	void (*releasedir)(struct ninep_fs_node *node,
+	                   struct ninep_dir_cursor *cur, void *fs_ctx);
+
+	/**
+	 * @brief Read a file through the fid's cursor (OPTIONAL)
+	 *
+	 * Gives plain files the per-fid cursor directories get, for state
+	 * that must not be shared between fids on the same node, such as a
+	 * snapshot of generated content that keeps a multi-read transfer
+	 * consistent. Anything left in cur->state is released with
+	 * releasedir(). Tried before read_ref(), read_deferred() and read();
+	 * return -ENOTSUP to have the server use those for this request.
+	 *
+	 * @return Bytes written to @p buf, or negative error
+	 */
+	int (*read_cursor)(struct ninep_fs_node *node, uint64_t offset,
+	                   uint8_t *buf, uint32_t count,
+	                   struct ninep_dir_cursor *cur, const char *uname,
+	                   void *fs_ctx);
+
 	/**
 	 * @brief Resolve a node to its policy-relevant path
 	 *
@@ -363,6 +483,50 @@ struct ninep_auth_state {
 #define CONFIG_NINEP_SERVER_MAX_PENDING_READS 4
 #endif
 
+/** Response buffers per server, i.e. max requests executing at once */
+#ifndef CONFIG_NINEP_SERVER_TX_BUFS
+#define CONFIG_NINEP_SERVER_TX_BUFS 1
+#endif
+
+/**
+ * Size of the server's fid hash index: the smallest power of two that is
+ * at least twice CONFIG_NINEP_SERVER_MAX_FIDS, so the load factor stays
+ * at or below 1/2 and linear probes stay short.
+ */
+#define NINEP_SERVER_FID_INDEX_SIZE \
+	((2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 16 ? 16 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 32 ? 32 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 64 ? 64 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 128 ? 128 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 256 ? 256 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 512 ? 512 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 1024 ? 1024 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 2048 ? 2048 : \
+	 (2 * CONFIG_NINEP_SERVER_MAX_FIDS) <= 4096 ? 4096 : 8192)
+
+/** Fids a single request can hold at once (its fid plus a new fid) */
+#define NINEP_SERVER_FIDS_PER_REQUEST 2
+
+/**
+ * @brief One response buffer from the server's pool
+ *
+ * Each request holds one for as long as it executes. The tag lets Tflush
+ * find a request that is still running and mark it flushed, which
+ * suppresses its reply. Protected by server->tx_mutex.
+ */
+struct ninep_server_txbuf {
+	uint8_t *buf;
+	uint16_t tag;
+	bool in_use;
+	bool flushed;
+	/* Fids this request took ownership of, released when it finishes.
+	 * Protected by server->state_lock. */
+	struct ninep_server_fid *held[NINEP_SERVER_FIDS_PER_REQUEST];
+	uint8_t nheld;
+};
+
+struct ninep_server_txwait;
+
 /**
  * @brief Lightweight FID entry (maps FID to filesystem node)
  *
@@ -388,6 +552,12 @@ struct ninep_server_fid {
 	                       *   open-time permission check. */
 	uint8_t open_mode;    /**< The mode Topen succeeded with (low 2 bits give
 	                       *   the access direction). */
+	struct ninep_server_txbuf *owner;  /**< Request executing on this
+	                       *   fid, NULL when idle. Requests on the same
+	                       *   fid run one at a time; requests on other
+	                       *   fids are not blocked. */
+	struct ninep_dir_cursor dir_cursor;  /**< Position of the last
+	                       *   directory read, for fs_ops->readdir */
 };
 
 /**
@@ -400,14 +570,29 @@ struct ninep_server_fid {
  * - Dynamic RX/TX buffers (can use PSRAM on ESP32)
  *
  * Total overhead for 32 FIDs: ~2KB (vs old: ~7KB)
+ *
+ * Concurrency: ninep_server_process_message() may be called from several
+ * threads at once (e.g. a transport's worker pool). Up to
+ * CONFIG_NINEP_SERVER_TX_BUFS requests execute in parallel, each with its
+ * own response buffer; only requests on the same fid are serialized, and
+ * sends are serialized at the transport by tx_mutex. Tflush takes no
+ * response buffer, so it runs even while all of them are held. Tversion
+ * waits for all other requests to finish and runs alone.
  */
 struct ninep_server {
 	struct ninep_server_config config;  /* Store by value, not pointer */
 	struct ninep_transport *transport;
 	uint32_t msize;  /* Negotiated max message size from Tversion */
 
-	/* Lightweight FID table */
+	/* Lightweight FID table. Slots are found through fid_index, an
+	 * open-addressing (linear probing) hash keyed on the client's fid
+	 * number that holds slot + 1 (0 = empty); unused slots are kept on
+	 * the fid_free stack. Lookup, allocation and release are O(1)
+	 * regardless of CONFIG_NINEP_SERVER_MAX_FIDS. */
 	struct ninep_server_fid fids[CONFIG_NINEP_SERVER_MAX_FIDS];
+	uint16_t fid_index[NINEP_SERVER_FID_INDEX_SIZE];
+	uint16_t fid_free[CONFIG_NINEP_SERVER_MAX_FIDS];
+	uint16_t fid_nfree;
 
 	/* Auth state pool - only a few concurrent auths needed */
 	struct ninep_auth_state auth_pool[CONFIG_NINEP_SERVER_AUTH_POOL];
@@ -419,18 +604,39 @@ struct ninep_server {
 
 	/* Request/response buffers (dynamically allocated, may use PSRAM) */
 	uint8_t *rx_buf;
-	uint8_t *tx_buf;
 	size_t rx_buf_size;  /* Allocated size for validation */
-	size_t tx_buf_size;  /* Allocated size for validation */
+	size_t tx_buf_size;  /* Size of each tx_bufs[] / cpl_buf buffer */
 	size_t rx_len;
 
-	struct k_mutex tx_buf_mutex;
+	/* Response buffer pool; tx_bufs_free counts the unused entries */
+	struct ninep_server_txbuf tx_bufs[CONFIG_NINEP_SERVER_TX_BUFS];
+	struct k_sem tx_bufs_free;
+
+	/* Rread buffer for ninep_server_read_complete(), which may run on a
+	 * thread already holding a pool buffer. Only allocated when the fs
+	 * implements read_deferred and the transport has no sendv op.
+	 * Protected by tx_mutex. */
+	uint8_t *cpl_buf;
+
+	/* Requests blocked waiting for a tx_bufs[] entry, so Tflush can find
+	 * them before they have one. Protected by tx_mutex. */
+	struct ninep_server_txwait *tx_waiters;
+
+	/* Serializes transport sends; protects tx_bufs[] and pending_reads[] */
+	struct k_mutex tx_mutex;
+
+	/* Protects the fid table, uname/auth pools and the dispatch gate
+	 * below. Never held across an fs_ops call or a send. */
+	struct k_mutex state_lock;
+	struct k_condvar state_cv;     /**< Signalled on fid release / request exit */
+	uint32_t active_reqs;          /**< Requests currently executing */
+	bool exclusive;                /**< Tversion running or waiting to run */
 
 	/* Deferred-read support (see read_deferred / ninep_server_read_complete).
 	 *
-	 * pending_reads[] is protected by tx_buf_mutex. The remaining fields
+	 * pending_reads[] is protected by tx_mutex. The remaining fields
 	 * coordinate completion vs. server teardown and are protected by
-	 * pending_lock, which is never held while acquiring tx_buf_mutex or
+	 * pending_lock, which is never held while acquiring tx_mutex or
 	 * during dispatch, so it cannot participate in a lock cycle. */
 	struct ninep_pending_read pending_reads[CONFIG_NINEP_SERVER_MAX_PENDING_READS];
 	uint32_t pending_gen;           /**< Monotonic generation counter */
@@ -502,6 +708,9 @@ int ninep_server_read_complete(struct ninep_read_handle h,
 /**
  * @brief Process incoming message (called by transport)
  *
+ * Safe to call concurrently from multiple threads; see struct
+ * ninep_server. @p msg only needs to stay valid until this returns.
+ *
  * @param server Server instance
  * @param msg Message buffer
  * @param len Message length
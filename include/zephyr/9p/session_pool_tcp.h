@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ZEPHYR_INCLUDE_9P_SESSION_POOL_TCP_H_
+#define ZEPHYR_INCLUDE_9P_SESSION_POOL_TCP_H_
+
+#include <zephyr/9p/session_pool.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief TCP session pool for multi-client 9P servers
+ *
+ * Creates a 9P server on a single TCP port that supports multiple
+ * concurrent clients. Each accepted connection is assigned to an
+ * independent session from the pool (its own ninep_server, so fids never
+ * collide between clients). All connections are multiplexed by one
+ * thread blocking in zsock_poll(); each poll round services every
+ * readable connection once, starting from a rotating index, so a busy
+ * client cannot starve the others.
+ *
+ * When every session is in use, further connections are accepted and
+ * closed immediately rather than left hanging in the listen backlog.
+ *
+ * Like the single-client TCP transport, this operates in dual-stack mode
+ * when CONFIG_NET_IPV6 is enabled and IPv4-only otherwise.
+ *
+ * Example usage:
+ *   NINEP_SESSION_POOL_TCP_DEFINE(tcp_pool, 4, 8192);
+ *   ninep_session_pool_tcp_init(&tcp_pool, &config);
+ *   ninep_session_pool_tcp_start(&tcp_pool);
+ *   // Accepts connections automatically
+ *   ninep_session_pool_tcp_stop(&tcp_pool);
+ */
+
+/** Stack size of the pool's poll/dispatch thread (runs all fs ops) */
+#ifndef CONFIG_NINEP_TCP_SESSION_STACK_SIZE
+#define CONFIG_NINEP_TCP_SESSION_STACK_SIZE 4096
+#endif
+
+/**
+ * @brief TCP session pool configuration
+ */
+struct ninep_session_pool_tcp_config {
+	uint16_t port;                      /* TCP port (0 = 564) */
+	int max_sessions;                   /* Maximum concurrent connections */
+	size_t rx_buf_size_per_session;    /* RX buffer size per session */
+	struct ninep_fs_ops *fs_ops;       /* Filesystem operations (shared) */
+	void *fs_context;                   /* Filesystem context (shared) */
+	const struct ninep_auth_config *auth_config;  /* Optional auth config (shared) */
+};
+
+/**
+ * @brief TCP session pool (opaque)
+ */
+struct ninep_session_pool_tcp;
+
+/**
+ * @brief Statically declare TCP session pool storage
+ *
+ * Use this macro to declare static storage for a session pool.
+ * This avoids heap allocation for the pool itself (each session's
+ * ninep_server still allocates its RX/TX buffers on connect).
+ *
+ * @param name Variable name for the pool
+ * @param num_sessions Maximum concurrent connections
+ * @param rx_buf_size RX buffer size per session
+ */
+#define NINEP_SESSION_POOL_TCP_DEFINE(name, num_sessions, rx_buf_size) \
+	_NINEP_SESSION_POOL_TCP_DEFINE(name, num_sessions, rx_buf_size)
+
+/**
+ * @brief Initialize statically allocated TCP session pool
+ *
+ * Use with storage declared by NINEP_SESSION_POOL_TCP_DEFINE().
+ * Does NOT use k_malloc().
+ *
+ * @param pool Statically allocated pool storage
+ * @param config Pool configuration
+ * @return 0 on success, negative errno on failure
+ */
+int ninep_session_pool_tcp_init(struct ninep_session_pool_tcp *pool,
+                                 const struct ninep_session_pool_tcp_config *config);
+
+/**
+ * @brief Create and initialize TCP session pool (dynamic allocation)
+ *
+ * The poll thread's stack comes from k_thread_stack_alloc(), so this
+ * needs CONFIG_DYNAMIC_THREAD; without it, use
+ * NINEP_SESSION_POOL_TCP_DEFINE() and ninep_session_pool_tcp_init().
+ *
+ * @param config Pool configuration
+ * @return Pointer to initialized pool, or NULL on failure
+ */
+struct ninep_session_pool_tcp *ninep_session_pool_tcp_create(
+	const struct ninep_session_pool_tcp_config *config);
+
+/**
+ * @brief Start listening and serving connections
+ *
+ * Binds the listen socket and starts the poll thread.
+ *
+ * @param pool TCP session pool
+ * @return 0 on success, negative errno on failure
+ */
+int ninep_session_pool_tcp_start(struct ninep_session_pool_tcp *pool);
+
+/**
+ * @brief Stop listening and disconnect all sessions
+ *
+ * @param pool TCP session pool
+ */
+void ninep_session_pool_tcp_stop(struct ninep_session_pool_tcp *pool);
+
+/**
+ * @brief Destroy a pool created with ninep_session_pool_tcp_create()
+ *
+ * Stops the pool and frees all allocated memory.
+ *
+ * @param pool TCP session pool
+ */
+void ninep_session_pool_tcp_destroy(struct ninep_session_pool_tcp *pool);
+
+/**
+ * @brief Number of currently connected sessions
+ *
+ * @param pool TCP session pool
+ * @return Connected session count
+ */
+int ninep_session_pool_tcp_active(struct ninep_session_pool_tcp *pool);
+
+/**
+ * @brief Per-connection state for a single session
+ * @internal
+ */
+struct tcp_session_conn {
+	int sock;
+	struct ninep_session *session;
+	uint8_t *rx_buf;
+	size_t rx_buf_size;
+	/* Bytes [rx_head, rx_tail) of rx_buf are received but undelivered */
+	size_t rx_head;
+	size_t rx_tail;
+};
+
+/**
+ * @brief TCP session pool structure
+ * @internal Exposed only for static allocation macro
+ */
+struct ninep_session_pool_tcp {
+	struct ninep_session_pool *pool;
+	struct ninep_session_pool_tcp_config config;
+	uint8_t *rx_buf_pool;
+	struct tcp_session_conn *conns;
+	struct zsock_pollfd *pollfds;       /* [0] = listen, [1 + i] = conns[i] */
+	int listen_sock;
+	int next_conn;                      /* Round-robin start for servicing */
+	bool active;
+	k_tid_t tid;
+	struct k_thread thread;
+	k_thread_stack_t *stack;            /* Static, or k_thread_stack_alloc() */
+};
+
+/**
+ * @brief Static allocation macro implementation
+ * @internal
+ */
+#define _NINEP_SESSION_POOL_TCP_DEFINE(name, num_sessions, rx_buf_size) \
+	static uint8_t _##name##_rx_pool[(num_sessions) * (rx_buf_size)]; \
+	static struct tcp_session_conn _##name##_conns[num_sessions]; \
+	static struct zsock_pollfd _##name##_pollfds[(num_sessions) + 1]; \
+	static K_KERNEL_STACK_DEFINE(_##name##_stack, \
+	                             CONFIG_NINEP_TCP_SESSION_STACK_SIZE); \
+	static struct { \
+		int max_sessions; \
+		struct k_mutex lock; \
+		struct ninep_fs_ops *fs_ops; \
+		void *fs_context; \
+		const struct ninep_auth_config *auth_config; \
+		struct ninep_session sessions[num_sessions]; \
+	} _##name##_session_pool_storage; \
+	static struct ninep_session_pool_tcp name = { \
+		.pool = (struct ninep_session_pool *)&_##name##_session_pool_storage, \
+		.rx_buf_pool = _##name##_rx_pool, \
+		.conns = _##name##_conns, \
+		.pollfds = _##name##_pollfds, \
+		.stack = _##name##_stack, \
+		.listen_sock = -1, \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_9P_SESSION_POOL_TCP_H_ */
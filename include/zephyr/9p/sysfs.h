@@ -14,6 +14,14 @@
 extern "C" {
 #endif
 
+#ifndef CONFIG_NINEP_SYSFS_HASH_BUCKETS
+#define CONFIG_NINEP_SYSFS_HASH_BUCKETS 64
+#endif
+
+#ifndef CONFIG_NINEP_SYSFS_NODE_CACHE
+#define CONFIG_NINEP_SYSFS_NODE_CACHE 4
+#endif
+
 /**
  * @brief Sysfs - Dynamic synthetic filesystem for Zephyr
  *
@@ -71,8 +79,25 @@ struct ninep_sysfs_entry {
 	ninep_sysfs_writer_t writer;       /* Content writer callback (NULL for read-only) */
 	ninep_sysfs_clunk_t clunk;         /* Clunk (close) callback (NULL if not needed) */
 	void *ctx;                         /* Optional context for callbacks */
+	const uint8_t *data;               /* Fixed content (static files only, else NULL) */
+	size_t data_len;                   /* Length of data */
 	bool is_dir;                       /* True for directories */
 	bool writable;                     /* True if file is writable */
+	uint32_t snapshot_size;            /* Snapshot buffer size, 0 = generate per read */
+	uint32_t snapshot_ttl_ms;          /* How long fids share a snapshot */
+	void *snapshot;                    /* Shared snapshot (internal) */
+
+	/* Path trie, linked at registration (internal) */
+	struct ninep_sysfs_entry *parent;
+	struct ninep_sysfs_entry *children;   /* In registration order */
+	struct ninep_sysfs_entry *last_child;
+	struct ninep_sysfs_entry *next;       /* Next sibling */
+	struct ninep_sysfs_entry *hash_next;  /* Lookup bucket chain */
+	uint32_t qid_path;
+	uint16_t name_off;                    /* Last path element */
+	uint16_t name_len;
+	bool implied;                         /* Parent dir never registered */
+	bool allocated;                       /* Implied dir's heap copy */
 };
 
 /**
@@ -84,11 +109,18 @@ struct ninep_sysfs {
 	size_t max_entries;                /* Maximum entries (array size) */
 	struct ninep_fs_node *root;        /* Root node */
 	uint64_t next_qid_path;            /* Next QID path number */
+	struct ninep_sysfs_entry root_entry;  /* "/" */
+	/* Children by (directory, name) */
+	struct ninep_sysfs_entry *buckets[CONFIG_NINEP_SYSFS_HASH_BUCKETS];
 };
 
 /**
  * @brief Initialize a sysfs instance
  *
+ * Initializing an instance again frees the nodes and implied directories
+ * of the earlier one. Nodes that fids still hold are freed on their last
+ * clunk, and until then read as empty.
+ *
  * @param sysfs Sysfs instance to initialize
  * @param entries Array of sysfs entries (must be static/persistent)
  * @param max_entries Maximum number of entries
@@ -101,17 +133,44 @@ int ninep_sysfs_init(struct ninep_sysfs *sysfs,
 /**
  * @brief Register a sysfs file
  *
+ * Entries are linked into a path tree as they are registered, so walks
+ * and directory listings cost in proportion to path depth and the
+ * directory's own children, not to the number of entries. Parent
+ * directories that were not registered are created implicitly; they take
+ * no slot in the entry array but a small heap allocation each (path
+ * included), freed when the instance is initialized again. This applies
+ * to every ninep_sysfs_register_*() call.
+ *
  * @param sysfs Sysfs instance
  * @param path Full path to the file (e.g., "/sys/uptime")
  * @param generator Content generator callback
  * @param ctx Optional context pointer passed to generator
- * @return 0 on success, negative error code on failure
+ * @return 0 on success, -ENOMEM if the entry array is full (or an implied
+ *         directory cannot be allocated), -EEXIST if @p path is already
+ *         registered, -ENOTDIR if a parent is a file
  */
 int ninep_sysfs_register_file(struct ninep_sysfs *sysfs,
                                const char *path,
                                ninep_sysfs_generator_t generator,
                                void *ctx);
 
+/**
+ * @brief Register a read-only sysfs file with fixed content
+ *
+ * For content that never changes (reference text, certificates, web
+ * assets). Reads are served straight from @p data, which is typically a
+ * const array in flash, without a generator call or an intermediate copy.
+ *
+ * @param sysfs Sysfs instance
+ * @param path Full path to the file (e.g., "/lib/readme.txt")
+ * @param data File content (must stay valid while registered)
+ * @param len Content length
+ * @return 0 on success, negative error code on failure
+ */
+int ninep_sysfs_register_static_file(struct ninep_sysfs *sysfs,
+                                      const char *path,
+                                      const void *data, size_t len);
+
 /**
  * @brief Register a writable sysfs file
  *
@@ -155,6 +214,8 @@ int ninep_sysfs_register_writable_file_ex(struct ninep_sysfs *sysfs,
  *
  * Directories don't have content generators - they're used for
  * organizing files hierarchically.
+ * Registering a directory that already exists implicitly (because a
+ * file below it was registered first) succeeds without using a slot.
  *
  * @param sysfs Sysfs instance
  * @param path Full path to the directory (e.g., "/sys")
@@ -162,6 +223,33 @@ int ninep_sysfs_register_writable_file_ex(struct ninep_sysfs *sysfs,
  */
 int ninep_sysfs_register_dir(struct ninep_sysfs *sysfs, const char *path);
 
+/**
+ * @brief Serve a generated file from a snapshot
+ *
+ * By default the generator runs on every Tread for the requested offset,
+ * so a file read in several chunks is generated several times and can
+ * change between them. In snapshot mode a fid's first read (and any read
+ * at offset 0) calls the generator with increasing offsets until it
+ * returns 0 or @p max_len bytes are buffered, and the fid's reads are then
+ * served from that copy until it is clunked. Content past @p max_len is
+ * cut off.
+ *
+ * With @p ttl_ms non-zero the latest snapshot is also shared: fids that
+ * start reading within @p ttl_ms of it get it instead of running the
+ * generator again, for generators too expensive to run per reader.
+ *
+ * @param sysfs Sysfs instance
+ * @param path Path of a file registered with a generator
+ * @param max_len Snapshot buffer size (heap, per snapshot); 0 turns
+ *                snapshot mode off
+ * @param ttl_ms How long a snapshot is shared between fids; 0 for one
+ *               snapshot per fid
+ * @return 0 on success, -ENOENT if @p path is not registered, -EINVAL if
+ *         it has no generator
+ */
+int ninep_sysfs_set_snapshot(struct ninep_sysfs *sysfs, const char *path,
+                             size_t max_len, uint32_t ttl_ms);
+
 /**
  * @brief Get filesystem operations for sysfs
  *
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include <errno.h>
 
 #ifdef __cplusplus
@@ -36,6 +37,14 @@ typedef void (*ninep_transport_recv_cb_t)(struct ninep_transport *transport,
                                           const uint8_t *buf, size_t len,
                                           void *user_data);
 
+/**
+ * @brief One piece of a scatter-gather message (see sendv)
+ */
+struct ninep_iovec {
+	const void *base;
+	size_t len;
+};
+
 /**
  * @brief Transport operations
  */
@@ -78,6 +87,24 @@ struct ninep_transport_ops {
 	 * @return MTU in bytes, or negative error code
 	 */
 	int (*get_mtu)(struct ninep_transport *transport);
+
+	/**
+	 * @brief Send one message gathered from several buffers (optional)
+	 *
+	 * Sends the concatenation of @p iov[0..iovcnt) as a single message,
+	 * so e.g. an Rread can go out as an 11-byte header plus the
+	 * filesystem's own data buffer without first being copied into one
+	 * contiguous buffer. The buffers only need to stay valid until the
+	 * call returns. Transports without it get a fallback to send (see
+	 * ninep_transport_sendv()).
+	 *
+	 * @param transport Transport instance
+	 * @param iov Message pieces, in order
+	 * @param iovcnt Number of pieces
+	 * @return Number of bytes sent, or negative error code
+	 */
+	int (*sendv)(struct ninep_transport *transport,
+	             const struct ninep_iovec *iov, int iovcnt);
 };
 
 /**
@@ -120,6 +147,45 @@ static inline int ninep_transport_send(struct ninep_transport *transport,
 	return transport->ops->send(transport, buf, len);
 }
 
+/**
+ * @brief Send a message gathered from several buffers
+ *
+ * Uses the transport's sendv op when it has one. Otherwise a single
+ * buffer is passed to send; a message in several pieces gets -ENOTSUP,
+ * and the caller must gather it into one buffer itself.
+ *
+ * @param transport Transport instance
+ * @param iov Message pieces, in order
+ * @param iovcnt Number of pieces
+ * @return Number of bytes sent, or negative error code
+ */
+static inline int ninep_transport_sendv(struct ninep_transport *transport,
+                                        const struct ninep_iovec *iov,
+                                        int iovcnt)
+{
+	if (!transport || !transport->ops || !iov || iovcnt <= 0) {
+		return -EINVAL;
+	}
+	if (transport->ops->sendv) {
+		return transport->ops->sendv(transport, iov, iovcnt);
+	}
+	if (iovcnt == 1 && transport->ops->send) {
+		return transport->ops->send(transport, iov[0].base, iov[0].len);
+	}
+	return -ENOTSUP;
+}
+
+/**
+ * @brief Check whether a transport sends scatter-gather natively
+ *
+ * @param transport Transport instance
+ * @return true if ninep_transport_sendv() never needs a gather buffer
+ */
+static inline bool ninep_transport_has_sendv(struct ninep_transport *transport)
+{
+	return transport && transport->ops && transport->ops->sendv;
+}
+
 /**
  * @brief Start receiving messages
  *
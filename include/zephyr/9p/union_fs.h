@@ -32,6 +32,28 @@ struct ninep_union_mount {
 	struct ninep_fs_node *root;          /* Backend's root node */
 };
 
+/**
+ * @brief Component of a mount path
+ *
+ * Mount paths are split into components when they are mounted and kept
+ * as a tree rooted at the "/" component. A component that is not itself
+ * a mount point is served as a synthetic directory.
+ */
+struct ninep_union_mount_node {
+	const char *name;                    /* Points into the mount path */
+	uint16_t name_len;
+	struct ninep_union_mount *mount;     /* Mounted here, or NULL */
+	uint64_t qid_path;                   /* QID path as a synthetic dir */
+	struct ninep_union_mount_node *children;
+	struct ninep_union_mount_node *next; /* Sibling, in mount order */
+};
+
+/** Nodes whose owning mount is tracked */
+#define NINEP_UNION_NODE_OWNERS 256
+
+/** Buckets in the node-to-owner table (a power of two) */
+#define NINEP_UNION_OWNER_BUCKETS 128
+
 /**
  * @brief Node ownership tracking entry
  */
@@ -40,6 +62,17 @@ struct ninep_node_owner {
 	struct ninep_union_mount *mount;
 	uint32_t last_access;  /* For LRU eviction */
 	uint32_t refcount;     /* Reference count (open fids) */
+	struct ninep_node_owner *hash_next;  /* Bucket chain, or free list */
+	struct ninep_node_owner *lru_prev;   /* Idle or active LRU list */
+	struct ninep_node_owner *lru_next;
+};
+
+/**
+ * @brief LRU list of tracking entries, most recently used first
+ */
+struct ninep_node_owner_lru {
+	struct ninep_node_owner *head;
+	struct ninep_node_owner *tail;
 };
 
 /**
@@ -61,11 +94,22 @@ struct ninep_union_fs {
 	struct ninep_fs_node *root;         /* Synthetic root directory */
 	uint64_t next_qid_path;             /* Next QID for synthetic nodes */
 
+	/* Mount paths by component; mount_tree.mount is the "/" mount */
+	struct ninep_union_mount_node mount_tree;
+	/* Stat records of the root's mount point children, rebuilt by
+	 * ninep_union_fs_mount() and served as is on root reads */
+	uint8_t *root_listing;
+	size_t root_listing_len;
+
 	/* Node ownership tracking (for non-root nodes) - LRU cache */
-	struct ninep_node_owner node_owners[256];  /* LRU cache for multi-client usage (4 clients × ~64 fids) */
+	struct ninep_node_owner node_owners[NINEP_UNION_NODE_OWNERS];  /* LRU cache for multi-client usage (4 clients × ~64 fids) */
 	size_t num_node_owners;
+	struct ninep_node_owner *owner_buckets[NINEP_UNION_OWNER_BUCKETS];  /* By node pointer */
+	struct ninep_node_owner *owner_free;  /* Unused node_owners[] */
+	struct ninep_node_owner_lru idle;     /* refcount == 0, evicted first */
+	struct ninep_node_owner_lru active;   /* refcount > 0 */
 
-	/* Protects node_owners[] and num_node_owners against concurrent
+	/* Protects the tracking table and its lists against concurrent
 	 * register/unregister/incref/decref/find from multiple per-session
 	 * threads. Held only inside the static tracking helpers; never held
 	 * across calls into backend fs_ops. */
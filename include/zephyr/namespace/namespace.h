@@ -74,18 +74,48 @@ struct ns_entry {
 	uint32_t flags;
 	int priority;  /**< Priority for union mounts */
 
-	/* For union mounts: linked list */
+	/* Retired list, once unmounted (internal) */
 	struct ns_entry *next;
 };
 
+/**
+ * @brief Union stack at one mount point, highest priority first
+ *
+ * Never modified once published: a mount or unmount publishes a new one.
+ */
+struct ns_union {
+	int count;
+	struct ns_union *retired_next;   /**< Retired list (internal) */
+	struct ns_entry *entries[];
+};
+
+/**
+ * @brief Path component in a namespace's mount tree
+ */
+struct ns_tree_node {
+	atomic_ptr_t stack;              /**< struct ns_union *, or NULL */
+	atomic_ptr_t children;           /**< First child; only ever prepended */
+	struct ns_tree_node *next;       /**< Sibling, set before publishing */
+	struct ns_tree_node *parent;
+	uint16_t name_len;
+	char name[];
+};
+
 /**
  * @brief Per-thread namespace
  */
 struct thread_namespace {
 	k_tid_t thread_id;  /**< Owning thread */
 
-	/* Namespace entries (hash table) */
-	struct ns_entry *entries[CONFIG_NS_HASH_SIZE];
+	/* Mount tree, one node per path component. Lookups read it without
+	 * the lock; see namespace.c. */
+	struct ns_tree_node *root;
+	atomic_ptr_t view;  /**< Namespace lookups read: self, or COW parent */
+
+	/* Unpublished, freed once no lookup is in progress */
+	struct ns_union *retired_stacks;
+	struct ns_entry *retired_entries;
+	struct thread_namespace *retired_parent;
 
 	/* Parent namespace (for COW inheritance) */
 	struct thread_namespace *parent;
@@ -367,10 +397,29 @@ struct thread_namespace *ns_get_current(void);
  */
 int ns_set_current(struct thread_namespace *ns);
 
+/**
+ * @brief Start using entries returned by ns_walk()
+ *
+ * A concurrent unmount may free an entry as soon as no lookup is in
+ * progress. Entries ns_walk() returns after ns_walk_begin() stay
+ * allocated until the matching ns_walk_end(). Keep the section short:
+ * nothing unmounted in any namespace is freed while one is open.
+ */
+void ns_walk_begin(void);
+
+/**
+ * @brief End a section started with ns_walk_begin()
+ */
+void ns_walk_end(void);
+
 /**
  * @brief Walk through namespace to resolve a path
  *
- * Returns list of all matching entries (for union mounts).
+ * Returns list of all matching entries (for union mounts): the longest
+ * matching mount point first, each mount point's union stack in priority
+ * order. Runs in time proportional to the path's depth and never waits
+ * for a concurrent mount or unmount. Call it between ns_walk_begin() and
+ * ns_walk_end() to dereference the entries it returns.
  *
  * @param path Path to resolve
  * @param entries Output array of matching ns_entries
@@ -29,6 +29,7 @@ extern "C" {
 
 /* Forward declarations */
 struct ninep_server;
+struct ninep_fs_node;
 struct srv_entry;
 
 /**
@@ -68,6 +69,19 @@ struct srv_entry {
 	struct srv_entry *next;
 };
 
+/**
+ * @brief Node handed out by the /srv filesystem, and its service
+ */
+struct srv_node_owner {
+	struct ninep_fs_node *node;
+	struct srv_entry *service;
+	uint32_t refcount;             /**< Walks and refs not yet clunked */
+	struct srv_node_owner *next;   /**< Bucket chain, or free list */
+};
+
+/** Buckets in the node-to-service table (a power of two) */
+#define SRV_OWNER_BUCKETS 64
+
 /**
  * @brief Global service registry
  */
@@ -75,6 +89,11 @@ struct srv_registry {
 	struct k_mutex lock;
 	struct srv_entry *services;  /**< Linked list of services */
 	int num_services;
+
+	/* Nodes handed out by the /srv filesystem, by node pointer */
+	struct srv_node_owner owners[CONFIG_SRV_MAX_NODES];
+	struct srv_node_owner *owner_buckets[SRV_OWNER_BUCKETS];
+	struct srv_node_owner *owner_free;
 };
 
 /* ========================================================================
@@ -716,81 +716,65 @@ static int gen_bt_address(uint8_t *buf, size_t buf_size, uint64_t offset, void *
 
 /* ========== LIBRARY FILES - Reference Material ========== */
 
-/* Generate lib/9p-intro.txt - large reference file */
-static int gen_9p_intro(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
-{
-	static const char intro[] =
-		"Introduction to the 9P Protocol\n"
-		"================================\n"
-		"\n"
-		"The 9P protocol (originally named Styx) is a network protocol\n"
-		"developed for Plan 9 from Bell Labs. It provides a unified\n"
-		"interface to distributed resources using a file system paradigm.\n"
-		"\n"
-		"Key Concepts:\n"
-		"-------------\n"
-		"\n"
-		"1. Everything is a File\n"
-		"   All resources are represented as files in a hierarchical\n"
-		"   namespace. Want to control hardware? Read/write a file!\n"
-		"\n"
-		"2. Simple Protocol\n"
-		"   9P uses a simple request-response model with just 14 message\n"
-		"   types. This makes it easy to implement and debug.\n"
-		"\n"
-		"3. Network Transparent\n"
-		"   Resources can be accessed locally or remotely using the same\n"
-		"   file operations. The network becomes transparent.\n"
-		"\n"
-		"Why 9P for Embedded/IoT?\n"
-		"------------------------\n"
-		"\n"
-		"- Lightweight: Small memory footprint\n"
-		"- Flexible: Works over any transport (TCP, BLE, UART...)\n"
-		"- Powerful: Expose ANY device capability as a file!\n"
-		"- Standard: Well-defined protocol with multiple implementations\n"
-		"\n"
-		"This Demo:\n"
-		"---------\n"
-		"\n"
-		"You're viewing this file over Bluetooth L2CAP using 9P!\n"
-		"Browse the filesystem to see:\n"
-		"\n"
-		"/dev/led        - Control an LED by writing 'on' or 'off'\n"
-		"/dev/button1    - Live button state and press counter\n"
-		"/dev/button2    - Live button state and press counter\n"
-		"/sensors/temp0  - Read live temperature sensor\n"
-		"/sys/threads    - See all running threads\n"
-		"/sys/firmware   - Upload firmware over BLE!\n"
-		"/net/bt/*       - Bluetooth connection statistics\n"
-		"\n"
-		"The Future:\n"
-		"----------\n"
-		"\n"
-		"Imagine your IoT devices exposing everything as files:\n"
-		"- Configuration via text files\n"
-		"- Sensor data as readable streams\n"
-		"- Control interfaces as writable files\n"
-		"- Firmware updates as file uploads\n"
-		"\n"
-		"All accessible from your phone, computer, or another device\n"
-		"using a simple, universal protocol. That's the power of 9P!\n"
-		"\n"
-		"Learn more: http://9p.io/\n";
-
-	/* Use sizeof() - 1 to get length (excluding null terminator) */
-	const int len = sizeof(intro) - 1;
-
-	if (offset >= len) {
-		return 0;
-	}
-
-	size_t remaining = len - offset;
-	size_t to_copy = MIN(remaining, buf_size);
-
-	memcpy(buf, intro + offset, to_copy);
-	return to_copy;
-}
+/* lib/9p-intro.txt - large reference file, served straight from flash */
+static const char intro_9p[] =
+	"Introduction to the 9P Protocol\n"
+	"================================\n"
+	"\n"
+	"The 9P protocol (originally named Styx) is a network protocol\n"
+	"developed for Plan 9 from Bell Labs. It provides a unified\n"
+	"interface to distributed resources using a file system paradigm.\n"
+	"\n"
+	"Key Concepts:\n"
+	"-------------\n"
+	"\n"
+	"1. Everything is a File\n"
+	"   All resources are represented as files in a hierarchical\n"
+	"   namespace. Want to control hardware? Read/write a file!\n"
+	"\n"
+	"2. Simple Protocol\n"
+	"   9P uses a simple request-response model with just 14 message\n"
+	"   types. This makes it easy to implement and debug.\n"
+	"\n"
+	"3. Network Transparent\n"
+	"   Resources can be accessed locally or remotely using the same\n"
+	"   file operations. The network becomes transparent.\n"
+	"\n"
+	"Why 9P for Embedded/IoT?\n"
+	"------------------------\n"
+	"\n"
+	"- Lightweight: Small memory footprint\n"
+	"- Flexible: Works over any transport (TCP, BLE, UART...)\n"
+	"- Powerful: Expose ANY device capability as a file!\n"
+	"- Standard: Well-defined protocol with multiple implementations\n"
+	"\n"
+	"This Demo:\n"
+	"---------\n"
+	"\n"
+	"You're viewing this file over Bluetooth L2CAP using 9P!\n"
+	"Browse the filesystem to see:\n"
+	"\n"
+	"/dev/led        - Control an LED by writing 'on' or 'off'\n"
+	"/dev/button1    - Live button state and press counter\n"
+	"/dev/button2    - Live button state and press counter\n"
+	"/sensors/temp0  - Read live temperature sensor\n"
+	"/sys/threads    - See all running threads\n"
+	"/sys/firmware   - Upload firmware over BLE!\n"
+	"/net/bt/*       - Bluetooth connection statistics\n"
+	"\n"
+	"The Future:\n"
+	"----------\n"
+	"\n"
+	"Imagine your IoT devices exposing everything as files:\n"
+	"- Configuration via text files\n"
+	"- Sensor data as readable streams\n"
+	"- Control interfaces as writable files\n"
+	"- Firmware updates as file uploads\n"
+	"\n"
+	"All accessible from your phone, computer, or another device\n"
+	"using a simple, universal protocol. That's the power of 9P!\n"
+	"\n"
+	"Learn more: http://9p.io/\n";
 
 #if 0  /* Disabled - removed general file storage partition */
 /* Pre-populate LittleFS with initial files */
@@ -1094,7 +1078,8 @@ static int setup_filesystem(void)
 	}
 
 	/* Create /lib/9p-intro.txt - Large reference file */
-	ret = ninep_sysfs_register_file(&sysfs, "lib/9p-intro.txt", gen_9p_intro, NULL);
+	ret = ninep_sysfs_register_static_file(&sysfs, "lib/9p-intro.txt",
+	                                       intro_9p, sizeof(intro_9p) - 1);
 	if (ret < 0) {
 		LOG_ERR("Failed to add lib/9p-intro.txt: %d", ret);
 		return ret;
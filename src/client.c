@@ -13,6 +13,7 @@
 #include <zephyr/logging/log.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 
 LOG_MODULE_REGISTER(ninep_client, CONFIG_NINEP_LOG_LEVEL);
 
@@ -28,7 +29,7 @@ static struct ninep_tag_entry *alloc_tag_locked(struct ninep_client *client, uin
 			client->tags[i].in_use = true;
 			client->tags[i].complete = false;
 			client->tags[i].error = 0;
-			client->tags[i].user_ctx = NULL;
+			client->tags[i].req = NULL;
 			*tag = client->next_tag++;
 			client->tags[i].tag = *tag;
 			return &client->tags[i];
@@ -61,35 +62,47 @@ static void free_tag_locked(struct ninep_client *client, uint16_t tag)
  * FID management
  */
 
-int ninep_client_alloc_fid(struct ninep_client *client, uint32_t *fid)
+/* Allocate a fid (caller must hold lock) */
+static int alloc_fid_locked(struct ninep_client *client, uint32_t *fid)
 {
-	k_mutex_lock(&client->lock, K_FOREVER);
-
 	for (size_t i = 0; i < client->max_fids; i++) {
 		if (!client->fids[i].in_use) {
 			client->fids[i].in_use = true;
 			client->fids[i].fid = client->next_fid++;
+			client->fids[i].iounit = 0;
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+			client->fids[i].path_origin = 0;
+#endif
 			*fid = client->fids[i].fid;
-			k_mutex_unlock(&client->lock);
 			return 0;
 		}
 	}
-
-	k_mutex_unlock(&client->lock);
 	return -ENOMEM;
 }
 
-void ninep_client_free_fid(struct ninep_client *client, uint32_t fid)
+/* Free a fid (caller must hold lock) */
+static void free_fid_locked(struct ninep_client *client, uint32_t fid)
 {
-	k_mutex_lock(&client->lock, K_FOREVER);
-
 	for (size_t i = 0; i < client->max_fids; i++) {
 		if (client->fids[i].in_use && client->fids[i].fid == fid) {
 			client->fids[i].in_use = false;
 			break;
 		}
 	}
+}
+
+int ninep_client_alloc_fid(struct ninep_client *client, uint32_t *fid)
+{
+	k_mutex_lock(&client->lock, K_FOREVER);
+	int ret = alloc_fid_locked(client, fid);
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
 
+void ninep_client_free_fid(struct ninep_client *client, uint32_t fid)
+{
+	k_mutex_lock(&client->lock, K_FOREVER);
+	free_fid_locked(client, fid);
 	k_mutex_unlock(&client->lock);
 }
 
@@ -162,7 +175,89 @@ static struct ninep_client_fid *find_fid_locked(struct ninep_client *client, uin
 }
 
 /*
- * Response handling - single shared buffer, broadcast to all waiters
+ * Request lifecycle
+ *
+ * Every request, blocking or not, is a struct ninep_client_req bound to a
+ * tag.  The receive callback parses the reply into the request, releases
+ * the tag and any fid the request gives up, and then notifies the owner.
+ */
+
+static int parse_reply_locked(struct ninep_client *client,
+                              struct ninep_tag_entry *entry,
+                              struct ninep_client_req *req);
+
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+static void path_cache_note_locked(struct ninep_client *client,
+                                   struct ninep_client_req *req, int result);
+#endif
+
+/* Drop a fid the request allocated (on failure) or consumed (lock held) */
+static void release_fids_locked(struct ninep_client *client,
+                                struct ninep_client_req *req, int result)
+{
+	switch (req->type) {
+	case NINEP_TAUTH:
+	case NINEP_TATTACH:
+	case NINEP_TWALK:
+		/* newfid only exists on the server if the request succeeded */
+		if (result < 0) {
+			free_fid_locked(client, req->fid);
+		}
+		break;
+	case NINEP_TREMOVE:
+	case NINEP_TCLUNK:
+		/* Consumed regardless of outcome — on timeout the server state
+		 * is unknown, but leaking client fids guarantees exhaustion */
+		free_fid_locked(client, req->fid);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Complete req with its reply, or with err if negative (lock held) */
+static void finish_req_locked(struct ninep_client *client,
+                              struct ninep_client_req *req, int err)
+{
+	struct ninep_tag_entry *entry = req->entry;
+	int result = err < 0 ? err : parse_reply_locked(client, entry, req);
+
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+	path_cache_note_locked(client, req, result);
+#endif
+	release_fids_locked(client, req, result);
+	entry->req = NULL;
+	req->result = result;
+	req->complete = true;
+
+	/* A held read keeps its tag until the data is taken from the RX buffer */
+	if (req->hold && result >= 0) {
+		return;
+	}
+	entry->in_use = false;
+	req->entry = NULL;
+}
+
+/* Tell the owner of an async request it completed (no lock held) */
+static void notify_req(struct ninep_client *client, struct ninep_client_req *req,
+                       ninep_client_done_t done, struct k_poll_signal *signal,
+                       int result)
+{
+#ifdef CONFIG_POLL
+	if (signal) {
+		k_poll_signal_raise(signal, result);
+	}
+#else
+	ARG_UNUSED(signal);
+	ARG_UNUSED(result);
+#endif
+	if (done) {
+		done(client, req);
+	}
+}
+
+/*
+ * Response handling - per-tag RX buffers, broadcast to all waiters
  */
 
 static void client_recv_callback(struct ninep_transport *transport,
@@ -187,6 +282,14 @@ static void client_recv_callback(struct ninep_transport *transport,
 		return;
 	}
 
+	/* Already answered: a held read's data is still in rx, and a second
+	 * reply (to a resend after a timeout) must not land on top of it */
+	if (entry->complete) {
+		LOG_DBG("Dropping duplicate reply for tag %u", hdr.tag);
+		k_mutex_unlock(&client->lock);
+		return;
+	}
+
 	/* Copy response into this tag's own RX buffer (per-tag when the caller
 	 * provided per-tag regions; otherwise the shared fallback). */
 	if (len <= client->buf_size) {
@@ -195,10 +298,7 @@ static void client_recv_callback(struct ninep_transport *transport,
 	} else {
 		LOG_ERR("Response too large: %zu > %zu", len, client->buf_size);
 		entry->error = -ENOMEM;
-		entry->complete = true;
-		k_condvar_broadcast(&client->resp_cv);
-		k_mutex_unlock(&client->lock);
-		return;
+		goto complete;
 	}
 
 	/* Handle error response */
@@ -244,12 +344,31 @@ static void client_recv_callback(struct ninep_transport *transport,
 		client->last_ename[0] = '\0';
 	}
 
+complete:
 	entry->complete = true;
 
+	/* A request's owner is notified after the lock is dropped; take what
+	 * that needs now, as a blocking caller's req may be gone by then. */
+	struct ninep_client_req *req = entry->req;
+	ninep_client_done_t done = NULL;
+	struct k_poll_signal *signal = NULL;
+	int result = 0;
+
+	if (req) {
+		finish_req_locked(client, req, entry->error);
+		done = req->done;
+		signal = req->signal;
+		result = req->result;
+	}
+
 	/* Wake ALL waiters - they check if their tag completed */
 	k_condvar_broadcast(&client->resp_cv);
 
 	k_mutex_unlock(&client->lock);
+
+	if (done || signal) {
+		notify_req(client, req, done, signal, result);
+	}
 }
 
 /*
@@ -306,42 +425,116 @@ static void flush_tag_locked(struct ninep_client *client, uint16_t oldtag)
 }
 
 /*
- * Send a T-message (already in tx_buf) and wait for its response,
- * optionally retrying on timeout.
+ * Abandon an outstanding request: Tflush it, then complete it with err
+ * unless its reply beat the Rflush.  Caller holds client->lock.
+ */
+static void cancel_req_locked(struct ninep_client *client,
+                              struct ninep_client_req *req, int err)
+{
+	if (req->complete) {
+		return;
+	}
+
+	flush_tag_locked(client, req->entry->tag);
+	if (!req->complete) {
+		finish_req_locked(client, req, err);
+	}
+}
+
+/*
+ * Bind req to a fresh tag for a request of the given type.
+ * Caller holds client->lock.  Returns the tag entry, or NULL if none free.
+ */
+static struct ninep_tag_entry *begin_req_locked(struct ninep_client *client,
+                                                struct ninep_client_req *req,
+                                                uint8_t type, uint32_t fid)
+{
+	uint16_t tag;
+	struct ninep_tag_entry *entry = alloc_tag_locked(client, &tag);
+
+	if (!entry) {
+		return NULL;
+	}
+
+	entry->req = req;
+	req->entry = entry;
+	req->type = type;
+	req->fid = fid;
+	req->complete = false;
+	req->result = 0;
+	return entry;
+}
+
+/*
+ * Send the T-message of len bytes built in req's tag TX buffer.  If it was
+ * not built or not sent, req is released without completing.
+ * Caller holds client->lock.  Returns the tag, or a negative error code.
+ */
+static int send_req_locked(struct ninep_client *client,
+                           struct ninep_client_req *req, int len)
+{
+	struct ninep_tag_entry *entry = req->entry;
+	uint16_t tag = entry->tag;
+	int ret = len;
+
+	if (len >= 0) {
+		entry->tx_len = len;
+		ret = ninep_transport_send(client->transport, entry->tx, len);
+	}
+
+	/* A synchronous transport may already have delivered the reply */
+	if (ret < 0 && !req->complete) {
+		release_fids_locked(client, req, ret);
+		entry->req = NULL;
+		entry->in_use = false;
+		req->entry = NULL;
+		return ret;
+	}
+
+	return tag;
+}
+
+/*
+ * Wait for a request to complete, re-sending it on timeout up to retries
+ * times.
  *
- * Only idempotent operations (read, stat, version, write) should pass
+ * Only idempotent operations (read, stat, version) should pass
  * retries > 0.  Stateful operations (walk, open, attach, auth, create,
- * clunk, remove) must NOT retry because the server may have already
+ * clunk, remove, write) must NOT retry because the server may have already
  * processed the request and changed state — a retry would hit a
  * "fid already in use" / "already open" error.
  *
  * Caller must hold client->lock.  Lock is held on return.
- * tx_buf must contain the built message of msg_len bytes.
  */
-static int send_and_wait(struct ninep_client *client,
-                         struct ninep_tag_entry *entry,
-                         size_t msg_len,
-                         uint8_t retries)
+static int wait_req_locked(struct ninep_client *client,
+                           struct ninep_client_req *req, uint8_t retries)
 {
 	uint8_t retries_left = retries;
-	int ret;
 
 	for (;;) {
-		ret = ninep_transport_send(client->transport,
-					   entry->tx, msg_len);
-		if (ret < 0) {
-			return ret;
-		}
+		int64_t deadline = k_uptime_get() + client->config->timeout_ms;
+
+		while (!req->complete) {
+			int64_t remaining = deadline - k_uptime_get();
 
-		ret = wait_for_tag(client, entry, client->config->timeout_ms);
-		if (ret != -ETIMEDOUT || retries_left == 0) {
-			if (ret == -ETIMEDOUT) {
-				/* Giving up on this tag — Tflush it so the server
-				 * cancels the in-flight op and no orphaned reply
-				 * lands later. */
-				flush_tag_locked(client, entry->tag);
+			if (remaining <= 0 ||
+			    k_condvar_wait(&client->resp_cv, &client->lock,
+			                   K_MSEC(remaining)) == -EAGAIN) {
+				break;
 			}
-			return ret;
+			/* Spurious wakeup or another tag completed - loop and check */
+		}
+
+		if (req->complete) {
+			return req->result;
+		}
+
+		if (retries_left == 0) {
+			/* Giving up on this tag — Tflush it so the server
+			 * cancels the in-flight op and no orphaned reply
+			 * lands later. */
+			cancel_req_locked(client, req, -ETIMEDOUT);
+			return req->result;
 		}
 
 		retries_left--;
@@ -358,14 +551,76 @@ static int send_and_wait(struct ninep_client *client,
 		k_mutex_lock(&client->lock, K_FOREVER);
 
 		/* Late response arrived during sleep? */
-		if (entry->complete) {
-			return entry->error;
+		if (req->complete) {
+			return req->result;
 		}
 
-		/* Reset tag for retry */
-		entry->complete = false;
-		entry->error = 0;
+		int ret = ninep_transport_send(client->transport, req->entry->tx,
+		                               req->entry->tx_len);
+		if (ret < 0) {
+			finish_req_locked(client, req, ret);
+			return ret;
+		}
+	}
+}
+
+/*
+ * Finish a blocking call: wait for the request it submitted.
+ * submitted is the submit result; retries as for wait_req_locked().
+ */
+static int run_blocking(struct ninep_client *client, struct ninep_client_req *req,
+                        int submitted, uint8_t retries, const char *what)
+{
+	if (submitted < 0) {
+		return submitted;
+	}
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+	int ret = wait_req_locked(client, req, retries);
+	k_mutex_unlock(&client->lock);
+
+	if (ret < 0) {
+		LOG_ERR("%s request failed: %d", what, ret);
+	}
+	return ret;
+}
+
+void ninep_client_req_init(struct ninep_client_req *req,
+                           ninep_client_done_t done, void *user_data)
+{
+	memset(req, 0, sizeof(*req));
+	req->done = done;
+	req->user_data = user_data;
+}
+
+int ninep_client_cancel(struct ninep_client *client, struct ninep_client_req *req)
+{
+	if (!client || !req) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	if (req->complete || !req->entry) {
+		k_mutex_unlock(&client->lock);
+		return -EALREADY;
+	}
+
+	cancel_req_locked(client, req, -ECANCELED);
+
+	/* The reply may have won the race; the owner is notified either way,
+	 * by the receive callback or here. */
+	bool cancelled = req->result == -ECANCELED;
+	ninep_client_done_t done = req->done;
+	struct k_poll_signal *signal = req->signal;
+
+	k_mutex_unlock(&client->lock);
+
+	if (!cancelled) {
+		return -EALREADY;
 	}
+	notify_req(client, req, done, signal, -ECANCELED);
+	return 0;
 }
 
 /*
@@ -421,6 +676,7 @@ int ninep_client_init(struct ninep_client *client,
 	 * (true 9P tag multiplexing). */
 	for (size_t i = 0; i < client->max_tags; i++) {
 		client->tags[i].in_use = false;
+		client->tags[i].req = NULL;
 		if (pool_tx != NULL) {
 			client->tags[i].tx = pool_tx + i * client->buf_size;
 			client->tags[i].rx = pool_rx + i * client->buf_size;
@@ -452,66 +708,33 @@ int ninep_client_init(struct ninep_client *client,
 }
 
 /*
- * 9P Protocol Operations
+ * Reply parsing
  */
 
-int ninep_client_version(struct ninep_client *client)
+static uint32_t get_le32(const uint8_t *b)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
-
-	k_mutex_lock(&client->lock, K_FOREVER);
-
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
-	}
-
-	/* Build Tversion */
-	int len = ninep_build_tversion(entry->tx, client->buf_size,
-	                                NINEP_NOTAG, client->config->max_message_size,
-	                                client->config->version,
-	                                strlen(client->config->version));
-	if (len < 0) {
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
-	}
-
-	/* Override tag to NOTAG for version */
-	entry->tag = NINEP_NOTAG;
-
-	/* Send and wait — version is idempotent, safe to retry */
-	int ret = send_and_wait(client, entry, len, client->max_retries);
-	if (ret < 0) {
-		LOG_ERR("Version request failed: %d", ret);
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return ret;
-	}
+	return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
 
-	/* Parse and validate Rversion. version(5): the server's msize must be
-	 * <= what we offered; we also cap it to our per-tag buffer. And the
-	 * server must actually speak our version — a "unknown" reply (or any
-	 * non-9P2000 string) means we cannot proceed. */
-	if (entry->rx_len < 13) {
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
+/* Rversion. version(5): the server's msize must be <= what we offered; we
+ * also cap it to our per-tag buffer. And the server must actually speak
+ * our version — a "unknown" reply (or any non-9P2000 string) means we
+ * cannot proceed. */
+static int parse_rversion_locked(struct ninep_client *client,
+                                 const uint8_t *rx, uint32_t rx_len)
+{
+	if (rx_len < 13) {
 		return -EIO;
 	}
 
-	uint32_t smsize = entry->rx[7] | (entry->rx[8] << 8) |
-	                  (entry->rx[9] << 16) | (entry->rx[10] << 24);
-	uint16_t sver_len = entry->rx[11] | (entry->rx[12] << 8);
-	const char *sver = (const char *)&entry->rx[13];
+	uint32_t smsize = get_le32(&rx[7]);
+	uint16_t sver_len = rx[11] | (rx[12] << 8);
+	const char *sver = (const char *)&rx[13];
 
-	if (entry->rx_len < (size_t)(13 + sver_len) ||
+	if (rx_len < (size_t)(13 + sver_len) ||
 	    sver_len < 6 || memcmp(sver, "9P2000", 6) != 0) {
 		LOG_ERR("Server did not accept 9P2000 (version=%.*s)",
 		        (int)sver_len, sver);
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
 		return -ENOTSUP;
 	}
 
@@ -523,179 +746,328 @@ int ninep_client_version(struct ninep_client *client)
 		client->msize = client->buf_size;
 	}
 	LOG_INF("Negotiated msize: %u", client->msize);
-
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
 	return 0;
 }
 
-int ninep_client_auth(struct ninep_client *client, uint32_t *afid,
-                      struct ninep_qid *aqid, const char *uname, const char *aname)
+/* Rstat.
+ * Wire format: header[7] nstat[2] stat[nstat]
+ * stat: size[2] type[2] dev[4] qid[13] mode[4] atime[4] mtime[4]
+ *       length[8] name[s] uid[s] gid[s] muid[s]
+ * Minimum stat size: 2+2+4+13+4+4+4+8 + 4×2(empty strings) = 49
+ */
+static int parse_rstat(const uint8_t *b, uint32_t rx_len, struct ninep_stat *stat)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
-	uint32_t allocated_afid;
+	if (!stat || rx_len < 9 + 2 + 41) {
+		return -EIO;
+	}
 
-	k_mutex_lock(&client->lock, K_FOREVER);
+	size_t off = 7;  /* skip header */
 
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
-	}
+	/* uint16_t nstat = b[off] | (b[off+1] << 8); */
+	off += 2;  /* skip nstat */
 
-	/* Allocate afid inline */
-	for (size_t i = 0; i < client->max_fids; i++) {
-		if (!client->fids[i].in_use) {
-			client->fids[i].in_use = true;
-			client->fids[i].fid = client->next_fid++;
-			allocated_afid = client->fids[i].fid;
-			*afid = allocated_afid;
-			goto afid_allocated;
-		}
-	}
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
-	return -ENOMEM;
+	/* uint16_t stat_size = b[off] | (b[off+1] << 8); */
+	off += 2;  /* skip stat size */
 
-afid_allocated:;
+	stat->type = b[off] | (b[off+1] << 8);
+	off += 2;
 
-	/* Build Tauth */
-	int len = ninep_build_tauth(entry->tx, client->buf_size,
-	                            tag, allocated_afid,
-	                            uname, strlen(uname),
-	                            aname, strlen(aname));
-	if (len < 0) {
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_afid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
-	}
+	stat->dev = get_le32(&b[off]);
+	off += 4;
 
-	/* Send and wait — auth is stateful (allocates afid), no retry */
-	int ret = send_and_wait(client, entry, len, 0);
-	if (ret < 0) {
-		LOG_ERR("Auth request failed: %d", ret);
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_afid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return ret;
-	}
+	/* Parse qid (13 bytes) */
+	ninep_parse_qid(b, rx_len, &off, &stat->qid);
 
-	/* Parse Rauth to get auth qid */
-	struct ninep_client_fid *cfid = find_fid_locked(client, allocated_afid);
-	if (cfid && entry->rx_len >= 20) {
-		size_t offset = 7;
-		ninep_parse_qid(entry->rx, entry->rx_len, &offset, &cfid->qid);
-		if (aqid) {
-			*aqid = cfid->qid;
-		}
-	}
+	stat->mode = get_le32(&b[off]);
+	off += 4;
+
+	stat->atime = get_le32(&b[off]);
+	off += 4;
+
+	stat->mtime = get_le32(&b[off]);
+	off += 4;
+
+	stat->length = (uint64_t)get_le32(&b[off]) |
+	               ((uint64_t)get_le32(&b[off + 4]) << 32);
+	off += 8;
+
+	/* Name/uid/gid/muid are variable-length strings — skip for now,
+	 * set pointers to NULL.  The stat struct fields that matter for
+	 * test -d / test -f are mode and length. */
+	stat->name = NULL;
+	stat->uid = NULL;
+	stat->gid = NULL;
+	stat->muid = NULL;
 
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
 	return 0;
 }
 
-int ninep_client_attach(struct ninep_client *client, uint32_t *fid,
-                        uint32_t afid, const char *uname, const char *aname)
+/*
+ * Parse a successful reply into req and the fid table.
+ * Returns the request's result.  Caller holds client->lock.
+ */
+static int parse_reply_locked(struct ninep_client *client,
+                              struct ninep_tag_entry *entry,
+                              struct ninep_client_req *req)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
-	uint32_t allocated_fid;
+	const uint8_t *rx = entry->rx;
+	uint32_t rx_len = entry->rx_len;
+	struct ninep_client_fid *cfid = find_fid_locked(client, req->fid);
+	size_t offset = 7;
+
+	switch (req->type) {
+	case NINEP_TVERSION:
+		return parse_rversion_locked(client, rx, rx_len);
+
+	case NINEP_TAUTH:
+	case NINEP_TATTACH:
+		/* Rauth/Rattach: the auth file's or root's qid */
+		if (rx_len >= 20) {
+			ninep_parse_qid(rx, rx_len, &offset, &req->qid);
+			if (cfid) {
+				cfid->qid = req->qid;
+			}
+		}
+		return 0;
+
+	case NINEP_TWALK: {
+		/* Rwalk. nwqid is how many elements the server actually walked.
+		 * If it falls short of nwname the walk stopped at a missing
+		 * element: per walk(5) the server did NOT establish newfid, so
+		 * we must drop the client-side fid and report failure rather
+		 * than believe we hold a fid for a path that doesn't fully
+		 * exist. (A clone, nwname==0, yields nwqid==0 and is a success.) */
+		if (rx_len < 9) {
+			return -EIO;
+		}
 
-	k_mutex_lock(&client->lock, K_FOREVER);
+		uint16_t nwqid = rx[7] | (rx[8] << 8);
 
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
+		if (nwqid < req->nwname) {
+			return -ENOENT;
+		}
+		if (nwqid > 0) {
+			offset = 9 + (nwqid - 1) * 13;
+			ninep_parse_qid(rx, rx_len, &offset, &req->qid);
+			if (cfid) {
+				cfid->qid = req->qid;
+			}
+		}
+		return 0;
 	}
 
-	/* Allocate FID inline */
-	for (size_t i = 0; i < client->max_fids; i++) {
-		if (!client->fids[i].in_use) {
-			client->fids[i].in_use = true;
-			client->fids[i].fid = client->next_fid++;
-			allocated_fid = client->fids[i].fid;
-			*fid = allocated_fid;
-			goto fid_allocated;
+	case NINEP_TOPEN:
+	case NINEP_TCREATE:
+		/* Ropen/Rcreate: qid and iounit */
+		if (rx_len >= 24) {
+			ninep_parse_qid(rx, rx_len, &offset, &req->qid);
+			req->iounit = get_le32(&rx[20]);
+			if (cfid) {
+				cfid->iounit = req->iounit;
+			}
 		}
-	}
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
-	return -ENOMEM;
+		return 0;
 
-fid_allocated:;
+	case NINEP_TREAD: {
+		/* Rread: copy data to caller's buffer */
+		if (rx_len < 11) {
+			return -EIO;
+		}
 
-	/* Build Tattach */
-	int len = ninep_build_tattach(entry->tx, client->buf_size,
-	                               tag, allocated_fid, afid,
-	                               uname, strlen(uname),
-	                               aname, strlen(aname));
-	if (len < 0) {
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
-	}
+		uint32_t data_count = get_le32(&rx[7]);
 
-	/* Send and wait — attach is stateful (allocates fid), no retry */
-	int ret = send_and_wait(client, entry, len, 0);
-	if (ret < 0) {
-		LOG_ERR("Attach request failed: %d", ret);
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return ret;
+		if (data_count > req->count) {
+			data_count = req->count;
+		}
+		if (!req->hold) {
+			memcpy(req->buf, &rx[11], data_count);
+		}
+		return data_count;
 	}
 
-	/* Parse Rattach to get root qid */
-	struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-	if (cfid && entry->rx_len >= 20) {
-		size_t offset = 7;
-		ninep_parse_qid(entry->rx, entry->rx_len, &offset, &cfid->qid);
-	}
+	case NINEP_TWRITE:
+		/* Rwrite */
+		if (rx_len < 11) {
+			return -EIO;
+		}
+		return get_le32(&rx[7]);
 
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
-	return 0;
+	case NINEP_TSTAT:
+		return parse_rstat(rx, rx_len, req->stat);
+
+	default:
+		return 0;
+	}
 }
 
-int ninep_client_walk(struct ninep_client *client, uint32_t fid,
-                      uint32_t *newfid, const char *path)
-{
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
-	uint32_t allocated_fid;
+/*
+ * 9P Protocol Operations
+ *
+ * Each *_async() call builds and sends one T-message and returns its tag;
+ * the reply completes the request later.  The blocking calls submit the
+ * same request and wait for it.
+ */
 
+int ninep_client_version_async(struct ninep_client *client,
+                               struct ninep_client_req *req)
+{
 	k_mutex_lock(&client->lock, K_FOREVER);
 
-	entry = alloc_tag_locked(client, &tag);
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TVERSION,
+	                                                 NINEP_NOFID);
 	if (!entry) {
 		k_mutex_unlock(&client->lock);
 		return -ENOMEM;
 	}
 
-	/* Allocate new FID */
-	for (size_t i = 0; i < client->max_fids; i++) {
-		if (!client->fids[i].in_use) {
-			client->fids[i].in_use = true;
-			client->fids[i].fid = client->next_fid++;
-			allocated_fid = client->fids[i].fid;
-			*newfid = allocated_fid;
-			goto fid_allocated;
-		}
-	}
-	free_tag_locked(client, tag);
+	/* Build Tversion */
+	int len = ninep_build_tversion(entry->tx, client->buf_size,
+	                                NINEP_NOTAG, client->config->max_message_size,
+	                                client->config->version,
+	                                strlen(client->config->version));
+
+	/* Override tag to NOTAG for version */
+	entry->tag = NINEP_NOTAG;
+
+	int ret = send_req_locked(client, req, len);
+
 	k_mutex_unlock(&client->lock);
-	return -ENOMEM;
+	return ret;
+}
+
+int ninep_client_version(struct ninep_client *client)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_version_async(client, &req);
+
+	/* Version is idempotent, safe to retry */
+	return run_blocking(client, &req, ret, client->max_retries, "Version");
+}
+
+int ninep_client_auth_async(struct ninep_client *client, const char *uname,
+                            const char *aname, struct ninep_client_req *req)
+{
+	uint32_t afid;
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	if (alloc_fid_locked(client, &afid) < 0) {
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TAUTH, afid);
+	if (!entry) {
+		free_fid_locked(client, afid);
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
+
+	/* Build Tauth */
+	int len = ninep_build_tauth(entry->tx, client->buf_size,
+	                            entry->tag, afid,
+	                            uname, strlen(uname),
+	                            aname, strlen(aname));
+	int ret = send_req_locked(client, req, len);
+
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
 
-fid_allocated:;
+int ninep_client_auth(struct ninep_client *client, uint32_t *afid,
+                      struct ninep_qid *aqid, const char *uname, const char *aname)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_auth_async(client, uname, aname, &req);
+
+	/* Auth is stateful (allocates afid), no retry */
+	ret = run_blocking(client, &req, ret, 0, "Auth");
+	if (ret < 0) {
+		return ret;
+	}
+
+	*afid = req.fid;
+	if (aqid) {
+		*aqid = req.qid;
+	}
+	return 0;
+}
+
+int ninep_client_attach_async(struct ninep_client *client, uint32_t afid,
+                              const char *uname, const char *aname,
+                              struct ninep_client_req *req)
+{
+	uint32_t fid;
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	if (alloc_fid_locked(client, &fid) < 0) {
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TATTACH, fid);
+	if (!entry) {
+		free_fid_locked(client, fid);
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
+
+	/* Build Tattach */
+	int len = ninep_build_tattach(entry->tx, client->buf_size,
+	                               entry->tag, fid, afid,
+	                               uname, strlen(uname),
+	                               aname, strlen(aname));
+	int ret = send_req_locked(client, req, len);
+
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
+
+int ninep_client_attach(struct ninep_client *client, uint32_t *fid,
+                        uint32_t afid, const char *uname, const char *aname)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_attach_async(client, afid, uname, aname, &req);
+
+	/* Attach is stateful (allocates fid), no retry */
+	ret = run_blocking(client, &req, ret, 0, "Attach");
+	if (ret < 0) {
+		return ret;
+	}
+
+	*fid = req.fid;
+	return 0;
+}
+
+int ninep_client_walk_async(struct ninep_client *client, uint32_t fid,
+                            const char *path, struct ninep_client_req *req)
+{
+	uint32_t newfid;
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	if (alloc_fid_locked(client, &newfid) < 0) {
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TWALK, newfid);
+	if (!entry) {
+		free_fid_locked(client, newfid);
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
 
 	/* Parse path into elements */
 	const char *wnames[NINEP_MAX_WELEM];
@@ -714,126 +1086,535 @@ fid_allocated:;
 		wname_lens[nwname] = p - start;
 		nwname++;
 	}
+	req->nwname = nwname;
+	req->walk_from = fid;
 
 	/* Build Twalk */
 	int len = ninep_build_twalk(entry->tx, client->buf_size,
-	                             tag, fid, allocated_fid, nwname, wnames, wname_lens);
-	if (len < 0) {
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
-	}
-
-	/* Send and wait — walk is stateful (allocates newfid), no retry */
-	int ret = send_and_wait(client, entry, len, 0);
-	if (ret == -ETIMEDOUT) {
-		LOG_ERR("Walk TIMEOUT: tag=%u fid=%u->%u nwname=%u first='%.*s'",
-		        entry->tag, fid, allocated_fid, nwname,
-		        nwname > 0 ? (int)wname_lens[0] : 0,
-		        nwname > 0 ? wnames[0] : "");
-		/* Free fid locally — server state is unknown but we can't
-		 * leak client-side fids on every timeout */
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return ret;
-	} else if (ret < 0) {
-		LOG_ERR("Walk request failed: %d", ret);
-		struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
+	                             entry->tag, fid, newfid, nwname, wnames,
+	                             wname_lens);
+	int ret = send_req_locked(client, req, len);
+
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
+
+static int walk_blocking(struct ninep_client *client, uint32_t fid,
+                         uint32_t *newfid, const char *path)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_walk_async(client, fid, path, &req);
+
+	/* Walk is stateful (allocates newfid), no retry.  On any failure,
+	 * including a timeout, the client-side newfid is freed — server state
+	 * is unknown but we can't leak client-side fids on every timeout. */
+	ret = run_blocking(client, &req, ret, 0, "Walk");
+	if (ret < 0) {
 		return ret;
 	}
 
-	/* Parse Rwalk. nwqid is how many elements the server actually walked.
-	 * If it falls short of nwname the walk stopped at a missing element:
-	 * per walk(5) the server did NOT establish newfid, so we must drop the
-	 * client-side fid and report failure rather than believe we hold a fid
-	 * for a path that doesn't fully exist. (A clone, nwname==0, yields
-	 * nwqid==0 and is a success.) */
-	struct ninep_client_fid *cfid = find_fid_locked(client, allocated_fid);
-	if (entry->rx_len < 9) {
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return -EIO;
+	*newfid = req.fid;
+	return 0;
+}
+
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+/*
+ * Path-to-fid cache
+ *
+ * Each entry keeps a fid walked from base to a normalized path and never
+ * opened.  A walk of the same path is answered with a zero-element Twalk
+ * clone of it.  Entries are only marked stale under the lock; their fids
+ * are clunked by path_cache_reap() once it is dropped.
+ */
+
+/* "a//./b/" -> "a/b"; -ENOTSUP if the path is not cached */
+static int normalize_path(const char *path, char *out, size_t size)
+{
+	const char *p = path;
+	size_t n = 0;
+
+	while (*p) {
+		while (*p == '/') {
+			p++;
+		}
+		if (!*p) {
+			break;
+		}
+
+		const char *start = p;
+
+		while (*p && *p != '/') {
+			p++;
+		}
+
+		size_t len = p - start;
+
+		if (len == 1 && start[0] == '.') {
+			continue;
+		}
+		/* Lexical ".." need not match what the server does with it */
+		if (len == 2 && start[0] == '.' && start[1] == '.') {
+			return -ENOTSUP;
+		}
+		if (n + (n > 0) + len + 1 > size) {
+			return -ENOTSUP;
+		}
+		if (n > 0) {
+			out[n++] = '/';
+		}
+		memcpy(&out[n], start, len);
+		n += len;
 	}
 
-	uint16_t nwqid = entry->rx[7] | (entry->rx[8] << 8);
-	if (nwqid < nwname) {
-		if (cfid) cfid->in_use = false;
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return -ENOENT;
+	/* No elements is a clone of the base fid; nothing to save */
+	if (n == 0) {
+		return -ENOTSUP;
+	}
+	out[n] = '\0';
+	return 0;
+}
+
+/* FNV-1a of base, then path */
+static uint32_t path_hash(uint32_t base, const char *path)
+{
+	uint32_t h = 2166136261u;
+
+	for (int i = 0; i < 4; i++) {
+		h ^= (base >> (8 * i)) & 0xff;
+		h *= 16777619u;
+	}
+	for (; *path; path++) {
+		h ^= (uint8_t)*path;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static struct ninep_client_path_entry *path_cache_find_locked(
+	struct ninep_client *client, uint32_t base, uint32_t hash, const char *path)
+{
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		struct ninep_client_path_entry *e = &client->path_cache[i];
+
+		if (e->in_use && !e->stale && e->hash == hash && e->base == base &&
+		    strcmp(e->path, path) == 0) {
+			return e;
+		}
 	}
+	return NULL;
+}
+
+/* Least recently used entry, stale ones first; NULL if there are none */
+static struct ninep_client_path_entry *path_cache_victim_locked(
+	struct ninep_client *client)
+{
+	struct ninep_client_path_entry *victim = NULL;
+
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		struct ninep_client_path_entry *e = &client->path_cache[i];
 
-	if (cfid && nwqid > 0) {
-		size_t offset = 9 + (nwqid - 1) * 13;
-		ninep_parse_qid(entry->rx, entry->rx_len, &offset, &cfid->qid);
+		if (!e->in_use) {
+			continue;
+		}
+		if (!victim || (e->stale && !victim->stale) ||
+		    (e->stale == victim->stale &&
+		     (int32_t)(e->last_use - victim->last_use) < 0)) {
+			victim = e;
+		}
 	}
+	return victim;
+}
+
+/* True if path is below (or is) prefix */
+static bool path_below(const char *prefix, const char *path)
+{
+	size_t n = strlen(prefix);
 
-	free_tag_locked(client, tag);
+	return strncmp(path, prefix, n) == 0 &&
+	       (path[n] == '\0' || path[n] == '/');
+}
+
+/*
+ * Drop e and every entry that depends on it: longer paths below it from
+ * the same base, and paths walked from a fid cloned out of it.  Entries
+ * only turn stale here, so a stale one has had its dependents dropped.
+ */
+static void path_cache_drop_locked(struct ninep_client *client,
+                                   struct ninep_client_path_entry *e)
+{
+	int idx = e - client->path_cache;
+
+	if (!e->in_use || e->stale) {
+		return;
+	}
+	e->stale = true;
+
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		struct ninep_client_path_entry *d = &client->path_cache[i];
+
+		if (!d->in_use || d->stale) {
+			continue;
+		}
+
+		struct ninep_client_fid *base = find_fid_locked(client, d->base);
+
+		if ((d->base == e->base && path_below(e->path, d->path)) ||
+		    (base && base->path_origin == idx + 1)) {
+			path_cache_drop_locked(client, d);
+		}
+	}
+}
+
+/* Drop the entries walked from a fid that is gone */
+static void path_cache_drop_base_locked(struct ninep_client *client,
+                                        uint32_t fid)
+{
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		if (client->path_cache[i].in_use &&
+		    client->path_cache[i].base == fid) {
+			path_cache_drop_locked(client, &client->path_cache[i]);
+		}
+	}
+}
+
+/* Drop the entry a fid was cloned from.  The slot may have been reused
+ * since, in which case an unrelated entry goes early; that costs a walk. */
+static void path_cache_drop_origin_locked(struct ninep_client *client,
+                                          uint32_t fid)
+{
+	struct ninep_client_fid *cfid = find_fid_locked(client, fid);
+
+	if (cfid && cfid->path_origin) {
+		struct ninep_client_path_entry *e =
+			&client->path_cache[cfid->path_origin - 1];
+
+		path_cache_drop_locked(client, e);
+		cfid->path_origin = 0;
+	}
+}
+
+/* Invalidate entries a completed request shows to be bad (lock held) */
+static void path_cache_note_locked(struct ninep_client *client,
+                                   struct ninep_client_req *req, int result)
+{
+	switch (req->type) {
+	case NINEP_TCLUNK:
+		/* Walked from a fid that is gone: never looked up again */
+		path_cache_drop_base_locked(client, req->fid);
+		break;
+	case NINEP_TREMOVE:
+		/* The file is gone, and so is the fid */
+		path_cache_drop_origin_locked(client, req->fid);
+		path_cache_drop_base_locked(client, req->fid);
+		break;
+	default:
+		/* An Rerror on a clone; a lost or cancelled reply says nothing */
+		if (result < 0 && result != -ETIMEDOUT && result != -ECANCELED) {
+			path_cache_drop_origin_locked(client,
+			                              req->type == NINEP_TWALK ?
+			                              req->walk_from : req->fid);
+		}
+		break;
+	}
+}
+
+/* Clunk the fids of stale entries and free the entries (lock not held) */
+static void path_cache_reap(struct ninep_client *client)
+{
+	uint32_t fids[CONFIG_NINEP_CLIENT_PATH_CACHE];
+	int n = 0;
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		struct ninep_client_path_entry *e = &client->path_cache[i];
+
+		if (e->in_use && e->stale) {
+			fids[n++] = e->fid;
+			e->in_use = false;
+		}
+	}
 	k_mutex_unlock(&client->lock);
-	return 0;
+
+	for (int i = 0; i < n; i++) {
+		(void)ninep_client_clunk(client, fids[i]);
+	}
 }
 
-int ninep_client_open(struct ninep_client *client, uint32_t fid, uint8_t mode)
+/*
+ * Clunk cached fids, least recently used first, until need fids are free.
+ * Returns false if the rest of the pool is held elsewhere.
+ */
+static bool path_cache_make_room(struct ninep_client *client, int need)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
+	int avail = 0;
 
 	k_mutex_lock(&client->lock, K_FOREVER);
+	for (size_t i = 0; i < client->max_fids; i++) {
+		avail += !client->fids[i].in_use;
+	}
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		avail += client->path_cache[i].in_use && client->path_cache[i].stale;
+	}
+	while (avail < need) {
+		struct ninep_client_path_entry *e = path_cache_victim_locked(client);
 
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
+		if (!e || e->stale) {
+			break;
+		}
+		e->stale = true;
+		client->path_cache_evictions++;
+		avail++;
 	}
+	k_mutex_unlock(&client->lock);
 
-	/* Build Topen */
-	int len = ninep_build_topen(entry->tx, client->buf_size,
-	                             tag, fid, mode);
-	if (len < 0) {
-		free_tag_locked(client, tag);
+	path_cache_reap(client);
+	return avail >= need;
+}
+
+/* Remember cached at path; returns a fid to clunk for the slot, or NOFID */
+static uint32_t path_cache_insert_locked(struct ninep_client *client,
+                                         uint32_t base, uint32_t hash,
+                                         const char *path, uint32_t cached,
+                                         uint32_t clone)
+{
+	struct ninep_client_path_entry *e = NULL;
+	uint32_t old = NINEP_NOFID;
+
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE && !e; i++) {
+		if (!client->path_cache[i].in_use) {
+			e = &client->path_cache[i];
+		}
+	}
+	if (!e) {
+		e = path_cache_victim_locked(client);
+		old = e->fid;
+		if (!e->stale) {
+			client->path_cache_evictions++;
+		}
+	}
+
+	e->base = base;
+	e->fid = cached;
+	e->hash = hash;
+	e->last_use = ++client->path_cache_clock;
+	e->in_use = true;
+	e->stale = false;
+	strcpy(e->path, path);
+
+	struct ninep_client_fid *cfid = find_fid_locked(client, clone);
+
+	if (cfid) {
+		cfid->path_origin = (e - client->path_cache) + 1;
+	}
+	return old;
+}
+
+/* Clone the cached fid for path; -ENOTSUP if the path is not cached */
+static int walk_cached(struct ninep_client *client, uint32_t fid,
+                       uint32_t *newfid, const char *path)
+{
+	char key[CONFIG_NINEP_CLIENT_PATH_CACHE_PATH_LEN];
+
+	if (normalize_path(path, key, sizeof(key)) < 0) {
+		return -ENOTSUP;
+	}
+
+	uint32_t hash = path_hash(fid, key);
+
+	(void)path_cache_make_room(client, 1);
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+	struct ninep_client_path_entry *e = path_cache_find_locked(client, fid,
+	                                                           hash, key);
+	if (e) {
+		uint32_t cached = e->fid;
+		int idx = e - client->path_cache;
+
+		e->last_use = ++client->path_cache_clock;
 		k_mutex_unlock(&client->lock);
-		return len;
+
+		int ret = walk_blocking(client, cached, newfid, "");
+
+		k_mutex_lock(&client->lock, K_FOREVER);
+		if (ret == 0) {
+			struct ninep_client_fid *cfid = find_fid_locked(client, *newfid);
+
+			if (cfid) {
+				cfid->path_origin = idx + 1;
+			}
+			client->path_cache_hits++;
+			k_mutex_unlock(&client->lock);
+			return 0;
+		}
+		if (ret == -ENOMEM || ret == -ETIMEDOUT) {
+			k_mutex_unlock(&client->lock);
+			return ret;
+		}
+
+		/* The cached fid went bad: drop it and walk afresh */
+		if (e->in_use && e->fid == cached) {
+			path_cache_drop_locked(client, e);
+		}
+	}
+	k_mutex_unlock(&client->lock);
+
+	/* Room for the fid to keep and the caller's clone, else walk plainly */
+	if (!path_cache_make_room(client, 2)) {
+		return walk_blocking(client, fid, newfid, key);
 	}
 
-	/* Send and wait — open is stateful (changes fid mode), no retry */
-	int ret = send_and_wait(client, entry, len, 0);
+	k_mutex_lock(&client->lock, K_FOREVER);
+	client->path_cache_misses++;
+
+	/* Miss: walk a fid to keep and clone it for the caller, back to back
+	 * only if the server will not run the clone before the walk */
+	struct ninep_client_req reqs[2];
+
+	ninep_client_req_init(&reqs[0], NULL, NULL);
+	ninep_client_req_init(&reqs[1], NULL, NULL);
+
+	int ret = ninep_client_walk_async(client, fid, key, &reqs[0]);
+
 	if (ret < 0) {
-		LOG_ERR("Open request failed: %d", ret);
-		free_tag_locked(client, tag);
 		k_mutex_unlock(&client->lock);
 		return ret;
 	}
 
-	/* Parse Ropen to get iounit */
-	struct ninep_client_fid *cfid = find_fid_locked(client, fid);
-	if (cfid && entry->rx_len >= 24) {
-		cfid->iounit = entry->rx[20] | (entry->rx[21] << 8) |
-		               (entry->rx[22] << 16) | (entry->rx[23] << 24);
+	uint32_t cached = reqs[0].fid;
+	bool burst = client->config->in_order;
+	int walked = burst ? 0 : wait_req_locked(client, &reqs[0], 0);
+	int cloned = walked < 0 ? walked :
+	             ninep_client_walk_async(client, cached, "", &reqs[1]);
+
+	if (burst) {
+		walked = wait_req_locked(client, &reqs[0], 0);
+	}
+	if (cloned >= 0) {
+		cloned = wait_req_locked(client, &reqs[1], 0);
 	}
 
-	free_tag_locked(client, tag);
+	uint32_t old = NINEP_NOFID;
+
+	if (walked == 0 && cloned == 0) {
+		old = path_cache_insert_locked(client, fid, hash, key, cached,
+		                               reqs[1].fid);
+	}
 	k_mutex_unlock(&client->lock);
+
+	if (old != NINEP_NOFID) {
+		(void)ninep_client_clunk(client, old);
+	}
+	if (walked < 0) {
+		/* A failed walk freed both fids */
+		return walked;
+	}
+	if (cloned < 0) {
+		(void)ninep_client_clunk(client, cached);
+		return cloned;
+	}
+
+	*newfid = reqs[1].fid;
 	return 0;
 }
+#endif /* CONFIG_NINEP_CLIENT_PATH_CACHE > 0 */
 
-int ninep_client_read(struct ninep_client *client, uint32_t fid,
-                      uint64_t offset, uint8_t *buf, uint32_t count)
+int ninep_client_walk(struct ninep_client *client, uint32_t fid,
+                      uint32_t *newfid, const char *path)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
-	int result;
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+	if (client->path_cache_enabled) {
+		int ret = walk_cached(client, fid, newfid, path);
+
+		if (ret != -ENOTSUP) {
+			return ret;
+		}
+	}
+#endif
+	return walk_blocking(client, fid, newfid, path);
+}
+
+int ninep_client_path_cache_enable(struct ninep_client *client, bool enable)
+{
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+	if (!client) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+	client->path_cache_enabled = enable;
+	k_mutex_unlock(&client->lock);
+
+	if (!enable) {
+		ninep_client_path_cache_flush(client);
+	}
+	return 0;
+#else
+	ARG_UNUSED(client);
+	ARG_UNUSED(enable);
+	return -ENOTSUP;
+#endif
+}
+
+void ninep_client_path_cache_flush(struct ninep_client *client)
+{
+#if CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+	if (!client) {
+		return;
+	}
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		client->path_cache[i].stale = true;
+	}
+	k_mutex_unlock(&client->lock);
+	path_cache_reap(client);
+#else
+	ARG_UNUSED(client);
+#endif
+}
+
+int ninep_client_open_async(struct ninep_client *client, uint32_t fid,
+                            uint8_t mode, struct ninep_client_req *req)
+{
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TOPEN, fid);
+	if (!entry) {
+		k_mutex_unlock(&client->lock);
+		return -ENOMEM;
+	}
+
+	/* Build Topen */
+	int len = ninep_build_topen(entry->tx, client->buf_size,
+	                             entry->tag, fid, mode);
+	int ret = send_req_locked(client, req, len);
+
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
+
+int ninep_client_open(struct ninep_client *client, uint32_t fid, uint8_t mode)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_open_async(client, fid, mode, &req);
+
+	/* Open is stateful (changes fid mode), no retry */
+	return run_blocking(client, &req, ret, 0, "Open");
+}
 
+int ninep_client_read_async(struct ninep_client *client, uint32_t fid,
+                            uint64_t offset, uint8_t *buf, uint32_t count,
+                            struct ninep_client_req *req)
+{
 	k_mutex_lock(&client->lock, K_FOREVER);
 
-	entry = alloc_tag_locked(client, &tag);
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TREAD, fid);
 	if (!entry) {
 		k_mutex_unlock(&client->lock);
 		return -ENOMEM;
@@ -848,55 +1629,38 @@ int ninep_client_read(struct ninep_client *client, uint32_t fid,
 	if (count > rmax) {
 		count = rmax;
 	}
+	req->buf = buf;
+	req->count = count;
 
 	/* Build Tread */
 	int len = ninep_build_tread(entry->tx, client->buf_size,
-	                             tag, fid, offset, count);
-	if (len < 0) {
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
-	}
-
-	/* Send and wait — read is idempotent, safe to retry */
-	int ret = send_and_wait(client, entry, len, client->max_retries);
-	if (ret < 0) {
-		LOG_ERR("Read request failed: %d", ret);
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return ret;
-	}
+	                             entry->tag, fid, offset, count);
+	int ret = send_req_locked(client, req, len);
 
-	/* Parse Rread and copy data to caller's buffer */
-	if (entry->rx_len >= 11) {
-		uint32_t data_count = entry->rx[7] | (entry->rx[8] << 8) |
-		                      (entry->rx[9] << 16) | (entry->rx[10] << 24);
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
 
-		if (data_count > count) {
-			data_count = count;
-		}
+int ninep_client_read(struct ninep_client *client, uint32_t fid,
+                      uint64_t offset, uint8_t *buf, uint32_t count)
+{
+	struct ninep_client_req req;
 
-		memcpy(buf, &entry->rx[11], data_count);
-		result = data_count;
-	} else {
-		result = -EIO;
-	}
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_read_async(client, fid, offset, buf, count, &req);
 
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
-	return result;
+	/* Read is idempotent, safe to retry */
+	return run_blocking(client, &req, ret, client->max_retries, "Read");
 }
 
-int ninep_client_write(struct ninep_client *client, uint32_t fid,
-                       uint64_t offset, const uint8_t *buf, uint32_t count)
+int ninep_client_write_async(struct ninep_client *client, uint32_t fid,
+                             uint64_t offset, const uint8_t *buf, uint32_t count,
+                             struct ninep_client_req *req)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
-	int result;
-
 	k_mutex_lock(&client->lock, K_FOREVER);
 
-	entry = alloc_tag_locked(client, &tag);
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TWRITE, fid);
 	if (!entry) {
 		k_mutex_unlock(&client->lock);
 		return -ENOMEM;
@@ -912,233 +1676,591 @@ int ninep_client_write(struct ninep_client *client, uint32_t fid,
 	if (count > wmax) {
 		count = wmax;
 	}
+	req->count = count;
 
 	/* Build Twrite */
 	int len = ninep_build_twrite(entry->tx, client->buf_size,
-	                              tag, fid, offset, count, buf);
-	if (len < 0) {
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
-	}
+	                              entry->tag, fid, offset, count, buf);
+	int ret = send_req_locked(client, req, len);
 
-	/* Send and wait with NO retry: Twrite is not idempotent in general. A
-	 * write to an append-only (DMAPPEND) file or a synthetic ctl/command
-	 * file ignores the offset, so a retransmit after a lost Rwrite would
-	 * duplicate the append or re-run the command. */
-	int ret = send_and_wait(client, entry, len, 0);
-	if (ret < 0) {
-		LOG_ERR("Write request failed: %d", ret);
-		free_tag_locked(client, tag);
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
+
+int ninep_client_write(struct ninep_client *client, uint32_t fid,
+                       uint64_t offset, const uint8_t *buf, uint32_t count)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_write_async(client, fid, offset, buf, count, &req);
+
+	/* NO retry: Twrite is not idempotent in general. A write to an
+	 * append-only (DMAPPEND) file or a synthetic ctl/command file ignores
+	 * the offset, so a retransmit after a lost Rwrite would duplicate the
+	 * append or re-run the command. */
+	return run_blocking(client, &req, ret, 0, "Write");
+}
+
+int ninep_client_stat_async(struct ninep_client *client, uint32_t fid,
+                            struct ninep_stat *stat, struct ninep_client_req *req)
+{
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TSTAT, fid);
+	if (!entry) {
 		k_mutex_unlock(&client->lock);
-		return ret;
+		return -ENOMEM;
 	}
+	req->stat = stat;
 
-	/* Parse Rwrite */
-	if (entry->rx_len >= 11) {
-		result = entry->rx[7] | (entry->rx[8] << 8) |
-		         (entry->rx[9] << 16) | (entry->rx[10] << 24);
-	} else {
-		result = -EIO;
-	}
+	/* Build Tstat */
+	int len = ninep_build_tstat(entry->tx, client->buf_size,
+	                             entry->tag, fid);
+	int ret = send_req_locked(client, req, len);
 
-	free_tag_locked(client, tag);
 	k_mutex_unlock(&client->lock);
-	return result;
+	return ret;
 }
 
 int ninep_client_stat(struct ninep_client *client, uint32_t fid,
                       struct ninep_stat *stat)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_stat_async(client, fid, stat, &req);
+
+	/* Stat is idempotent, safe to retry */
+	return run_blocking(client, &req, ret, client->max_retries, "Stat");
+}
 
+int ninep_client_create_async(struct ninep_client *client, uint32_t fid,
+                              const char *name, uint32_t perm, uint8_t mode,
+                              struct ninep_client_req *req)
+{
 	k_mutex_lock(&client->lock, K_FOREVER);
 
-	entry = alloc_tag_locked(client, &tag);
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TCREATE, fid);
 	if (!entry) {
 		k_mutex_unlock(&client->lock);
 		return -ENOMEM;
 	}
 
-	/* Build Tstat */
-	int len = ninep_build_tstat(entry->tx, client->buf_size,
-	                             tag, fid);
-	if (len < 0) {
-		free_tag_locked(client, tag);
+	/* Build Tcreate */
+	int len = ninep_build_tcreate(entry->tx, client->buf_size,
+	                               entry->tag, fid, name, strlen(name), perm,
+	                               mode);
+	int ret = send_req_locked(client, req, len);
+
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
+
+int ninep_client_create(struct ninep_client *client, uint32_t fid,
+                        const char *name, uint32_t perm, uint8_t mode)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_create_async(client, fid, name, perm, mode, &req);
+
+	/* Create is stateful, no retry */
+	return run_blocking(client, &req, ret, 0, "Create");
+}
+
+int ninep_client_remove_async(struct ninep_client *client, uint32_t fid,
+                              struct ninep_client_req *req)
+{
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TREMOVE, fid);
+	if (!entry) {
 		k_mutex_unlock(&client->lock);
-		return len;
+		return -ENOMEM;
 	}
 
-	/* Send and wait — stat is idempotent, safe to retry */
-	int ret = send_and_wait(client, entry, len, client->max_retries);
-	if (ret < 0) {
-		LOG_ERR("Stat request failed: %d", ret);
-		free_tag_locked(client, tag);
+	/* Build Tremove */
+	int len = ninep_build_tremove(entry->tx, client->buf_size,
+	                               entry->tag, fid);
+	int ret = send_req_locked(client, req, len);
+
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
+
+int ninep_client_remove(struct ninep_client *client, uint32_t fid)
+{
+	struct ninep_client_req req;
+
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_remove_async(client, fid, &req);
+
+	/* Remove is stateful, no retry; it consumes the fid even on error */
+	return run_blocking(client, &req, ret, 0, "Remove");
+}
+
+int ninep_client_clunk_async(struct ninep_client *client, uint32_t fid,
+                             struct ninep_client_req *req)
+{
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	struct ninep_tag_entry *entry = begin_req_locked(client, req,
+	                                                 NINEP_TCLUNK, fid);
+	if (!entry) {
 		k_mutex_unlock(&client->lock);
-		return ret;
+		return -ENOMEM;
 	}
 
-	/* Parse Rstat response.
-	 * Wire format: header[7] nstat[2] stat[nstat]
-	 * stat: size[2] type[2] dev[4] qid[13] mode[4] atime[4] mtime[4]
-	 *       length[8] name[s] uid[s] gid[s] muid[s]
-	 * Minimum stat size: 2+2+4+13+4+4+4+8 + 4×2(empty strings) = 49
-	 */
-	int result = -EIO;
-
-	if (stat && entry->rx_len >= 9 + 2 + 41) {
-		const uint8_t *b = entry->rx;
-		size_t off = 7;  /* skip header */
+	/* Build Tclunk */
+	int len = ninep_build_tclunk(entry->tx, client->buf_size,
+	                              entry->tag, fid);
+	int ret = send_req_locked(client, req, len);
 
-		/* uint16_t nstat = b[off] | (b[off+1] << 8); */
-		off += 2;  /* skip nstat */
+	k_mutex_unlock(&client->lock);
+	return ret;
+}
 
-		/* uint16_t stat_size = b[off] | (b[off+1] << 8); */
-		off += 2;  /* skip stat size */
+int ninep_client_clunk(struct ninep_client *client, uint32_t fid)
+{
+	struct ninep_client_req req;
 
-		stat->type = b[off] | (b[off+1] << 8);
-		off += 2;
+	ninep_client_req_init(&req, NULL, NULL);
+	int ret = ninep_client_clunk_async(client, fid, &req);
 
-		stat->dev = b[off] | (b[off+1] << 8) |
-		            (b[off+2] << 16) | (b[off+3] << 24);
-		off += 4;
+	/* Clunk is stateful, no retry; the fid is freed regardless of outcome */
+	return run_blocking(client, &req, ret, 0, "Clunk");
+}
 
-		/* Parse qid (13 bytes) */
-		ninep_parse_qid(b, entry->rx_len, &off, &stat->qid);
+/*
+ * Windowed transfers
+ *
+ * Keep up to a window of requests for consecutive chunks of a file in
+ * flight and retire them in offset order, so a bulk transfer pays about
+ * one round trip per window rather than one per chunk.
+ */
 
-		stat->mode = b[off] | (b[off+1] << 8) |
-		             (b[off+2] << 16) | (b[off+3] << 24);
-		off += 4;
+struct stream_slot {
+	struct ninep_client_req req;
+	uint64_t offset;
+	uint32_t count;
+};
 
-		stat->atime = b[off] | (b[off+1] << 8) |
-		              (b[off+2] << 16) | (b[off+3] << 24);
-		off += 4;
+/* Largest payload per request on fid: its iounit, else what fits msize */
+static uint32_t io_chunk_locked(struct ninep_client *client, uint32_t fid,
+                                uint32_t hdr_len)
+{
+	uint32_t max = client->buf_size > hdr_len ? client->buf_size - hdr_len : 0;
+	struct ninep_client_fid *cfid = find_fid_locked(client, fid);
 
-		stat->mtime = b[off] | (b[off+1] << 8) |
-		              (b[off+2] << 16) | (b[off+3] << 24);
-		off += 4;
+	if (client->msize > hdr_len && client->msize - hdr_len < max) {
+		max = client->msize - hdr_len;
+	}
+	if (cfid && cfid->iounit > 0 && cfid->iounit < max) {
+		max = cfid->iounit;
+	}
+	return max;
+}
 
-		stat->length = (uint64_t)(b[off] | (b[off+1] << 8) |
-		               (b[off+2] << 16) | (b[off+3] << 24)) |
-		               ((uint64_t)(b[off+4] | (b[off+5] << 8) |
-		               (b[off+6] << 16) | (b[off+7] << 24)) << 32);
-		off += 8;
+static unsigned int clamp_window(struct ninep_client *client, unsigned int window)
+{
+	window = MIN(window, CONFIG_NINEP_CLIENT_MAX_WINDOW);
 
-		/* Name/uid/gid/muid are variable-length strings — skip for now,
-		 * set pointers to NULL.  The stat struct fields that matter for
-		 * test -d / test -f are mode and length. */
-		stat->name = NULL;
-		stat->uid = NULL;
-		stat->gid = NULL;
-		stat->muid = NULL;
+	/* Leave a tag for the Tflush of a timed-out request */
+	if (client->max_tags > 1) {
+		window = MIN(window, client->max_tags - 1);
+	}
+	return window;
+}
 
-		result = 0;
+/* Give back the tag a held read kept for its data (lock held) */
+static void release_held_locked(struct ninep_client_req *req)
+{
+	if (req->entry) {
+		req->entry->in_use = false;
+		req->entry = NULL;
 	}
+}
 
-	free_tag_locked(client, tag);
-	k_mutex_unlock(&client->lock);
-	return result;
+/* Wait out the n requests from slots[head] on, discarding them (lock held) */
+static void drain_slots_locked(struct ninep_client *client,
+                               struct stream_slot *slots, unsigned int window,
+                               unsigned int head, unsigned int n)
+{
+	for (unsigned int i = 0; i < n; i++) {
+		struct stream_slot *s = &slots[(head + i) % window];
+
+		(void)wait_req_locked(client, &s->req, 0);
+		release_held_locked(&s->req);
+	}
 }
 
-int ninep_client_create(struct ninep_client *client, uint32_t fid,
-                        const char *name, uint32_t perm, uint8_t mode)
+int ninep_client_read_stream_sink(struct ninep_client *client, uint32_t fid,
+                                  uint64_t offset, uint32_t len,
+                                  ninep_client_sink_t sink, void *user_data,
+                                  unsigned int window)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
+	struct stream_slot slots[CONFIG_NINEP_CLIENT_MAX_WINDOW];
+	unsigned int head = 0;
+	unsigned int queued = 0;
+	int total = 0;
+	int ret = 0;
+
+	if (!client || !sink || window == 0) {
+		return -EINVAL;
+	}
 
 	k_mutex_lock(&client->lock, K_FOREVER);
 
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
-	}
+	window = clamp_window(client, window);
+	uint32_t chunk = io_chunk_locked(client, fid, 11);
+	uint64_t next = offset;
+	uint64_t end = offset + MIN(len, (uint32_t)INT_MAX);
 
-	/* Build Tcreate */
-	int len = ninep_build_tcreate(entry->tx, client->buf_size,
-	                               tag, fid, name, strlen(name), perm, mode);
-	if (len < 0) {
-		free_tag_locked(client, tag);
+	if (chunk == 0) {
 		k_mutex_unlock(&client->lock);
-		return len;
+		return -EINVAL;
 	}
 
-	/* Send and wait — create is stateful, no retry */
-	int ret = send_and_wait(client, entry, len, 0);
+	for (;;) {
+		/* Top up the window.  The lock is recursive, and a synchronous
+		 * transport may complete a read before it is counted here. */
+		while (queued < window && next < end) {
+			struct stream_slot *s = &slots[(head + queued) % window];
+
+			s->offset = next;
+			s->count = (uint32_t)MIN((uint64_t)chunk, end - next);
+			ninep_client_req_init(&s->req, NULL, NULL);
+			s->req.hold = true;
+
+			int sent = ninep_client_read_async(client, fid, next, NULL,
+			                                   s->count, &s->req);
+			if (sent < 0) {
+				/* Out of tags: go on with what is in flight */
+				if (queued == 0) {
+					ret = sent;
+				}
+				break;
+			}
+			next += s->count;
+			queued++;
+		}
+
+		if (ret < 0 || queued == 0) {
+			break;
+		}
+
+		/* Retire the lowest offset; later replies wait in their tags */
+		struct stream_slot *s = &slots[head];
+		int n = wait_req_locked(client, &s->req, client->max_retries);
+
+		if (n < 0) {
+			ret = n;
+			break;
+		}
+
+		if (n > 0) {
+			k_mutex_unlock(&client->lock);
+			ret = sink(&s->req.entry->rx[11], n, s->offset, user_data);
+			k_mutex_lock(&client->lock, K_FOREVER);
+		}
+		release_held_locked(&s->req);
+		head = (head + 1) % window;
+		queued--;
+
+		if (ret < 0) {
+			break;
+		}
+		total += n;
+
+		/* A short read is end of file; what was read past it is void */
+		if ((uint32_t)n < s->count) {
+			break;
+		}
+	}
 
-	free_tag_locked(client, tag);
+	drain_slots_locked(client, slots, window, head, queued);
 	k_mutex_unlock(&client->lock);
-	return ret;
+
+	if (ret < 0) {
+		LOG_ERR("Stream read at %llu failed: %d",
+		        (unsigned long long)offset + total, ret);
+		return ret;
+	}
+	return total;
 }
 
-int ninep_client_remove(struct ninep_client *client, uint32_t fid)
+struct stream_buf {
+	uint8_t *buf;
+	uint64_t base;
+};
+
+static int stream_buf_sink(const uint8_t *data, uint32_t len, uint64_t offset,
+                           void *user_data)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
+	struct stream_buf *sb = user_data;
 
-	k_mutex_lock(&client->lock, K_FOREVER);
+	memcpy(sb->buf + (offset - sb->base), data, len);
+	return 0;
+}
 
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
+int ninep_client_read_stream(struct ninep_client *client, uint32_t fid,
+                             uint64_t offset, uint8_t *buf, uint32_t len,
+                             unsigned int window)
+{
+	struct stream_buf sb = { .buf = buf, .base = offset };
+
+	if (!buf) {
+		return -EINVAL;
 	}
+	return ninep_client_read_stream_sink(client, fid, offset, len,
+	                                     stream_buf_sink, &sb, window);
+}
 
-	/* Build Tremove */
-	int len = ninep_build_tremove(entry->tx, client->buf_size,
-	                               tag, fid);
-	if (len < 0) {
-		free_tag_locked(client, tag);
+/* Send count bytes of data at s->offset as one Twrite (lock held) */
+static int stream_write_locked(struct ninep_client *client, uint32_t fid,
+                               struct stream_slot *s, const uint8_t *data,
+                               uint32_t count)
+{
+	ninep_client_req_init(&s->req, NULL, NULL);
+
+	int sent = ninep_client_write_async(client, fid, s->offset, data, count,
+	                                    &s->req);
+	if (sent >= 0) {
+		s->count = s->req.count;
+	}
+	return sent;
+}
+
+int ninep_client_write_stream(struct ninep_client *client, uint32_t fid,
+                              uint64_t offset, const uint8_t *buf, uint32_t len,
+                              unsigned int window)
+{
+	struct stream_slot slots[CONFIG_NINEP_CLIENT_MAX_WINDOW];
+	unsigned int head = 0;
+	unsigned int queued = 0;
+	uint64_t failed_at = offset;
+	int ret = 0;
+
+	if (!client || (!buf && len > 0) || window == 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&client->lock, K_FOREVER);
+
+	window = clamp_window(client, window);
+	len = MIN(len, (uint32_t)INT_MAX);
+	uint32_t chunk = io_chunk_locked(client, fid, 23);
+	uint64_t next = offset;
+	uint64_t end = offset + len;
+
+	if (chunk == 0) {
 		k_mutex_unlock(&client->lock);
-		return len;
+		return -EINVAL;
 	}
 
-	/* Send and wait — remove is stateful, no retry */
-	int ret = send_and_wait(client, entry, len, 0);
-	/* Free FID regardless — remove consumes the fid even on error */
-	{
-		struct ninep_client_fid *cfid = find_fid_locked(client, fid);
-		if (cfid) cfid->in_use = false;
+	for (;;) {
+		while (queued < window && next < end) {
+			struct stream_slot *s = &slots[(head + queued) % window];
+
+			s->offset = next;
+			int sent = stream_write_locked(client, fid, s,
+			                               buf + (next - offset),
+			                               (uint32_t)MIN((uint64_t)chunk,
+			                                             end - next));
+			if (sent < 0) {
+				if (queued == 0) {
+					ret = sent;
+					failed_at = next;
+				}
+				break;
+			}
+			next += s->count;
+			queued++;
+		}
+
+		if (ret < 0 || queued == 0) {
+			break;
+		}
+
+		/* Retire in offset order, so the error reported is always the
+		 * one at the lowest offset, whatever order replies came in. */
+		struct stream_slot *s = &slots[head];
+		int n = wait_req_locked(client, &s->req, 0);
+
+		if (n >= 0 && (n == 0 || (uint32_t)n > s->count)) {
+			n = -EIO;  /* No progress, or a bogus count */
+		}
+		if (n < 0) {
+			ret = n;
+			failed_at = s->offset;
+			break;
+		}
+
+		if ((uint32_t)n < s->count) {
+			/* Short write: send the tail again from the same slot */
+			uint32_t tail = s->count - n;
+
+			s->offset += n;
+			int sent = stream_write_locked(client, fid, s,
+			                               buf + (s->offset - offset),
+			                               tail);
+			if (sent < 0) {
+				head = (head + 1) % window;
+				queued--;
+				ret = sent;
+				failed_at = s->offset;
+				break;
+			}
+			continue;
+		}
+
+		head = (head + 1) % window;
+		queued--;
 	}
 
-	free_tag_locked(client, tag);
+	drain_slots_locked(client, slots, window, head, queued);
 	k_mutex_unlock(&client->lock);
-	return ret;
+
+	if (ret < 0) {
+		LOG_ERR("Stream write at %llu failed: %d",
+		        (unsigned long long)failed_at, ret);
+		/* Like write(2): report what landed before the first error */
+		return failed_at > offset ? (int)(failed_at - offset) : ret;
+	}
+	return len;
 }
 
-int ninep_client_clunk(struct ninep_client *client, uint32_t fid)
+/*
+ * Path operations
+ *
+ * Walk a fresh fid to a file, open it, read or write it and clunk it.  The
+ * client names the new fid, so on a server that runs requests in the order
+ * sent (config->in_order) the four go out back to back: if a link fails,
+ * the ones after it fail on the server too, and the clunk still releases
+ * whatever the walk established.  Any other server may run the open before
+ * the walk has made the fid, so there each link waits for the one before
+ * it and the chain stops at the first failure.
+ */
+
+enum {
+	CHAIN_WALK,
+	CHAIN_OPEN,
+	CHAIN_IO,
+	CHAIN_CLUNK,
+	CHAIN_LEN,
+};
+
+static int submit_chain_link(struct ninep_client *client,
+                             struct ninep_client_req *reqs, int link,
+                             uint32_t newfid, uint8_t mode, uint8_t *rbuf,
+                             const uint8_t *wbuf, uint32_t count)
 {
-	uint16_t tag;
-	struct ninep_tag_entry *entry;
+	struct ninep_client_req *req = &reqs[link];
+
+	switch (link) {
+	case CHAIN_OPEN:
+		return ninep_client_open_async(client, newfid, mode, req);
+	case CHAIN_IO:
+		if (rbuf) {
+			return ninep_client_read_async(client, newfid, 0, rbuf,
+			                               count, req);
+		}
+		return ninep_client_write_async(client, newfid, 0, wbuf, count, req);
+	default:
+		return ninep_client_clunk_async(client, newfid, req);
+	}
+}
+
+static int path_chain(struct ninep_client *client, uint32_t fid, const char *path,
+                      uint8_t mode, uint8_t *rbuf, const uint8_t *wbuf,
+                      uint32_t count)
+{
+	struct ninep_client_req reqs[CHAIN_LEN];
+	int waited = 0;  /* reqs[0..waited) have been waited for */
+	int sent = 0;
+	int ret;
+
+	for (int i = 0; i < CHAIN_LEN; i++) {
+		ninep_client_req_init(&reqs[i], NULL, NULL);
+	}
+
+	ret = ninep_client_walk_async(client, fid, path, &reqs[CHAIN_WALK]);
+	if (ret < 0) {
+		return ret;
+	}
+	sent = 1;
+
+	uint32_t newfid = reqs[CHAIN_WALK].fid;
+	bool burst = client->config->in_order;
 
 	k_mutex_lock(&client->lock, K_FOREVER);
 
-	entry = alloc_tag_locked(client, &tag);
-	if (!entry) {
-		k_mutex_unlock(&client->lock);
-		return -ENOMEM;
+	while (sent < CHAIN_LEN) {
+		if (!burst && waited < sent &&
+		    wait_req_locked(client, &reqs[waited++], 0) < 0) {
+			break;
+		}
+		ret = submit_chain_link(client, reqs, sent, newfid, mode, rbuf,
+		                        wbuf, count);
+		if (ret >= 0) {
+			sent++;
+		} else if (ret == -ENOMEM && waited < sent) {
+			/* Out of tags: let the oldest link finish first */
+			(void)wait_req_locked(client, &reqs[waited++], 0);
+		} else {
+			break;
+		}
 	}
 
-	/* Build Tclunk */
-	int len = ninep_build_tclunk(entry->tx, client->buf_size,
-	                              tag, fid);
-	if (len < 0) {
-		free_tag_locked(client, tag);
-		k_mutex_unlock(&client->lock);
-		return len;
+	while (waited < sent) {
+		(void)wait_req_locked(client, &reqs[waited++], 0);
 	}
 
-	/* Send and wait — clunk is stateful, no retry */
-	int ret = send_and_wait(client, entry, len, 0);
-	/* Free FID regardless of outcome — on timeout the server state is
-	 * unknown, but leaking client fids guarantees eventual exhaustion */
-	{
-		struct ninep_client_fid *cfid = find_fid_locked(client, fid);
-		if (cfid) cfid->in_use = false;
+	/* Report the first link that failed, in chain order */
+	int result = ret < 0 ? ret : 0;
+
+	for (int i = CHAIN_WALK; i < MIN(sent, CHAIN_CLUNK); i++) {
+		if (reqs[i].result < 0) {
+			result = reqs[i].result;
+			break;
+		}
 	}
 
-	free_tag_locked(client, tag);
+	/* The clunk never went out: release the walked fid on our own */
+	bool walked = reqs[CHAIN_WALK].result == 0;
+
 	k_mutex_unlock(&client->lock);
-	return ret;
+
+	if (sent <= CHAIN_CLUNK && walked &&
+	    ninep_client_clunk(client, newfid) < 0) {
+		LOG_WRN("Path op: clunk of fid %u failed", newfid);
+	}
+
+	if (result < 0) {
+		LOG_ERR("Path op on %s failed: %d", path, result);
+		return result;
+	}
+	return reqs[CHAIN_IO].result;
+}
+
+int ninep_client_read_path(struct ninep_client *client, uint32_t fid,
+                           const char *path, uint8_t *buf, uint32_t count)
+{
+	if (!client || !path || !buf) {
+		return -EINVAL;
+	}
+	return path_chain(client, fid, path, NINEP_OREAD, buf, NULL, count);
+}
+
+int ninep_client_write_path(struct ninep_client *client, uint32_t fid,
+                            const char *path, const uint8_t *buf, uint32_t count)
+{
+	if (!client || !path || (!buf && count > 0)) {
+		return -EINVAL;
+	}
+	return path_chain(client, fid, path, NINEP_OWRITE, NULL, buf, count);
 }
@@ -781,6 +781,30 @@ int ninep_build_rread(uint8_t *buf, size_t buf_len, uint16_t tag, uint32_t count
 	return msg_size;
 }
 
+int ninep_build_rread_hdr(uint8_t *buf, size_t buf_len, uint16_t tag,
+                          uint32_t count)
+{
+	size_t offset = 7;
+
+	if (!buf || buf_len < 11 || count > UINT32_MAX - 11) {
+		return -EINVAL;
+	}
+
+	struct ninep_msg_header hdr = {
+		.size = 11 + count,
+		.type = NINEP_RREAD,
+		.tag = tag,
+	};
+
+	int ret = ninep_write_header(buf, buf_len, &hdr);
+	if (ret < 0) {
+		return ret;
+	}
+
+	write_u32_le(buf, &offset, count);
+	return 11;
+}
+
 int ninep_build_rremove(uint8_t *buf, size_t buf_len, uint16_t tag)
 {
 	if (!buf || buf_len < 7) {
@@ -10,6 +10,7 @@
 #include <zephyr/fs/fs.h>
 #include <zephyr/logging/log.h>
 #include <errno.h>
+#include <limits.h>
 #include <string.h>
 
 LOG_MODULE_REGISTER(fs_9p, CONFIG_NINEP_LOG_LEVEL);
@@ -252,7 +253,10 @@ static ssize_t fs_9p_write(struct fs_file_t *filp, const void *buf, size_t count
 		return -EINVAL;
 	}
 
-	ret = ninep_client_write(ctx->client, fid, filp->offset, buf, count);
+	/* Large writes go out as a window of Twrites, not one per round trip */
+	ret = ninep_client_write_stream(ctx->client, fid, filp->offset, buf,
+	                                MIN(count, (size_t)INT_MAX),
+	                                CONFIG_NINEP_CLIENT_MAX_WINDOW);
 	if (ret < 0) {
 		LOG_ERR("Write failed: %d", (int)ret);
 		return ret;
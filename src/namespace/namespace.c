@@ -18,16 +18,24 @@ LOG_MODULE_REGISTER(namespace, CONFIG_NINEP_LOG_LEVEL);
  * Global State
  * ======================================================================== */
 
-/* Thread-local storage for current namespace */
-#if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
-__thread struct thread_namespace *current_ns = NULL;
-#else
-/* Hash table for thread ID -> namespace mapping */
+/* Thread ID -> namespace mapping, kept by ns_create/ns_fork/ns_destroy.
+ * Writers hold ns_thread_map_lock; lookups scan it without the lock.
+ */
 static struct {
-	k_tid_t tid;
-	struct thread_namespace *ns;
+	atomic_ptr_t tid;  /* k_tid_t, published after ns */
+	atomic_ptr_t ns;   /* struct thread_namespace * */
 } ns_thread_map[CONFIG_NS_MAX_MOUNTS_PER_THREAD];
 static struct k_mutex ns_thread_map_lock;
+
+/* Changes on every map update; older cached lookups are stale */
+static atomic_t ns_thread_map_gen;
+
+#if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
+/* Thread-local cache of the current namespace */
+static __thread struct {
+	struct thread_namespace *ns;
+	atomic_val_t gen;
+} current_ns;
 #endif
 
 /* Global namespace initialization flag */
@@ -100,44 +108,253 @@ static int path_normalize(const char *path, char *normalized, size_t norm_len)
 	return 0;
 }
 
+/* ========================================================================
+ * Mount Tree
+ *
+ * Mounts live in a tree with one node per path component; a node's union
+ * stack lists what is mounted there, highest priority first. Writers hold
+ * ns->lock. Lookups take no lock: children are only ever prepended, and a
+ * union stack is never modified once published - a mount or unmount
+ * publishes a new one - so every pointer a lookup loads leads to
+ * something complete. Stacks and entries taken out of the tree are
+ * retired, and freed by the first writer to find no lookup in progress
+ * in any namespace (ns_readers), or with the namespace.
+ * ======================================================================== */
+
+/* Lookups in progress, in all namespaces */
+static atomic_t ns_readers;
+
+/**
+ * @brief Next component of a normalized path
+ *
+ * @return Length of the component at *name, 0 at the end of the path
+ */
+static size_t next_component(const char **p, const char **name)
+{
+	const char *s = *p;
+
+	while (*s == '/') {
+		s++;
+	}
+	*name = s;
+	while (*s != '\0' && *s != '/') {
+		s++;
+	}
+	*p = s;
+	return s - *name;
+}
+
+static struct ns_tree_node *tree_node_alloc(struct ns_tree_node *parent,
+                                            const char *name, size_t len)
+{
+	struct ns_tree_node *node = k_malloc(sizeof(*node) + len + 1);
+
+	if (!node) {
+		return NULL;
+	}
+	memset(node, 0, sizeof(*node));
+	node->parent = parent;
+	node->name_len = len;
+	memcpy(node->name, name, len);
+	node->name[len] = '\0';
+	return node;
+}
+
+static struct ns_tree_node *tree_child(const struct ns_tree_node *dir,
+                                       const char *name, size_t len)
+{
+	struct ns_tree_node *c = atomic_ptr_get(&dir->children);
+
+	while (c && (c->name_len != len || memcmp(c->name, name, len) != 0)) {
+		c = c->next;
+	}
+	return c;
+}
+
+/**
+ * @brief Find the node for a normalized path
+ *
+ * With create set, missing nodes are added (lock held).
+ */
+static struct ns_tree_node *tree_lookup(struct ns_tree_node *root,
+                                        const char *path, bool create)
+{
+	struct ns_tree_node *node = root;
+	const char *name;
+	size_t len;
+
+	while (node && (len = next_component(&path, &name)) > 0) {
+		struct ns_tree_node *c = tree_child(node, name, len);
+
+		if (!c && create) {
+			c = tree_node_alloc(node, name, len);
+			if (c) {
+				c->next = atomic_ptr_get(&node->children);
+				atomic_ptr_set(&node->children, c);
+			}
+		}
+		node = c;
+	}
+	return node;
+}
+
+/**
+ * @brief Next node in a depth-first walk of the tree under root
+ */
+static struct ns_tree_node *tree_next(struct ns_tree_node *root,
+                                      struct ns_tree_node *node)
+{
+	struct ns_tree_node *c = atomic_ptr_get(&node->children);
+
+	if (c) {
+		return c;
+	}
+	while (node != root && !node->next) {
+		node = node->parent;
+	}
+	return node == root ? NULL : node->next;
+}
+
+static struct ns_union *stack_alloc(int count)
+{
+	struct ns_union *stack = k_malloc(sizeof(*stack) +
+	                                  count * sizeof(stack->entries[0]));
+
+	if (stack) {
+		stack->count = count;
+		stack->retired_next = NULL;
+	}
+	return stack;
+}
+
+/**
+ * @brief Replace the union stack at node, retiring the old one (lock held)
+ */
+static void stack_publish(struct thread_namespace *ns, struct ns_tree_node *node,
+                          struct ns_union *stack)
+{
+	struct ns_union *old = atomic_ptr_set(&node->stack, stack);
+
+	if (old) {
+		old->retired_next = ns->retired_stacks;
+		ns->retired_stacks = old;
+	}
+}
+
+/**
+ * @brief Retire an entry taken out of the tree (lock held)
+ */
+static void entry_retire(struct thread_namespace *ns, struct ns_entry *entry)
+{
+	if (entry->type == NS_ENTRY_VFS) {
+		fs_unmount(entry->vfs_mount);
+	}
+	entry->next = ns->retired_entries;
+	ns->retired_entries = entry;
+}
+
+static void ns_free(struct thread_namespace *ns);
+static void ns_put(struct thread_namespace *ns);
+
+/**
+ * @brief Free what ns has retired
+ */
+static void ns_free_retired(struct thread_namespace *ns)
+{
+	while (ns->retired_stacks) {
+		struct ns_union *next = ns->retired_stacks->retired_next;
+
+		k_free(ns->retired_stacks);
+		ns->retired_stacks = next;
+	}
+	while (ns->retired_entries) {
+		struct ns_entry *next = ns->retired_entries->next;
+
+		k_free(ns->retired_entries);
+		ns->retired_entries = next;
+	}
+	ns_put(ns->retired_parent);
+	ns->retired_parent = NULL;
+}
+
+/**
+ * @brief Free what ns has retired, unless a lookup is in progress
+ *
+ * Lock held. Anything retired stays until a later call finds no lookup.
+ */
+static void ns_reclaim(struct thread_namespace *ns)
+{
+	if (atomic_get(&ns_readers) == 0) {
+		ns_free_retired(ns);
+	}
+}
+
 /**
- * @brief Check if path has prefix
+ * @brief Add an entry at its path, placed as flags say (lock held)
  */
-static bool path_has_prefix(const char *path, const char *prefix)
+static int tree_add(struct thread_namespace *ns, struct ns_entry *entry,
+                    uint32_t flags)
 {
-	size_t plen = strlen(prefix);
+	struct ns_tree_node *node = tree_lookup(ns->root, entry->path, true);
 
-	/* Root prefix matches everything */
-	if (plen == 1 && prefix[0] == '/') {
-		return true;
+	if (!node) {
+		return -ENOMEM;
 	}
 
-	/* Check prefix match */
-	if (strncmp(path, prefix, plen) != 0) {
-		return false;
+	struct ns_union *old = atomic_ptr_get(&node->stack);
+	int n = old ? old->count : 0;
+	struct ns_union *stack = stack_alloc((flags & NS_FLAG_REPLACE) ? 1 : n + 1);
+
+	if (!stack) {
+		return -ENOMEM;
 	}
 
-	/* Ensure it's a full path component match */
-	if (path[plen] != '\0' && path[plen] != '/') {
-		return false;
+	if (flags & NS_FLAG_REPLACE) {
+		/* Replace existing entries */
+		stack->entries[0] = entry;
+		for (int i = 0; i < n; i++) {
+			entry_retire(ns, old->entries[i]);
+		}
+	} else if (flags & NS_FLAG_BEFORE) {
+		/* Insert at beginning */
+		stack->entries[0] = entry;
+		for (int i = 0; i < n; i++) {
+			stack->entries[i + 1] = old->entries[i];
+		}
+		entry->priority = 0;
+	} else {  /* NS_FLAG_AFTER or default */
+		/* Append to end */
+		for (int i = 0; i < n; i++) {
+			stack->entries[i] = old->entries[i];
+		}
+		stack->entries[n] = entry;
+		entry->priority = n ? old->entries[n - 1]->priority + 1 : 0;
 	}
 
-	return true;
+	stack_publish(ns, node, stack);
+	return 0;
 }
 
 /**
- * @brief Hash function for namespace entries
+ * @brief Start a lookup in ns
+ *
+ * @return The namespace whose tree to read: ns, or for a copy-on-write
+ *         namespace the one it still shares. Pair with ns_read_end().
  */
-static uint32_t ns_hash(const char *path)
+static struct thread_namespace *ns_read_begin(struct thread_namespace *ns)
 {
-	uint32_t hash = 5381;
-	int c;
+	struct thread_namespace *view;
 
-	while ((c = *path++)) {
-		hash = ((hash << 5) + hash) + c;
+	atomic_inc(&ns_readers);
+	while ((view = atomic_ptr_get(&ns->view)) != ns) {
+		ns = view;
 	}
+	return ns;
+}
 
-	return hash % CONFIG_NS_HASH_SIZE;
+static void ns_read_end(void)
+{
+	atomic_dec(&ns_readers);
 }
 
 /* ========================================================================
@@ -150,10 +367,8 @@ int ns_init(void)
 		return 0;
 	}
 
-#if !defined(CONFIG_NS_THREAD_LOCAL_STORAGE) || !defined(CONFIG_THREAD_LOCAL_STORAGE)
 	k_mutex_init(&ns_thread_map_lock);
 	memset(ns_thread_map, 0, sizeof(ns_thread_map));
-#endif
 
 	/* TODO: Initialize 9P VFS driver for network mounts
 	 * This would register a VFS driver that allows mounting remote
@@ -184,8 +399,14 @@ static struct thread_namespace *ns_alloc(void)
 	}
 
 	memset(ns, 0, sizeof(*ns));
+	ns->root = tree_node_alloc(NULL, "", 0);
+	if (!ns->root) {
+		k_free(ns);
+		return NULL;
+	}
 	k_mutex_init(&ns->lock);
 	atomic_set(&ns->refcount, 1);
+	atomic_ptr_set(&ns->view, ns);
 
 	return ns;
 }
@@ -199,19 +420,109 @@ static void ns_free(struct thread_namespace *ns)
 		return;
 	}
 
-	/* Free all namespace entries */
-	for (int i = 0; i < CONFIG_NS_HASH_SIZE; i++) {
-		struct ns_entry *entry = ns->entries[i];
-		while (entry) {
-			struct ns_entry *next = entry->next;
-			k_free(entry);
-			entry = next;
+	/* Free the tree bottom up, with each node's stack and entries */
+	struct ns_tree_node *node = ns->root;
+
+	while (node) {
+		struct ns_tree_node *child = atomic_ptr_get(&node->children);
+
+		if (child) {
+			atomic_ptr_set(&node->children, NULL);
+			node = child;
+			continue;
+		}
+
+		struct ns_tree_node *next = node->next ? node->next : node->parent;
+		struct ns_union *stack = atomic_ptr_get(&node->stack);
+
+		for (int i = 0; stack && i < stack->count; i++) {
+			k_free(stack->entries[i]);
 		}
+		k_free(stack);
+		k_free(node);
+		node = next;
 	}
 
+	ns_free_retired(ns);
+
 	k_free(ns);
 }
 
+/**
+ * @brief Set the namespace mapped to tid; NULL removes the mapping
+ *
+ * @return The namespace previously mapped, or NULL. *err is -ENOMEM when
+ *         the map is full.
+ */
+static struct thread_namespace *ns_map_set(k_tid_t tid,
+                                           struct thread_namespace *ns,
+                                           int *err)
+{
+	struct thread_namespace *old = NULL;
+	int slot = -1;
+
+	*err = 0;
+	k_mutex_lock(&ns_thread_map_lock, K_FOREVER);
+
+	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
+		k_tid_t t = atomic_ptr_get(&ns_thread_map[i].tid);
+
+		if (t == tid) {
+			slot = i;
+			break;
+		}
+		if (t == NULL && slot < 0) {
+			slot = i;
+		}
+	}
+
+	if (slot < 0) {
+		*err = ns ? -ENOMEM : 0;
+	} else if (atomic_ptr_get(&ns_thread_map[slot].tid) == tid) {
+		old = atomic_ptr_get(&ns_thread_map[slot].ns);
+		if (ns) {
+			atomic_ptr_set(&ns_thread_map[slot].ns, ns);
+		} else {
+			atomic_ptr_set(&ns_thread_map[slot].tid, NULL);
+			atomic_ptr_set(&ns_thread_map[slot].ns, NULL);
+		}
+		atomic_inc(&ns_thread_map_gen);
+	} else if (ns) {
+		atomic_ptr_set(&ns_thread_map[slot].ns, ns);
+		atomic_ptr_set(&ns_thread_map[slot].tid, tid);
+		atomic_inc(&ns_thread_map_gen);
+	}
+
+	k_mutex_unlock(&ns_thread_map_lock);
+	return old;
+}
+
+/**
+ * @brief Namespace mapped to tid, found without the map lock
+ */
+static struct thread_namespace *ns_map_get(k_tid_t tid)
+{
+	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
+		if (atomic_ptr_get(&ns_thread_map[i].tid) == tid) {
+			return atomic_ptr_get(&ns_thread_map[i].ns);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Drop a reference to ns, and to its COW parent with the last one
+ */
+static void ns_put(struct thread_namespace *ns)
+{
+	while (ns && atomic_dec(&ns->refcount) == 1) {
+		struct thread_namespace *parent = ns->parent;
+
+		ns_free(ns);
+		ns = parent;
+	}
+}
+
 int ns_create(struct thread_namespace *parent)
 {
 	struct thread_namespace *ns;
@@ -226,6 +537,7 @@ int ns_create(struct thread_namespace *parent)
 		ns->parent = parent;
 		ns->is_cow = true;
 		atomic_inc(&parent->refcount);
+		atomic_ptr_set(&ns->view, parent);
 	} else {
 		/* Create fresh namespace */
 		ns = ns_alloc();
@@ -237,19 +549,12 @@ int ns_create(struct thread_namespace *parent)
 	ns->thread_id = k_current_get();
 
 	/* Set as current namespace */
-#if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
-	current_ns = ns;
-#else
-	k_mutex_lock(&ns_thread_map_lock, K_FOREVER);
-	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
-		if (ns_thread_map[i].tid == NULL) {
-			ns_thread_map[i].tid = ns->thread_id;
-			ns_thread_map[i].ns = ns;
-			break;
-		}
+	int ret = ns_set_current(ns);
+
+	if (ret < 0) {
+		ns_put(ns);
+		return ret;
 	}
-	k_mutex_unlock(&ns_thread_map_lock);
-#endif
 
 	LOG_DBG("Created namespace for thread %p (parent=%p)", ns->thread_id, parent);
 	return 0;
@@ -271,22 +576,16 @@ int ns_fork(k_tid_t child_tid)
 	child->parent = parent;
 	child->is_cow = true;
 	atomic_inc(&parent->refcount);
+	atomic_ptr_set(&child->view, parent);
 
-	/* Store child namespace */
-#if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
-	/* TLS is per-thread, child will have its own */
-	/* We'll set it when the child thread starts */
-#else
-	k_mutex_lock(&ns_thread_map_lock, K_FOREVER);
-	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
-		if (ns_thread_map[i].tid == NULL) {
-			ns_thread_map[i].tid = child_tid;
-			ns_thread_map[i].ns = child;
-			break;
-		}
+	/* Store child namespace; the child finds it on its first lookup */
+	int ret;
+
+	ns_map_set(child_tid, child, &ret);
+	if (ret < 0) {
+		ns_put(child);
+		return ret;
 	}
-	k_mutex_unlock(&ns_thread_map_lock);
-#endif
 
 	LOG_DBG("Forked namespace for child thread %p", child_tid);
 	return 0;
@@ -294,38 +593,15 @@ int ns_fork(k_tid_t child_tid)
 
 int ns_destroy(k_tid_t tid)
 {
-	struct thread_namespace *ns = NULL;
-
-#if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
-	if (tid == k_current_get()) {
-		ns = current_ns;
-		current_ns = NULL;
-	}
-#else
-	k_mutex_lock(&ns_thread_map_lock, K_FOREVER);
-	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
-		if (ns_thread_map[i].tid == tid) {
-			ns = ns_thread_map[i].ns;
-			ns_thread_map[i].tid = NULL;
-			ns_thread_map[i].ns = NULL;
-			break;
-		}
-	}
-	k_mutex_unlock(&ns_thread_map_lock);
-#endif
+	int ret;
+	struct thread_namespace *ns = ns_map_set(tid, NULL, &ret);
 
 	if (!ns) {
 		return -ENOENT;
 	}
 
-	/* Decrement refcount */
-	if (atomic_dec(&ns->refcount) == 1) {
-		/* Last reference, free namespace */
-		if (ns->parent) {
-			ns_destroy((k_tid_t)ns->parent->thread_id);
-		}
-		ns_free(ns);
-	}
+	/* Drop the thread's reference; the parent's only goes with the last */
+	ns_put(ns);
 
 	LOG_DBG("Destroyed namespace for thread %p", tid);
 	return 0;
@@ -335,8 +611,57 @@ int ns_destroy(k_tid_t tid)
  * Namespace Manipulation
  * ======================================================================== */
 
+/**
+ * @brief Free the stacks copied into ns before it was published (lock held)
+ */
+static void ns_drop_copies(struct thread_namespace *ns)
+{
+	for (struct ns_tree_node *node = ns->root; node;
+	     node = tree_next(ns->root, node)) {
+		struct ns_union *stack = atomic_ptr_set(&node->stack, NULL);
+
+		for (int i = 0; stack && i < stack->count; i++) {
+			k_free(stack->entries[i]);
+		}
+		k_free(stack);
+	}
+}
+
+/**
+ * @brief Copy a union stack of the parent into ns (lock held)
+ */
+static int ns_copy_stack(struct thread_namespace *ns, const struct ns_union *stack)
+{
+	struct ns_tree_node *dst = tree_lookup(ns->root, stack->entries[0]->path,
+	                                       true);
+	struct ns_union *copy = dst ? stack_alloc(stack->count) : NULL;
+
+	if (!copy) {
+		return -ENOMEM;
+	}
+
+	for (int i = 0; i < stack->count; i++) {
+		copy->entries[i] = k_malloc(sizeof(*copy->entries[i]));
+		if (!copy->entries[i]) {
+			while (i-- > 0) {
+				k_free(copy->entries[i]);
+			}
+			k_free(copy);
+			return -ENOMEM;
+		}
+		memcpy(copy->entries[i], stack->entries[i], sizeof(*copy->entries[i]));
+		copy->entries[i]->next = NULL;
+	}
+
+	atomic_ptr_set(&dst->stack, copy);
+	return 0;
+}
+
 /**
  * @brief Ensure namespace is writable (break COW if needed)
+ *
+ * Lookups keep reading the parent's tree until the copy is complete and
+ * published; the parent reference is dropped once they are done with it.
  */
 static int ns_make_writable(struct thread_namespace *ns)
 {
@@ -346,33 +671,40 @@ static int ns_make_writable(struct thread_namespace *ns)
 
 	k_mutex_lock(&ns->lock, K_FOREVER);
 
+	if (!ns->is_cow) {
+		k_mutex_unlock(&ns->lock);
+		return 0;
+	}
+
 	/* Copy parent's entries */
 	if (ns->parent) {
-		for (int i = 0; i < CONFIG_NS_HASH_SIZE; i++) {
-			struct ns_entry *e = ns->parent->entries[i];
-			while (e) {
-				struct ns_entry *copy = k_malloc(sizeof(*copy));
-				if (!copy) {
-					k_mutex_unlock(&ns->lock);
-					return -ENOMEM;
-				}
+		struct thread_namespace *src = ns_read_begin(ns->parent);
+		int ret = 0;
 
-				memcpy(copy, e, sizeof(*copy));
-				copy->next = ns->entries[i];
-				ns->entries[i] = copy;
+		for (struct ns_tree_node *node = src->root; node && ret == 0;
+		     node = tree_next(src->root, node)) {
+			struct ns_union *stack = atomic_ptr_get(&node->stack);
 
-				e = e->next;
+			if (stack && stack->count > 0) {
+				ret = ns_copy_stack(ns, stack);
 			}
 		}
+		ns_read_end();
 
-		/* Drop parent reference */
-		if (atomic_dec(&ns->parent->refcount) == 1) {
-			ns_free(ns->parent);
+		if (ret < 0) {
+			ns_drop_copies(ns);
+			k_mutex_unlock(&ns->lock);
+			return ret;
 		}
+
+		/* Drop parent reference once no lookup can be reading it */
+		ns->retired_parent = ns->parent;
 		ns->parent = NULL;
 	}
 
+	atomic_ptr_set(&ns->view, ns);
 	ns->is_cow = false;
+	ns_reclaim(ns);
 	k_mutex_unlock(&ns->lock);
 
 	return 0;
@@ -437,40 +769,16 @@ int ns_mount(struct fs_mount_t *vfs_mount, const char *mnt_point, uint32_t flags
 
 	/* Add to namespace */
 	k_mutex_lock(&ns->lock, K_FOREVER);
+	ret = tree_add(ns, entry, flags);
+	ns_reclaim(ns);
+	k_mutex_unlock(&ns->lock);
 
-	uint32_t hash = ns_hash(norm_path);
-
-	if (flags & NS_FLAG_REPLACE) {
-		/* Replace existing entries */
-		struct ns_entry *old = ns->entries[hash];
-		ns->entries[hash] = entry;
-		entry->next = NULL;
-
-		/* Free old entries */
-		while (old) {
-			struct ns_entry *next = old->next;
-			k_free(old);
-			old = next;
-		}
-	} else if (flags & NS_FLAG_BEFORE) {
-		/* Insert at beginning */
-		entry->next = ns->entries[hash];
-		ns->entries[hash] = entry;
-		entry->priority = 0;
-	} else {  /* NS_FLAG_AFTER or default */
-		/* Append to end */
-		struct ns_entry **tail = &ns->entries[hash];
-		int priority = 0;
-		while (*tail) {
-			priority = (*tail)->priority + 1;
-			tail = &(*tail)->next;
-		}
-		*tail = entry;
-		entry->priority = priority;
+	if (ret < 0) {
+		k_free(entry);
+		fs_unmount(vfs_mount);
+		return ret;
 	}
 
-	k_mutex_unlock(&ns->lock);
-
 	LOG_INF("Mounted %s at %s (flags=0x%x)", vfs_mount->mnt_point, norm_path, flags);
 	return 0;
 }
@@ -514,36 +822,15 @@ int ns_mount_server(struct ninep_server *server, const char *mnt_point,
 
 	/* Add to namespace (same logic as ns_mount) */
 	k_mutex_lock(&ns->lock, K_FOREVER);
+	ret = tree_add(ns, entry, flags);
+	ns_reclaim(ns);
+	k_mutex_unlock(&ns->lock);
 
-	uint32_t hash = ns_hash(norm_path);
-
-	if (flags & NS_FLAG_REPLACE) {
-		struct ns_entry *old = ns->entries[hash];
-		ns->entries[hash] = entry;
-		entry->next = NULL;
-
-		while (old) {
-			struct ns_entry *next = old->next;
-			k_free(old);
-			old = next;
-		}
-	} else if (flags & NS_FLAG_BEFORE) {
-		entry->next = ns->entries[hash];
-		ns->entries[hash] = entry;
-		entry->priority = 0;
-	} else {
-		struct ns_entry **tail = &ns->entries[hash];
-		int priority = 0;
-		while (*tail) {
-			priority = (*tail)->priority + 1;
-			tail = &(*tail)->next;
-		}
-		*tail = entry;
-		entry->priority = priority;
+	if (ret < 0) {
+		k_free(entry);
+		return ret;
 	}
 
-	k_mutex_unlock(&ns->lock);
-
 	LOG_INF("Mounted in-process server at %s", norm_path);
 	return 0;
 }
@@ -577,29 +864,35 @@ int ns_unmount(const char *mnt_point, const char *old_path)
 
 	k_mutex_lock(&ns->lock, K_FOREVER);
 
-	uint32_t hash = ns_hash(norm_path);
-	struct ns_entry **entry_ptr = &ns->entries[hash];
+	struct ns_tree_node *node = tree_lookup(ns->root, norm_path, false);
+	struct ns_union *old = node ? atomic_ptr_get(&node->stack) : NULL;
 
-	while (*entry_ptr) {
-		if (strcmp((*entry_ptr)->path, norm_path) == 0) {
-			struct ns_entry *to_remove = *entry_ptr;
-			*entry_ptr = to_remove->next;
+	if (!old || old->count == 0) {
+		k_mutex_unlock(&ns->lock);
+		return -ENOENT;
+	}
 
-			/* Unmount from VFS if needed */
-			if (to_remove->type == NS_ENTRY_VFS) {
-				fs_unmount(to_remove->vfs_mount);
-			}
+	/* Take the first entry at the mount point off its stack */
+	struct ns_union *stack = NULL;
 
-			k_free(to_remove);
+	if (old->count > 1) {
+		stack = stack_alloc(old->count - 1);
+		if (!stack) {
 			k_mutex_unlock(&ns->lock);
-			LOG_INF("Unmounted %s", norm_path);
-			return 0;
+			return -ENOMEM;
 		}
-		entry_ptr = &(*entry_ptr)->next;
+		memcpy(stack->entries, &old->entries[1],
+		       stack->count * sizeof(stack->entries[0]));
 	}
 
+	/* Unmount from VFS if needed */
+	entry_retire(ns, old->entries[0]);
+	stack_publish(ns, node, stack);
+	ns_reclaim(ns);
+
 	k_mutex_unlock(&ns->lock);
-	return -ENOENT;
+	LOG_INF("Unmounted %s", norm_path);
+	return 0;
 }
 
 int ns_clear(void)
@@ -618,20 +911,19 @@ int ns_clear(void)
 	k_mutex_lock(&ns->lock, K_FOREVER);
 
 	/* Unmount and free all entries */
-	for (int i = 0; i < CONFIG_NS_HASH_SIZE; i++) {
-		struct ns_entry *entry = ns->entries[i];
-		while (entry) {
-			struct ns_entry *next = entry->next;
+	for (struct ns_tree_node *node = ns->root; node;
+	     node = tree_next(ns->root, node)) {
+		struct ns_union *stack = atomic_ptr_get(&node->stack);
 
-			if (entry->type == NS_ENTRY_VFS) {
-				fs_unmount(entry->vfs_mount);
-			}
-
-			k_free(entry);
-			entry = next;
+		if (!stack) {
+			continue;
 		}
-		ns->entries[i] = NULL;
+		for (int i = 0; i < stack->count; i++) {
+			entry_retire(ns, stack->entries[i]);
+		}
+		stack_publish(ns, node, NULL);
 	}
+	ns_reclaim(ns);
 
 	k_mutex_unlock(&ns->lock);
 
@@ -646,44 +938,40 @@ int ns_clear(void)
 struct thread_namespace *ns_get_current(void)
 {
 #if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
-	return current_ns;
-#else
-	k_tid_t tid = k_current_get();
+	atomic_val_t gen = atomic_get(&ns_thread_map_gen);
 
-	k_mutex_lock(&ns_thread_map_lock, K_FOREVER);
-	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
-		if (ns_thread_map[i].tid == tid) {
-			struct thread_namespace *ns = ns_thread_map[i].ns;
-			k_mutex_unlock(&ns_thread_map_lock);
-			return ns;
-		}
+	if (current_ns.ns && current_ns.gen == gen) {
+		return current_ns.ns;
 	}
-	k_mutex_unlock(&ns_thread_map_lock);
 
-	return NULL;
+	current_ns.ns = ns_map_get(k_current_get());
+	current_ns.gen = gen;
+	return current_ns.ns;
+#else
+	return ns_map_get(k_current_get());
 #endif
 }
 
 int ns_set_current(struct thread_namespace *ns)
 {
-#if defined(CONFIG_NS_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_LOCAL_STORAGE)
-	current_ns = ns;
-	return 0;
-#else
-	k_tid_t tid = k_current_get();
+	int ret;
 
-	k_mutex_lock(&ns_thread_map_lock, K_FOREVER);
-	for (int i = 0; i < CONFIG_NS_MAX_MOUNTS_PER_THREAD; i++) {
-		if (ns_thread_map[i].tid == tid) {
-			ns_thread_map[i].ns = ns;
-			k_mutex_unlock(&ns_thread_map_lock);
-			return 0;
-		}
+	if (!ns) {
+		return -EINVAL;
 	}
-	k_mutex_unlock(&ns_thread_map_lock);
 
-	return -ENOENT;
-#endif
+	ns_map_set(k_current_get(), ns, &ret);
+	return ret;
+}
+
+void ns_walk_begin(void)
+{
+	atomic_inc(&ns_readers);
+}
+
+void ns_walk_end(void)
+{
+	atomic_dec(&ns_readers);
 }
 
 int ns_walk(const char *path, struct ns_entry **entries, int max_entries)
@@ -700,47 +988,29 @@ int ns_walk(const char *path, struct ns_entry **entries, int max_entries)
 	}
 
 	int count = 0;
-
-	k_mutex_lock(&ns->lock, K_FOREVER);
-
-	/* Check COW parent first if needed */
-	struct thread_namespace *search_ns = ns;
-	while (search_ns) {
-		/* Search all hash buckets for matching entries */
-		for (int i = 0; i < CONFIG_NS_HASH_SIZE; i++) {
-			struct ns_entry *e = search_ns->entries[i];
-			while (e) {
-				if (path_has_prefix(norm_path, e->path)) {
-					if (count < max_entries) {
-						entries[count++] = e;
-					}
-				}
-				e = e->next;
-			}
-		}
-
-		/* Check parent namespace if COW */
-		search_ns = search_ns->is_cow ? search_ns->parent : NULL;
+	struct thread_namespace *view = ns_read_begin(ns);
+	struct ns_tree_node *node = view->root;
+	struct ns_tree_node *child;
+	const char *p = norm_path;
+	const char *name;
+	size_t len;
+
+	/* Deepest mount point on the path, then each one above it */
+	while ((len = next_component(&p, &name)) > 0 &&
+	       (child = tree_child(node, name, len)) != NULL) {
+		node = child;
 	}
 
-	k_mutex_unlock(&ns->lock);
+	for (; node && count < max_entries; node = node->parent) {
+		struct ns_union *stack = atomic_ptr_get(&node->stack);
 
-	/* Sort by priority (longest prefix first, then by priority) */
-	/* Simple bubble sort for small arrays */
-	for (int i = 0; i < count - 1; i++) {
-		for (int j = 0; j < count - i - 1; j++) {
-			size_t len_j = strlen(entries[j]->path);
-			size_t len_jp1 = strlen(entries[j + 1]->path);
-
-			if (len_jp1 > len_j ||
-			    (len_jp1 == len_j && entries[j + 1]->priority < entries[j]->priority)) {
-				struct ns_entry *temp = entries[j];
-				entries[j] = entries[j + 1];
-				entries[j + 1] = temp;
-			}
+		for (int i = 0; stack && i < stack->count && count < max_entries; i++) {
+			entries[count++] = stack->entries[i];
 		}
 	}
 
+	ns_read_end();
+
 	return count;
 }
 
@@ -756,16 +1026,22 @@ void ns_dump(void)
 
 	k_mutex_lock(&ns->lock, K_FOREVER);
 
-	for (int i = 0; i < CONFIG_NS_HASH_SIZE; i++) {
-		struct ns_entry *e = ns->entries[i];
-		while (e) {
+	struct thread_namespace *view = ns_read_begin(ns);
+
+	for (struct ns_tree_node *node = view->root; node;
+	     node = tree_next(view->root, node)) {
+		struct ns_union *stack = atomic_ptr_get(&node->stack);
+
+		for (int i = 0; stack && i < stack->count; i++) {
+			struct ns_entry *e = stack->entries[i];
 			const char *type = (e->type == NS_ENTRY_VFS) ? "VFS" : "SERVER";
 			printk("  %s -> %s (priority=%d, flags=0x%x)\n",
 			       e->path, type, e->priority, e->flags);
-			e = e->next;
 		}
 	}
 
+	ns_read_end();
+
 	if (ns->is_cow && ns->parent) {
 		printk("  (COW parent namespace exists)\n");
 	}
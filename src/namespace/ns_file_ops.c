@@ -20,6 +20,20 @@ LOG_MODULE_REGISTER(ns_file_ops, CONFIG_NINEP_LOG_LEVEL);
 #define CONFIG_NS_MAX_OPEN_FILES 32
 #endif
 
+/**
+ * @brief What a path resolved to
+ *
+ * Copied out of the namespace entry, which an unmount may free as soon
+ * as the lookup is over.
+ */
+struct ns_target {
+	enum ns_entry_type type;
+	union {
+		struct fs_mount_t *vfs_mount;
+		struct ninep_server *server;
+	};
+};
+
 /**
  * @brief File descriptor entry
  */
@@ -28,7 +42,7 @@ struct ns_fd_entry {
 	struct fs_file_t vfs_file;          /* Underlying VFS file */
 	struct fs_dir_t vfs_dir;            /* Underlying VFS directory */
 	bool is_dir;                        /* True if directory */
-	struct ns_entry *ns_entry;          /* Which namespace entry */
+	struct ns_target target;            /* Which backend */
 	k_tid_t owner;                      /* Owning thread */
 
 	/* In-process server state */
@@ -91,7 +105,6 @@ static void free_fd(int fd)
 	k_mutex_lock(&fd_table_lock, K_FOREVER);
 	fd_table[fd].in_use = false;
 	fd_table[fd].owner = NULL;
-	fd_table[fd].ns_entry = NULL;
 	k_mutex_unlock(&fd_table_lock);
 }
 
@@ -131,22 +144,33 @@ static struct ns_fd_entry *get_fd_entry(int fd)
  * Given a namespace path, find the matching namespace entry and
  * calculate the relative path within that entry.
  */
-static int resolve_path(const char *ns_path, struct ns_entry **out_entry,
+static int resolve_path(const char *ns_path, struct ns_target *target,
                         const char **out_rel_path)
 {
 	struct ns_entry *entries[CONFIG_NS_MAX_UNION_DEPTH];
+
+	ns_walk_begin();
 	int count = ns_walk(ns_path, entries, CONFIG_NS_MAX_UNION_DEPTH);
 
 	if (count <= 0) {
+		ns_walk_end();
 		return -ENOENT;
 	}
 
 	/* Use first matching entry (highest priority) */
 	struct ns_entry *entry = entries[0];
-	*out_entry = entry;
+	size_t mount_len = strlen(entry->path);
+
+	target->type = entry->type;
+	if (entry->type == NS_ENTRY_VFS) {
+		target->vfs_mount = entry->vfs_mount;
+	} else {
+		target->server = entry->server;
+	}
+	ns_walk_end();
 
 	/* Calculate path relative to mount point */
-	const char *rel_path = ns_path + strlen(entry->path);
+	const char *rel_path = ns_path + mount_len;
 	if (*rel_path == '/') {
 		rel_path++;
 	}
@@ -158,25 +182,23 @@ static int resolve_path(const char *ns_path, struct ns_entry **out_entry,
 /**
  * @brief Resolve path to VFS path (for backward compatibility)
  */
-static int resolve_to_vfs_path(const char *ns_path, struct ns_entry **out_entry,
+static int resolve_to_vfs_path(const char *ns_path, struct ns_target *target,
                                char *vfs_path, size_t vfs_path_len)
 {
 	const char *rel_path;
-	int ret = resolve_path(ns_path, out_entry, &rel_path);
+	int ret = resolve_path(ns_path, target, &rel_path);
 	if (ret < 0) {
 		return ret;
 	}
 
-	struct ns_entry *entry = *out_entry;
-
-	if (entry->type != NS_ENTRY_VFS) {
+	if (target->type != NS_ENTRY_VFS) {
 		/* Not a VFS mount */
 		return -ENOTSUP;
 	}
 
 	/* Build VFS path: <vfs_mount_point>/<rel_path> */
 	snprintf(vfs_path, vfs_path_len, "%s/%s",
-	         entry->vfs_mount->mnt_point, rel_path);
+	         target->vfs_mount->mnt_point, rel_path);
 
 	return 0;
 }
@@ -246,10 +268,10 @@ int ns_open(const char *path, fs_mode_t flags)
 		return -EINVAL;
 	}
 
-	struct ns_entry *entry;
+	struct ns_target target;
 	const char *rel_path;
 
-	int ret = resolve_path(path, &entry, &rel_path);
+	int ret = resolve_path(path, &target, &rel_path);
 	if (ret < 0) {
 		LOG_ERR("Failed to resolve %s: %d", path, ret);
 		return ret;
@@ -263,15 +285,15 @@ int ns_open(const char *path, fs_mode_t flags)
 	}
 
 	struct ns_fd_entry *fd_entry = &fd_table[fd];
-	fd_entry->ns_entry = entry;
+	fd_entry->target = target;
 	fd_entry->is_dir = false;
 	fd_entry->server_offset = 0;
 
-	if (entry->type == NS_ENTRY_VFS) {
+	if (target.type == NS_ENTRY_VFS) {
 		/* VFS mount - open through VFS */
 		char vfs_path[CONFIG_NS_MAX_PATH_LEN];
 		snprintf(vfs_path, sizeof(vfs_path), "%s/%s",
-		         entry->vfs_mount->mnt_point, rel_path);
+		         target.vfs_mount->mnt_point, rel_path);
 
 		ret = fs_open(&fd_entry->vfs_file, vfs_path, flags);
 		if (ret < 0) {
@@ -282,9 +304,9 @@ int ns_open(const char *path, fs_mode_t flags)
 
 		LOG_DBG("Opened VFS %s -> %s (fd=%d)", path, vfs_path, fd);
 
-	} else if (entry->type == NS_ENTRY_SERVER) {
+	} else if (target.type == NS_ENTRY_SERVER) {
 		/* In-process server - walk to node and open */
-		struct ninep_server *server = entry->server;
+		struct ninep_server *server = target.server;
 		struct ninep_fs_node *node = server_walk_path(server, rel_path);
 		if (!node) {
 			LOG_ERR("Server walk failed for %s", rel_path);
@@ -323,7 +345,7 @@ int ns_open(const char *path, fs_mode_t flags)
 		LOG_DBG("Opened server %s (fd=%d)", path, fd);
 
 	} else {
-		LOG_ERR("Unknown entry type: %d", entry->type);
+		LOG_ERR("Unknown entry type: %d", target.type);
 		free_fd(fd);
 		return -EINVAL;
 	}
@@ -350,7 +372,7 @@ ssize_t ns_read(int fd, void *buf, size_t count)
 
 	ssize_t ret;
 
-	if (entry->ns_entry->type == NS_ENTRY_VFS) {
+	if (entry->target.type == NS_ENTRY_VFS) {
 		/* Read through VFS */
 		ret = fs_read(&entry->vfs_file, buf, count);
 		if (ret < 0) {
@@ -358,9 +380,9 @@ ssize_t ns_read(int fd, void *buf, size_t count)
 			return ret;
 		}
 
-	} else if (entry->ns_entry->type == NS_ENTRY_SERVER) {
+	} else if (entry->target.type == NS_ENTRY_SERVER) {
 		/* Read from in-process server */
-		struct ninep_server *server = entry->ns_entry->server;
+		struct ninep_server *server = entry->target.server;
 		const struct ninep_fs_ops *ops = server->config.fs_ops;
 
 		ret = ops->read(entry->server_node, entry->server_offset,
@@ -400,7 +422,7 @@ ssize_t ns_write(int fd, const void *buf, size_t count)
 
 	ssize_t ret;
 
-	if (entry->ns_entry->type == NS_ENTRY_VFS) {
+	if (entry->target.type == NS_ENTRY_VFS) {
 		/* Write through VFS */
 		ret = fs_write(&entry->vfs_file, buf, count);
 		if (ret < 0) {
@@ -408,9 +430,9 @@ ssize_t ns_write(int fd, const void *buf, size_t count)
 			return ret;
 		}
 
-	} else if (entry->ns_entry->type == NS_ENTRY_SERVER) {
+	} else if (entry->target.type == NS_ENTRY_SERVER) {
 		/* Write to in-process server */
-		struct ninep_server *server = entry->ns_entry->server;
+		struct ninep_server *server = entry->target.server;
 		const struct ninep_fs_ops *ops = server->config.fs_ops;
 
 		/* Use "local" as uname for namespace operations (not remote 9P) */
@@ -442,7 +464,7 @@ int ns_close(int fd)
 
 	int ret = 0;
 
-	if (entry->ns_entry->type == NS_ENTRY_VFS) {
+	if (entry->target.type == NS_ENTRY_VFS) {
 		/* Close through VFS */
 		if (entry->is_dir) {
 			ret = fs_closedir(&entry->vfs_dir);
@@ -454,9 +476,9 @@ int ns_close(int fd)
 			LOG_ERR("VFS close failed: %d", ret);
 		}
 
-	} else if (entry->ns_entry->type == NS_ENTRY_SERVER) {
+	} else if (entry->target.type == NS_ENTRY_SERVER) {
 		/* Clunk on in-process server */
-		struct ninep_server *server = entry->ns_entry->server;
+		struct ninep_server *server = entry->target.server;
 		const struct ninep_fs_ops *ops = server->config.fs_ops;
 
 		if (ops->clunk) {
@@ -489,7 +511,7 @@ off_t ns_lseek(int fd, off_t offset, int whence)
 
 	off_t ret;
 
-	if (entry->ns_entry->type == NS_ENTRY_VFS) {
+	if (entry->target.type == NS_ENTRY_VFS) {
 		/* Seek through VFS */
 		ret = fs_seek(&entry->vfs_file, offset, whence);
 		if (ret < 0) {
@@ -497,7 +519,7 @@ off_t ns_lseek(int fd, off_t offset, int whence)
 			return ret;
 		}
 
-	} else if (entry->ns_entry->type == NS_ENTRY_SERVER) {
+	} else if (entry->target.type == NS_ENTRY_SERVER) {
 		/* Server - just update offset */
 		switch (whence) {
 		case FS_SEEK_SET:
@@ -528,10 +550,10 @@ int ns_stat(const char *path, struct fs_dirent *entry)
 		return -EINVAL;
 	}
 
-	struct ns_entry *ns_entry;
+	struct ns_target target;
 	char vfs_path[CONFIG_NS_MAX_PATH_LEN];
 
-	int ret = resolve_to_vfs_path(path, &ns_entry, vfs_path, sizeof(vfs_path));
+	int ret = resolve_to_vfs_path(path, &target, vfs_path, sizeof(vfs_path));
 	if (ret < 0) {
 		return ret;
 	}
@@ -553,10 +575,10 @@ int ns_opendir(const char *path)
 		return -EINVAL;
 	}
 
-	struct ns_entry *entry;
+	struct ns_target target;
 	char vfs_path[CONFIG_NS_MAX_PATH_LEN];
 
-	int ret = resolve_to_vfs_path(path, &entry, vfs_path, sizeof(vfs_path));
+	int ret = resolve_to_vfs_path(path, &target, vfs_path, sizeof(vfs_path));
 	if (ret < 0) {
 		LOG_ERR("Failed to resolve %s: %d", path, ret);
 		return ret;
@@ -579,8 +601,8 @@ int ns_opendir(const char *path)
 		return ret;
 	}
 
-	/* Store namespace entry reference */
-	fd_entry->ns_entry = entry;
+	/* Store the backend */
+	fd_entry->target = target;
 	fd_entry->is_dir = true;
 
 	LOG_DBG("Opened directory %s -> %s (fd=%d)", path, vfs_path, fd);
@@ -652,11 +674,11 @@ int ns_mkdir(const char *path)
 		return -EINVAL;
 	}
 
-	struct ns_entry *entry;
+	struct ns_target target;
 	char vfs_path[CONFIG_NS_MAX_PATH_LEN];
 
 	/* Find writable mount (NS_FLAG_CREATE or highest priority) */
-	int ret = resolve_to_vfs_path(path, &entry, vfs_path, sizeof(vfs_path));
+	int ret = resolve_to_vfs_path(path, &target, vfs_path, sizeof(vfs_path));
 	if (ret < 0) {
 		return ret;
 	}
@@ -678,10 +700,10 @@ int ns_unlink(const char *path)
 		return -EINVAL;
 	}
 
-	struct ns_entry *entry;
+	struct ns_target target;
 	char vfs_path[CONFIG_NS_MAX_PATH_LEN];
 
-	int ret = resolve_to_vfs_path(path, &entry, vfs_path, sizeof(vfs_path));
+	int ret = resolve_to_vfs_path(path, &target, vfs_path, sizeof(vfs_path));
 	if (ret < 0) {
 		return ret;
 	}
@@ -703,24 +725,24 @@ int ns_rename(const char *old_path, const char *new_path)
 		return -EINVAL;
 	}
 
-	struct ns_entry *old_entry, *new_entry;
+	struct ns_target old_target, new_target;
 	char old_vfs_path[CONFIG_NS_MAX_PATH_LEN];
 	char new_vfs_path[CONFIG_NS_MAX_PATH_LEN];
 
-	int ret = resolve_to_vfs_path(old_path, &old_entry,
+	int ret = resolve_to_vfs_path(old_path, &old_target,
 	                              old_vfs_path, sizeof(old_vfs_path));
 	if (ret < 0) {
 		return ret;
 	}
 
-	ret = resolve_to_vfs_path(new_path, &new_entry,
+	ret = resolve_to_vfs_path(new_path, &new_target,
 	                         new_vfs_path, sizeof(new_vfs_path));
 	if (ret < 0) {
 		return ret;
 	}
 
 	/* Verify both paths are in same mount */
-	if (old_entry != new_entry) {
+	if (old_target.vfs_mount != new_target.vfs_mount) {
 		LOG_ERR("Cannot rename across different mounts");
 		return -EXDEV;
 	}
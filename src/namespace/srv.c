@@ -19,6 +19,175 @@ LOG_MODULE_REGISTER(srv, CONFIG_NINEP_LOG_LEVEL);
 static struct srv_registry global_srv_registry;
 static bool srv_initialized = false;
 
+/* ========================================================================
+ * Node Ownership
+ *
+ * Every node the /srv filesystem hands out - a service root, or a node
+ * walked or created below one - is recorded with its service, so later
+ * operations go straight to that service's fs_ops. Entries are counted
+ * like fids: walk, create and ref add one, clunk drops one, and the entry
+ * is dropped at zero. Protected by the registry lock; backend calls are
+ * made without it.
+ * ======================================================================== */
+
+/* fs_ops and context of the service owning a node */
+struct srv_target {
+	const struct ninep_fs_ops *ops;
+	void *ctx;
+};
+
+static struct srv_node_owner **owner_bucket(const struct ninep_fs_node *node)
+{
+	uintptr_t key = (uintptr_t)node >> 3;  /* Nodes are at least 8-aligned */
+
+	return &global_srv_registry.owner_buckets[(uint32_t)(key * 2654435761u) &
+	                                          (SRV_OWNER_BUCKETS - 1)];
+}
+
+static struct srv_node_owner *lookup_owner(const struct ninep_fs_node *node)
+{
+	struct srv_node_owner *o = *owner_bucket(node);
+
+	while (o && o->node != node) {
+		o = o->next;
+	}
+	return o;
+}
+
+static void target_of(const struct srv_entry *service, struct srv_target *t)
+{
+	t->ops = service->local.server->config.fs_ops;
+	t->ctx = service->local.server->config.fs_ctx;
+}
+
+/* Count one more reference to node as service's. Lock held. */
+static int track_node(struct ninep_fs_node *node, struct srv_entry *service)
+{
+	struct srv_node_owner *o = lookup_owner(node);
+
+	if (o) {
+		o->refcount++;
+		return 0;
+	}
+
+	o = global_srv_registry.owner_free;
+	if (!o) {
+		LOG_ERR("Node table full (%d nodes)", CONFIG_SRV_MAX_NODES);
+		return -ENOMEM;
+	}
+	global_srv_registry.owner_free = o->next;
+
+	struct srv_node_owner **bucket = owner_bucket(node);
+
+	o->node = node;
+	o->service = service;
+	o->refcount = 1;
+	o->next = *bucket;
+	*bucket = o;
+	return 0;
+}
+
+static void free_owner(struct srv_node_owner **link)
+{
+	struct srv_node_owner *o = *link;
+
+	*link = o->next;
+	o->next = global_srv_registry.owner_free;
+	global_srv_registry.owner_free = o;
+}
+
+/* Forget every node of a service being removed. Lock held. Their
+ * clunks then find no owner and are not passed on. */
+static void drop_service_nodes(const struct srv_entry *service)
+{
+	for (int i = 0; i < SRV_OWNER_BUCKETS; i++) {
+		struct srv_node_owner **link = &global_srv_registry.owner_buckets[i];
+
+		while (*link) {
+			if ((*link)->service == service) {
+				free_owner(link);
+			} else {
+				link = &(*link)->next;
+			}
+		}
+	}
+}
+
+/* The registered service called name (name_len bytes). Lock held. */
+static struct srv_entry *find_service_locked(const char *name,
+                                             uint16_t name_len)
+{
+	struct srv_entry *entry = global_srv_registry.services;
+
+	while (entry && (strncmp(entry->name, name, name_len) != 0 ||
+	                 entry->name[name_len] != '\0')) {
+		entry = entry->next;
+	}
+	return entry;
+}
+
+/* Look up the service that owns node; false if /srv never handed it out */
+static bool find_owner(const struct ninep_fs_node *node, struct srv_target *t)
+{
+	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
+	struct srv_node_owner *o = lookup_owner(node);
+
+	if (o) {
+		target_of(o->service, t);
+	}
+	k_mutex_unlock(&global_srv_registry.lock);
+	return o != NULL;
+}
+
+/* Drop one reference to node, forgetting it after the last. Sets *t to
+ * its service; false if /srv never handed it out. */
+static bool release_owner(const struct ninep_fs_node *node,
+                          struct srv_target *t)
+{
+	bool found = false;
+
+	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
+	struct srv_node_owner **link = owner_bucket(node);
+
+	while (*link && (*link)->node != node) {
+		link = &(*link)->next;
+	}
+	if (*link) {
+		target_of((*link)->service, t);
+		found = true;
+		if (--(*link)->refcount == 0) {
+			free_owner(link);
+		}
+	}
+	k_mutex_unlock(&global_srv_registry.lock);
+	return found;
+}
+
+/* Track node as belonging to the same service as from. If that service
+ * is gone or the table is full, hand node back to the backend. */
+static struct ninep_fs_node *track_as(struct ninep_fs_node *node,
+                                      const struct ninep_fs_node *from,
+                                      const struct srv_target *t)
+{
+	int ret = -ENOENT;
+
+	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
+	struct srv_node_owner *o = lookup_owner(from);
+
+	if (o) {
+		ret = track_node(node, o->service);
+	}
+	k_mutex_unlock(&global_srv_registry.lock);
+
+	if (ret < 0) {
+		if (t->ops->clunk) {
+			t->ops->clunk(node, t->ctx);
+		}
+		return NULL;
+	}
+	return node;
+}
+
 /* ========================================================================
  * Service Management
  * ======================================================================== */
@@ -150,6 +319,7 @@ int srv_remove(const char *name)
 			struct srv_entry *to_remove = *entry_ptr;
 			*entry_ptr = to_remove->next;
 			global_srv_registry.num_services--;
+			drop_service_nodes(to_remove);
 
 			/* Free entry */
 			k_free(to_remove);
@@ -270,7 +440,7 @@ static struct ninep_fs_node *srv_alloc_root_node(void)
 	}
 
 	memset(node, 0, sizeof(*node));
-	strncpy(node->name, "", sizeof(node->name) - 1);  /* Empty name for root */
+	node->name = "";  /* Empty name for root */
 	node->type = NINEP_NODE_DIR;
 	node->mode = 0555 | NINEP_DMDIR;
 	node->qid.type = NINEP_QTDIR;
@@ -302,114 +472,95 @@ static struct ninep_fs_node *srv_fs_walk(struct ninep_fs_node *dir, const char *
 
 	/* Check if walking from /srv root */
 	if (dir == srv_root_node) {
-		/* Walking from /srv root to a service */
-		char service_name[256];
-		if (name_len >= sizeof(service_name)) {
+		/* Walking from /srv root to a service. For local services, return
+		 * the service's root node directly, so union_fs tracks the actual
+		 * filesystem nodes that have proper ninep_fs_node structure. */
+		struct ninep_fs_node *target = NULL;
+
+		if (name_len >= CONFIG_SRV_MAX_NAME_LEN) {
 			return NULL;
 		}
-		memcpy(service_name, name, name_len);
-		service_name[name_len] = '\0';
 
-		struct srv_entry *entry = srv_lookup(service_name);
-		if (!entry) {
-			return NULL;
+		struct srv_target t = { 0 };
+		bool found;
+
+		k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
+		struct srv_entry *entry = find_service_locked(name, name_len);
+
+		found = entry != NULL;
+		if (entry && entry->type == SRV_TYPE_LOCAL && entry->local.server) {
+			target_of(entry, &t);
 		}
+		k_mutex_unlock(&global_srv_registry.lock);
 
-		/* For local services, return the service's root node directly.
-		 * This avoids invalid casts and ensures union_fs tracks the actual
-		 * filesystem nodes that have proper ninep_fs_node structure. */
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->get_root) {
-				struct ninep_fs_node *target = ops->get_root(ctx);
-				LOG_DBG("Returning service root for '%s': target=%p", service_name, target);
-				return target;
+		if (t.ops && t.ops->get_root) {
+			target = t.ops->get_root(t.ctx);
+		}
+
+		/* The service may have been removed (or replaced) meanwhile */
+		if (target) {
+			k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
+			entry = find_service_locked(name, name_len);
+			if (!entry || entry->type != SRV_TYPE_LOCAL ||
+			    !entry->local.server ||
+			    entry->local.server->config.fs_ops != t.ops ||
+			    entry->local.server->config.fs_ctx != t.ctx ||
+			    track_node(target, entry) < 0) {
+				target = NULL;
 			}
+			k_mutex_unlock(&global_srv_registry.lock);
 		}
 
 		/* For network services (not yet implemented), we'd need different handling */
-		LOG_WRN("Service '%s' has no accessible root", service_name);
-		return NULL;
-
+		if (found && !target) {
+			LOG_WRN("Service '%.*s' has no accessible root", name_len, name);
+		}
+		LOG_DBG("Returning service root for '%.*s': target=%p", name_len, name, target);
+		return target;
 	}
 
-	/* If dir is not srv_root_node, we need to delegate to the service that owns this node.
-	 * Walk through all services to find which one owns this node. */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
+	/* Otherwise delegate to the service that handed out dir */
+	struct srv_target t;
 
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			/* Check if this service's root matches our dir, or if dir is a descendant.
-			 * For simplicity, we check if the service root matches the dir pointer exactly.
-			 * For deeper nodes, we rely on the fact that BBS (and other services) will
-			 * return nodes that can be checked. */
-			if (ops && ops->get_root) {
-				struct ninep_fs_node *service_root = ops->get_root(ctx);
-				if (service_root == dir) {
-					/* Found the service that owns this node - delegate the walk */
-					k_mutex_unlock(&global_srv_registry.lock);
-					if (ops->walk) {
-						LOG_DBG("Delegating walk to service '%s' filesystem", entry->name);
-						return ops->walk(dir, name, name_len, ctx);
-					}
-					LOG_WRN("Service '%s' has no walk function", entry->name);
-					return NULL;
-				}
-			}
-		}
-		entry = entry->next;
+	if (!find_owner(dir, &t)) {
+		LOG_WRN("srv_fs_walk: node %p (%s) has no service", dir, dir->name);
+		return NULL;
+	}
+	if (!t.ops->walk) {
+		return NULL;
 	}
 
-	k_mutex_unlock(&global_srv_registry.lock);
+	struct ninep_fs_node *node = t.ops->walk(dir, name, name_len, t.ctx);
 
-	/* If we couldn't find a service root match, this might be a deeper node.
-	 * Try delegating to each service - the service will return NULL if it
-	 * doesn't own the node. */
-	LOG_DBG("Node %p (%s) not a service root, trying all services", dir, dir->name);
+	/* Walk failed - normal "file not found" case, no logging needed */
+	return node ? track_as(node, dir, &t) : NULL;
+}
 
-	/* We need to iterate without holding the lock during the walk call.
-	 * Collect service info first. */
-	struct {
-		const struct ninep_fs_ops *ops;
-		void *ctx;
-		char name[32];
-	} services[32];
-	int num_services = 0;
+/* Take another reference to a node (fid clone) */
+static void srv_fs_ref(struct ninep_fs_node *node, void *fs_ctx)
+{
+	ARG_UNUSED(fs_ctx);
+
+	if (node == srv_root_node) {
+		return;
+	}
+
+	struct srv_target t;
+	bool found = false;
 
 	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	entry = global_srv_registry.services;
-	while (entry && num_services < 32) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			services[num_services].ops = entry->local.server->config.fs_ops;
-			services[num_services].ctx = entry->local.server->config.fs_ctx;
-			strncpy(services[num_services].name, entry->name, sizeof(services[num_services].name) - 1);
-			services[num_services].name[sizeof(services[num_services].name) - 1] = '\0';
-			num_services++;
-		}
-		entry = entry->next;
+	struct srv_node_owner *o = lookup_owner(node);
+
+	if (o) {
+		o->refcount++;
+		target_of(o->service, &t);
+		found = true;
 	}
 	k_mutex_unlock(&global_srv_registry.lock);
 
-	/* Now try each service */
-	for (int i = 0; i < num_services; i++) {
-		if (services[i].ops && services[i].ops->walk) {
-			LOG_DBG("Trying service '%s' for node %p", services[i].name, dir);
-			struct ninep_fs_node *result = services[i].ops->walk(dir, name, name_len, services[i].ctx);
-			if (result) {
-				LOG_DBG("Service '%s' handled the walk", services[i].name);
-				return result;
-			}
-		}
+	if (found && t.ops->ref) {
+		t.ops->ref(node, t.ctx);
 	}
-
-	/* Walk failed - normal "file not found" case, no logging needed */
-	return NULL;
 }
 
 /* Stat a node */
@@ -428,29 +579,13 @@ static int srv_fs_stat(struct ninep_fs_node *node, uint8_t *buf,
 		return (ret < 0) ? ret : offset;
 	}
 
-	/* Otherwise, delegate to underlying services.
-	 * Since we return target nodes directly from walk, this should normally
-	 * be handled by the service's own stat handler via union_fs delegation. */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->stat) {
-				int ret = ops->stat(node, buf, buf_len, ctx);
-				if (ret >= 0 || ret != -EINVAL) {
-					k_mutex_unlock(&global_srv_registry.lock);
-					return ret;
-				}
-			}
-		}
-		entry = entry->next;
-	}
-	k_mutex_unlock(&global_srv_registry.lock);
+	/* Otherwise, delegate to the service that owns the node */
+	struct srv_target t;
 
-	return -ENOENT;
+	if (!find_owner(node, &t)) {
+		return -ENOENT;
+	}
+	return t.ops->stat ? t.ops->stat(node, buf, buf_len, t.ctx) : -ENOTSUP;
 }
 
 /* Open a node */
@@ -464,28 +599,14 @@ static int srv_fs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 		return 0;
 	}
 
-	/* Delegate to underlying services */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->open) {
-				int ret = ops->open(node, mode, ctx);
-				if (ret == 0 || ret != -EINVAL) {
-					k_mutex_unlock(&global_srv_registry.lock);
-					return ret;
-				}
-			}
-		}
-		entry = entry->next;
-	}
-	k_mutex_unlock(&global_srv_registry.lock);
+	/* Delegate to the service that owns the node */
+	struct srv_target t;
 
-	/* No service claimed it, but allow opening anyway */
-	return 0;
+	if (!find_owner(node, &t) || !t.ops->open) {
+		/* No service claimed it, but allow opening anyway */
+		return 0;
+	}
+	return t.ops->open(node, mode, t.ctx);
 }
 
 /* Read directory or service info */
@@ -568,27 +689,14 @@ static int srv_fs_read(struct ninep_fs_node *node, uint64_t offset,
 		return buf_offset;
 	}
 
-	/* Not the srv root - delegate to underlying services */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->read) {
-				int ret = ops->read(node, offset, buf, count, NULL, ctx);
-				if (ret >= 0 || ret != -EINVAL) {
-					k_mutex_unlock(&global_srv_registry.lock);
-					return ret;
-				}
-			}
-		}
-		entry = entry->next;
-	}
-	k_mutex_unlock(&global_srv_registry.lock);
+	/* Not the srv root - delegate to the service that owns the node */
+	struct srv_target t;
 
-	return -ENOENT;
+	if (!find_owner(node, &t)) {
+		return -ENOENT;
+	}
+	return t.ops->read ? t.ops->read(node, offset, buf, count, NULL, t.ctx) :
+	                     -ENOTSUP;
 }
 
 /* Clunk (close) a node */
@@ -604,33 +712,16 @@ static int srv_fs_clunk(struct ninep_fs_node *node, void *fs_ctx)
 		return 0;
 	}
 
-	/* For all other nodes, they belong to underlying services.
-	 * Delegate clunk to the owning service. */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->clunk) {
-				/* Try this service's clunk - it will return error if it doesn't own the node */
-				int ret = ops->clunk(node, ctx);
-				if (ret == 0 || ret != -EINVAL) {
-					/* This service handled it */
-					k_mutex_unlock(&global_srv_registry.lock);
-					LOG_DBG("Delegated clunk to service '%s'", entry->name);
-					return ret;
-				}
-			}
-		}
-		entry = entry->next;
-	}
-	k_mutex_unlock(&global_srv_registry.lock);
+	/* For all other nodes, drop our reference and pass the clunk to the
+	 * owning service */
+	struct srv_target t;
 
-	/* No service claimed this node - it might be a node without clunk handler */
-	LOG_DBG("srv_fs_clunk: no service claimed node '%s'", node->name);
-	return 0;
+	if (!release_owner(node, &t)) {
+		/* Not handed out by /srv, or its service was removed */
+		LOG_DBG("srv_fs_clunk: no service claimed node '%s'", node->name);
+		return 0;
+	}
+	return t.ops->clunk ? t.ops->clunk(node, t.ctx) : 0;
 }
 
 /* Write - delegate to underlying service */
@@ -640,27 +731,13 @@ static int srv_fs_write(struct ninep_fs_node *node, uint64_t offset,
 {
 	ARG_UNUSED(fs_ctx);
 
-	/* Delegate to underlying services */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->write) {
-				int ret = ops->write(node, offset, buf, count, uname, ctx);
-				if (ret >= 0 || ret != -EINVAL) {
-					k_mutex_unlock(&global_srv_registry.lock);
-					return ret;
-				}
-			}
-		}
-		entry = entry->next;
-	}
-	k_mutex_unlock(&global_srv_registry.lock);
+	/* Delegate to the service that owns the node */
+	struct srv_target t;
 
-	return -EROFS;
+	if (!find_owner(node, &t) || !t.ops->write) {
+		return -EROFS;
+	}
+	return t.ops->write(node, offset, buf, count, uname, t.ctx);
 }
 
 /* Create operation - delegate to underlying service */
@@ -671,29 +748,28 @@ static int srv_fs_create(struct ninep_fs_node *dir, const char *name,
 {
 	ARG_UNUSED(fs_ctx);
 
-	/* Delegate to underlying services */
-	k_mutex_lock(&global_srv_registry.lock, K_FOREVER);
-	struct srv_entry *entry = global_srv_registry.services;
-	while (entry) {
-		if (entry->type == SRV_TYPE_LOCAL && entry->local.server) {
-			const struct ninep_fs_ops *ops = entry->local.server->config.fs_ops;
-			void *ctx = entry->local.server->config.fs_ctx;
-
-			if (ops && ops->create) {
-				int ret = ops->create(dir, name, name_len, perm,
-				                      mode, uname, child, ctx);
-				if (ret != -EINVAL) {
-					k_mutex_unlock(&global_srv_registry.lock);
-					return ret;
-				}
-			}
-		}
-		entry = entry->next;
+	/* Delegate to the service that owns the directory; the new node is
+	 * that service's too. Can't create directly in /srv root. */
+	struct srv_target t;
+
+	if (!find_owner(dir, &t) || !t.ops->create) {
+		return -EROFS;
 	}
-	k_mutex_unlock(&global_srv_registry.lock);
 
-	/* Can't create directly in /srv root */
-	return -EROFS;
+	int ret = t.ops->create(dir, name, name_len, perm, mode, uname, child,
+	                        t.ctx);
+
+	if (ret < 0) {
+		return ret;
+	}
+	if (*child && !track_as(*child, dir, &t)) {
+		*child = NULL;
+		ret = -ENOMEM;
+	}
+
+	/* The backend took over the fid's reference to dir */
+	release_owner(dir, &t);
+	return ret;
 }
 
 static int srv_fs_remove(struct ninep_fs_node *node, void *fs_ctx)
@@ -714,6 +790,7 @@ static const struct ninep_fs_ops srv_fs_ops = {
 	.create = srv_fs_create,
 	.remove = srv_fs_remove,
 	.clunk = srv_fs_clunk,
+	.ref = srv_fs_ref,
 };
 
 const struct ninep_fs_ops *srv_get_fs_ops(void)
@@ -733,6 +810,10 @@ int srv_init(void)
 
 	memset(&global_srv_registry, 0, sizeof(global_srv_registry));
 	k_mutex_init(&global_srv_registry.lock);
+	for (int i = CONFIG_SRV_MAX_NODES; i-- > 0;) {
+		global_srv_registry.owners[i].next = global_srv_registry.owner_free;
+		global_srv_registry.owner_free = &global_srv_registry.owners[i];
+	}
 
 	srv_initialized = true;
 	LOG_INF("/srv service registry initialized");
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/9p/node_alloc.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ninep_node_alloc, CONFIG_NINEP_LOG_LEVEL);
+
+#define NODE_ALIGN 8
+#define BLOCK_SIZE(mul) ROUND_UP(CONFIG_NINEP_NODE_BLOCK_SIZE * (mul), NODE_ALIGN)
+
+#if CONFIG_NINEP_NODE_BLOCKS_SMALL > 0
+K_MEM_SLAB_DEFINE_STATIC(small_slab, BLOCK_SIZE(1),
+                         CONFIG_NINEP_NODE_BLOCKS_SMALL, NODE_ALIGN);
+#endif
+#if CONFIG_NINEP_NODE_BLOCKS_MEDIUM > 0
+K_MEM_SLAB_DEFINE_STATIC(medium_slab, BLOCK_SIZE(2),
+                         CONFIG_NINEP_NODE_BLOCKS_MEDIUM, NODE_ALIGN);
+#endif
+#if CONFIG_NINEP_NODE_BLOCKS_LARGE > 0
+K_MEM_SLAB_DEFINE_STATIC(large_slab, BLOCK_SIZE(4),
+                         CONFIG_NINEP_NODE_BLOCKS_LARGE, NODE_ALIGN);
+#endif
+
+struct node_class {
+	struct k_mem_slab *slab;  /* NULL when the class has no blocks */
+	size_t block_size;
+	uint32_t blocks;
+	uint32_t in_use;
+	uint32_t high_water;
+};
+
+static struct node_class classes[NINEP_NODE_ALLOC_CLASSES] = {
+	{
+#if CONFIG_NINEP_NODE_BLOCKS_SMALL > 0
+		.slab = &small_slab,
+#endif
+		.block_size = BLOCK_SIZE(1),
+		.blocks = CONFIG_NINEP_NODE_BLOCKS_SMALL,
+	},
+	{
+#if CONFIG_NINEP_NODE_BLOCKS_MEDIUM > 0
+		.slab = &medium_slab,
+#endif
+		.block_size = BLOCK_SIZE(2),
+		.blocks = CONFIG_NINEP_NODE_BLOCKS_MEDIUM,
+	},
+	{
+#if CONFIG_NINEP_NODE_BLOCKS_LARGE > 0
+		.slab = &large_slab,
+#endif
+		.block_size = BLOCK_SIZE(4),
+		.blocks = CONFIG_NINEP_NODE_BLOCKS_LARGE,
+	},
+};
+
+static uint32_t heap_in_use;
+static uint32_t heap_high_water;
+static uint32_t failures;
+static struct k_spinlock lock;
+
+/* Class whose slab holds mem, or NULL for heap blocks */
+static struct node_class *class_of(const void *mem)
+{
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		const struct node_class *c = &classes[i];
+
+		if (c->slab && (const char *)mem >= c->slab->buffer &&
+		    (const char *)mem < c->slab->buffer + c->blocks * c->block_size) {
+			return &classes[i];
+		}
+	}
+	return NULL;
+}
+
+static void *alloc_block(size_t total)
+{
+	void *mem = NULL;
+	k_spinlock_key_t key;
+
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		struct node_class *c = &classes[i];
+
+		if (total > c->block_size || !c->slab) {
+			continue;
+		}
+		/* Only the smallest fitting class: a full class falls back to
+		 * the heap rather than eating blocks meant for longer names */
+		if (k_mem_slab_alloc(c->slab, &mem, K_NO_WAIT) == 0) {
+			key = k_spin_lock(&lock);
+			c->in_use++;
+			c->high_water = MAX(c->high_water, c->in_use);
+			k_spin_unlock(&lock, key);
+			return mem;
+		}
+		break;
+	}
+
+#if defined(CONFIG_NINEP_NODE_HEAP_FALLBACK)
+	mem = k_malloc(total);
+	if (mem) {
+		key = k_spin_lock(&lock);
+		heap_in_use++;
+		heap_high_water = MAX(heap_high_water, heap_in_use);
+		k_spin_unlock(&lock, key);
+		return mem;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
+	failures++;
+	k_spin_unlock(&lock, key);
+	LOG_WRN("Cannot allocate %zu-byte node", total);
+	return NULL;
+}
+
+struct ninep_fs_node *ninep_node_alloc(size_t size, const char *name,
+                                       size_t name_len)
+{
+	size_t total = size + name_len + 1;
+	struct ninep_fs_node *node = alloc_block(total);
+
+	if (!node) {
+		return NULL;
+	}
+
+	memset(node, 0, size);
+
+	char *name_buf = (char *)node + size;
+
+	memcpy(name_buf, name, name_len);
+	name_buf[name_len] = '\0';
+	node->name = name_buf;
+
+	return node;
+}
+
+void ninep_node_free(struct ninep_fs_node *node)
+{
+	if (!node) {
+		return;
+	}
+
+	struct node_class *c = class_of(node);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (c) {
+		c->in_use--;
+	} else {
+		heap_in_use--;
+	}
+	k_spin_unlock(&lock, key);
+
+	if (c) {
+		k_mem_slab_free(c->slab, node);
+	} else {
+		k_free(node);
+	}
+}
+
+void ninep_node_alloc_get_stats(struct ninep_node_alloc_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		stats->classes[i].block_size = classes[i].block_size;
+		stats->classes[i].blocks = classes[i].blocks;
+		stats->classes[i].in_use = classes[i].in_use;
+		stats->classes[i].high_water = classes[i].high_water;
+	}
+	stats->heap_in_use = heap_in_use;
+	stats->heap_high_water = heap_high_water;
+	stats->failures = failures;
+	k_spin_unlock(&lock, key);
+}
@@ -4,6 +4,7 @@
  */
 
 #include <zephyr/9p/passthrough_fs.h>
+#include <zephyr/9p/node_alloc.h>
 #include <zephyr/9p/protocol.h>
 #include <zephyr/fs/fs.h>
 #include <zephyr/kernel.h>
@@ -13,11 +14,134 @@
 
 LOG_MODULE_REGISTER(ninep_passthrough_fs, CONFIG_NINEP_LOG_LEVEL);
 
-/* Extended node data: stores full path */
+/* Passthrough node; node.data points back at it. One reference per fid,
+ * except on the root, which lives as long as the fs. */
 struct node_data {
-	char path[256];  /* Full path from mount point */
+	struct ninep_fs_node node;
+	struct ninep_passthrough_handle *handle;  /* Open file, if any */
+	fs_mode_t flags;  /* Access requested by every Topen of this node */
+	uint32_t refs;
+	bool interned;    /* In fs->nodes; walks of path return this node */
+	uint32_t last_use;                /* When refs last dropped to 0 */
+	struct ninep_fs_node *hash_next;  /* Next in the fs->nodes bucket */
+	char path[];      /* Full path from mount point */
 };
 
+/*
+ * qid.path is FNV-1a 64 of the path below the mount point (never 0, which
+ * marks free table entries). qid_slots remembers recently issued values
+ * with a second, independent hash of their path; a different path that
+ * hashes onto one of them is rehashed with a salt until it is unique.
+ */
+static uint64_t hash_path(const char *path, uint8_t salt)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+
+	for (const char *p = path; *p; p++) {
+		h = (h ^ (uint8_t)*p) * 0x100000001b3ULL;
+	}
+	if (salt) {
+		h = (h ^ salt) * 0x100000001b3ULL;
+	}
+	return h ? h : 1;
+}
+
+static uint32_t check_path(const char *path)
+{
+	uint32_t h = 5381;
+
+	for (const char *p = path; *p; p++) {
+		h = ((h << 5) + h) ^ (uint8_t)*p;
+	}
+	return h;
+}
+
+static uint64_t path_qid(struct ninep_passthrough_fs *fs, const char *path)
+{
+	uint32_t check = check_path(path);
+	uint64_t qid_path;
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	for (uint8_t salt = 0; ; salt++) {
+		struct ninep_passthrough_qid_slot *slot;
+
+		qid_path = hash_path(path, salt);
+		slot = &fs->qid_slots[qid_path % ARRAY_SIZE(fs->qid_slots)];
+		if (slot->qid_path != qid_path || slot->check == check ||
+		    salt == UINT8_MAX) {
+			slot->qid_path = qid_path;
+			slot->check = check;
+			break;
+		}
+		LOG_WRN("qid.path collision on '%s', rehashing", path);
+	}
+	k_mutex_unlock(&fs->lock);
+
+	return qid_path;
+}
+
+/*
+ * qid.version: files changed through 9P get a fresh value from
+ * version_seq, kept in a small LRU table. Everything else reports
+ * version_floor, which is raised to version_seq whenever an entry is
+ * evicted so an evicted file can never appear to go back in time.
+ */
+static struct ninep_passthrough_qid_version *find_version(
+	struct ninep_passthrough_fs *fs, uint64_t qid_path)
+{
+	for (int i = 0; i < ARRAY_SIZE(fs->versions); i++) {
+		if (fs->versions[i].qid_path == qid_path) {
+			return &fs->versions[i];
+		}
+	}
+	return NULL;
+}
+
+static uint32_t qid_version(struct ninep_passthrough_fs *fs, uint64_t qid_path)
+{
+	struct ninep_passthrough_qid_version *v;
+	uint32_t version;
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	v = find_version(fs, qid_path);
+	version = v ? v->version : fs->version_floor;
+	k_mutex_unlock(&fs->lock);
+
+	return version;
+}
+
+static uint32_t bump_version(struct ninep_passthrough_fs *fs, uint64_t qid_path)
+{
+	struct ninep_passthrough_qid_version *v;
+	uint32_t version;
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	v = find_version(fs, qid_path);
+	if (!v) {
+		for (int i = 0; i < ARRAY_SIZE(fs->versions); i++) {
+			struct ninep_passthrough_qid_version *cand = &fs->versions[i];
+
+			if (!cand->qid_path) {
+				v = cand;
+				break;
+			}
+			if (!v || cand->last_use < v->last_use) {
+				v = cand;
+			}
+		}
+		if (v->qid_path) {
+			fs->version_floor = fs->version_seq;
+		}
+		v->qid_path = qid_path;
+	}
+	version = ++fs->version_seq;
+	v->version = version;
+	v->last_use = ++fs->handle_clock;
+	k_mutex_unlock(&fs->lock);
+
+	return version;
+}
+
 /* Helper to allocate node with path */
 static struct ninep_fs_node *alloc_node(struct ninep_passthrough_fs *fs,
                                          const char *name,
@@ -26,30 +150,26 @@ static struct ninep_fs_node *alloc_node(struct ninep_passthrough_fs *fs,
                                          uint32_t mode,
                                          uint64_t length)
 {
-	struct ninep_fs_node *node = k_malloc(sizeof(struct ninep_fs_node));
+	size_t path_len = strlen(full_path);
+	struct ninep_fs_node *node = ninep_node_alloc(sizeof(struct node_data) +
+	                                              path_len + 1,
+	                                              name, strlen(name));
 	if (!node) {
 		return NULL;
 	}
 
-	struct node_data *data = k_malloc(sizeof(struct node_data));
-	if (!data) {
-		k_free(node);
-		return NULL;
-	}
-
-	memset(node, 0, sizeof(*node));
-	memset(data, 0, sizeof(*data));
+	struct node_data *data = CONTAINER_OF(node, struct node_data, node);
 
-	strncpy(node->name, name, sizeof(node->name) - 1);
-	strncpy(data->path, full_path, sizeof(data->path) - 1);
+	memcpy(data->path, full_path, path_len + 1);
+	data->refs = 1;
 
 	node->type = type;
 	node->mode = mode;
 	node->length = length;
 	node->data = data;
 
-	node->qid.path = fs->next_qid_path++;
-	node->qid.version = 0;
+	node->qid.path = path_qid(fs, full_path);
+	node->qid.version = qid_version(fs, node->qid.path);
 	node->qid.type = (type == NINEP_NODE_DIR) ? NINEP_QTDIR : NINEP_QTFILE;
 
 	LOG_DBG("Allocated node: name='%s' path='%s' type=%d qid.path=%llu",
@@ -58,17 +178,116 @@ static struct ninep_fs_node *alloc_node(struct ninep_passthrough_fs *fs,
 	return node;
 }
 
-/* Helper to free node */
-static void free_node(struct ninep_fs_node *node)
+/*
+ * Node interning. fs->nodes maps paths to nodes so that every walk of a
+ * path returns the same node. A node no fid holds stays interned, idle,
+ * until more than CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE are idle; then
+ * the least recently released one is freed. All of it is protected by
+ * fs->lock.
+ */
+static struct ninep_fs_node **node_bucket(struct ninep_passthrough_fs *fs,
+                                          const char *path)
 {
-	if (!node) {
-		return;
+	return &fs->nodes[hash_path(path, 0) % ARRAY_SIZE(fs->nodes)];
+}
+
+static struct ninep_fs_node *find_node(struct ninep_passthrough_fs *fs,
+                                       const char *path)
+{
+	struct ninep_fs_node *node = *node_bucket(fs, path);
+
+	while (node) {
+		struct node_data *data = node->data;
+
+		if (strcmp(data->path, path) == 0) {
+			return node;
+		}
+		node = data->hash_next;
+	}
+	return NULL;
+}
+
+static void intern_node(struct ninep_passthrough_fs *fs, struct ninep_fs_node *node)
+{
+	struct node_data *data = node->data;
+	struct ninep_fs_node **bucket = node_bucket(fs, data->path);
+
+	data->hash_next = *bucket;
+	data->interned = true;
+	*bucket = node;
+}
+
+/* Forget node's path; an idle node is freed, a held one when released */
+static void unintern_node(struct ninep_passthrough_fs *fs, struct ninep_fs_node *node)
+{
+	struct node_data *data = node->data;
+	struct ninep_fs_node **link = node_bucket(fs, data->path);
+
+	while (*link != node) {
+		link = &((struct node_data *)(*link)->data)->hash_next;
+	}
+	*link = data->hash_next;
+	data->interned = false;
+
+	if (data->refs == 0) {
+		fs->idle_nodes--;
+		ninep_node_free(node);
+	}
+}
+
+static void evict_idle_node(struct ninep_passthrough_fs *fs)
+{
+	struct ninep_fs_node *lru = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(fs->nodes); i++) {
+		for (struct ninep_fs_node *node = fs->nodes[i]; node;
+		     node = ((struct node_data *)node->data)->hash_next) {
+			struct node_data *data = node->data;
+
+			if (data->refs == 0 &&
+			    (!lru || data->last_use <
+			     ((struct node_data *)lru->data)->last_use)) {
+				lru = node;
+			}
+		}
+	}
+	if (lru) {
+		unintern_node(fs, lru);
+	}
+}
+
+/* Take a fid's reference */
+static void get_node(struct ninep_passthrough_fs *fs, struct ninep_fs_node *node)
+{
+	struct node_data *data = node->data;
+
+	if (data->refs++ == 0 && data->interned) {
+		fs->idle_nodes--;
 	}
+}
+
+static void handle_close(struct ninep_passthrough_handle *h);
+
+/* Drop a fid's reference. The last one closes the file handle and leaves
+ * the node idle, or frees it if it is no longer interned. */
+static void put_node(struct ninep_passthrough_fs *fs, struct ninep_fs_node *node)
+{
+	struct node_data *data = node->data;
 
-	if (node->data) {
-		k_free(node->data);
+	if (node == fs->root || --data->refs > 0) {
+		return;
+	}
+	if (data->handle) {
+		handle_close(data->handle);
+	}
+	if (!data->interned) {
+		ninep_node_free(node);
+		return;
+	}
+	data->last_use = ++fs->handle_clock;
+	if (++fs->idle_nodes > CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE) {
+		evict_idle_node(fs);
 	}
-	k_free(node);
 }
 
 /* Get full path from node */
@@ -93,6 +312,132 @@ static int build_child_path(const char *parent_path, const char *child_name,
 	return 0;
 }
 
+/*
+ * Open file handles. Opened nodes keep a handle from fs->handles between
+ * reads and writes; all handle state is protected by fs->lock. Since the
+ * backing filesystem may not show one handle's unsynced writes through
+ * another (littlefs doesn't), dirty handles on a path are synced before
+ * that path is opened, read or stat'ed through anything else.
+ */
+
+static void handle_close(struct ninep_passthrough_handle *h)
+{
+	struct node_data *data = h->node->data;
+
+	fs_close(&h->file);
+	data->handle = NULL;
+	h->node = NULL;
+	h->dirty = false;
+}
+
+/* Sync dirty handles on path other than except */
+static void sync_path(struct ninep_passthrough_fs *fs, const char *path,
+                      struct ninep_passthrough_handle *except)
+{
+	for (int i = 0; i < ARRAY_SIZE(fs->handles); i++) {
+		struct ninep_passthrough_handle *h = &fs->handles[i];
+
+		if (h->node && h != except && h->dirty &&
+		    strcmp(get_node_path(h->node), path) == 0) {
+			fs_sync(&h->file);
+			h->dirty = false;
+		}
+	}
+}
+
+/* Close every handle on path */
+static void close_path(struct ninep_passthrough_fs *fs, const char *path)
+{
+	for (int i = 0; i < ARRAY_SIZE(fs->handles); i++) {
+		struct ninep_passthrough_handle *h = &fs->handles[i];
+
+		if (h->node && strcmp(get_node_path(h->node), path) == 0) {
+			handle_close(h);
+		}
+	}
+}
+
+/*
+ * Get node's open handle with at least the given access, (re)opening it if
+ * it was evicted or opened with less. Evicts the least recently used
+ * handle when all are taken. Caller holds fs->lock.
+ */
+static struct ninep_passthrough_handle *handle_get(struct ninep_passthrough_fs *fs,
+                                                   struct ninep_fs_node *node,
+                                                   fs_mode_t flags, int *err)
+{
+	struct node_data *data = node->data;
+	struct ninep_passthrough_handle *h = data->handle;
+
+	sync_path(fs, data->path, h);
+
+	if (h && (h->flags & flags) == flags) {
+		h->last_use = ++fs->handle_clock;
+		return h;
+	}
+	if (h) {
+		handle_close(h);
+	}
+
+	h = NULL;
+	for (int i = 0; i < ARRAY_SIZE(fs->handles); i++) {
+		struct ninep_passthrough_handle *cand = &fs->handles[i];
+
+		if (!cand->node) {
+			h = cand;
+			break;
+		}
+		if (!h || cand->last_use < h->last_use) {
+			h = cand;
+		}
+	}
+	if (h->node) {
+		LOG_DBG("Evicting handle for '%s'", get_node_path(h->node));
+		handle_close(h);
+	}
+
+	char fs_path[256];
+	snprintf(fs_path, sizeof(fs_path), "%s%s", fs->mount_point, data->path);
+
+	/* Only remembered once the open succeeds: a failed write open
+	 * must not make later reads ask for write access too */
+	fs_mode_t open_flags = data->flags | flags;
+
+	fs_file_t_init(&h->file);
+	int ret = fs_open(&h->file, fs_path, open_flags);
+	if (ret < 0) {
+		LOG_ERR("fs_open failed: %d", ret);
+		*err = ret;
+		return NULL;
+	}
+
+	data->flags = open_flags;
+	h->node = node;
+	h->pos = 0;
+	h->flags = open_flags;
+	h->dirty = false;
+	h->last_use = ++fs->handle_clock;
+	data->handle = h;
+	return h;
+}
+
+/* Position h at offset, skipping the seek when it is already there */
+static int handle_seek(struct ninep_passthrough_handle *h, uint64_t offset)
+{
+	if (h->pos == (off_t)offset) {
+		return 0;
+	}
+
+	int ret = fs_seek(&h->file, offset, FS_SEEK_SET);
+	if (ret < 0) {
+		LOG_ERR("fs_seek failed: %d", ret);
+		h->pos = -1;
+		return ret;
+	}
+	h->pos = offset;
+	return 0;
+}
+
 /* Get root */
 static struct ninep_fs_node *passthrough_get_root(void *fs_ctx)
 {
@@ -133,8 +478,25 @@ static struct ninep_fs_node *passthrough_walk(struct ninep_fs_node *parent,
 	LOG_DBG("Walk: looking for '%s' in '%s' -> fs_path='%s'",
 	        child_name, parent_path, fs_path);
 
+	/* A node already interned for the path needs no fs_stat() */
+	struct ninep_fs_node *node;
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	node = find_node(fs, child_path);
+	if (node) {
+		get_node(fs, node);
+		fs->node_hits++;
+		k_mutex_unlock(&fs->lock);
+		node->qid.version = qid_version(fs, node->qid.path);
+		return node;
+	}
+	fs->node_misses++;
+	sync_path(fs, child_path, NULL);
+	k_mutex_unlock(&fs->lock);
+
 	/* Stat the path to see if it exists */
 	struct fs_dirent entry;
+
 	int ret = fs_stat(fs_path, &entry);
 	if (ret < 0) {
 		LOG_DBG("Walk failed: fs_stat returned %d", ret);
@@ -146,25 +508,168 @@ static struct ninep_fs_node *passthrough_walk(struct ninep_fs_node *parent,
 	                             NINEP_NODE_DIR : NINEP_NODE_FILE;
 	uint32_t mode = (entry.type == FS_DIR_ENTRY_DIR) ? 0755 : 0644;
 
-	struct ninep_fs_node *node = alloc_node(fs, child_name, child_path,
-	                                          type, mode, entry.size);
+	node = alloc_node(fs, child_name, child_path, type, mode, entry.size);
 	if (!node) {
 		LOG_ERR("Walk failed: could not allocate node");
 		return NULL;
 	}
 
+	/* Another walk of the path may have interned it meanwhile */
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	struct ninep_fs_node *raced = find_node(fs, child_path);
+
+	if (raced) {
+		ninep_node_free(node);
+		get_node(fs, raced);
+		node = raced;
+	} else {
+		intern_node(fs, node);
+	}
+	k_mutex_unlock(&fs->lock);
+
 	return node;
 }
 
-/* Open node */
+/* Open node: files get a handle that stays open until clunk */
 static int passthrough_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 {
-	/* Zephyr FS doesn't require explicit open for stat/read operations */
-	/* We'll open files on-demand during read/write */
+	struct ninep_passthrough_fs *fs = fs_ctx;
+	fs_mode_t flags;
+	int ret = 0;
+
 	LOG_DBG("Open: node='%s' mode=%u", node->name, mode);
+
+	if (node->type != NINEP_NODE_FILE || !node->data) {
+		return 0;
+	}
+
+	/* Another fid may have written the file since this node was walked */
+	node->qid.version = qid_version(fs, node->qid.path);
+
+	switch (mode & 0x03) {
+	case NINEP_OWRITE:
+		flags = FS_O_WRITE;
+		break;
+	case NINEP_ORDWR:
+		flags = FS_O_RDWR;
+		break;
+	default:  /* NINEP_OREAD, NINEP_OEXEC */
+		flags = FS_O_READ;
+		break;
+	}
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	if (!handle_get(fs, node, flags, &ret)) {
+		k_mutex_unlock(&fs->lock);
+		return ret;
+	}
+	k_mutex_unlock(&fs->lock);
 	return 0;
 }
 
+/*
+ * Emit stat records for the entries of an open directory. Records wholly
+ * inside the first skip bytes are consumed unwritten. An entry that does
+ * not fit in count is kept in *pending for the next call. *pos counts
+ * the entries read from dir and consumed, so a rescan can skip them.
+ */
+static int dir_fill(struct ninep_passthrough_fs *fs, const char *dir_path,
+                    struct fs_dir_t *dir,
+                    struct fs_dirent *pending, bool *has_pending,
+                    uintptr_t *pos, uint64_t skip, uint8_t *buf,
+                    uint32_t count)
+{
+	size_t buf_offset = 0;
+	int entry_count = 0;
+
+	/* Iterate through directory entries */
+	while (true) {
+		struct fs_dirent entry;
+
+		if (*has_pending) {
+			entry = *pending;
+			*has_pending = false;
+		} else {
+			int ret = fs_readdir(dir, &entry);
+			if (ret < 0) {
+				LOG_ERR("fs_readdir failed: %d", ret);
+				return ret;
+			}
+		}
+
+		/* End of directory */
+		if (entry.name[0] == '\0') {
+			break;
+		}
+
+		/* Skip . and .. */
+		if (strcmp(entry.name, ".") == 0 || strcmp(entry.name, "..") == 0) {
+			(*pos)++;
+			continue;
+		}
+
+		LOG_DBG("  Entry: %s (type=%d, size=%zu)",
+		        entry.name, entry.type, entry.size);
+
+		/* Record size as written by ninep_write_stat: size[2] + type[2] +
+		 * dev[4] + qid[13] + mode[4] + atime[4] + mtime[4] + length[8] +
+		 * name[2+len] + uid[2+6] + gid[2+6] + muid[2+6]
+		 */
+		uint16_t name_len = strlen(entry.name);
+		uint32_t stat_size = 2 + 2 + 4 + 13 + 4 + 4 + 4 + 8 +
+		                     (2 + name_len) + (2 + 6) + (2 + 6) + (2 + 6);
+
+		if (skip >= stat_size) {
+			skip -= stat_size;
+			(*pos)++;
+			continue;
+		}
+		skip = 0;
+
+		if (buf_offset + stat_size > count) {
+			*pending = entry;
+			*has_pending = true;
+			break;
+		}
+
+		/* Build QID for this entry, the same one a walk would give */
+		char child_path[256];
+
+		build_child_path(dir_path, entry.name, child_path, sizeof(child_path));
+
+		struct ninep_qid entry_qid = {
+			.type = (entry.type == FS_DIR_ENTRY_DIR) ? NINEP_QTDIR : NINEP_QTFILE,
+			.path = path_qid(fs, child_path),
+		};
+		entry_qid.version = qid_version(fs, entry_qid.path);
+
+		/* Build mode */
+		uint32_t mode = (entry.type == FS_DIR_ENTRY_DIR) ? 0755 : 0644;
+		if (entry.type == FS_DIR_ENTRY_DIR) {
+			mode |= NINEP_DMDIR;
+		}
+
+		/* Write stat structure using helper */
+		size_t write_offset = 0;
+		int write_ret = ninep_write_stat(buf + buf_offset, count - buf_offset,
+		                                  &write_offset, &entry_qid, mode,
+		                                  entry.size, entry.name, name_len,
+		                                  NULL, NULL, NULL);  /* uid/gid/muid default to "zephyr" */
+
+		if (write_ret < 0) {
+			LOG_ERR("ninep_write_stat failed: %d", write_ret);
+			break;
+		}
+
+		buf_offset += write_offset;
+		entry_count++;
+		(*pos)++;
+	}
+
+	LOG_DBG("Directory read complete: %d entries, %zu bytes", entry_count, buf_offset);
+	return buf_offset;
+}
+
 /* Read from file or directory */
 static int passthrough_read(struct ninep_fs_node *node, uint64_t offset,
                              uint8_t *buf, uint32_t count, const char *uname,
@@ -185,6 +690,10 @@ static int passthrough_read(struct ninep_fs_node *node, uint64_t offset,
 		LOG_DBG("Reading directory: '%s' (offset=%llu, count=%u)", fs_path, offset, count);
 
 		struct fs_dir_t dir;
+		struct fs_dirent pending;
+		bool has_pending = false;
+		uintptr_t pos = 0;
+
 		fs_dir_t_init(&dir);
 
 		int ret = fs_opendir(&dir, fs_path);
@@ -193,113 +702,36 @@ static int passthrough_read(struct ninep_fs_node *node, uint64_t offset,
 			return ret;
 		}
 
-		size_t buf_offset = 0;
-		uint64_t current_offset = 0;
-		int entry_count = 0;
-
-		/* Iterate through directory entries */
-		while (true) {
-			struct fs_dirent entry;
-			ret = fs_readdir(&dir, &entry);
-			if (ret < 0) {
-				LOG_ERR("fs_readdir failed: %d", ret);
-				fs_closedir(&dir);
-				return ret;
-			}
-
-			/* End of directory */
-			if (entry.name[0] == '\0') {
-				break;
-			}
-
-			/* Skip . and .. */
-			if (strcmp(entry.name, ".") == 0 || strcmp(entry.name, "..") == 0) {
-				continue;
-			}
-
-			LOG_DBG("  Entry: %s (type=%d, size=%zu)",
-			        entry.name, entry.type, entry.size);
-
-			/* Build QID for this entry */
-			struct ninep_qid entry_qid = {
-				.type = (entry.type == FS_DIR_ENTRY_DIR) ? NINEP_QTDIR : NINEP_QTFILE,
-				.version = 0,
-				.path = fs->next_qid_path++
-			};
-
-			/* Build mode */
-			uint32_t mode = (entry.type == FS_DIR_ENTRY_DIR) ? 0755 : 0644;
-			if (entry.type == FS_DIR_ENTRY_DIR) {
-				mode |= NINEP_DMDIR;
-			}
-
-			/* Calculate stat size using ninep_write_stat's format:
-			 * type[2] + dev[4] + qid[13] + mode[4] + atime[4] + mtime[4] +
-			 * length[8] + name[2+len] + uid[2+6] + gid[2+6] + muid[2+6]
-			 */
-			uint16_t name_len = strlen(entry.name);
-			uint16_t stat_size = 2 + 4 + 13 + 4 + 4 + 4 + 8 +
-			                     (2 + name_len) + (2 + 6) + (2 + 6) + (2 + 6);
-
-			/* Check if this entry is past the requested offset */
-			if (current_offset >= offset) {
-				/* Check if we have space */
-				LOG_DBG("    Checking space: buf_offset=%zu + stat_size=%u > count=%u?",
-				        buf_offset, stat_size, count);
-				if (buf_offset + stat_size > count) {
-					LOG_DBG("    NO SPACE! Breaking.");
-					break;
-				}
-
-				/* Write stat structure using helper */
-				size_t write_offset = 0;
-				int write_ret = ninep_write_stat(buf + buf_offset, count - buf_offset,
-				                                  &write_offset, &entry_qid, mode,
-				                                  entry.size, entry.name, name_len,
-				                                  NULL, NULL, NULL);  /* uid/gid/muid default to "zephyr" */
-
-				if (write_ret < 0) {
-					LOG_ERR("ninep_write_stat failed: %d", write_ret);
-					break;
-				}
-
-				buf_offset += write_offset;
-				current_offset += write_offset;
-				entry_count++;
-			} else {
-				/* Skip this entry - update offset */
-				current_offset += stat_size;
-			}
-		}
-
+		ret = dir_fill(fs, node_path, &dir, &pending, &has_pending, &pos,
+		               offset, buf, count);
 		fs_closedir(&dir);
-		LOG_DBG("Directory read complete: %d entries, %zu bytes", entry_count, buf_offset);
-		return buf_offset;
+		return ret;
 
 	} else {
 		/* Read file content */
 		LOG_DBG("Reading file: '%s' offset=%llu count=%u", fs_path, offset, count);
 
-		struct fs_file_t file;
-		fs_file_t_init(&file);
+		int ret = 0;
+		struct ninep_passthrough_handle *h;
 
-		int ret = fs_open(&file, fs_path, FS_O_READ);
-		if (ret < 0) {
-			LOG_ERR("fs_open failed: %d", ret);
-			return ret;
+		k_mutex_lock(&fs->lock, K_FOREVER);
+		h = handle_get(fs, node, FS_O_READ, &ret);
+		if (h) {
+			ret = handle_seek(h, offset);
 		}
-
-		/* Seek to offset */
-		ret = fs_seek(&file, offset, FS_SEEK_SET);
 		if (ret < 0) {
-			LOG_ERR("fs_seek failed: %d", ret);
-			fs_close(&file);
+			k_mutex_unlock(&fs->lock);
 			return ret;
 		}
 
 		/* Read data */
-		ssize_t bytes_read = fs_read(&file, buf, count);
-		fs_close(&file);
+		ssize_t bytes_read = fs_read(&h->file, buf, count);
+		if (bytes_read < 0) {
+			h->pos = -1;
+		} else {
+			h->pos += bytes_read;
+		}
+		k_mutex_unlock(&fs->lock);
 
 		if (bytes_read < 0) {
 			LOG_ERR("fs_read failed: %zd", bytes_read);
@@ -311,6 +743,179 @@ static int passthrough_read(struct ninep_fs_node *node, uint64_t offset,
 	}
 }
 
+/*
+ * Open directories kept between reads. A listing holds a slot from
+ * fs->dirs until it reaches its end; the least recently used slot is
+ * taken over when all are in use. The slot remembers its cursor, so a
+ * cursor whose slot was taken over sees that and rescans instead.
+ * Protected by fs->lock, like the file handles.
+ */
+
+static void dir_close(struct ninep_passthrough_dir *d)
+{
+	fs_closedir(&d->dir);
+	d->cur = NULL;
+	d->has_pending = false;
+}
+
+/* A free slot if free_ok and there is one, else the least recently used
+ * slot in use; NULL if none is in use */
+static struct ninep_passthrough_dir *dir_victim(struct ninep_passthrough_fs *fs,
+                                                bool free_ok)
+{
+	struct ninep_passthrough_dir *d = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(fs->dirs); i++) {
+		struct ninep_passthrough_dir *cand = &fs->dirs[i];
+
+		if (!cand->cur) {
+			if (free_ok) {
+				return cand;
+			}
+			continue;
+		}
+		if (!d || cand->last_use < d->last_use) {
+			d = cand;
+		}
+	}
+	return d;
+}
+
+/*
+ * Open fs_path into a slot for cur and skip the cur->pos entries already
+ * consumed. If the filesystem has no directory left to give, the other
+ * kept listings are closed one by one until it does. Caller holds
+ * fs->lock.
+ */
+static struct ninep_passthrough_dir *dir_get(struct ninep_passthrough_fs *fs,
+                                             const char *fs_path,
+                                             struct ninep_dir_cursor *cur,
+                                             int *err)
+{
+	struct ninep_passthrough_dir *d = dir_victim(fs, true);
+	int ret;
+
+	if (d->cur) {
+		LOG_DBG("Evicting open directory slot %d", (int)(d - fs->dirs));
+		dir_close(d);
+	}
+
+	while (true) {
+		fs_dir_t_init(&d->dir);
+		ret = fs_opendir(&d->dir, fs_path);
+		if (ret == 0) {
+			break;
+		}
+
+		struct ninep_passthrough_dir *victim = dir_victim(fs, false);
+
+		if (!victim) {
+			LOG_ERR("fs_opendir failed: %d", ret);
+			*err = ret;
+			return NULL;
+		}
+		dir_close(victim);
+	}
+
+	for (uintptr_t i = 0; i < cur->pos; i++) {
+		struct fs_dirent entry;
+
+		ret = fs_readdir(&d->dir, &entry);
+		if (ret < 0) {
+			LOG_ERR("fs_readdir failed: %d", ret);
+			fs_closedir(&d->dir);
+			*err = ret;
+			return NULL;
+		}
+		if (entry.name[0] == '\0') {
+			break;
+		}
+	}
+
+	d->cur = cur;
+	d->has_pending = false;
+	cur->state = d;
+	return d;
+}
+
+/* Read directory entries, keeping the directory open between reads */
+static int passthrough_readdir(struct ninep_fs_node *node, uint64_t offset,
+                               uint8_t *buf, uint32_t count,
+                               struct ninep_dir_cursor *cur, const char *uname,
+                               void *fs_ctx)
+{
+	struct ninep_passthrough_fs *fs = fs_ctx;
+	const char *node_path = get_node_path(node);
+	struct ninep_passthrough_dir *d;
+	uint64_t skip = 0;
+	int ret = 0;
+
+	if (node->type != NINEP_NODE_DIR) {
+		return -ENOTDIR;
+	}
+	if (!node_path) {
+		return -EINVAL;
+	}
+
+	char fs_path[256];
+	snprintf(fs_path, sizeof(fs_path), "%s%s", fs->mount_point, node_path);
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+
+	/* A slot taken over by another listing is no longer ours */
+	d = cur->state;
+	if (d && d->cur != cur) {
+		d = NULL;
+		cur->state = NULL;
+	}
+
+	/* Not where the last read ended: start over and skip offset bytes */
+	if (offset == 0 || offset != cur->offset) {
+		if (d) {
+			dir_close(d);
+			d = NULL;
+			cur->state = NULL;
+		}
+		cur->pos = 0;
+		skip = offset;
+	}
+
+	if (!d) {
+		d = dir_get(fs, fs_path, cur, &ret);
+		if (!d) {
+			k_mutex_unlock(&fs->lock);
+			return ret;
+		}
+	}
+	d->last_use = ++fs->handle_clock;
+
+	ret = dir_fill(fs, node_path, &d->dir, &d->pending, &d->has_pending,
+	               &cur->pos, skip, buf, count);
+
+	/* Listing done (or failed): give the directory back right away */
+	if (ret < 0 || (ret == 0 && !d->has_pending)) {
+		dir_close(d);
+		cur->state = NULL;
+	}
+	k_mutex_unlock(&fs->lock);
+	return ret;
+}
+
+/* Close the directory held by a fid's cursor */
+static void passthrough_releasedir(struct ninep_fs_node *node,
+                                   struct ninep_dir_cursor *cur, void *fs_ctx)
+{
+	struct ninep_passthrough_fs *fs = fs_ctx;
+	struct ninep_passthrough_dir *d = cur->state;
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	if (d && d->cur == cur) {
+		dir_close(d);
+	}
+	cur->state = NULL;
+	k_mutex_unlock(&fs->lock);
+}
+
 /* Write to file */
 static int passthrough_write(struct ninep_fs_node *node, uint64_t offset,
                               const uint8_t *buf, uint32_t count, const char *uname,
@@ -333,26 +938,28 @@ static int passthrough_write(struct ninep_fs_node *node, uint64_t offset,
 
 	LOG_DBG("Writing to file: '%s' offset=%llu count=%u", fs_path, offset, count);
 
-	struct fs_file_t file;
-	fs_file_t_init(&file);
+	int ret = 0;
+	struct ninep_passthrough_handle *h;
 
-	int ret = fs_open(&file, fs_path, FS_O_WRITE);
-	if (ret < 0) {
-		LOG_ERR("fs_open failed: %d", ret);
-		return ret;
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	h = handle_get(fs, node, FS_O_WRITE, &ret);
+	if (h) {
+		ret = handle_seek(h, offset);
 	}
-
-	/* Seek to offset */
-	ret = fs_seek(&file, offset, FS_SEEK_SET);
 	if (ret < 0) {
-		LOG_ERR("fs_seek failed: %d", ret);
-		fs_close(&file);
+		k_mutex_unlock(&fs->lock);
 		return ret;
 	}
 
 	/* Write data */
-	ssize_t bytes_written = fs_write(&file, buf, count);
-	fs_close(&file);
+	ssize_t bytes_written = fs_write(&h->file, buf, count);
+	if (bytes_written < 0) {
+		h->pos = -1;
+	} else {
+		h->pos += bytes_written;
+		h->dirty = true;
+	}
+	k_mutex_unlock(&fs->lock);
 
 	if (bytes_written < 0) {
 		LOG_ERR("fs_write failed: %zd", bytes_written);
@@ -363,6 +970,7 @@ static int passthrough_write(struct ninep_fs_node *node, uint64_t offset,
 	if (offset + bytes_written > node->length) {
 		node->length = offset + bytes_written;
 	}
+	node->qid.version = bump_version(fs, node->qid.path);
 
 	LOG_DBG("Wrote %zd bytes to file", bytes_written);
 	return bytes_written;
@@ -372,10 +980,14 @@ static int passthrough_write(struct ninep_fs_node *node, uint64_t offset,
 static int passthrough_stat(struct ninep_fs_node *node, uint8_t *buf,
                              size_t buf_len, void *fs_ctx)
 {
+	struct ninep_passthrough_fs *fs = fs_ctx;
+
 	if (!node || !buf) {
 		return -EINVAL;
 	}
 
+	node->qid.version = qid_version(fs, node->qid.path);
+
 	size_t offset = 0;
 	uint16_t name_len = strlen(node->name);
 
@@ -446,6 +1058,9 @@ static int passthrough_create(struct ninep_fs_node *parent, const char *name,
 		node_mode = 0644;
 	}
 
+	/* A file recreated under an old name must not match cached data */
+	bump_version(fs, path_qid(fs, child_path));
+
 	/* Create node */
 	struct ninep_fs_node *node = alloc_node(fs, child_name, child_path,
 	                                          node_type, node_mode, 0);
@@ -453,6 +1068,18 @@ static int passthrough_create(struct ninep_fs_node *parent, const char *name,
 		return -ENOMEM;
 	}
 
+	/* The new node replaces any interned for the path; the fid that held
+	 * parent now holds it */
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	struct ninep_fs_node *old = find_node(fs, child_path);
+
+	if (old) {
+		unintern_node(fs, old);
+	}
+	intern_node(fs, node);
+	put_node(fs, parent);
+	k_mutex_unlock(&fs->lock);
+
 	*new_node = node;
 	LOG_DBG("Created: %s", fs_path);
 	return 0;
@@ -473,28 +1100,68 @@ static int passthrough_remove(struct ninep_fs_node *node, void *fs_ctx)
 
 	LOG_DBG("Remove: path='%s'", fs_path);
 
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	close_path(fs, node_path);
+	k_mutex_unlock(&fs->lock);
+
 	int ret = fs_unlink(fs_path);
 	if (ret < 0) {
 		LOG_ERR("fs_unlink failed: %d", ret);
 		return ret;
 	}
+	bump_version(fs, node->qid.path);
 
-	/* Free the node */
-	free_node(node);
+	/* Tremove drops the fid without a clunk */
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	if (((struct node_data *)node->data)->interned) {
+		unintern_node(fs, node);
+	}
+	put_node(fs, node);
+	k_mutex_unlock(&fs->lock);
 
 	LOG_DBG("Removed: %s", fs_path);
 	return 0;
 }
 
+/* Clunk: drop the fid's reference; the last one closes the file handle
+ * and frees the node */
+static int passthrough_clunk(struct ninep_fs_node *node, void *fs_ctx)
+{
+	struct ninep_passthrough_fs *fs = fs_ctx;
+
+	if (!node || !node->data) {
+		return 0;
+	}
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	put_node(fs, node);
+	k_mutex_unlock(&fs->lock);
+	return 0;
+}
+
+/* A cloned fid shares node */
+static void passthrough_ref(struct ninep_fs_node *node, void *fs_ctx)
+{
+	struct ninep_passthrough_fs *fs = fs_ctx;
+
+	k_mutex_lock(&fs->lock, K_FOREVER);
+	get_node(fs, node);
+	k_mutex_unlock(&fs->lock);
+}
+
 static const struct ninep_fs_ops passthrough_fs_ops = {
 	.get_root = passthrough_get_root,
 	.walk = passthrough_walk,
 	.open = passthrough_open,
 	.read = passthrough_read,
+	.readdir = passthrough_readdir,
+	.releasedir = passthrough_releasedir,
 	.write = passthrough_write,
 	.stat = passthrough_stat,
 	.create = passthrough_create,
 	.remove = passthrough_remove,
+	.clunk = passthrough_clunk,
+	.ref = passthrough_ref,
 };
 
 const struct ninep_fs_ops *ninep_passthrough_fs_get_ops(void)
@@ -511,7 +1178,7 @@ int ninep_passthrough_fs_init(struct ninep_passthrough_fs *fs,
 
 	memset(fs, 0, sizeof(*fs));
 	fs->mount_point = mount_point;
-	fs->next_qid_path = 1;
+	k_mutex_init(&fs->lock);
 
 	/* Create root node */
 	fs->root = alloc_node(fs, "/", "/", NINEP_NODE_DIR, 0755, 0);
@@ -4,6 +4,7 @@
  */
 
 #include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/node_alloc.h>
 #include <zephyr/9p/protocol.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -12,44 +13,519 @@
 
 LOG_MODULE_REGISTER(ninep_ramfs, CONFIG_NINEP_LOG_LEVEL);
 
+#define CHUNK_SIZE CONFIG_NINEP_RAMFS_CHUNK_SIZE
+
+#if CONFIG_NINEP_RAMFS_CHUNKS > 0
+K_MEM_SLAB_DEFINE_STATIC(chunk_slab, CONFIG_NINEP_RAMFS_CHUNK_SIZE,
+                         CONFIG_NINEP_RAMFS_CHUNKS, 4);
+#endif
+
+/* Where a file's content lives */
+enum ramfs_storage {
+	RAMFS_HEAP,    /* One k_malloc'd copy, from ninep_ramfs_create_file() */
+	RAMFS_STATIC,  /* Caller-owned and read-only, node->data points at it */
+	RAMFS_CHUNKS,  /* Slab chunks, node->data unused */
+};
+
+/*
+ * ramfs node. Every fid on a node holds a reference (taken by get_root,
+ * walk and ref, dropped by clunk, remove and create's hand-over), and
+ * read_ref spans of HEAP or CHUNKS content are borrows. A removed node is
+ * unlinked at once and freed when both counts reach zero; writers wait
+ * for borrows to drain before changing content.
+ */
+struct ramfs_node {
+	struct ninep_fs_node node;
+	struct ninep_ramfs *ramfs;
+	uint32_t refs;
+	uint32_t borrows;
+	uint32_t gen;          /* Directories: bumped when children change */
+	uint8_t storage;       /* enum ramfs_storage */
+	bool removed;
+	uint8_t **chunks;      /* RAMFS_CHUNKS; NULL entries read as zeros */
+	uint32_t nchunks;      /* Entries in chunks */
+	uint32_t hash;         /* Name hash, for the parent's index */
+	struct ramfs_node *hash_next;
+	struct ninep_fs_node *prev_sibling;
+	/* Directories: children by name hash, built once there are
+	 * dir_index_min of them. The sibling list keeps listing order. */
+	struct ramfs_node **index;
+	uint32_t index_size;   /* Buckets, a power of two */
+	uint32_t nchildren;
+};
+
+static inline struct ramfs_node *rnode(struct ninep_fs_node *node)
+{
+	return CONTAINER_OF(node, struct ramfs_node, node);
+}
+
+/* FNV-1a */
+static uint32_t name_hash(const char *name, size_t len)
+{
+	uint32_t h = 2166136261u;
+
+	for (size_t i = 0; i < len; i++) {
+		h = (h ^ (uint8_t)name[i]) * 16777619u;
+	}
+	return h;
+}
+
 /* Helper to allocate node */
 static struct ninep_fs_node *alloc_node(struct ninep_ramfs *ramfs,
-                                         const char *name,
+                                         const char *name, size_t name_len,
                                          enum ninep_node_type type)
 {
-	struct ninep_fs_node *node = k_malloc(sizeof(struct ninep_fs_node));
+	struct ninep_fs_node *node = ninep_node_alloc(sizeof(struct ramfs_node),
+	                                              name, name_len);
 
 	if (!node) {
 		return NULL;
 	}
 
-	memset(node, 0, sizeof(*node));
-	strncpy(node->name, name, sizeof(node->name) - 1);
+	struct ramfs_node *rn = rnode(node);
+
+	rn->ramfs = ramfs;
+	rn->storage = RAMFS_HEAP;
+	rn->hash = name_hash(name, name_len);
 	node->type = type;
 	node->mode = (type == NINEP_NODE_DIR) ? 0755 : 0644;
 	node->qid.path = ramfs->next_qid_path++;
 	node->qid.version = 0;
 	node->qid.type = (type == NINEP_NODE_DIR) ? NINEP_QTDIR : NINEP_QTFILE;
 
+	ramfs->nodes++;
+	ramfs->meta_bytes += sizeof(*rn) + name_len + 1;
 	return node;
 }
 
+/* Release a file's content; it reads as empty afterwards */
+static void free_content(struct ramfs_node *rn)
+{
+	struct ninep_ramfs *ramfs = rn->ramfs;
+
+	if (rn->storage == RAMFS_CHUNKS) {
+		for (uint32_t i = 0; i < rn->nchunks; i++) {
+			if (rn->chunks[i]) {
+#if CONFIG_NINEP_RAMFS_CHUNKS > 0
+				k_mem_slab_free(&chunk_slab, rn->chunks[i]);
+#endif
+				ramfs->chunk_bytes -= CHUNK_SIZE;
+			}
+		}
+		k_free(rn->chunks);
+		ramfs->meta_bytes -= rn->nchunks * sizeof(rn->chunks[0]);
+		rn->chunks = NULL;
+		rn->nchunks = 0;
+	} else if (rn->storage == RAMFS_HEAP) {
+		k_free(rn->node.data);
+	}
+	rn->node.data = NULL;
+	rn->node.length = 0;
+}
+
+/* Free a removed node once no fid or borrow is left on it */
+static void maybe_free(struct ramfs_node *rn)
+{
+	if (!rn->removed || rn->refs || rn->borrows) {
+		return;
+	}
+
+	free_content(rn);
+	k_free(rn->index);
+	rn->ramfs->meta_bytes -= rn->index_size * sizeof(rn->index[0]);
+	rn->ramfs->nodes--;
+	rn->ramfs->meta_bytes -= sizeof(*rn) + strlen(rn->node.name) + 1;
+	ninep_node_free(&rn->node);
+}
+
+/* Wait until no read_ref span of rn's content is outstanding */
+static void wait_borrows(struct ramfs_node *rn)
+{
+	while (rn->borrows) {
+		k_condvar_wait(&rn->ramfs->borrows_done, &rn->ramfs->lock,
+		               K_FOREVER);
+	}
+}
+
+static void release_borrow(void *arg)
+{
+	struct ramfs_node *rn = arg;
+	struct ninep_ramfs *ramfs = rn->ramfs;
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (--rn->borrows == 0) {
+		k_condvar_broadcast(&ramfs->borrows_done);
+		maybe_free(rn);
+	}
+	k_mutex_unlock(&ramfs->lock);
+}
+
+/* Grow the chunk table to at least n entries */
+static int reserve_chunks(struct ramfs_node *rn, uint32_t n)
+{
+	if (n <= rn->nchunks) {
+		return 0;
+	}
+
+	uint32_t slots = MAX(n, MAX(rn->nchunks * 2, 4U));
+	uint8_t **table = k_malloc(slots * sizeof(*table));
+
+	if (!table) {
+		return -ENOSPC;
+	}
+	if (rn->nchunks) {
+		memcpy(table, rn->chunks, rn->nchunks * sizeof(*table));
+	}
+	memset(&table[rn->nchunks], 0, (slots - rn->nchunks) * sizeof(*table));
+	k_free(rn->chunks);
+
+	rn->ramfs->meta_bytes += (slots - rn->nchunks) * sizeof(*table);
+	rn->chunks = table;
+	rn->nchunks = slots;
+	return 0;
+}
+
+/* Chunks missing in [first, last], i.e. what writing there will allocate */
+static uint32_t missing_chunks(struct ramfs_node *rn, uint32_t first,
+                               uint32_t last)
+{
+	uint32_t n = 0;
+
+	for (uint32_t i = first; i <= last; i++) {
+		if (i >= rn->nchunks || !rn->chunks[i]) {
+			n++;
+		}
+	}
+	return n;
+}
+
+/* Check that n more chunks fit this instance's budget and the slab */
+static int can_alloc(struct ninep_ramfs *ramfs, uint32_t n)
+{
+#if CONFIG_NINEP_RAMFS_CHUNKS > 0
+	if (ramfs->max_bytes &&
+	    ramfs->chunk_bytes + (size_t)n * CHUNK_SIZE > ramfs->max_bytes) {
+		return -ENOSPC;
+	}
+	if (n > k_mem_slab_num_free_get(&chunk_slab)) {
+		return -ENOSPC;
+	}
+	return 0;
+#else
+	return n ? -ENOSPC : 0;
+#endif
+}
+
+/* Make sure chunk i exists, zero-filled when new. Table must cover i. */
+static int get_chunk(struct ramfs_node *rn, uint32_t i)
+{
+	if (rn->chunks[i]) {
+		return 0;
+	}
+
+#if CONFIG_NINEP_RAMFS_CHUNKS > 0
+	void *mem;
+
+	if (can_alloc(rn->ramfs, 1) < 0 ||
+	    k_mem_slab_alloc(&chunk_slab, &mem, K_NO_WAIT) < 0) {
+		return -ENOSPC;
+	}
+	memset(mem, 0, CHUNK_SIZE);
+	rn->chunks[i] = mem;
+	rn->ramfs->chunk_bytes += CHUNK_SIZE;
+	return 0;
+#else
+	return -ENOSPC;
+#endif
+}
+
+/* Copy count bytes at offset into chunks, allocating as needed */
+static int write_chunks(struct ramfs_node *rn, uint64_t offset,
+                        const uint8_t *buf, uint32_t count)
+{
+	uint64_t end = offset + count;
+
+	if (count == 0) {
+		return 0;
+	}
+	if (end < offset || DIV_ROUND_UP(end, CHUNK_SIZE) > UINT32_MAX) {
+		return -EFBIG;
+	}
+
+	uint32_t first = offset / CHUNK_SIZE;
+	uint32_t last = (end - 1) / CHUNK_SIZE;
+	int ret = can_alloc(rn->ramfs, missing_chunks(rn, first, last));
+
+	if (ret == 0) {
+		ret = reserve_chunks(rn, last + 1);
+	}
+	for (uint32_t i = first; ret == 0 && i <= last; i++) {
+		ret = get_chunk(rn, i);
+	}
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (offset < end) {
+		uint32_t in = offset % CHUNK_SIZE;
+		uint32_t n = MIN(CHUNK_SIZE - in, end - offset);
+
+		memcpy(&rn->chunks[offset / CHUNK_SIZE][in], buf, n);
+		buf += n;
+		offset += n;
+	}
+	return 0;
+}
+
+/* Copy count bytes at offset out of chunks; caller clips to the length */
+static void read_chunks(struct ramfs_node *rn, uint64_t offset, uint8_t *buf,
+                        uint32_t count)
+{
+	while (count) {
+		uint32_t i = offset / CHUNK_SIZE;
+		uint32_t in = offset % CHUNK_SIZE;
+		uint32_t n = MIN(CHUNK_SIZE - in, count);
+
+		if (i < rn->nchunks && rn->chunks[i]) {
+			memcpy(buf, &rn->chunks[i][in], n);
+		} else {
+			memset(buf, 0, n);
+		}
+		buf += n;
+		offset += n;
+		count -= n;
+	}
+}
+
+/* Move HEAP content into chunks so it can be changed; no-op for CHUNKS */
+static int to_chunks(struct ramfs_node *rn)
+{
+	if (rn->storage != RAMFS_HEAP) {
+		return 0;
+	}
+
+	uint8_t *content = rn->node.data;
+	uint64_t length = rn->node.length;
+
+	rn->storage = RAMFS_CHUNKS;
+	int ret = write_chunks(rn, 0, content, length);
+
+	if (ret < 0) {
+		/* Put the heap copy back; free_content() sees CHUNKS */
+		rn->node.data = NULL;
+		free_content(rn);
+		rn->storage = RAMFS_HEAP;
+		rn->node.data = content;
+		rn->node.length = length;
+		return ret;
+	}
+
+	k_free(content);
+	rn->node.data = NULL;
+	return 0;
+}
+
+/* Truncate with the lock held */
+static int truncate_locked(struct ramfs_node *rn, uint64_t length)
+{
+	struct ninep_fs_node *node = &rn->node;
+
+	if (node->type == NINEP_NODE_DIR) {
+		return -EISDIR;
+	}
+	if (rn->storage == RAMFS_STATIC) {
+		return -EACCES;
+	}
+	if (rn->removed) {
+		return -ENOENT;
+	}
+
+	wait_borrows(rn);
+
+	if (rn->storage == RAMFS_HEAP && length == 0) {
+		free_content(rn);
+		rn->storage = RAMFS_CHUNKS;
+	} else {
+		int ret = to_chunks(rn);
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (length < node->length) {
+		/* Free whole chunks past the end; zero the tail of the last so
+		 * growing the file again reads zeros */
+		uint32_t keep = DIV_ROUND_UP(length, CHUNK_SIZE);
+
+		for (uint32_t i = keep; i < rn->nchunks; i++) {
+			if (rn->chunks[i]) {
+#if CONFIG_NINEP_RAMFS_CHUNKS > 0
+				k_mem_slab_free(&chunk_slab, rn->chunks[i]);
+#endif
+				rn->chunks[i] = NULL;
+				rn->ramfs->chunk_bytes -= CHUNK_SIZE;
+			}
+		}
+		if (length % CHUNK_SIZE && keep <= rn->nchunks &&
+		    rn->chunks[keep - 1]) {
+			uint32_t in = length % CHUNK_SIZE;
+
+			memset(&rn->chunks[keep - 1][in], 0, CHUNK_SIZE - in);
+		}
+	}
+
+	node->length = length;
+	node->qid.version++;
+	return 0;
+}
+
+static void index_insert(struct ramfs_node *dir, struct ramfs_node *child)
+{
+	struct ramfs_node **bucket = &dir->index[child->hash & (dir->index_size - 1)];
+
+	child->hash_next = *bucket;
+	*bucket = child;
+}
+
+/* (Re)build dir's index with size buckets. On allocation failure the
+ * old index, or the linear scan, stays in use. */
+static void index_build(struct ramfs_node *dir, uint32_t size)
+{
+	struct ramfs_node **index = k_malloc(size * sizeof(*index));
+
+	if (!index) {
+		return;
+	}
+	memset(index, 0, size * sizeof(*index));
+
+	k_free(dir->index);
+	dir->ramfs->meta_bytes += (size - dir->index_size) * sizeof(*index);
+	dir->index = index;
+	dir->index_size = size;
+
+	for (struct ninep_fs_node *c = dir->node.children; c; c = c->next_sibling) {
+		index_insert(dir, rnode(c));
+	}
+}
+
 /* Helper to add child to parent */
 static void add_child(struct ninep_fs_node *parent, struct ninep_fs_node *child)
 {
+	struct ramfs_node *dir = rnode(parent);
+
 	LOG_DBG("Adding child '%s' to parent '%s' (parent=%p, child=%p)",
 	        child->name, parent->name, parent, child);
 	child->parent = parent;
 	child->next_sibling = parent->children;
+	rnode(child)->prev_sibling = NULL;
+	if (parent->children) {
+		rnode(parent->children)->prev_sibling = child;
+	}
 	parent->children = child;
+	dir->nchildren++;
+	dir->gen++;
+	parent->qid.version++;
+
+	if (dir->index) {
+		index_insert(dir, rnode(child));
+		if (dir->nchildren > 2 * dir->index_size) {
+			index_build(dir, 2 * dir->index_size);
+		}
+	}
 	LOG_DBG("After add_child: parent->children=%p", parent->children);
 }
 
+/* Unlink child from its parent's list */
+static void remove_child(struct ninep_fs_node *child)
+{
+	struct ninep_fs_node *parent = child->parent;
+	struct ramfs_node *dir = rnode(parent);
+	struct ramfs_node *rc = rnode(child);
+
+	if (rc->prev_sibling) {
+		rc->prev_sibling->next_sibling = child->next_sibling;
+	} else {
+		parent->children = child->next_sibling;
+	}
+	if (child->next_sibling) {
+		rnode(child->next_sibling)->prev_sibling = rc->prev_sibling;
+	}
+
+	if (dir->index) {
+		struct ramfs_node **link = &dir->index[rc->hash & (dir->index_size - 1)];
+
+		while (*link && *link != rc) {
+			link = &(*link)->hash_next;
+		}
+		if (*link) {
+			*link = rc->hash_next;
+		}
+		rc->hash_next = NULL;
+	}
+
+	child->parent = NULL;
+	child->next_sibling = NULL;
+	rc->prev_sibling = NULL;
+	dir->nchildren--;
+	dir->gen++;
+	parent->qid.version++;
+}
+
+static bool name_is(struct ninep_fs_node *node, const char *name,
+                    uint16_t name_len)
+{
+	return strlen(node->name) == name_len &&
+	       strncmp(node->name, name, name_len) == 0;
+}
+
+/* Child of parent named name, or NULL */
+static struct ninep_fs_node *find_child(struct ninep_fs_node *parent,
+                                        const char *name, uint16_t name_len)
+{
+	struct ramfs_node *dir = rnode(parent);
+	uint32_t min = dir->ramfs->dir_index_min;
+
+	if (!dir->index && min && dir->nchildren >= min) {
+		/* Buckets for up to two children each before growing */
+		uint32_t size = 8;
+
+		while (size * 2 < dir->nchildren) {
+			size *= 2;
+		}
+		index_build(dir, size);
+	}
+
+	if (dir->index) {
+		uint32_t hash = name_hash(name, name_len);
+		struct ramfs_node *rc = dir->index[hash & (dir->index_size - 1)];
+
+		for (; rc; rc = rc->hash_next) {
+			if (rc->hash == hash && name_is(&rc->node, name, name_len)) {
+				return &rc->node;
+			}
+		}
+		return NULL;
+	}
+
+	for (struct ninep_fs_node *child = parent->children; child;
+	     child = child->next_sibling) {
+		if (name_is(child, name, name_len)) {
+			return child;
+		}
+	}
+	return NULL;
+}
+
 /* Get root */
 static struct ninep_fs_node *ramfs_get_root(void *fs_ctx)
 {
 	struct ninep_ramfs *ramfs = fs_ctx;
 
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	rnode(ramfs->root)->refs++;
+	k_mutex_unlock(&ramfs->lock);
+
 	return ramfs->root;
 }
 
@@ -58,37 +534,192 @@ static struct ninep_fs_node *ramfs_walk(struct ninep_fs_node *parent,
                                          const char *name, uint16_t name_len,
                                          void *fs_ctx)
 {
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ninep_fs_node *child;
+
 	if (!parent || parent->type != NINEP_NODE_DIR) {
 		return NULL;
 	}
 
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+
 	/* walk(5): "." is the current directory; ".." is the parent, and
 	 * stays at the root when the root has no parent. */
 	if (name_len == 1 && name[0] == '.') {
-		return parent;
+		child = parent;
+	} else if (name_len == 2 && name[0] == '.' && name[1] == '.') {
+		child = parent->parent ? parent->parent : parent;
+	} else {
+		child = find_child(parent, name, name_len);
 	}
-	if (name_len == 2 && name[0] == '.' && name[1] == '.') {
-		return parent->parent ? parent->parent : parent;
+
+	if (child) {
+		rnode(child)->refs++;
 	}
+	k_mutex_unlock(&ramfs->lock);
 
-	struct ninep_fs_node *child = parent->children;
+	return child;
+}
 
-	while (child) {
-		if (strlen(child->name) == name_len &&
-		    strncmp(child->name, name, name_len) == 0) {
-			return child;
-		}
-		child = child->next_sibling;
+/* Open node; OTRUNC empties a file */
+static int ramfs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
+{
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ramfs_node *rn = rnode(node);
+	bool writing = (mode & 0x03) == NINEP_OWRITE ||
+	               (mode & 0x03) == NINEP_ORDWR || (mode & NINEP_OTRUNC);
+	int ret = 0;
+
+	if (!writing) {
+		return 0;
+	}
+	if (node->type == NINEP_NODE_DIR) {
+		return -EISDIR;
 	}
 
-	return NULL;
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (rn->removed) {
+		ret = -ENOENT;
+	} else if (rn->storage == RAMFS_STATIC) {
+		ret = -EACCES;
+	} else if ((mode & NINEP_OTRUNC) && node->length > 0) {
+		ret = truncate_locked(rn, 0);
+	}
+	k_mutex_unlock(&ramfs->lock);
+
+	return ret;
 }
 
-/* Open node */
-static int ramfs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
+/* Bytes of a child's stat record in a directory read, size[2] included */
+static uint32_t dirent_size(const struct ninep_fs_node *child)
 {
-	/* RAM FS supports all open modes */
-	return 0;
+	return 2 + 2 + 4 + 13 + 4 + 4 + 4 + 8 +
+	       2 + strlen(child->name) +
+	       2 + 0 +  /* uid */
+	       2 + 0 +  /* gid */
+	       2 + 0;   /* muid */
+}
+
+/* Encode a child's stat record at buf; returns its size */
+static size_t put_dirent(uint8_t *buf, const struct ninep_fs_node *child)
+{
+	uint16_t stat_size = dirent_size(child) - 2;
+	size_t off = 0;
+
+	/* size[2] */
+	buf[off++] = stat_size & 0xFF;
+	buf[off++] = (stat_size >> 8) & 0xFF;
+
+	/* type[2] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	/* dev[4] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	/* qid[13] */
+	buf[off++] = child->qid.type;
+	buf[off++] = child->qid.version & 0xFF;
+	buf[off++] = (child->qid.version >> 8) & 0xFF;
+	buf[off++] = (child->qid.version >> 16) & 0xFF;
+	buf[off++] = (child->qid.version >> 24) & 0xFF;
+	buf[off++] = child->qid.path & 0xFF;
+	buf[off++] = (child->qid.path >> 8) & 0xFF;
+	buf[off++] = (child->qid.path >> 16) & 0xFF;
+	buf[off++] = (child->qid.path >> 24) & 0xFF;
+	buf[off++] = (child->qid.path >> 32) & 0xFF;
+	buf[off++] = (child->qid.path >> 40) & 0xFF;
+	buf[off++] = (child->qid.path >> 48) & 0xFF;
+	buf[off++] = (child->qid.path >> 56) & 0xFF;
+
+	/* mode[4] */
+	uint32_t mode = child->mode;
+
+	if (child->type == NINEP_NODE_DIR) {
+		mode |= NINEP_DMDIR;
+	}
+	buf[off++] = mode & 0xFF;
+	buf[off++] = (mode >> 8) & 0xFF;
+	buf[off++] = (mode >> 16) & 0xFF;
+	buf[off++] = (mode >> 24) & 0xFF;
+
+	/* atime[4] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	/* mtime[4] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	/* length[8] */
+	uint64_t len = child->length;
+
+	buf[off++] = len & 0xFF;
+	buf[off++] = (len >> 8) & 0xFF;
+	buf[off++] = (len >> 16) & 0xFF;
+	buf[off++] = (len >> 24) & 0xFF;
+	buf[off++] = (len >> 32) & 0xFF;
+	buf[off++] = (len >> 40) & 0xFF;
+	buf[off++] = (len >> 48) & 0xFF;
+	buf[off++] = (len >> 56) & 0xFF;
+
+	/* name[s] */
+	uint16_t name_len = strlen(child->name);
+
+	buf[off++] = name_len & 0xFF;
+	buf[off++] = (name_len >> 8) & 0xFF;
+	memcpy(&buf[off], child->name, name_len);
+	off += name_len;
+
+	/* uid[s] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	/* gid[s] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	/* muid[s] */
+	buf[off++] = 0;
+	buf[off++] = 0;
+
+	return off;
+}
+
+/* First child whose record starts at or after byte offset of dir */
+static struct ninep_fs_node *dir_seek(struct ninep_fs_node *dir,
+                                      uint64_t offset)
+{
+	struct ninep_fs_node *child = dir->children;
+	uint64_t current_offset = 0;
+
+	while (child && current_offset < offset) {
+		current_offset += dirent_size(child);
+		child = child->next_sibling;
+	}
+	return child;
+}
+
+/* Fill buf with the whole records of child and its later siblings that
+ * fit in count; *next is set to the first child not emitted. */
+static size_t dir_fill(struct ninep_fs_node *child, uint8_t *buf,
+                       uint32_t count, struct ninep_fs_node **next)
+{
+	size_t buf_offset = 0;
+
+	while (child && buf_offset + dirent_size(child) <= count) {
+		buf_offset += put_dirent(&buf[buf_offset], child);
+		child = child->next_sibling;
+	}
+	*next = child;
+	return buf_offset;
 }
 
 /* Read from file */
@@ -96,171 +727,181 @@ static int ramfs_read(struct ninep_fs_node *node, uint64_t offset,
                       uint8_t *buf, uint32_t count, const char *uname,
                       void *fs_ctx)
 {
+	struct ninep_ramfs *ramfs = fs_ctx;
+	int ret;
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
 	if (node->type == NINEP_NODE_DIR) {
 		/* Read directory entries.
 		 *
 		 * read(5): directory reads return whole stat records only, and a
 		 * client presents offset == 0 or the previous offset+count (no
-		 * seeking). This walk re-scans from the start each call (O(n^2))
-		 * and emits records whose byte-range starts at `offset`; because
-		 * we never split a record and `offset` is always a record
-		 * boundary for a conformant client, successive reads stay
-		 * coherent. A count too small to hold the next whole record
-		 * yields 0 bytes here — callers must offer count >= iounit. */
+		 * seeking). This walk re-scans from the start each call (O(n^2)
+		 * over a whole listing; ramfs_readdir() avoids that) and emits
+		 * records whose byte-range starts at `offset`; because we never
+		 * split a record and `offset` is always a record boundary for a
+		 * conformant client, successive reads stay coherent. A count too
+		 * small to hold the next whole record yields 0 bytes here —
+		 * callers must offer count >= iounit. */
 		LOG_DBG("Reading directory '%s': children=%p, offset=%llu, count=%u",
 		        node->name, node->children, offset, count);
 
-		struct ninep_fs_node *child = node->children;
-		size_t buf_offset = 0;
-		int child_count = 0;
-		uint64_t current_offset = 0;  /* Track position in directory stream */
-
-		/* Iterate through children to find starting point and fill buffer */
-		while (child) {
-			/* Calculate size of this entry */
-			uint16_t stat_size = 2 + 4 + 13 + 4 + 4 + 4 + 8 +
-			                      2 + strlen(child->name) +
-			                      2 + 0 +  /* uid */
-			                      2 + 0 +  /* gid */
-			                      2 + 0;   /* muid */
-			uint32_t entry_size = 2 + stat_size;  /* size field + stat */
-
-			/* Check if this entry is past the requested offset */
-			if (current_offset >= offset) {
-				/* This entry should be included in output */
-
-				/* Check if we have space */
-				if (buf_offset + entry_size > count) {
-					break;
-				}
-
-			/* size[2] */
-			buf[buf_offset++] = stat_size & 0xFF;
-			buf[buf_offset++] = (stat_size >> 8) & 0xFF;
-
-			/* type[2] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-			/* dev[4] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-			/* qid[13] */
-			buf[buf_offset++] = child->qid.type;
-			buf[buf_offset++] = child->qid.version & 0xFF;
-			buf[buf_offset++] = (child->qid.version >> 8) & 0xFF;
-			buf[buf_offset++] = (child->qid.version >> 16) & 0xFF;
-			buf[buf_offset++] = (child->qid.version >> 24) & 0xFF;
-			buf[buf_offset++] = child->qid.path & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 8) & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 16) & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 24) & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 32) & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 40) & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 48) & 0xFF;
-			buf[buf_offset++] = (child->qid.path >> 56) & 0xFF;
-
-			/* mode[4] */
-			uint32_t mode = child->mode;
-
-			if (child->type == NINEP_NODE_DIR) {
-				mode |= NINEP_DMDIR;
-			}
-			buf[buf_offset++] = mode & 0xFF;
-			buf[buf_offset++] = (mode >> 8) & 0xFF;
-			buf[buf_offset++] = (mode >> 16) & 0xFF;
-			buf[buf_offset++] = (mode >> 24) & 0xFF;
-
-			/* atime[4] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-			/* mtime[4] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-			/* length[8] */
-			uint64_t len = child->length;
-
-			buf[buf_offset++] = len & 0xFF;
-			buf[buf_offset++] = (len >> 8) & 0xFF;
-			buf[buf_offset++] = (len >> 16) & 0xFF;
-			buf[buf_offset++] = (len >> 24) & 0xFF;
-			buf[buf_offset++] = (len >> 32) & 0xFF;
-			buf[buf_offset++] = (len >> 40) & 0xFF;
-			buf[buf_offset++] = (len >> 48) & 0xFF;
-			buf[buf_offset++] = (len >> 56) & 0xFF;
-
-			/* name[s] */
-			uint16_t name_len = strlen(child->name);
-
-			buf[buf_offset++] = name_len & 0xFF;
-			buf[buf_offset++] = (name_len >> 8) & 0xFF;
-			memcpy(&buf[buf_offset], child->name, name_len);
-			buf_offset += name_len;
-
-			/* uid[s] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-			/* gid[s] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-			/* muid[s] */
-			buf[buf_offset++] = 0;
-			buf[buf_offset++] = 0;
-
-				child_count++;
-			}
-
-			/* Move to next entry and update offset */
-			current_offset += entry_size;
-			child = child->next_sibling;
-		}
+		struct ninep_fs_node *next;
+		size_t n = dir_fill(dir_seek(node, offset), buf, count, &next);
 
-		LOG_DBG("Directory read complete: %d children, %zu bytes", child_count, buf_offset);
-		return buf_offset;
+		LOG_DBG("Directory read complete: %zu bytes", n);
+		ret = n;
+	} else if (offset >= node->length) {
+		ret = 0;
 	} else {
 		/* Read file content */
-		if (offset >= node->length) {
-			return 0;
-		}
-
 		uint32_t to_read = count;
 
 		if (offset + to_read > node->length) {
 			to_read = node->length - offset;
 		}
 
-		if (node->data) {
+		if (rnode(node)->storage == RAMFS_CHUNKS) {
+			read_chunks(rnode(node), offset, buf, to_read);
+		} else if (node->data) {
 			memcpy(buf, (uint8_t *)node->data + offset, to_read);
 		}
 
-		return to_read;
+		ret = to_read;
+	}
+	k_mutex_unlock(&ramfs->lock);
+
+	return ret;
+}
+
+/* Read directory entries, resuming from the fid's cursor */
+static int ramfs_readdir(struct ninep_fs_node *node, uint64_t offset,
+                         uint8_t *buf, uint32_t count,
+                         struct ninep_dir_cursor *cur, const char *uname,
+                         void *fs_ctx)
+{
+	ARG_UNUSED(uname);
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ninep_fs_node *child;
+
+	if (node->type != NINEP_NODE_DIR) {
+		return -ENOTDIR;
+	}
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+
+	/* cur->pos is the next child to emit (0 once the listing is done);
+	 * it may have been removed since unless the generation still holds */
+	if (offset != 0 && offset == cur->offset && cur->gen == rnode(node)->gen) {
+		child = (struct ninep_fs_node *)cur->pos;
+	} else {
+		child = dir_seek(node, offset);
+	}
+
+	size_t n = dir_fill(child, buf, count, &child);
+
+	cur->pos = (uintptr_t)child;
+	cur->gen = rnode(node)->gen;
+	k_mutex_unlock(&ramfs->lock);
+
+	return n;
+}
+
+/* Borrow file content (zero-copy read) */
+static int ramfs_read_ref(struct ninep_fs_node *node, uint64_t offset,
+                          uint32_t count, const char *uname,
+                          struct ninep_read_ref *ref, void *fs_ctx)
+{
+	ARG_UNUSED(uname);
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ramfs_node *rn = rnode(node);
+	int ret = 0;
+
+	if (node->type == NINEP_NODE_DIR) {
+		return -ENOTSUP;
+	}
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (offset >= node->length) {
+		/* EOF: nothing to borrow */
+	} else if (rn->storage == RAMFS_CHUNKS) {
+		/* In place only when the span sits in one chunk */
+		uint32_t len = MIN(count, node->length - offset);
+		uint32_t i = offset / CHUNK_SIZE;
+		uint32_t in = offset % CHUNK_SIZE;
+
+		if (in + len > CHUNK_SIZE || i >= rn->nchunks ||
+		    !rn->chunks[i]) {
+			ret = -ENOTSUP;
+		} else {
+			ref->data = &rn->chunks[i][in];
+			ref->len = len;
+		}
+	} else if (node->data) {
+		ref->data = (const uint8_t *)node->data + offset;
+		ref->len = MIN(count, node->length - offset);
+	}
+
+	/* Static content never changes; anything else stays put until
+	 * the reply has gone out */
+	if (ret == 0 && ref->len && rn->storage != RAMFS_STATIC) {
+		rn->borrows++;
+		ref->release = release_borrow;
+		ref->release_arg = rn;
 	}
+	k_mutex_unlock(&ramfs->lock);
+
+	return ret;
 }
 
-/* Write (not implemented) */
+/* Write file content, moving it to chunks first if needed */
 static int ramfs_write(struct ninep_fs_node *node, uint64_t offset,
                        const uint8_t *buf, uint32_t count, const char *uname,
                        void *fs_ctx)
 {
 	ARG_UNUSED(uname);
-	return -ENOTSUP;
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ramfs_node *rn = rnode(node);
+	int ret;
+
+	if (node->type == NINEP_NODE_DIR) {
+		return -EISDIR;
+	}
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (rn->removed) {
+		ret = -ENOENT;
+		goto out;
+	}
+	if (rn->storage == RAMFS_STATIC) {
+		ret = -EACCES;
+		goto out;
+	}
+
+	wait_borrows(rn);
+
+	ret = to_chunks(rn);
+	if (ret == 0) {
+		ret = write_chunks(rn, offset, buf, count);
+	}
+	if (ret == 0) {
+		if (offset + count > node->length) {
+			node->length = offset + count;
+		}
+		node->qid.version++;
+		ret = count;
+	}
+out:
+	k_mutex_unlock(&ramfs->lock);
+	return ret;
 }
 
 /* Get stat */
 static int ramfs_stat(struct ninep_fs_node *node, uint8_t *buf,
                       size_t buf_len, void *fs_ctx)
 {
+	struct ninep_ramfs *ramfs = fs_ctx;
+
 	if (!node || !buf) {
 		return -EINVAL;
 	}
@@ -268,10 +909,12 @@ static int ramfs_stat(struct ninep_fs_node *node, uint8_t *buf,
 	size_t offset = 0;
 	uint16_t name_len = strlen(node->name);
 
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
 	int ret = ninep_write_stat(buf, buf_len, &offset, &node->qid,
 	                            node->mode, node->length,
 	                            node->name, name_len,
 	                            NULL, NULL, NULL);  /* uid/gid/muid default to "zephyr" */
+	k_mutex_unlock(&ramfs->lock);
 	if (ret < 0) {
 		return ret;
 	}
@@ -279,20 +922,116 @@ static int ramfs_stat(struct ninep_fs_node *node, uint8_t *buf,
 	return offset;
 }
 
-/* Create (not implemented) */
+/* Create an empty file or directory; the fid moves to it */
 static int ramfs_create(struct ninep_fs_node *parent, const char *name,
                         uint16_t name_len, uint32_t perm, uint8_t mode,
                         const char *uname, struct ninep_fs_node **new_node,
                         void *fs_ctx)
 {
 	ARG_UNUSED(uname);
-	return -ENOTSUP;
+	ARG_UNUSED(mode);
+	struct ninep_ramfs *ramfs = fs_ctx;
+	int ret = 0;
+
+	if (parent->type != NINEP_NODE_DIR) {
+		return -ENOTDIR;
+	}
+	if (name_len == 0 || (name_len == 1 && name[0] == '.') ||
+	    (name_len == 2 && name[0] == '.' && name[1] == '.') ||
+	    memchr(name, '/', name_len)) {
+		return -EINVAL;
+	}
+	if (name_len > NINEP_NODE_NAME_MAX) {
+		return -ENAMETOOLONG;
+	}
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (rnode(parent)->removed) {
+		ret = -ENOENT;
+		goto out;
+	}
+	if (find_child(parent, name, name_len)) {
+		ret = -EEXIST;
+		goto out;
+	}
+
+	bool is_dir = perm & NINEP_DMDIR;
+	struct ninep_fs_node *node = alloc_node(ramfs, name, name_len,
+	                                        is_dir ? NINEP_NODE_DIR :
+	                                                 NINEP_NODE_FILE);
+
+	if (!node) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	node->mode = perm & 0777;
+	rnode(node)->storage = RAMFS_CHUNKS;
+	rnode(node)->refs = 1;
+	add_child(parent, node);
+
+	/* The fid that held parent now holds node */
+	if (rnode(parent)->refs) {
+		rnode(parent)->refs--;
+	}
+	*new_node = node;
+out:
+	k_mutex_unlock(&ramfs->lock);
+	return ret;
 }
 
-/* Remove (not implemented) */
+/* Unlink a file or empty directory; freed when the last fid lets go */
 static int ramfs_remove(struct ninep_fs_node *node, void *fs_ctx)
 {
-	return -ENOTSUP;
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ramfs_node *rn = rnode(node);
+	int ret = 0;
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (node == ramfs->root) {
+		ret = -EBUSY;
+	} else if (rn->removed) {
+		ret = -ENOENT;
+	} else if (node->children) {
+		ret = -ENOTEMPTY;
+	} else {
+		remove_child(node);
+		rn->removed = true;
+		/* Tremove drops the fid without a clunk; content stays
+		 * readable through other fids until the last one goes */
+		if (rn->refs) {
+			rn->refs--;
+		}
+		maybe_free(rn);
+	}
+	k_mutex_unlock(&ramfs->lock);
+
+	return ret;
+}
+
+/* Clunk: drop a fid's reference */
+static int ramfs_clunk(struct ninep_fs_node *node, void *fs_ctx)
+{
+	struct ninep_ramfs *ramfs = fs_ctx;
+	struct ramfs_node *rn = rnode(node);
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	if (rn->refs) {
+		rn->refs--;
+	}
+	maybe_free(rn);
+	k_mutex_unlock(&ramfs->lock);
+
+	return 0;
+}
+
+/* A cloned fid shares node */
+static void ramfs_ref(struct ninep_fs_node *node, void *fs_ctx)
+{
+	struct ninep_ramfs *ramfs = fs_ctx;
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	rnode(node)->refs++;
+	k_mutex_unlock(&ramfs->lock);
 }
 
 static const struct ninep_fs_ops ramfs_ops = {
@@ -300,10 +1039,14 @@ static const struct ninep_fs_ops ramfs_ops = {
 	.walk = ramfs_walk,
 	.open = ramfs_open,
 	.read = ramfs_read,
+	.read_ref = ramfs_read_ref,
+	.readdir = ramfs_readdir,
 	.write = ramfs_write,
 	.stat = ramfs_stat,
 	.create = ramfs_create,
 	.remove = ramfs_remove,
+	.clunk = ramfs_clunk,
+	.ref = ramfs_ref,
 };
 
 const struct ninep_fs_ops *ninep_ramfs_get_ops(void)
@@ -319,9 +1062,12 @@ int ninep_ramfs_init(struct ninep_ramfs *ramfs)
 
 	memset(ramfs, 0, sizeof(*ramfs));
 	ramfs->next_qid_path = 1;
+	ramfs->dir_index_min = CONFIG_NINEP_RAMFS_DIR_INDEX_MIN;
+	k_mutex_init(&ramfs->lock);
+	k_condvar_init(&ramfs->borrows_done);
 
 	/* Create root directory */
-	ramfs->root = alloc_node(ramfs, "/", NINEP_NODE_DIR);
+	ramfs->root = alloc_node(ramfs, "/", 1, NINEP_NODE_DIR);
 	if (!ramfs->root) {
 		return -ENOMEM;
 	}
@@ -340,23 +1086,56 @@ struct ninep_fs_node *ninep_ramfs_create_file(struct ninep_ramfs *ramfs,
 		return NULL;
 	}
 
-	struct ninep_fs_node *file = alloc_node(ramfs, name, NINEP_NODE_FILE);
-
-	if (!file) {
-		return NULL;
-	}
+	void *data = NULL;
 
 	if (content && length > 0) {
-		file->data = k_malloc(length);
-		if (!file->data) {
-			k_free(file);
+		data = k_malloc(length);
+		if (!data) {
 			return NULL;
 		}
-		memcpy(file->data, content, length);
-		file->length = length;
+		memcpy(data, content, length);
+	}
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	struct ninep_fs_node *file = alloc_node(ramfs, name, strlen(name),
+	                                        NINEP_NODE_FILE);
+
+	if (file) {
+		file->data = data;
+		file->length = data ? length : 0;
+		add_child(parent, file);
+	} else {
+		k_free(data);
+	}
+	k_mutex_unlock(&ramfs->lock);
+
+	return file;
+}
+
+struct ninep_fs_node *ninep_ramfs_create_static_file(struct ninep_ramfs *ramfs,
+                                                       struct ninep_fs_node *parent,
+                                                       const char *name,
+                                                       const void *content,
+                                                       size_t length)
+{
+	if (!ramfs || !parent || !name) {
+		return NULL;
 	}
 
-	add_child(parent, file);
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	struct ninep_fs_node *file = alloc_node(ramfs, name, strlen(name),
+	                                        NINEP_NODE_FILE);
+
+	if (file) {
+		/* Content is referenced in place, never copied or freed */
+		rnode(file)->storage = RAMFS_STATIC;
+		file->data = (void *)content;
+		file->length = content ? length : 0;
+		file->mode = 0444;
+		add_child(parent, file);
+	}
+	k_mutex_unlock(&ramfs->lock);
+
 	return file;
 }
 
@@ -368,12 +1147,38 @@ struct ninep_fs_node *ninep_ramfs_create_dir(struct ninep_ramfs *ramfs,
 		return NULL;
 	}
 
-	struct ninep_fs_node *dir = alloc_node(ramfs, name, NINEP_NODE_DIR);
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	struct ninep_fs_node *dir = alloc_node(ramfs, name, strlen(name),
+	                                       NINEP_NODE_DIR);
 
-	if (!dir) {
-		return NULL;
+	if (dir) {
+		add_child(parent, dir);
 	}
+	k_mutex_unlock(&ramfs->lock);
 
-	add_child(parent, dir);
 	return dir;
 }
+
+int ninep_ramfs_truncate(struct ninep_ramfs *ramfs, struct ninep_fs_node *node,
+                         uint64_t length)
+{
+	if (!ramfs || !node) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	int ret = truncate_locked(rnode(node), length);
+
+	k_mutex_unlock(&ramfs->lock);
+	return ret;
+}
+
+void ninep_ramfs_get_stats(struct ninep_ramfs *ramfs,
+                           struct ninep_ramfs_stats *stats)
+{
+	k_mutex_lock(&ramfs->lock, K_FOREVER);
+	stats->nodes = ramfs->nodes;
+	stats->chunk_bytes = ramfs->chunk_bytes;
+	stats->meta_bytes = ramfs->meta_bytes;
+	k_mutex_unlock(&ramfs->lock);
+}
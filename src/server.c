@@ -112,51 +112,131 @@ static struct ninep_auth_state *auth_get(struct ninep_server *server, uint8_t id
 
 /*
  * FID management - lightweight with pooled resources
+ *
+ * find_fid/alloc_fid/free_fid (and the uname/auth pools above) touch
+ * shared per-session state and are called with state_lock held. Handlers
+ * go through fid_acquire()/fid_create(), which make the calling request
+ * the fid's owner until the dispatcher calls fid_release_all(). Requests
+ * on the same fid therefore execute one at a time (9P requires e.g.
+ * Twalk→Topen→Tread on a fid to see each other's effects, and Tclunk must
+ * not free a node another request is using), while requests on other
+ * fids proceed in parallel.
  */
 
-/* Helper to find FID */
-static struct ninep_server_fid *find_fid(struct ninep_server *server, uint32_t fid)
+#define FID_INDEX_MASK (NINEP_SERVER_FID_INDEX_SIZE - 1)
+
+BUILD_ASSERT(CONFIG_NINEP_SERVER_MAX_FIDS < UINT16_MAX,
+             "fid slot numbers must fit the uint16_t index");
+
+/* Home bucket of a client fid number. Clients usually number fids
+ * sequentially, so mix the bits rather than just masking. */
+static inline uint32_t fid_bucket(uint32_t fid)
+{
+	fid *= 0x9E3779B1u;
+	return (fid ^ (fid >> 16)) & FID_INDEX_MASK;
+}
+
+/* Empty the fid index and put every slot back on the free stack */
+static void fid_table_reset(struct ninep_server *server)
 {
+	memset(server->fid_index, 0, sizeof(server->fid_index));
 	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_FIDS; i++) {
-		if (server->fids[i].in_use && server->fids[i].fid == fid) {
-			return &server->fids[i];
-		}
+		/* Hand out low slots first */
+		server->fid_free[i] = CONFIG_NINEP_SERVER_MAX_FIDS - 1 - i;
 	}
-	return NULL;
+	server->fid_nfree = CONFIG_NINEP_SERVER_MAX_FIDS;
 }
 
-/* Helper to allocate FID */
-static struct ninep_server_fid *alloc_fid(struct ninep_server *server, uint32_t fid)
+/* Index position holding fid, or the empty position where it would go */
+static uint32_t fid_probe(struct ninep_server *server, uint32_t fid)
 {
-	/* Check if already exists */
-	if (find_fid(server, fid)) {
+	uint32_t pos = fid_bucket(fid);
+
+	while (server->fid_index[pos] != 0 &&
+	       server->fids[server->fid_index[pos] - 1].fid != fid) {
+		pos = (pos + 1) & FID_INDEX_MASK;
+	}
+	return pos;
+}
+
+/* Helper to find FID */
+static struct ninep_server_fid *find_fid(struct ninep_server *server, uint32_t fid)
+{
+	uint16_t ent = server->fid_index[fid_probe(server, fid)];
+
+	return ent ? &server->fids[ent - 1] : NULL;
+}
+
+/* Helper to allocate FID. The new fid starts owned by the allocating
+ * request, so no other request can observe it half-initialized. */
+static struct ninep_server_fid *alloc_fid(struct ninep_server *server,
+                                          struct ninep_server_txbuf *owner,
+                                          uint32_t fid)
+{
+	uint32_t pos = fid_probe(server, fid);
+
+	/* Already exists, or table full */
+	if (server->fid_index[pos] != 0 || server->fid_nfree == 0) {
 		return NULL;
 	}
 
-	/* Find free slot */
-	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_FIDS; i++) {
-		if (!server->fids[i].in_use) {
-			server->fids[i].fid = fid;
-			server->fids[i].in_use = true;
-			server->fids[i].node = NULL;
-			server->fids[i].iounit = 0;
-			server->fids[i].uname_idx = NINEP_POOL_NONE;
-			server->fids[i].auth_idx = NINEP_POOL_NONE;
-			server->fids[i].is_auth_fid = false;
-			server->fids[i].is_open = false;
-			server->fids[i].open_mode = 0;
-			return &server->fids[i];
+	uint16_t slot = server->fid_free[--server->fid_nfree];
+	struct ninep_server_fid *sfid = &server->fids[slot];
+
+	server->fid_index[pos] = slot + 1;
+	sfid->fid = fid;
+	sfid->in_use = true;
+	sfid->owner = owner;
+	sfid->node = NULL;
+	sfid->iounit = 0;
+	sfid->uname_idx = NINEP_POOL_NONE;
+	sfid->auth_idx = NINEP_POOL_NONE;
+	sfid->is_auth_fid = false;
+	sfid->authenticated = false;
+	sfid->is_open = false;
+	sfid->open_mode = 0;
+	if (owner && owner->nheld < NINEP_SERVER_FIDS_PER_REQUEST) {
+		owner->held[owner->nheld++] = sfid;
+	}
+	return sfid;
+}
+
+/* Remove the index entry at pos. Later entries of the same probe run are
+ * shifted back into the hole (no tombstones), so lookups never have to
+ * skip deleted entries however long the session runs. */
+static void fid_index_remove(struct ninep_server *server, uint32_t pos)
+{
+	uint32_t next = pos;
+
+	for (;;) {
+		next = (next + 1) & FID_INDEX_MASK;
+		if (server->fid_index[next] == 0) {
+			break;
+		}
+		uint32_t home = fid_bucket(
+			server->fids[server->fid_index[next] - 1].fid);
+
+		/* Move the entry back unless its home lies cyclically in
+		 * (pos, next], where it would no longer be reachable. */
+		bool reachable = (pos <= next) ? (pos < home && home <= next)
+		                               : (pos < home || home <= next);
+		if (!reachable) {
+			server->fid_index[pos] = server->fid_index[next];
+			pos = next;
 		}
 	}
-	return NULL;
+	server->fid_index[pos] = 0;
 }
 
 /* Helper to free FID and release pooled resources */
 static void free_fid(struct ninep_server *server, uint32_t fid)
 {
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	uint32_t pos = fid_probe(server, fid);
+	uint16_t ent = server->fid_index[pos];
+
+	if (ent) {
+		struct ninep_server_fid *sfid = &server->fids[ent - 1];
 
-	if (sfid) {
 		/* Release pooled resources */
 		if (sfid->uname_idx != NINEP_POOL_NONE) {
 			uname_release(server, sfid->uname_idx);
@@ -165,23 +245,244 @@ static void free_fid(struct ninep_server *server, uint32_t fid)
 			auth_free(server, sfid->auth_idx);
 		}
 		sfid->in_use = false;
+		sfid->owner = NULL;
 		sfid->node = NULL;
 		sfid->uname_idx = NINEP_POOL_NONE;
 		sfid->auth_idx = NINEP_POOL_NONE;
+		memset(&sfid->dir_cursor, 0, sizeof(sfid->dir_cursor));
+
+		fid_index_remove(server, pos);
+		server->fid_free[server->fid_nfree++] = ent - 1;
+	}
+}
+
+/* Drop a fid's directory cursor, letting the fs free what it keeps there.
+ * Must run before the fs clunks or removes the node. */
+static void dir_cursor_release(struct ninep_server *server,
+                               struct ninep_server_fid *sfid)
+{
+	if (sfid->dir_cursor.state && sfid->node && server->config.fs_ops &&
+	    server->config.fs_ops->releasedir) {
+		server->config.fs_ops->releasedir(sfid->node, &sfid->dir_cursor,
+		                                  server->config.fs_ctx);
+	}
+	memset(&sfid->dir_cursor, 0, sizeof(sfid->dir_cursor));
+}
+
+/* Look up a fid and take it for request tx, waiting while another request
+ * holds it. Returns NULL if the fid does not exist (including when it was
+ * clunked while we waited). Released by fid_release_all(). */
+static struct ninep_server_fid *fid_acquire(struct ninep_server *server,
+                                            struct ninep_server_txbuf *tx,
+                                            uint32_t fid)
+{
+	struct ninep_server_fid *sfid;
+
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	while ((sfid = find_fid(server, fid)) != NULL &&
+	       sfid->owner && sfid->owner != tx) {
+		k_condvar_wait(&server->state_cv, &server->state_lock, K_FOREVER);
+	}
+	if (sfid && sfid->owner != tx) {
+		sfid->owner = tx;
+		if (tx->nheld < NINEP_SERVER_FIDS_PER_REQUEST) {
+			tx->held[tx->nheld++] = sfid;
+		}
+	}
+	k_mutex_unlock(&server->state_lock);
+
+	return sfid;
+}
+
+/* Allocate a new fid owned by request tx */
+static struct ninep_server_fid *fid_create(struct ninep_server *server,
+                                           struct ninep_server_txbuf *tx,
+                                           uint32_t fid)
+{
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	struct ninep_server_fid *sfid = alloc_fid(server, tx, fid);
+	k_mutex_unlock(&server->state_lock);
+
+	return sfid;
+}
+
+/* Free a fid held by the calling request */
+static void fid_destroy(struct ninep_server *server, uint32_t fid)
+{
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	free_fid(server, fid);
+	k_condvar_broadcast(&server->state_cv);
+	k_mutex_unlock(&server->state_lock);
+}
+
+/* Release every fid request tx acquired or created. A held slot is only
+ * released if tx still owns it: the request may have freed its fid, and
+ * another request may since have reused the slot. */
+static void fid_release_all(struct ninep_server *server,
+                            struct ninep_server_txbuf *tx)
+{
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	for (int i = 0; i < tx->nheld; i++) {
+		if (tx->held[i]->owner == tx) {
+			tx->held[i]->owner = NULL;
+		}
+	}
+	tx->nheld = 0;
+	k_condvar_broadcast(&server->state_cv);
+	k_mutex_unlock(&server->state_lock);
+}
+
+/* Give a new fid a reference to its parent's interned uname */
+static void fid_inherit_uname(struct ninep_server *server,
+                              struct ninep_server_fid *new_sfid,
+                              const struct ninep_server_fid *sfid)
+{
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	if (sfid->uname_idx != NINEP_POOL_NONE) {
+		new_sfid->uname_idx = sfid->uname_idx;
+		server->uname_refcount[sfid->uname_idx]++;
+	}
+	k_mutex_unlock(&server->state_lock);
+}
+
+/*
+ * Response buffers and sends
+ *
+ * Every request draws a buffer from tx_bufs[] for its lifetime, so
+ * handlers build replies without sharing memory. Sends go through
+ * server_reply() under tx_mutex, which keeps messages whole on the
+ * transport and lets Tflush suppress the reply of a request that is still
+ * executing: once Tflush has marked it and sent Rflush (under the same
+ * lock), the late reply is dropped instead of following the Rflush.
+ * Tflush itself takes no buffer: it must get through while every buffer
+ * is held by the requests it may cancel, so Rflush is built on the stack.
+ * A request still waiting for a buffer is on tx_waiters, where Tflush
+ * marks it too; it then gets its buffer already flushed and never runs.
+ */
+
+/* A request blocked in txbuf_get(), on server->tx_waiters */
+struct ninep_server_txwait {
+	struct ninep_server_txwait *next;
+	uint16_t tag;
+	bool flushed;
+};
+
+static struct ninep_server_txbuf *txbuf_get(struct ninep_server *server,
+                                            uint16_t tag)
+{
+	struct ninep_server_txbuf *tx = NULL;
+	struct ninep_server_txwait wait = { .tag = tag };
+
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
+	wait.next = server->tx_waiters;
+	server->tx_waiters = &wait;
+	k_mutex_unlock(&server->tx_mutex);
+
+	k_sem_take(&server->tx_bufs_free, K_FOREVER);
+
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
+	for (struct ninep_server_txwait **pp = &server->tx_waiters; *pp;
+	     pp = &(*pp)->next) {
+		if (*pp == &wait) {
+			*pp = wait.next;
+			break;
+		}
+	}
+	for (int i = 0; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		if (!server->tx_bufs[i].in_use && server->tx_bufs[i].buf) {
+			tx = &server->tx_bufs[i];
+			tx->in_use = true;
+			tx->flushed = wait.flushed;
+			tx->tag = tag;
+			tx->nheld = 0;
+			break;
+		}
+	}
+	k_mutex_unlock(&server->tx_mutex);
+
+	if (!tx) {
+		/* Buffers were never allocated (or already freed) */
+		k_sem_give(&server->tx_bufs_free);
+	}
+	return tx;
+}
+
+static void txbuf_put(struct ninep_server *server, struct ninep_server_txbuf *tx)
+{
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
+	tx->in_use = false;
+	k_mutex_unlock(&server->tx_mutex);
+
+	k_sem_give(&server->tx_bufs_free);
+}
+
+/* Send the reply built in tx->buf, unless the request was flushed */
+static int server_reply(struct ninep_server *server,
+                        struct ninep_server_txbuf *tx, size_t len)
+{
+	int ret = 0;
+
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
+	if (tx->flushed) {
+		LOG_DBG("Dropping reply to flushed tag %u", tx->tag);
+	} else {
+		ret = ninep_transport_send(server->transport, tx->buf, len);
+	}
+	k_mutex_unlock(&server->tx_mutex);
+
+	return ret;
+}
+
+/*
+ * Send an Rread whose data lives outside the response buffers (a deferred
+ * read's completer, or a filesystem's own buffer). Scatter-gather
+ * transports send the 11-byte header and the data in place; for the rest
+ * the message is assembled in scratch (tx_buf_size bytes). Caller holds
+ * tx_mutex.
+ */
+static int send_rread_data(struct ninep_server *server, uint8_t *scratch,
+                           uint16_t tag, const uint8_t *data, uint32_t len)
+{
+	if (ninep_transport_has_sendv(server->transport)) {
+		uint8_t hdr[11];
+		struct ninep_iovec iov[2] = {
+			{ .base = hdr, .len = sizeof(hdr) },
+			{ .base = data, .len = len },
+		};
+
+		if (ninep_build_rread_hdr(hdr, sizeof(hdr), tag, len) < 0) {
+			return -EINVAL;
+		}
+		return ninep_transport_sendv(server->transport, iov,
+		                             len > 0 ? 2 : 1);
+	}
+
+	if (!scratch) {
+		return -EINVAL;
+	}
+	if (len > 0 && data != &scratch[11]) {
+		memcpy(&scratch[11], data, len);
+	}
+
+	int msg_size = ninep_build_rread(scratch, server->tx_buf_size, tag, len);
+
+	if (msg_size < 0) {
+		return msg_size;
 	}
+	return ninep_transport_send(server->transport, scratch, msg_size);
 }
 
 /*
  * Deferred (parked) reads — see read_deferred in server.h.
  *
- * pending_reads[] is protected by tx_buf_mutex, which the dispatch loop
- * already holds for the duration of every handler. Completions from other
- * threads validate the generation token after acquiring tx_buf_mutex, so
- * dispatch never waits on a completer and a flushed/clunked request simply
- * yields -ESTALE to the late completer.
+ * pending_reads[] is protected by tx_mutex, the lock every reply is sent
+ * under. Completions from other threads validate the generation token
+ * after acquiring tx_mutex, so a flushed/clunked request simply yields
+ * -ESTALE to the late completer, and a cancellation's Rread always
+ * precedes the Rflush/Rclunk that caused it.
  */
 
-/* Caller holds tx_buf_mutex. Returns slot index, or -1 if the table is full. */
+/* Caller holds tx_mutex. Returns slot index, or -1 if the table is full. */
 static int pending_read_alloc(struct ninep_server *server, uint16_t tag,
                               uint32_t fid, uint32_t count)
 {
@@ -199,26 +500,28 @@ static int pending_read_alloc(struct ninep_server *server, uint16_t tag,
 	return -1;
 }
 
-/* Caller holds tx_buf_mutex. Answers a parked read with zero bytes (the
+/* Caller holds tx_mutex. Answers a parked read with zero bytes (the
  * canonical "cancelled" answer, per hubfs convention) and frees the slot. */
 static void pending_read_cancel(struct ninep_server *server,
                                 struct ninep_pending_read *p)
 {
-	int msg_size = ninep_build_rread(server->tx_buf, server->tx_buf_size,
-	                                 p->tag, 0);
+	uint8_t rread[11];
+	int msg_size = ninep_build_rread(rread, sizeof(rread), p->tag, 0);
+
 	if (msg_size > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, msg_size);
+		ninep_transport_send(server->transport, rread, msg_size);
 	}
 	p->in_use = false;
 }
 
 /* Send error response */
-static void send_error(struct ninep_server *server, uint16_t tag, const char *error)
+static void send_error(struct ninep_server *server, struct ninep_server_txbuf *tx,
+                       uint16_t tag, const char *error)
 {
-	int ret = ninep_build_rerror(server->tx_buf, server->tx_buf_size,
+	int ret = ninep_build_rerror(tx->buf, server->tx_buf_size,
 	                               tag, error, strlen(error));
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	}
 }
 
@@ -257,10 +560,11 @@ static const char *errno_to_ename(int err, const char *fallback)
 	}
 }
 
-static void send_error_errno(struct ninep_server *server, uint16_t tag,
+static void send_error_errno(struct ninep_server *server,
+                             struct ninep_server_txbuf *tx, uint16_t tag,
                              int err, const char *fallback)
 {
-	send_error(server, tag, errno_to_ename(err, fallback));
+	send_error(server, tx, tag, errno_to_ename(err, fallback));
 }
 
 /*
@@ -301,7 +605,8 @@ static const char *fid_identity(struct ninep_server *server,
  * Returns 0 if allowed (or no policy configured), -EPERM if denied. On
  * denial, sends an Rerror to the client; callers should just return.
  */
-static int check_perm_or_deny(struct ninep_server *server, uint16_t tag,
+static int check_perm_or_deny(struct ninep_server *server,
+                               struct ninep_server_txbuf *tx, uint16_t tag,
                                struct ninep_server_fid *sfid, uint8_t mode)
 {
 	const struct ninep_auth_config *auth = server->config.auth_config;
@@ -321,7 +626,7 @@ static int check_perm_or_deny(struct ninep_server *server, uint16_t tag,
 		/* Filesystem couldn't resolve the path. Fail closed when a
 		 * policy IS configured — better than silently allowing. */
 		LOG_WRN("check_perm: get_path failed (%d), denying", n);
-		send_error(server, tag, "permission denied");
+		send_error(server, tx, tag, "permission denied");
 		return -EPERM;
 	}
 
@@ -333,20 +638,22 @@ static int check_perm_or_deny(struct ninep_server *server, uint16_t tag,
 	if (ret < 0) {
 		LOG_DBG("check_perm denied: uname='%s' path='%s' mode=0x%02x",
 		        uname ? uname : "(null)", path, mode);
-		send_error(server, tag, "permission denied");
+		send_error(server, tx, tag, "permission denied");
 		return -EPERM;
 	}
 	return 0;
 }
 
 /* Handle Tversion */
-static void handle_tversion(struct ninep_server *server, const uint8_t *msg, size_t len)
+static void handle_tversion(struct ninep_server *server,
+                            struct ninep_server_txbuf *tx,
+                            const uint8_t *msg, size_t len)
 {
 	uint16_t tag = msg[5] | (msg[6] << 8);
 
 	/* header[7] + msize[4] + version-count[2] */
 	if (len < 13) {
-		send_error(server, tag, "bad Tversion");
+		send_error(server, tx, tag, "bad Tversion");
 		return;
 	}
 
@@ -355,7 +662,7 @@ static void handle_tversion(struct ninep_server *server, const uint8_t *msg, siz
 	const char *version = (const char *)&msg[13];
 
 	if (len < (size_t)(13 + version_len)) {
-		send_error(server, tag, "bad Tversion");
+		send_error(server, tx, tag, "bad Tversion");
 		return;
 	}
 
@@ -378,10 +685,10 @@ static void handle_tversion(struct ninep_server *server, const uint8_t *msg, siz
 	 * leaves the session untouched, since a garbled Tversion must not tear
 	 * down a live session. */
 	if (version_len < 6 || strncmp(version, "9P2000", 6) != 0) {
-		int ret = ninep_build_rversion(server->tx_buf, server->tx_buf_size,
+		int ret = ninep_build_rversion(tx->buf, server->tx_buf_size,
 		                                tag, msize, "unknown", 7);
 		if (ret > 0) {
-			ninep_transport_send(server->transport, server->tx_buf, ret);
+			server_reply(server, tx, ret);
 		}
 		return;
 	}
@@ -389,13 +696,20 @@ static void handle_tversion(struct ninep_server *server, const uint8_t *msg, siz
 	/* Version accepted: Tversion resets all session state. Parked reads
 	 * are dropped without replies (the client reset the session); late
 	 * completers get -ESTALE from the generation check. */
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
 	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_PENDING_READS; i++) {
 		server->pending_reads[i].in_use = false;
 	}
+	k_mutex_unlock(&server->tx_mutex);
+
+	/* Tversion runs with no other request executing (see the dispatch
+	 * gate in ninep_server_process_message), so the fid table can be
+	 * torn down without taking each fid. */
 	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_FIDS; i++) {
 		if (server->fids[i].in_use) {
 			/* Let the filesystem release per-fid resources — the
 			 * reset is semantically a clunk of every live fid. */
+			dir_cursor_release(server, &server->fids[i]);
 			if (server->config.fs_ops->clunk && server->fids[i].node &&
 			    !server->fids[i].is_auth_fid) {
 				server->config.fs_ops->clunk(server->fids[i].node,
@@ -409,24 +723,27 @@ static void handle_tversion(struct ninep_server *server, const uint8_t *msg, siz
 			}
 		}
 		server->fids[i].in_use = false;
+		server->fids[i].owner = NULL;
 		server->fids[i].node = NULL;
 		server->fids[i].uname_idx = NINEP_POOL_NONE;
 		server->fids[i].auth_idx = NINEP_POOL_NONE;
 	}
+	fid_table_reset(server);
 	memset(server->uname_refcount, 0, sizeof(server->uname_refcount));
 	memset(server->auth_pool_used, 0, sizeof(server->auth_pool_used));
 
 	server->msize = msize;
 
-	int ret = ninep_build_rversion(server->tx_buf, server->tx_buf_size,
+	int ret = ninep_build_rversion(tx->buf, server->tx_buf_size,
 	                                tag, msize, "9P2000", 6);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	}
 }
 
 /* Handle Tattach */
-static void handle_tattach(struct ninep_server *server, uint16_t tag,
+static void handle_tattach(struct ninep_server *server,
+                           struct ninep_server_txbuf *tx, uint16_t tag,
                            const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
@@ -444,14 +761,14 @@ static void handle_tattach(struct ninep_server *server, uint16_t tag,
 	const struct ninep_fs_ops *ops = server->config.fs_ops;
 	if (!ops) {
 		LOG_ERR("fs_ops is NULL!");
-		send_error(server, tag, "filesystem not configured");
+		send_error(server, tx, tag, "filesystem not configured");
 		return;
 	}
 	LOG_DBG("fs_ops=%p", ops);
 
 	if (!ops->get_root) {
 		LOG_ERR("get_root is NULL!");
-		send_error(server, tag, "get_root not implemented");
+		send_error(server, tx, tag, "get_root not implemented");
 		return;
 	}
 	LOG_DBG("get_root=%p", ops->get_root);
@@ -478,19 +795,32 @@ static void handle_tattach(struct ninep_server *server, uint16_t tag,
 	 * rejected outright (true) or admitted as an anonymous guest (false). */
 	const struct ninep_auth_config *auth_cfg = server->config.auth_config;
 	bool auth_ok = false;
+	char identity[NINEP_AUTH_IDENTITY_MAX];
 
 	if (afid != NINEP_NOFID) {
-		/* Find and verify the auth fid + its completed challenge-response */
+		/* Find and verify the auth fid + its completed challenge-response.
+		 * The identity is copied out under state_lock since the auth fid
+		 * may be written or clunked by a concurrent request. */
+		bool verified = false;
+
+		k_mutex_lock(&server->state_lock, K_FOREVER);
 		struct ninep_server_fid *auth_fid = find_fid(server, afid);
 		struct ninep_auth_state *auth_state =
 			(auth_fid && auth_fid->is_auth_fid)
 				? auth_get(server, auth_fid->auth_idx)
 				: NULL;
 
-		if (!auth_state || !auth_state->authenticated) {
+		if (auth_state && auth_state->authenticated) {
+			memcpy(identity, auth_state->claimed_identity, sizeof(identity));
+			identity[sizeof(identity) - 1] = '\0';
+			verified = true;
+		}
+		k_mutex_unlock(&server->state_lock);
+
+		if (!verified) {
 			/* afid present but no valid completed Tauth. */
 			if (auth_cfg && auth_cfg->required) {
-				send_error(server, tag, "authentication incomplete");
+				send_error(server, tx, tag, "authentication incomplete");
 				return;
 			}
 			/* Not required: admit as unauthenticated guest (auth_ok stays false). */
@@ -501,37 +831,40 @@ static void handle_tattach(struct ninep_server *server, uint16_t tag,
 			 * must agree too. An empty uname is a deliberate "use my auth
 			 * identity" and skips the check. */
 			if (uname_len > 0 &&
-			    (uname_len != strlen(auth_state->claimed_identity) ||
-			     strncmp(uname, auth_state->claimed_identity, uname_len) != 0)) {
+			    (uname_len != strlen(identity) ||
+			     strncmp(uname, identity, uname_len) != 0)) {
 				LOG_WRN("Tattach uname mismatch: claimed='%.*s', auth='%s'",
-				        uname_len, uname, auth_state->claimed_identity);
-				send_error(server, tag, "uname does not match authenticated identity");
+				        uname_len, uname, identity);
+				send_error(server, tx, tag, "uname does not match authenticated identity");
 				return;
 			}
 
 			/* Use authenticated identity as uname */
-			uname = auth_state->claimed_identity;
-			uname_len = strlen(auth_state->claimed_identity);
+			uname = identity;
+			uname_len = strlen(identity);
 			auth_ok = true;
 			LOG_INF("Authenticated attach for identity '%s'", uname);
 		}
 	} else if (auth_cfg && auth_cfg->required) {
 		/* No afid at all, and auth is mandatory. */
-		send_error(server, tag, "authentication required");
+		send_error(server, tx, tag, "authentication required");
 		return;
 	}
 
-	/* Allocate FID */
-	struct ninep_server_fid *sfid = alloc_fid(server, fid);
+	/* Allocate FID and intern uname in pool */
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	struct ninep_server_fid *sfid = alloc_fid(server, tx, fid);
+
+	if (sfid) {
+		sfid->uname_idx = uname_intern(server, uname, uname_len);
+	}
+	k_mutex_unlock(&server->state_lock);
 
 	if (!sfid) {
-		send_error(server, tag, "FID already in use");
+		send_error(server, tx, tag, "FID already in use");
 		return;
 	}
 
-	/* Intern uname in pool */
-	sfid->uname_idx = uname_intern(server, uname, uname_len);
-
 	/* Verified if and only if a valid Tauth challenge-response completed
 	 * above (auth_ok). A bare afid value proves nothing on its own, so it
 	 * must never gate this flag directly. An unverified attach keeps its
@@ -546,8 +879,8 @@ static void handle_tattach(struct ninep_server *server, uint16_t tag,
 	/* Get root node */
 	sfid->node = server->config.fs_ops->get_root(server->config.fs_ctx);
 	if (!sfid->node) {
-		free_fid(server, fid);
-		send_error(server, tag, "cannot get root");
+		fid_destroy(server, fid);
+		send_error(server, tx, tag, "cannot get root");
 		return;
 	}
 
@@ -603,8 +936,8 @@ static void handle_tattach(struct ninep_server *server, uint16_t tag,
 							node,
 							server->config.fs_ctx);
 					}
-					free_fid(server, fid);
-					send_error(server, tag,
+					fid_destroy(server, fid);
+					send_error(server, tx, tag,
 						   "aname not found");
 					return;
 				}
@@ -625,15 +958,16 @@ static void handle_tattach(struct ninep_server *server, uint16_t tag,
 	}
 
 	/* Send Rattach */
-	int ret = ninep_build_rattach(server->tx_buf, server->tx_buf_size,
+	int ret = ninep_build_rattach(tx->buf, server->tx_buf_size,
 	                                tag, &sfid->node->qid);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	}
 }
 
 /* Handle Twalk */
-static void handle_twalk(struct ninep_server *server, uint16_t tag,
+static void handle_twalk(struct ninep_server *server,
+                         struct ninep_server_txbuf *tx, uint16_t tag,
                          const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
@@ -642,17 +976,17 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 
 	LOG_INF("Twalk: fid=%u, newfid=%u, nwname=%u", fid, newfid, nwname);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 
 	if (!sfid) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
 	/* walk(5): it is illegal to walk an open fid, whether or not nwname
 	 * is 0. */
 	if (sfid->is_open) {
-		send_error(server, tag, "cannot walk an open fid");
+		send_error(server, tx, tag, "cannot walk an open fid");
 		return;
 	}
 
@@ -660,32 +994,33 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 	 * rather than silently truncating it and returning a newfid the client
 	 * will believe walked the full path. */
 	if (nwname > NINEP_MAX_WELEM) {
-		send_error(server, tag, "too many name elements");
+		send_error(server, tx, tag, "too many name elements");
 		return;
 	}
 
 	/* If nwname is 0, clone the FID */
 	if (nwname == 0) {
-		struct ninep_server_fid *new_sfid = alloc_fid(server, newfid);
+		struct ninep_server_fid *new_sfid = fid_create(server, tx, newfid);
 
 		if (!new_sfid) {
-			send_error(server, tag, "cannot allocate newfid");
+			send_error(server, tx, tag, "cannot allocate newfid");
 			return;
 		}
 		new_sfid->node = sfid->node;
-		/* Share uname from parent fid (increment refcount) */
-		if (sfid->uname_idx != NINEP_POOL_NONE) {
-			new_sfid->uname_idx = sfid->uname_idx;
-			server->uname_refcount[sfid->uname_idx]++;
+		if (server->config.fs_ops->ref) {
+			server->config.fs_ops->ref(new_sfid->node,
+			                           server->config.fs_ctx);
 		}
+		/* Share uname from parent fid (increment refcount) */
+		fid_inherit_uname(server, new_sfid, sfid);
 		/* Inherit authentication status from the parent fid */
 		new_sfid->authenticated = sfid->authenticated;
 
 		/* Send Rwalk with 0 qids */
-		int ret = ninep_build_rwalk(server->tx_buf, server->tx_buf_size,
+		int ret = ninep_build_rwalk(tx->buf, server->tx_buf_size,
 		                             tag, 0, NULL);
 		if (ret > 0) {
-			ninep_transport_send(server->transport, server->tx_buf, ret);
+			server_reply(server, tx, ret);
 		}
 		return;
 	}
@@ -707,7 +1042,7 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 				server->config.fs_ops->clunk(node,
 				                             server->config.fs_ctx);
 			}
-			send_error(server, tag, "malformed walk message");
+			send_error(server, tx, tag, "malformed walk message");
 			return;
 		}
 		uint16_t name_len = msg[offset] | (msg[offset + 1] << 8);
@@ -718,7 +1053,7 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 				server->config.fs_ops->clunk(node,
 				                             server->config.fs_ctx);
 			}
-			send_error(server, tag, "malformed walk message");
+			send_error(server, tx, tag, "malformed walk message");
 			return;
 		}
 		const char *name = (const char *)&msg[offset + 2];
@@ -745,15 +1080,14 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 			 * far and leave newfid unset, so the client knows the walk
 			 * stopped short. */
 			if (i == 0) {
-				send_error(server, tag, "file not found");
+				send_error(server, tx, tag, "file not found");
 				return;
 			}
-			int rerr = ninep_build_rwalk(server->tx_buf,
+			int rerr = ninep_build_rwalk(tx->buf,
 			                             server->tx_buf_size,
 			                             tag, nwqid, wqids);
 			if (rerr > 0) {
-				ninep_transport_send(server->transport,
-				                     server->tx_buf, rerr);
+				server_reply(server, tx, rerr);
 			}
 			return;
 		}
@@ -764,7 +1098,7 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 	}
 
 	/* Full walk (nwqid == nwname): establish newfid at the final node. */
-	struct ninep_server_fid *new_sfid = alloc_fid(server, newfid);
+	struct ninep_server_fid *new_sfid = fid_create(server, tx, newfid);
 
 	if (!new_sfid) {
 		/* Free the final walk result if it's not the starting node */
@@ -772,28 +1106,26 @@ static void handle_twalk(struct ninep_server *server, uint16_t tag,
 			server->config.fs_ops->clunk(node,
 			                             server->config.fs_ctx);
 		}
-		send_error(server, tag, "cannot allocate newfid");
+		send_error(server, tx, tag, "cannot allocate newfid");
 		return;
 	}
 	new_sfid->node = node;
 	/* Share uname from parent fid (increment refcount) */
-	if (sfid->uname_idx != NINEP_POOL_NONE) {
-		new_sfid->uname_idx = sfid->uname_idx;
-		server->uname_refcount[sfid->uname_idx]++;
-	}
+	fid_inherit_uname(server, new_sfid, sfid);
 	/* Inherit authentication status from the parent fid */
 	new_sfid->authenticated = sfid->authenticated;
 
 	/* Send Rwalk with actual walked count (per 9P2000 spec) */
-	int ret = ninep_build_rwalk(server->tx_buf, server->tx_buf_size,
+	int ret = ninep_build_rwalk(tx->buf, server->tx_buf_size,
 	                             tag, nwqid, wqids);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	}
 }
 
 /* Handle Topen */
-static void handle_topen(struct ninep_server *server, uint16_t tag,
+static void handle_topen(struct ninep_server *server,
+                         struct ninep_server_txbuf *tx, uint16_t tag,
                          const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
@@ -801,21 +1133,21 @@ static void handle_topen(struct ninep_server *server, uint16_t tag,
 
 	LOG_INF("Topen: fid=%u, mode=0x%02x", fid, mode);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 
 	if (!sfid || !sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
 	/* open(5): a fid may be opened only once. */
 	if (sfid->is_open) {
-		send_error(server, tag, "fid already open");
+		send_error(server, tx, tag, "fid already open");
 		return;
 	}
 
 	/* Per-operation permission check. Sends Rerror itself on denial. */
-	if (check_perm_or_deny(server, tag, sfid, mode) < 0) {
+	if (check_perm_or_deny(server, tx, tag, sfid, mode) < 0) {
 		return;
 	}
 
@@ -823,12 +1155,13 @@ static void handle_topen(struct ninep_server *server, uint16_t tag,
 	int ret = server->config.fs_ops->open(sfid->node, mode,
 	                                        server->config.fs_ctx);
 	if (ret < 0) {
-		send_error_errno(server, tag, ret, "open failed");
+		send_error_errno(server, tx, tag, ret, "open failed");
 		return;
 	}
 
 	sfid->is_open = true;
 	sfid->open_mode = mode;
+	memset(&sfid->dir_cursor, 0, sizeof(sfid->dir_cursor));
 
 	/* iounit is the largest guaranteed atomic read/write; base it on the
 	 * negotiated msize (further limited by the transport MTU), not the
@@ -843,12 +1176,12 @@ static void handle_topen(struct ninep_server *server, uint16_t tag,
 	sfid->iounit = eff > 24 ? eff - 24 : 0; /* minus Twrite/Rread header */
 
 	/* Send Ropen */
-	ret = ninep_build_ropen(server->tx_buf, server->tx_buf_size,
+	ret = ninep_build_ropen(tx->buf, server->tx_buf_size,
 	                         tag, &sfid->node->qid, sfid->iounit);
 	if (ret > 0) {
 		LOG_INF("Sending Ropen: tag=%u, qid.type=%u, qid.path=0x%llx, iounit=%u, size=%d",
 		        tag, sfid->node->qid.type, sfid->node->qid.path, sfid->iounit, ret);
-		int send_ret = ninep_transport_send(server->transport, server->tx_buf, ret);
+		int send_ret = server_reply(server, tx, ret);
 		if (send_ret < 0) {
 			LOG_ERR("Failed to send Ropen: %d", send_ret);
 		}
@@ -858,12 +1191,13 @@ static void handle_topen(struct ninep_server *server, uint16_t tag,
 }
 
 /* Handle Tread */
-static void handle_tread(struct ninep_server *server, uint16_t tag,
+static void handle_tread(struct ninep_server *server,
+                         struct ninep_server_txbuf *tx, uint16_t tag,
                          const uint8_t *msg, size_t len)
 {
 	/* size[4] type[1] tag[2] fid[4] offset[8] count[4] = 23 bytes */
 	if (len < 23) {
-		send_error(server, tag, "malformed Tread");
+		send_error(server, tx, tag, "malformed Tread");
 		return;
 	}
 
@@ -876,10 +1210,10 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 
 	LOG_DBG("Tread: fid=%u, offset=%llu, count=%u", fid, offset, count);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 
 	if (!sfid) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
@@ -887,14 +1221,14 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 	if (sfid->is_auth_fid) {
 		struct ninep_auth_state *auth_state = auth_get(server, sfid->auth_idx);
 		if (!auth_state) {
-			send_error(server, tag, "invalid auth state");
+			send_error(server, tx, tag, "invalid auth state");
 			return;
 		}
 
 		/* Check challenge expiry (60 seconds) */
 		uint64_t now = get_current_time_ms();
 		if (now - auth_state->challenge_time > 60000) {
-			send_error(server, tag, "authentication timeout");
+			send_error(server, tx, tag, "authentication timeout");
 			return;
 		}
 
@@ -905,23 +1239,23 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 			if ((uint32_t)bytes > count) {
 				bytes = count;
 			}
-			memcpy(&server->tx_buf[11], &auth_state->challenge[offset], bytes);
+			memcpy(&tx->buf[11], &auth_state->challenge[offset], bytes);
 		}
 
 		auth_state->challenge_issued = true;
 		LOG_DBG("Auth read: returning %d bytes of challenge", bytes);
 
 		/* Build and send Rread */
-		int msg_size = ninep_build_rread(server->tx_buf, server->tx_buf_size,
+		int msg_size = ninep_build_rread(tx->buf, server->tx_buf_size,
 		                                  tag, bytes);
 		if (msg_size > 0) {
-			ninep_transport_send(server->transport, server->tx_buf, msg_size);
+			server_reply(server, tx, msg_size);
 		}
 		return;
 	}
 
 	if (!sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
@@ -929,11 +1263,11 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 	 * also means the open-time permission check cannot be bypassed by
 	 * walking straight to a file and reading it. */
 	if (!sfid->is_open) {
-		send_error(server, tag, "fid not open");
+		send_error(server, tx, tag, "fid not open");
 		return;
 	}
 	if ((sfid->open_mode & 3) == NINEP_OWRITE) {
-		send_error(server, tag, "fid not open for reading");
+		send_error(server, tx, tag, "fid not open for reading");
 		return;
 	}
 
@@ -946,6 +1280,80 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 		count = max_data;
 	}
 
+	/* Directories: continue from where this fid's last read ended */
+	if (sfid->node->type == NINEP_NODE_DIR && server->config.fs_ops->readdir) {
+		int bytes = server->config.fs_ops->readdir(sfid->node, offset,
+		                                           &tx->buf[11], count,
+		                                           &sfid->dir_cursor,
+		                                           fid_identity(server, sfid),
+		                                           server->config.fs_ctx);
+		if (bytes < 0) {
+			send_error_errno(server, tx, tag, bytes, "read failed");
+			return;
+		}
+		sfid->dir_cursor.offset = offset + bytes;
+
+		int msg_size = ninep_build_rread(tx->buf, server->tx_buf_size,
+		                                  tag, bytes);
+		if (msg_size > 0) {
+			server_reply(server, tx, msg_size);
+		}
+		return;
+	}
+
+	/* Files with per-fid read state */
+	if (server->config.fs_ops->read_cursor) {
+		int bytes = server->config.fs_ops->read_cursor(sfid->node, offset,
+		                                               &tx->buf[11], count,
+		                                               &sfid->dir_cursor,
+		                                               fid_identity(server, sfid),
+		                                               server->config.fs_ctx);
+		if (bytes != -ENOTSUP) {
+			if (bytes < 0) {
+				send_error_errno(server, tx, tag, bytes, "read failed");
+				return;
+			}
+			sfid->dir_cursor.offset = offset + bytes;
+
+			int msg_size = ninep_build_rread(tx->buf, server->tx_buf_size,
+			                                  tag, bytes);
+			if (msg_size > 0) {
+				server_reply(server, tx, msg_size);
+			}
+			return;
+		}
+	}
+
+	/* Borrowed data goes out without passing through the fs read() copy */
+	if (server->config.fs_ops->read_ref) {
+		struct ninep_read_ref ref = { 0 };
+		int ret = server->config.fs_ops->read_ref(sfid->node, offset, count,
+		                                          fid_identity(server, sfid),
+		                                          &ref, server->config.fs_ctx);
+
+		if (ret == 0) {
+			uint32_t n = MIN(ref.len, count);
+
+			k_mutex_lock(&server->tx_mutex, K_FOREVER);
+			if (tx->flushed) {
+				LOG_DBG("Dropping reply to flushed tag %u", tag);
+			} else {
+				send_rread_data(server, tx->buf, tag,
+				                n > 0 ? ref.data : NULL, n);
+			}
+			k_mutex_unlock(&server->tx_mutex);
+
+			if (ref.release) {
+				ref.release(ref.release_arg);
+			}
+			return;
+		}
+		if (ret != -ENOTSUP) {
+			send_error_errno(server, tx, tag, ret, "read failed");
+			return;
+		}
+	}
+
 	/* Read data directly into tx_buf at offset 11 */
 	int bytes;
 	if (server->config.fs_ops->read_deferred) {
@@ -953,6 +1361,11 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 		 * parked read answers the old one with zero bytes first (the
 		 * stream fs keeps a single wait slot per fid). Also guards
 		 * against a misbehaving client reusing a parked tag. */
+		struct ninep_read_handle h;
+		const struct ninep_read_handle *hp = NULL;
+		int slot = -1;
+
+		k_mutex_lock(&server->tx_mutex, K_FOREVER);
 		for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_PENDING_READS; i++) {
 			struct ninep_pending_read *p = &server->pending_reads[i];
 			if (p->in_use && (p->fid == fid || p->tag == tag)) {
@@ -962,20 +1375,23 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 			}
 		}
 
-		struct ninep_read_handle h;
-		const struct ninep_read_handle *hp = NULL;
-		int slot = pending_read_alloc(server, tag, fid, count);
+		/* A request already flushed must not park: nothing would
+		 * ever cancel it. */
+		if (!tx->flushed) {
+			slot = pending_read_alloc(server, tag, fid, count);
+		}
 		if (slot >= 0) {
 			h.server = server;
 			h.slot = (uint8_t)slot;
 			h.gen = server->pending_reads[slot].gen;
 			hp = &h;
-		} else {
+		} else if (!tx->flushed) {
 			LOG_WRN("Pending-read table full; Tread tag %u cannot defer", tag);
 		}
+		k_mutex_unlock(&server->tx_mutex);
 
 		bytes = server->config.fs_ops->read_deferred(sfid->node, offset,
-		                                             &server->tx_buf[11], count,
+		                                             &tx->buf[11], count,
 		                                             fid_identity(server, sfid),
 		                                             hp, server->config.fs_ctx);
 		if (bytes == NINEP_READ_DEFER && hp) {
@@ -985,7 +1401,9 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 		}
 		if (slot >= 0) {
 			/* Answered (or failed) immediately — release the slot. */
+			k_mutex_lock(&server->tx_mutex, K_FOREVER);
 			server->pending_reads[slot].in_use = false;
+			k_mutex_unlock(&server->tx_mutex);
 		}
 		if (bytes == NINEP_READ_DEFER) {
 			/* fs violated the h==NULL contract; degrade to EOF. */
@@ -994,35 +1412,36 @@ static void handle_tread(struct ninep_server *server, uint16_t tag,
 		}
 	} else {
 		bytes = server->config.fs_ops->read(sfid->node, offset,
-		                                    &server->tx_buf[11], count,
+		                                    &tx->buf[11], count,
 		                                    fid_identity(server, sfid),
 		                                    server->config.fs_ctx);
 	}
 	if (bytes < 0) {
-		send_error_errno(server, tag, bytes, "read failed");
+		send_error_errno(server, tx, tag, bytes, "read failed");
 		return;
 	}
 
 	/* Build and send Rread */
-	int msg_size = ninep_build_rread(server->tx_buf, server->tx_buf_size,
+	int msg_size = ninep_build_rread(tx->buf, server->tx_buf_size,
 	                                  tag, bytes);
 	if (msg_size > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, msg_size);
+		server_reply(server, tx, msg_size);
 	}
 }
 
 /* Handle Tstat */
-static void handle_tstat(struct ninep_server *server, uint16_t tag,
+static void handle_tstat(struct ninep_server *server,
+                         struct ninep_server_txbuf *tx, uint16_t tag,
                          const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
 
 	LOG_DBG("Tstat: fid=%u", fid);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 
 	if (!sfid || !sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
@@ -1032,17 +1451,17 @@ static void handle_tstat(struct ninep_server *server, uint16_t tag,
 	                                             sizeof(stat_buf),
 	                                             server->config.fs_ctx);
 	if (stat_len < 0) {
-		send_error_errno(server, tag, stat_len, "stat failed");
+		send_error_errno(server, tx, tag, stat_len, "stat failed");
 		return;
 	}
 
 	/* Build Rstat */
-	int ret = ninep_build_rstat(server->tx_buf, server->tx_buf_size,
+	int ret = ninep_build_rstat(tx->buf, server->tx_buf_size,
 	                             tag, stat_buf, stat_len);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	} else {
-		send_error(server, tag, "rstat build failed");
+		send_error(server, tx, tag, "rstat build failed");
 	}
 }
 
@@ -1075,7 +1494,8 @@ static uint64_t get_current_time_ms(void)
 }
 
 /* Handle Tauth - authentication start */
-static void handle_tauth(struct ninep_server *server, uint16_t tag,
+static void handle_tauth(struct ninep_server *server,
+                         struct ninep_server_txbuf *tx, uint16_t tag,
                          const uint8_t *msg, size_t len)
 {
 	/* Parse Tauth: size[4] type[1] tag[2] afid[4] uname[s] aname[s] */
@@ -1097,39 +1517,46 @@ static void handle_tauth(struct ninep_server *server, uint16_t tag,
 	const struct ninep_auth_config *auth = server->config.auth_config;
 	if (!auth) {
 		/* No auth configured - return error (authentication not required) */
-		send_error(server, tag, "authentication not required");
+		send_error(server, tx, tag, "authentication not required");
 		return;
 	}
 
 	/* Validate identity length (format validation is app's responsibility) */
 	if (uname_len == 0 || uname_len >= NINEP_AUTH_IDENTITY_MAX) {
 		LOG_WRN("Invalid identity length: %u", uname_len);
-		send_error(server, tag, "invalid identity");
+		send_error(server, tx, tag, "invalid identity");
 		return;
 	}
 
-	/* Allocate auth FID */
-	struct ninep_server_fid *sfid = alloc_fid(server, afid);
+	/* Allocate auth FID and its auth state from the pool */
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	struct ninep_server_fid *sfid = alloc_fid(server, tx, afid);
+	uint8_t auth_idx = NINEP_POOL_NONE;
+
+	if (sfid) {
+		auth_idx = auth_alloc(server);
+		if (auth_idx == NINEP_POOL_NONE) {
+			free_fid(server, afid);
+		} else {
+			/* Mark as auth fid */
+			sfid->is_auth_fid = true;
+			sfid->auth_idx = auth_idx;
+			sfid->node = NULL;  /* Auth fids don't point to filesystem nodes */
+		}
+	}
+	k_mutex_unlock(&server->state_lock);
+
 	if (!sfid) {
-		send_error(server, tag, "cannot allocate afid");
+		send_error(server, tx, tag, "cannot allocate afid");
 		return;
 	}
-
-	/* Allocate auth state from pool */
-	uint8_t auth_idx = auth_alloc(server);
 	if (auth_idx == NINEP_POOL_NONE) {
-		free_fid(server, afid);
-		send_error(server, tag, "too many concurrent authentications");
+		send_error(server, tx, tag, "too many concurrent authentications");
 		return;
 	}
 
 	struct ninep_auth_state *auth_state = auth_get(server, auth_idx);
 
-	/* Mark as auth fid */
-	sfid->is_auth_fid = true;
-	sfid->auth_idx = auth_idx;
-	sfid->node = NULL;  /* Auth fids don't point to filesystem nodes */
-
 	/* Store claimed identity */
 	memcpy(auth_state->claimed_identity, uname, uname_len);
 	auth_state->claimed_identity[uname_len] = '\0';
@@ -1149,9 +1576,9 @@ static void handle_tauth(struct ninep_server *server, uint16_t tag,
 		.path = (uint64_t)afid  /* Use afid as unique path */
 	};
 
-	int ret = ninep_build_rauth(server->tx_buf, server->tx_buf_size, tag, &aqid);
+	int ret = ninep_build_rauth(tx->buf, server->tx_buf_size, tag, &aqid);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	}
 }
 
@@ -1164,9 +1591,15 @@ static void handle_tflush(struct ninep_server *server, uint16_t tag,
 
 	/* Cancel a parked (deferred) read for oldtag: answer it with
 	 * Rread count=0, then Rflush — in that order on the wire (hubfs
-	 * convention). Both sends happen under tx_buf_mutex, which the
-	 * dispatch loop already holds, so ordering is guaranteed. A late
-	 * completer for this request will get -ESTALE and drop it. */
+	 * convention). A late completer for this request will get -ESTALE
+	 * and drop it.
+	 *
+	 * If oldtag is still executing on another thread, or waiting for a
+	 * response buffer, mark it flushed so its reply is dropped: flush(5)
+	 * forbids answering a request after its Rflush. Everything happens
+	 * under tx_mutex, the lock every reply is sent under, so no reply to
+	 * oldtag can slip in between. */
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
 	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_PENDING_READS; i++) {
 		struct ninep_pending_read *p = &server->pending_reads[i];
 		if (p->in_use && p->tag == oldtag) {
@@ -1174,20 +1607,36 @@ static void handle_tflush(struct ninep_server *server, uint16_t tag,
 			pending_read_cancel(server, p);
 		}
 	}
+	for (int i = 0; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		struct ninep_server_txbuf *other = &server->tx_bufs[i];
+		if (other->in_use && other->tag == oldtag) {
+			LOG_DBG("Tflush suppresses reply to executing tag %u", oldtag);
+			other->flushed = true;
+		}
+	}
+	for (struct ninep_server_txwait *w = server->tx_waiters; w; w = w->next) {
+		if (w->tag == oldtag) {
+			LOG_DBG("Tflush drops tag %u waiting for a buffer", oldtag);
+			w->flushed = true;
+		}
+	}
 
-	int ret = ninep_build_rflush(server->tx_buf, server->tx_buf_size, tag);
+	uint8_t rflush[7];
+	int ret = ninep_build_rflush(rflush, sizeof(rflush), tag);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		ninep_transport_send(server->transport, rflush, ret);
 	}
+	k_mutex_unlock(&server->tx_mutex);
 }
 
 /* Handle Tcreate */
-static void handle_tcreate(struct ninep_server *server, uint16_t tag,
+static void handle_tcreate(struct ninep_server *server,
+                           struct ninep_server_txbuf *tx, uint16_t tag,
                            const uint8_t *msg, size_t len)
 {
 	/* size[4] type[1] tag[2] fid[4] name[s] perm[4] mode[1] */
 	if (len < 13) {
-		send_error(server, tag, "malformed Tcreate");
+		send_error(server, tx, tag, "malformed Tcreate");
 		return;
 	}
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
@@ -1195,7 +1644,7 @@ static void handle_tcreate(struct ninep_server *server, uint16_t tag,
 
 	/* Refuse to index perm/mode past the received frame. */
 	if (len < (size_t)(13 + name_len + 5)) {
-		send_error(server, tag, "malformed Tcreate");
+		send_error(server, tx, tag, "malformed Tcreate");
 		return;
 	}
 	const char *name = (const char *)&msg[13];
@@ -1206,21 +1655,21 @@ static void handle_tcreate(struct ninep_server *server, uint16_t tag,
 	LOG_DBG("Tcreate: fid=%u, name=%.*s, perm=0x%x, mode=%u",
 	        fid, name_len, name, perm, mode);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 	if (!sfid || !sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
 	/* Check if filesystem supports create */
 	if (!server->config.fs_ops->create) {
-		send_error(server, tag, "create not supported");
+		send_error(server, tx, tag, "create not supported");
 		return;
 	}
 
 	/* Permission check: creating a child in the parent dir requires
 	 * write permission on the parent's path. */
-	if (check_perm_or_deny(server, tag, sfid, NINEP_OWRITE) < 0) {
+	if (check_perm_or_deny(server, tx, tag, sfid, NINEP_OWRITE) < 0) {
 		return;
 	}
 
@@ -1231,7 +1680,7 @@ static void handle_tcreate(struct ninep_server *server, uint16_t tag,
 		sfid->node, name, name_len, perm, mode, uname, &new_node, server->config.fs_ctx);
 
 	if (ret < 0 || !new_node) {
-		send_error_errno(server, tag, ret, "create failed");
+		send_error_errno(server, tx, tag, ret, "create failed");
 		return;
 	}
 
@@ -1246,22 +1695,23 @@ static void handle_tcreate(struct ninep_server *server, uint16_t tag,
 	sfid->open_mode = mode;
 
 	/* Send Rcreate */
-	ret = ninep_build_rcreate(server->tx_buf, server->tx_buf_size,
+	ret = ninep_build_rcreate(tx->buf, server->tx_buf_size,
 	                          tag, &new_node->qid, sfid->iounit);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	} else {
-		send_error(server, tag, "rcreate build failed");
+		send_error(server, tx, tag, "rcreate build failed");
 	}
 }
 
 /* Handle Twrite */
-static void handle_twrite(struct ninep_server *server, uint16_t tag,
+static void handle_twrite(struct ninep_server *server,
+                          struct ninep_server_txbuf *tx, uint16_t tag,
                           const uint8_t *msg, size_t len)
 {
 	/* size[4] type[1] tag[2] fid[4] offset[8] count[4] data[count] */
 	if (len < 23) {
-		send_error(server, tag, "malformed Twrite");
+		send_error(server, tx, tag, "malformed Twrite");
 		return;
 	}
 
@@ -1275,15 +1725,15 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 
 	/* Refuse to read data past the received frame. */
 	if ((len - 23) < count) {
-		send_error(server, tag, "malformed Twrite");
+		send_error(server, tx, tag, "malformed Twrite");
 		return;
 	}
 
 	LOG_DBG("Twrite: fid=%u, offset=%llu, count=%u", fid, offset, count);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 	if (!sfid) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
@@ -1291,20 +1741,20 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 	if (sfid->is_auth_fid) {
 		struct ninep_auth_state *auth_state = auth_get(server, sfid->auth_idx);
 		if (!auth_state) {
-			send_error(server, tag, "auth state lost");
+			send_error(server, tx, tag, "auth state lost");
 			return;
 		}
 
 		/* Must have read challenge first */
 		if (!auth_state->challenge_issued) {
-			send_error(server, tag, "must read challenge first");
+			send_error(server, tx, tag, "must read challenge first");
 			return;
 		}
 
 		/* Check challenge expiry (60 seconds) */
 		uint64_t now = get_current_time_ms();
 		if (now - auth_state->challenge_time > 60000) {
-			send_error(server, tag, "authentication timeout");
+			send_error(server, tx, tag, "authentication timeout");
 			return;
 		}
 
@@ -1313,7 +1763,7 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 		 * But we don't assume - app callback parses the data */
 		if (count < 2) {  /* Minimum sanity check */
 			LOG_WRN("Auth response too short: %u bytes", count);
-			send_error(server, tag, "invalid auth response");
+			send_error(server, tx, tag, "invalid auth response");
 			return;
 		}
 
@@ -1321,7 +1771,7 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 		const struct ninep_auth_config *auth = server->config.auth_config;
 		if (!auth || !auth->verify_auth) {
 			LOG_ERR("No auth verify callback configured");
-			send_error(server, tag, "auth not configured");
+			send_error(server, tx, tag, "auth not configured");
 			return;
 		}
 
@@ -1340,7 +1790,7 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 			pubkey_size = 32;
 		} else {
 			LOG_WRN("Auth response size %u doesn't match known formats (96 or 129)", count);
-			send_error(server, tag, "invalid auth response size");
+			send_error(server, tx, tag, "invalid auth response size");
 			return;
 		}
 
@@ -1361,33 +1811,35 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 		if (ret != 0) {
 			LOG_WRN("Auth verification failed for identity '%s'",
 			        auth_state->claimed_identity);
-			send_error(server, tag, "authentication failed");
+			send_error(server, tx, tag, "authentication failed");
 			return;
 		}
 
 		LOG_INF("Auth successful for identity '%s'", auth_state->claimed_identity);
 
-		/* Mark as authenticated */
+		/* Mark as authenticated and store the identity in uname
+		 * (interned). Under state_lock: a concurrent Tattach reads
+		 * this auth state to validate its afid. */
+		k_mutex_lock(&server->state_lock, K_FOREVER);
 		auth_state->authenticated = true;
-
-		/* Store authenticated identity in uname (intern it) */
 		if (sfid->uname_idx != NINEP_POOL_NONE) {
 			uname_release(server, sfid->uname_idx);
 		}
 		sfid->uname_idx = uname_intern(server, auth_state->claimed_identity,
 		                               strlen(auth_state->claimed_identity));
+		k_mutex_unlock(&server->state_lock);
 
 		/* Send Rwrite with bytes written */
-		ret = ninep_build_rwrite(server->tx_buf, server->tx_buf_size,
+		ret = ninep_build_rwrite(tx->buf, server->tx_buf_size,
 		                         tag, count);
 		if (ret > 0) {
-			ninep_transport_send(server->transport, server->tx_buf, ret);
+			server_reply(server, tx, ret);
 		}
 		return;
 	}
 
 	if (!sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
@@ -1395,18 +1847,18 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 	 * also stops a client from bypassing the open-time permission check by
 	 * walking straight to a file and writing it. */
 	if (!sfid->is_open) {
-		send_error(server, tag, "fid not open");
+		send_error(server, tx, tag, "fid not open");
 		return;
 	}
 	if ((sfid->open_mode & 3) == NINEP_OREAD ||
 	    (sfid->open_mode & 3) == NINEP_OEXEC) {
-		send_error(server, tag, "fid not open for writing");
+		send_error(server, tx, tag, "fid not open for writing");
 		return;
 	}
 
 	/* Check if filesystem supports write */
 	if (!server->config.fs_ops->write) {
-		send_error(server, tag, "write not supported");
+		send_error(server, tx, tag, "write not supported");
 		return;
 	}
 
@@ -1415,89 +1867,93 @@ static void handle_twrite(struct ninep_server *server, uint16_t tag,
 	int bytes = server->config.fs_ops->write(sfid->node, offset, data, count,
 	                                           uname, server->config.fs_ctx);
 	if (bytes < 0) {
-		send_error_errno(server, tag, bytes, "write failed");
+		send_error_errno(server, tx, tag, bytes, "write failed");
 		return;
 	}
 
 	/* Send Rwrite */
-	int ret = ninep_build_rwrite(server->tx_buf, server->tx_buf_size,
+	int ret = ninep_build_rwrite(tx->buf, server->tx_buf_size,
 	                              tag, bytes);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	} else {
-		send_error(server, tag, "rwrite build failed");
+		send_error(server, tx, tag, "rwrite build failed");
 	}
 }
 
 /* Handle Tremove */
-static void handle_tremove(struct ninep_server *server, uint16_t tag,
+static void handle_tremove(struct ninep_server *server,
+                           struct ninep_server_txbuf *tx, uint16_t tag,
                            const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
 
 	LOG_DBG("Tremove: fid=%u", fid);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 	if (!sfid || !sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
 	/* Check if filesystem supports remove */
 	if (!server->config.fs_ops->remove) {
-		send_error(server, tag, "remove not supported");
+		send_error(server, tx, tag, "remove not supported");
 		return;
 	}
 
 	/* Permission check: removing requires write permission on the path. */
-	if (check_perm_or_deny(server, tag, sfid, NINEP_OWRITE) < 0) {
+	if (check_perm_or_deny(server, tx, tag, sfid, NINEP_OWRITE) < 0) {
 		return;
 	}
 
 	/* Remove file/directory */
+	dir_cursor_release(server, sfid);
 	int ret = server->config.fs_ops->remove(sfid->node, server->config.fs_ctx);
 	if (ret < 0) {
-		send_error_errno(server, tag, ret, "remove failed");
+		send_error_errno(server, tx, tag, ret, "remove failed");
 		return;
 	}
 
 	/* Free FID */
-	free_fid(server, fid);
+	fid_destroy(server, fid);
 
 	/* Send Rremove */
-	ret = ninep_build_rremove(server->tx_buf, server->tx_buf_size, tag);
+	ret = ninep_build_rremove(tx->buf, server->tx_buf_size, tag);
 	if (ret > 0) {
-		ninep_transport_send(server->transport, server->tx_buf, ret);
+		server_reply(server, tx, ret);
 	}
 }
 
 /* Handle Twstat */
-static void handle_twstat(struct ninep_server *server, uint16_t tag,
+static void handle_twstat(struct ninep_server *server,
+                          struct ninep_server_txbuf *tx, uint16_t tag,
                           const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
 
 	LOG_DBG("Twstat: fid=%u", fid);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 	if (!sfid || !sfid->node) {
-		send_error(server, tag, "unknown fid");
+		send_error(server, tx, tag, "unknown fid");
 		return;
 	}
 
 	/* Most embedded filesystems don't support metadata modification */
-	send_error(server, tag, "wstat not supported");
+	send_error(server, tx, tag, "wstat not supported");
 }
 
 /* Handle Tclunk */
-static void handle_tclunk(struct ninep_server *server, uint16_t tag,
+static void handle_tclunk(struct ninep_server *server,
+                          struct ninep_server_txbuf *tx, uint16_t tag,
                           const uint8_t *msg, size_t len)
 {
 	uint32_t fid = msg[7] | (msg[8] << 8) | (msg[9] << 16) | (msg[10] << 24);
 
 	LOG_INF("Tclunk: fid=%u tag=%u", fid, tag);
 
-	struct ninep_server_fid *sfid = find_fid(server, fid);
+	struct ninep_server_fid *sfid = fid_acquire(server, tx, fid);
 
 	/*
 	 * Per 9P2000 spec: "The clunk request informs the file server that the
@@ -1509,6 +1965,7 @@ static void handle_tclunk(struct ninep_server *server, uint16_t tag,
 	if (sfid) {
 		/* Answer any parked reads on this fid with Rread count=0
 		 * before the fs clunk drops their wait-registry entries. */
+		k_mutex_lock(&server->tx_mutex, K_FOREVER);
 		for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_PENDING_READS; i++) {
 			struct ninep_pending_read *p = &server->pending_reads[i];
 			if (p->in_use && p->fid == fid) {
@@ -1516,26 +1973,61 @@ static void handle_tclunk(struct ninep_server *server, uint16_t tag,
 				pending_read_cancel(server, p);
 			}
 		}
+		k_mutex_unlock(&server->tx_mutex);
 
 		/* Call filesystem clunk handler if available */
+		dir_cursor_release(server, sfid);
 		if (server->config.fs_ops->clunk && sfid->node) {
 			server->config.fs_ops->clunk(sfid->node, server->config.fs_ctx);
 		}
 
 		/* Free FID */
-		free_fid(server, fid);
+		fid_destroy(server, fid);
 	} else {
 		LOG_DBG("Tclunk: fid %u not found (already clunked or never allocated)", fid);
 	}
 
 	/* Always send Rclunk per 9P2000 spec */
-	int ret = ninep_build_rclunk(server->tx_buf, server->tx_buf_size, tag);
+	int ret = ninep_build_rclunk(tx->buf, server->tx_buf_size, tag);
 	if (ret > 0) {
-		int send_ret = ninep_transport_send(server->transport, server->tx_buf, ret);
+		int send_ret = server_reply(server, tx, ret);
 		LOG_INF("Rclunk sent: tag=%u, ret=%d", tag, send_ret);
 	}
 }
 
+/*
+ * Dispatch gate. Ordinary requests run concurrently; Tversion resets the
+ * whole session, so it waits for every executing request to finish and
+ * holds off new ones until it is done.
+ */
+static void dispatch_enter(struct ninep_server *server, bool exclusive)
+{
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	while (server->exclusive) {
+		k_condvar_wait(&server->state_cv, &server->state_lock, K_FOREVER);
+	}
+	if (exclusive) {
+		server->exclusive = true;
+		while (server->active_reqs > 0) {
+			k_condvar_wait(&server->state_cv, &server->state_lock,
+			               K_FOREVER);
+		}
+	}
+	server->active_reqs++;
+	k_mutex_unlock(&server->state_lock);
+}
+
+static void dispatch_exit(struct ninep_server *server, bool exclusive)
+{
+	k_mutex_lock(&server->state_lock, K_FOREVER);
+	server->active_reqs--;
+	if (exclusive) {
+		server->exclusive = false;
+	}
+	k_condvar_broadcast(&server->state_cv);
+	k_mutex_unlock(&server->state_lock);
+}
+
 /* Message dispatcher */
 void ninep_server_process_message(struct ninep_server *server,
                                    const uint8_t *msg, size_t len)
@@ -1554,55 +2046,81 @@ void ninep_server_process_message(struct ninep_server *server,
 
 	LOG_INF("Received 9P message: type=%u, tag=%u, size=%u", hdr.type, hdr.tag, hdr.size);
 
-	k_mutex_lock(&server->tx_buf_mutex, K_FOREVER);
+	/* Tflush needs no response buffer, so it is never stuck behind the
+	 * requests it cancels */
+	if (hdr.type == NINEP_TFLUSH) {
+		dispatch_enter(server, false);
+		handle_tflush(server, hdr.tag, msg, len);
+		dispatch_exit(server, false);
+		return;
+	}
+
+	/* Each request executes with its own response buffer; this blocks
+	 * while CONFIG_NINEP_SERVER_TX_BUFS requests are already running. */
+	struct ninep_server_txbuf *tx = txbuf_get(server, hdr.tag);
+
+	if (!tx) {
+		LOG_ERR("No response buffer (server not initialized?)");
+		return;
+	}
+
+	/* Flushed while it waited: Rflush is out, so it must not run */
+	if (tx->flushed) {
+		LOG_DBG("Dropping flushed tag %u", hdr.tag);
+		txbuf_put(server, tx);
+		return;
+	}
+
+	bool exclusive = (hdr.type == NINEP_TVERSION);
+
+	dispatch_enter(server, exclusive);
 
 	switch (hdr.type) {
 	case NINEP_TVERSION:
-		handle_tversion(server, msg, len);
+		handle_tversion(server, tx, msg, len);
 		break;
 	case NINEP_TAUTH:
-		handle_tauth(server, hdr.tag, msg, len);
+		handle_tauth(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TATTACH:
-		handle_tattach(server, hdr.tag, msg, len);
-		break;
-	case NINEP_TFLUSH:
-		handle_tflush(server, hdr.tag, msg, len);
+		handle_tattach(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TWALK:
-		handle_twalk(server, hdr.tag, msg, len);
+		handle_twalk(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TOPEN:
-		handle_topen(server, hdr.tag, msg, len);
+		handle_topen(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TCREATE:
-		handle_tcreate(server, hdr.tag, msg, len);
+		handle_tcreate(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TREAD:
-		handle_tread(server, hdr.tag, msg, len);
+		handle_tread(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TWRITE:
-		handle_twrite(server, hdr.tag, msg, len);
+		handle_twrite(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TCLUNK:
-		handle_tclunk(server, hdr.tag, msg, len);
+		handle_tclunk(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TREMOVE:
-		handle_tremove(server, hdr.tag, msg, len);
+		handle_tremove(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TSTAT:
-		handle_tstat(server, hdr.tag, msg, len);
+		handle_tstat(server, tx, hdr.tag, msg, len);
 		break;
 	case NINEP_TWSTAT:
-		handle_twstat(server, hdr.tag, msg, len);
+		handle_twstat(server, tx, hdr.tag, msg, len);
 		break;
 	default:
 		LOG_WRN("Unhandled message type: %u", hdr.type);
-		send_error(server, hdr.tag, "operation not supported");
+		send_error(server, tx, hdr.tag, "operation not supported");
 		break;
 	}
 
-	k_mutex_unlock(&server->tx_buf_mutex);
+	fid_release_all(server, tx);
+	dispatch_exit(server, exclusive);
+	txbuf_put(server, tx);
 }
 
 int ninep_server_read_complete(struct ninep_read_handle h,
@@ -1627,7 +2145,11 @@ int ninep_server_read_complete(struct ninep_read_handle h,
 
 	int ret = 0;
 
-	k_mutex_lock(&server->tx_buf_mutex, K_FOREVER);
+	/* The completer's data is sent in place when the transport supports
+	 * sendv. Otherwise it is gathered into cpl_buf rather than a pool
+	 * buffer: the completing thread may itself be inside a request
+	 * holding one. */
+	k_mutex_lock(&server->tx_mutex, K_FOREVER);
 	struct ninep_pending_read *p = &server->pending_reads[h.slot];
 	if (!p->in_use || p->gen != h.gen) {
 		/* Flushed, clunked, or session reset since parking. Normal. */
@@ -1639,24 +2161,15 @@ int ninep_server_read_complete(struct ninep_read_handle h,
 		if (len > server->tx_buf_size - 11) {
 			len = server->tx_buf_size - 11;
 		}
-		if (len > 0) {
-			memcpy(&server->tx_buf[11], data, len);
-		}
-		int msg_size = ninep_build_rread(server->tx_buf, server->tx_buf_size,
-		                                 p->tag, (uint32_t)len);
-		if (msg_size > 0) {
-			int sret = ninep_transport_send(server->transport,
-			                                server->tx_buf, msg_size);
-			if (sret < 0) {
-				ret = sret;
-			}
-		} else {
-			ret = (msg_size < 0) ? msg_size : -EINVAL;
+		int sret = send_rread_data(server, server->cpl_buf, p->tag,
+		                           data, (uint32_t)len);
+		if (sret < 0) {
+			ret = sret;
 		}
 		/* The request is answered (or unanswerable) either way. */
 		p->in_use = false;
 	}
-	k_mutex_unlock(&server->tx_buf_mutex);
+	k_mutex_unlock(&server->tx_mutex);
 
 	k_mutex_lock(&server->pending_lock, K_FOREVER);
 	server->completions_active--;
@@ -1684,7 +2197,10 @@ int ninep_server_init(struct ninep_server *server,
 	}
 
 	memset(server, 0, sizeof(*server));
-	k_mutex_init(&server->tx_buf_mutex);
+	fid_table_reset(server);
+	k_mutex_init(&server->tx_mutex);
+	k_mutex_init(&server->state_lock);
+	k_condvar_init(&server->state_cv);
 	k_mutex_init(&server->pending_lock);
 	k_condvar_init(&server->pending_cv);
 	/* Copy config by value instead of storing pointer */
@@ -1702,17 +2218,34 @@ int ninep_server_init(struct ninep_server *server,
 	}
 	server->rx_buf_size = buf_size;
 
-	server->tx_buf = k_malloc(buf_size);
-	if (!server->tx_buf) {
-		LOG_ERR("Failed to allocate %zu bytes for TX buffer", buf_size);
-		k_free(server->rx_buf);
-		server->rx_buf = NULL;
-		return -ENOMEM;
+	for (int i = 0; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		server->tx_bufs[i].buf = k_malloc(buf_size);
+		if (!server->tx_bufs[i].buf) {
+			LOG_ERR("Failed to allocate %zu bytes for TX buffer %d",
+			        buf_size, i);
+			goto err_free;
+		}
 	}
 	server->tx_buf_size = buf_size;
 
-	LOG_INF("9P server buffers allocated: RX=%zu TX=%zu bytes (may be PSRAM)",
-	        buf_size, buf_size);
+	/* Only backends that complete reads asynchronously need a buffer for
+	 * replies sent outside a request, and scatter-gather transports send
+	 * those from the completer's buffer directly */
+	if (config->fs_ops && config->fs_ops->read_deferred &&
+	    !ninep_transport_has_sendv(transport)) {
+		server->cpl_buf = k_malloc(buf_size);
+		if (!server->cpl_buf) {
+			LOG_ERR("Failed to allocate %zu bytes for completion buffer",
+			        buf_size);
+			goto err_free;
+		}
+	}
+
+	k_sem_init(&server->tx_bufs_free, CONFIG_NINEP_SERVER_TX_BUFS,
+	           CONFIG_NINEP_SERVER_TX_BUFS);
+
+	LOG_INF("9P server buffers allocated: RX=%zu TX=%d x %zu bytes (may be PSRAM)",
+	        buf_size, CONFIG_NINEP_SERVER_TX_BUFS, buf_size);
 
 	/* Set transport callback (only for network servers) */
 	if (transport) {
@@ -1724,6 +2257,15 @@ int ninep_server_init(struct ninep_server *server,
 	}
 
 	return 0;
+
+err_free:
+	for (int i = 0; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		k_free(server->tx_bufs[i].buf);
+		server->tx_bufs[i].buf = NULL;
+	}
+	k_free(server->rx_buf);
+	server->rx_buf = NULL;
+	return -ENOMEM;
 }
 
 void ninep_server_cleanup(struct ninep_server *server)
@@ -1735,10 +2277,10 @@ void ninep_server_cleanup(struct ninep_server *server)
 	LOG_INF("Cleaning up 9P server - clunking open fids");
 
 	/* Teardown gate for deferred reads: refuse new completions, then wait
-	 * for any completion currently inside (or blocked on) tx_buf_mutex to
+	 * for any completion currently inside (or blocked on) tx_mutex to
 	 * drain. After this, no other thread can touch this server, so it is
 	 * safe for the caller to free/unwind the server's memory once we
-	 * return. pending_lock is never held while acquiring tx_buf_mutex,
+	 * return. pending_lock is never held while acquiring tx_mutex,
 	 * and we hold no other lock here, so this cannot deadlock. */
 	k_mutex_lock(&server->pending_lock, K_FOREVER);
 	server->dying = true;
@@ -1760,6 +2302,7 @@ void ninep_server_cleanup(struct ninep_server *server)
 				LOG_DBG("Cleanup: clunking fid %u node '%s'", sfid->fid, sfid->node->name);
 
 				/* Call filesystem clunk handler if available */
+				dir_cursor_release(server, sfid);
 				if (server->config.fs_ops && server->config.fs_ops->clunk) {
 					server->config.fs_ops->clunk(sfid->node, server->config.fs_ctx);
 				}
@@ -1779,6 +2322,7 @@ void ninep_server_cleanup(struct ninep_server *server)
 			sfid->in_use = false;
 		}
 	}
+	fid_table_reset(server);
 
 	/* Free dynamically allocated buffers */
 	if (server->rx_buf) {
@@ -1786,11 +2330,13 @@ void ninep_server_cleanup(struct ninep_server *server)
 		server->rx_buf = NULL;
 		server->rx_buf_size = 0;
 	}
-	if (server->tx_buf) {
-		k_free(server->tx_buf);
-		server->tx_buf = NULL;
-		server->tx_buf_size = 0;
+	for (int i = 0; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		k_free(server->tx_bufs[i].buf);
+		server->tx_bufs[i].buf = NULL;
 	}
+	server->tx_buf_size = 0;
+	k_free(server->cpl_buf);
+	server->cpl_buf = NULL;
 
 	LOG_INF("9P server cleanup complete");
 }
@@ -69,10 +69,13 @@ static struct bt_l2cap_chan_ops l2cap_session_chan_ops = {
 /* Transport operations for session-based L2CAP */
 static int l2cap_session_send(struct ninep_transport *transport, const uint8_t *buf,
                                size_t len);
+static int l2cap_session_sendv(struct ninep_transport *transport,
+                               const struct ninep_iovec *iov, int iovcnt);
 static int l2cap_session_get_mtu(struct ninep_transport *transport);
 
 static const struct ninep_transport_ops l2cap_session_transport_ops = {
 	.send = l2cap_session_send,
+	.sendv = l2cap_session_sendv,
 	.get_mtu = l2cap_session_get_mtu,
 	/* start/stop not needed - managed by session pool */
 };
@@ -303,13 +306,20 @@ static int l2cap_session_accept(struct bt_conn *conn, struct bt_l2cap_server *se
 	return 0;
 }
 
-static int l2cap_session_send(struct ninep_transport *transport, const uint8_t *buf,
-                               size_t len)
+/* Pieces are gathered straight into the TX net_buf, which the stack
+ * keeps until the SDU is sent; see l2cap_sendv() in transport_l2cap.c */
+static int l2cap_session_sendv(struct ninep_transport *transport,
+                               const struct ninep_iovec *iov, int iovcnt)
 {
 	struct l2cap_session_chan *chan = transport->priv_data;
 	struct net_buf *msg_buf;
+	size_t len = 0;
 	int ret;
 
+	for (int i = 0; i < iovcnt; i++) {
+		len += iov[i].len;
+	}
+
 	if (!chan || !chan->session || chan->session->state != NINEP_SESSION_CONNECTED) {
 		return -ENOTCONN;
 	}
@@ -328,8 +338,16 @@ static int l2cap_session_send(struct ninep_transport *transport, const uint8_t *
 	/* Reserve L2CAP SDU headroom */
 	net_buf_reserve(msg_buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
 
-	/* Copy message data to net_buf */
-	net_buf_add_mem(msg_buf, buf, len);
+	if (net_buf_tailroom(msg_buf) < len) {
+		LOG_ERR("Message of %zu bytes exceeds TX buffer", len);
+		net_buf_unref(msg_buf);
+		return -EMSGSIZE;
+	}
+
+	/* Gather message pieces into the net_buf */
+	for (int i = 0; i < iovcnt; i++) {
+		net_buf_add_mem(msg_buf, iov[i].base, iov[i].len);
+	}
 
 	/* Send via L2CAP channel */
 	ret = bt_l2cap_chan_send(&chan->le.chan, msg_buf);
@@ -343,6 +361,14 @@ static int l2cap_session_send(struct ninep_transport *transport, const uint8_t *
 	return len;
 }
 
+static int l2cap_session_send(struct ninep_transport *transport, const uint8_t *buf,
+                               size_t len)
+{
+	struct ninep_iovec iov = { .base = buf, .len = len };
+
+	return l2cap_session_sendv(transport, &iov, 1);
+}
+
 static int l2cap_session_get_mtu(struct ninep_transport *transport)
 {
 	struct l2cap_session_chan *chan = transport->priv_data;
@@ -0,0 +1,679 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/9p/session_pool_tcp.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(ninep_session_pool_tcp, CONFIG_NINEP_LOG_LEVEL);
+
+#define TCP_POOL_THREAD_PRIORITY 5
+
+/* How long the pool thread blocks in zsock_poll() before re-checking
+ * pool->active, so ninep_session_pool_tcp_stop() can join it promptly. */
+#define TCP_POOL_POLL_TIMEOUT_MS 100
+
+/* 9P size[4] type[1] tag[2] */
+#define TCP_HDR_SIZE 7
+
+/* Most pieces a single sendv() call accepts (header + data + slack) */
+#define TCP_SENDV_MAX_IOV 4
+
+/* Transport operations for session-based TCP */
+static int tcp_session_send(struct ninep_transport *transport, const uint8_t *buf,
+                            size_t len);
+static int tcp_session_sendv(struct ninep_transport *transport,
+                             const struct ninep_iovec *iov, int iovcnt);
+
+static const struct ninep_transport_ops tcp_session_transport_ops = {
+	.send = tcp_session_send,
+	.sendv = tcp_session_sendv,
+	/* start/stop not needed - managed by session pool */
+};
+
+static void tcp_session_log_peer(int session_id,
+                                 const struct sockaddr_storage *client_addr)
+{
+	char addr_str[INET6_ADDRSTRLEN];
+
+	if (client_addr->ss_family == AF_INET6) {
+		const struct sockaddr_in6 *addr6 =
+			(const struct sockaddr_in6 *)client_addr;
+		zsock_inet_ntop(AF_INET6, &addr6->sin6_addr,
+		               addr_str, sizeof(addr_str));
+		LOG_INF("Session %d: client connected from [%s]:%d",
+		        session_id, addr_str, ntohs(addr6->sin6_port));
+	} else {
+		const struct sockaddr_in *addr4 =
+			(const struct sockaddr_in *)client_addr;
+		zsock_inet_ntop(AF_INET, &addr4->sin_addr,
+		               addr_str, sizeof(addr_str));
+		LOG_INF("Session %d: client connected from %s:%d",
+		        session_id, addr_str, ntohs(addr4->sin_port));
+	}
+}
+
+/* Close a connection and return its session (and all its fids) to the pool */
+static void tcp_session_drop(struct tcp_session_conn *conn)
+{
+	struct ninep_session *session = conn->session;
+
+	zsock_close(conn->sock);
+	conn->sock = -1;
+	conn->rx_head = 0;
+	conn->rx_tail = 0;
+	conn->session = NULL;
+
+	if (session) {
+		ninep_session_free(session);
+	}
+}
+
+/*
+ * Deliver every complete 9P message sitting in [rx_head, rx_tail) to the
+ * connection's server, in place. Same framing as the single-client TCP
+ * transport: afterwards the window is reset when empty, or a trailing
+ * partial message is moved to the front of rx_buf if the rest of it would
+ * not fit before the end of the buffer.
+ *
+ * Returns 0, or -EMSGSIZE / -EINVAL if the stream cannot be framed.
+ */
+static int tcp_session_frame_messages(struct tcp_session_conn *conn)
+{
+	struct ninep_transport *transport = &conn->session->transport;
+	size_t need = TCP_HDR_SIZE;
+
+	while (conn->rx_tail - conn->rx_head >= TCP_HDR_SIZE) {
+		const uint8_t *msg = &conn->rx_buf[conn->rx_head];
+		size_t avail = conn->rx_tail - conn->rx_head;
+		struct ninep_msg_header hdr;
+
+		if (ninep_parse_header(msg, avail, &hdr) < 0) {
+			LOG_WRN("Session %d: invalid header, dropping connection",
+			        conn->session->session_id);
+			return -EINVAL;
+		}
+		if (hdr.size > conn->rx_buf_size) {
+			LOG_WRN("Session %d: message of %u bytes exceeds RX buffer (%zu)",
+			        conn->session->session_id, hdr.size, conn->rx_buf_size);
+			return -EMSGSIZE;
+		}
+		if (avail < hdr.size) {
+			need = hdr.size;
+			break;
+		}
+
+		if (transport->recv_cb) {
+			transport->recv_cb(transport, msg, hdr.size,
+			                   transport->user_data);
+		}
+		conn->rx_head += hdr.size;
+	}
+
+	if (conn->rx_head == conn->rx_tail) {
+		conn->rx_head = 0;
+		conn->rx_tail = 0;
+	} else if (conn->rx_head + need > conn->rx_buf_size) {
+		size_t pending = conn->rx_tail - conn->rx_head;
+
+		memmove(conn->rx_buf, &conn->rx_buf[conn->rx_head], pending);
+		conn->rx_head = 0;
+		conn->rx_tail = pending;
+	}
+
+	return 0;
+}
+
+/*
+ * Service one readable connection: a single bulk recv followed by dispatch
+ * of whatever complete messages it produced. Bounding each connection to
+ * one recv per poll round is what keeps servicing fair.
+ */
+static void tcp_session_service(struct tcp_session_conn *conn)
+{
+	int ret = zsock_recv(conn->sock, &conn->rx_buf[conn->rx_tail],
+	                     conn->rx_buf_size - conn->rx_tail, ZSOCK_MSG_DONTWAIT);
+
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return;
+		}
+		LOG_ERR("Session %d: receive error: %d",
+		        conn->session->session_id, errno);
+		tcp_session_drop(conn);
+		return;
+	} else if (ret == 0) {
+		LOG_INF("Session %d: client disconnected", conn->session->session_id);
+		tcp_session_drop(conn);
+		return;
+	}
+
+	conn->rx_tail += ret;
+
+	if (tcp_session_frame_messages(conn) < 0) {
+		tcp_session_drop(conn);
+	}
+}
+
+static void tcp_session_accept(struct ninep_session_pool_tcp *tcp_pool)
+{
+	struct sockaddr_storage client_addr;
+	socklen_t client_addr_len = sizeof(client_addr);
+	int sock;
+
+	sock = zsock_accept(tcp_pool->listen_sock, (struct sockaddr *)&client_addr,
+	                    &client_addr_len);
+	if (sock < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			LOG_ERR("Accept failed: %d", errno);
+		}
+		return;
+	}
+
+	/* Allocate a session from the generic pool */
+	struct ninep_session *session = ninep_session_alloc(tcp_pool->pool);
+
+	if (!session) {
+		/* Closing right away lets the client fail fast instead of
+		 * waiting on a connection that will never be serviced. */
+		LOG_WRN("Connection limit (%d) reached, rejecting client",
+		        tcp_pool->config.max_sessions);
+		zsock_close(sock);
+		return;
+	}
+
+	struct tcp_session_conn *conn = &tcp_pool->conns[session->session_id];
+
+	memset(conn, 0, sizeof(*conn));
+	conn->sock = sock;
+	conn->session = session;
+	conn->rx_buf = tcp_pool->rx_buf_pool +
+	               (session->session_id * tcp_pool->config.rx_buf_size_per_session);
+	conn->rx_buf_size = tcp_pool->config.rx_buf_size_per_session;
+
+	/* Initialize transport for this session */
+	session->transport.ops = &tcp_session_transport_ops;
+	session->transport.priv_data = conn;
+	session->transport_priv = conn;
+
+	/* Initialize 9P server for this session */
+	struct ninep_server_config server_config = {
+		.fs_ops = tcp_pool->pool->fs_ops,
+		.fs_ctx = tcp_pool->pool->fs_context,
+		.auth_config = tcp_pool->pool->auth_config,
+	};
+
+	int ret = ninep_server_init(&session->server, &server_config, &session->transport);
+
+	if (ret < 0) {
+		LOG_ERR("Failed to initialize 9P server for session %d: %d",
+		        session->session_id, ret);
+		tcp_session_drop(conn);
+		return;
+	}
+
+	ninep_session_connected(session);
+	tcp_session_log_peer(session->session_id, &client_addr);
+}
+
+static void tcp_pool_thread_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	struct ninep_session_pool_tcp *tcp_pool = arg1;
+	struct zsock_pollfd *fds = tcp_pool->pollfds;
+	int max_sessions = tcp_pool->config.max_sessions;
+
+	LOG_INF("TCP session pool thread started");
+
+	while (tcp_pool->active) {
+		/* fds[0] is the listen socket, fds[1 + i] belongs to conns[i].
+		 * Idle slots carry fd -1, which zsock_poll() ignores. */
+		fds[0].fd = tcp_pool->listen_sock;
+		fds[0].events = ZSOCK_POLLIN;
+		fds[0].revents = 0;
+		for (int i = 0; i < max_sessions; i++) {
+			fds[1 + i].fd = tcp_pool->conns[i].sock;
+			fds[1 + i].events = ZSOCK_POLLIN;
+			fds[1 + i].revents = 0;
+		}
+
+		int ret = zsock_poll(fds, max_sessions + 1, TCP_POOL_POLL_TIMEOUT_MS);
+
+		if (ret < 0) {
+			if (errno != EINTR) {
+				LOG_ERR("Poll failed: %d", errno);
+				k_sleep(K_MSEC(TCP_POOL_POLL_TIMEOUT_MS));
+			}
+			continue;
+		} else if (ret == 0) {
+			continue;
+		}
+
+		/* One recv per ready connection, starting from a rotating
+		 * index so no client is always served first. POLLHUP is
+		 * treated as readable: recv() then returns 0 (EOF). */
+		for (int n = 0; n < max_sessions; n++) {
+			int i = (tcp_pool->next_conn + n) % max_sessions;
+			struct tcp_session_conn *conn = &tcp_pool->conns[i];
+			short revents = fds[1 + i].revents;
+
+			if (conn->sock < 0 || revents == 0) {
+				continue;
+			}
+			if (revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
+				LOG_WRN("Session %d: socket error, dropping",
+				        conn->session->session_id);
+				tcp_session_drop(conn);
+				continue;
+			}
+			tcp_session_service(conn);
+		}
+		tcp_pool->next_conn = (tcp_pool->next_conn + 1) % max_sessions;
+
+		/* Accept after servicing so fds[] still matches conns[] above */
+		if (fds[0].revents & ZSOCK_POLLIN) {
+			tcp_session_accept(tcp_pool);
+		}
+	}
+
+	LOG_INF("TCP session pool thread exiting");
+}
+
+static int tcp_session_send(struct ninep_transport *transport, const uint8_t *buf,
+                            size_t len)
+{
+	struct tcp_session_conn *conn = transport->priv_data;
+	size_t sent = 0;
+
+	if (!conn || conn->sock < 0) {
+		return -ENOTCONN;
+	}
+
+	while (sent < len) {
+		int ret = zsock_send(conn->sock, buf + sent, len - sent, 0);
+
+		if (ret < 0) {
+			LOG_ERR("Session %d: send failed: %d",
+			        conn->session ? conn->session->session_id : -1, errno);
+			return -errno;
+		}
+		sent += ret;
+	}
+
+	LOG_DBG("Sent %zu bytes", sent);
+	return sent;
+}
+
+static int tcp_session_sendv(struct ninep_transport *transport,
+                             const struct ninep_iovec *iov, int iovcnt)
+{
+	struct tcp_session_conn *conn = transport->priv_data;
+	struct iovec vec[TCP_SENDV_MAX_IOV];
+	struct msghdr msg = { 0 };
+	size_t total = 0;
+	size_t sent = 0;
+
+	if (!conn || conn->sock < 0) {
+		return -ENOTCONN;
+	}
+	if (iovcnt > TCP_SENDV_MAX_IOV) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < iovcnt; i++) {
+		vec[i].iov_base = (void *)iov[i].base;
+		vec[i].iov_len = iov[i].len;
+		total += iov[i].len;
+	}
+	msg.msg_iov = vec;
+	msg.msg_iovlen = iovcnt;
+
+	while (sent < total) {
+		ssize_t ret = zsock_sendmsg(conn->sock, &msg, 0);
+
+		if (ret < 0) {
+			LOG_ERR("Session %d: sendmsg failed: %d",
+			        conn->session ? conn->session->session_id : -1, errno);
+			return -errno;
+		}
+		sent += ret;
+
+		/* Drop the pieces that went out; trim a partly sent one */
+		while (ret > 0) {
+			if ((size_t)ret >= msg.msg_iov->iov_len) {
+				ret -= msg.msg_iov->iov_len;
+				msg.msg_iov++;
+				msg.msg_iovlen--;
+			} else {
+				msg.msg_iov->iov_base = (uint8_t *)msg.msg_iov->iov_base + ret;
+				msg.msg_iov->iov_len -= ret;
+				ret = 0;
+			}
+		}
+	}
+
+	LOG_DBG("Sent %zu bytes (%d pieces)", sent, iovcnt);
+	return sent;
+}
+
+static int tcp_pool_listen(struct ninep_session_pool_tcp *tcp_pool)
+{
+	uint16_t port = tcp_pool->config.port;
+	int sock;
+	int ret;
+
+#if defined(CONFIG_NET_IPV6)
+	/* Use IPv6 socket in dual-stack mode when IPv6 is available */
+	struct sockaddr_in6 addr;
+
+	sock = zsock_socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		LOG_ERR("Failed to create IPv6 socket: %d", errno);
+		return -errno;
+	}
+
+	int opt = 1;
+	ret = zsock_setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+	if (ret < 0) {
+		LOG_WRN("Failed to set SO_REUSEADDR: %d", errno);
+	}
+
+	/* Disable IPv6-only mode to allow IPv4-mapped IPv6 addresses */
+	opt = 0;
+	ret = zsock_setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, &opt, sizeof(opt));
+	if (ret < 0) {
+		LOG_WRN("Failed to set IPV6_V6ONLY: %d", errno);
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin6_family = AF_INET6;
+	addr.sin6_addr = in6addr_any;
+	addr.sin6_port = htons(port);
+#else
+	/* IPv4-only mode when IPv6 is not available */
+	struct sockaddr_in addr;
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		LOG_ERR("Failed to create socket: %d", errno);
+		return -errno;
+	}
+
+	int opt = 1;
+	ret = zsock_setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+	if (ret < 0) {
+		LOG_WRN("Failed to set SO_REUSEADDR: %d", errno);
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = INADDR_ANY;
+	addr.sin_port = htons(port);
+#endif
+
+	ret = zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	if (ret < 0) {
+		ret = -errno;
+		LOG_ERR("Failed to bind to port %d: %d", port, ret);
+		zsock_close(sock);
+		return ret;
+	}
+
+	/* Backlog sized to the pool so simultaneous connects are not refused
+	 * before the poll thread gets to them. */
+	ret = zsock_listen(sock, tcp_pool->config.max_sessions);
+	if (ret < 0) {
+		ret = -errno;
+		LOG_ERR("Failed to listen: %d", ret);
+		zsock_close(sock);
+		return ret;
+	}
+
+	tcp_pool->listen_sock = sock;
+	return 0;
+}
+
+/* Common initialization for both static and dynamic pools */
+static int ninep_session_pool_tcp_init_common(
+	struct ninep_session_pool_tcp *tcp_pool,
+	const struct ninep_session_pool_tcp_config *config)
+{
+	struct ninep_session_pool *pool = tcp_pool->pool;
+	int ret;
+
+	memcpy(&tcp_pool->config, config, sizeof(*config));
+	if (tcp_pool->config.port == 0) {
+		tcp_pool->config.port = 564;  /* Default 9P port */
+	}
+
+	/* Manually initialize pool fields (skip memset to avoid size mismatch
+	 * with the static storage declared by NINEP_SESSION_POOL_TCP_DEFINE) */
+	pool->max_sessions = config->max_sessions;
+	pool->fs_ops = config->fs_ops;
+	pool->fs_context = config->fs_context;
+	pool->auth_config = config->auth_config;
+
+	ret = k_mutex_init(&pool->lock);
+	if (ret < 0) {
+		LOG_ERR("Failed to initialize pool mutex: %d", ret);
+		return ret;
+	}
+
+	for (int i = 0; i < pool->max_sessions; i++) {
+		memset(&pool->sessions[i], 0, sizeof(struct ninep_session));
+		pool->sessions[i].state = NINEP_SESSION_FREE;
+		pool->sessions[i].session_id = i;
+
+		memset(&tcp_pool->conns[i], 0, sizeof(struct tcp_session_conn));
+		tcp_pool->conns[i].sock = -1;
+	}
+
+	tcp_pool->listen_sock = -1;
+	tcp_pool->next_conn = 0;
+	tcp_pool->active = false;
+	tcp_pool->tid = NULL;
+
+	LOG_INF("TCP session pool initialized: port %d, %d sessions, %zu bytes RX per session",
+	        tcp_pool->config.port, config->max_sessions,
+	        config->rx_buf_size_per_session);
+
+	return 0;
+}
+
+int ninep_session_pool_tcp_init(struct ninep_session_pool_tcp *tcp_pool,
+                                 const struct ninep_session_pool_tcp_config *config)
+{
+	if (!tcp_pool || !config || !config->fs_ops || config->max_sessions <= 0 ||
+	    config->rx_buf_size_per_session < TCP_HDR_SIZE) {
+		LOG_ERR("Invalid arguments");
+		return -EINVAL;
+	}
+
+	/* Verify pre-allocated storage is set */
+	if (!tcp_pool->pool || !tcp_pool->rx_buf_pool || !tcp_pool->conns ||
+	    !tcp_pool->pollfds || !tcp_pool->stack) {
+		LOG_ERR("Session pool storage not allocated (use NINEP_SESSION_POOL_TCP_DEFINE)");
+		return -EINVAL;
+	}
+
+	return ninep_session_pool_tcp_init_common(tcp_pool, config);
+}
+
+/* Poll thread stack for a pool created at run time */
+static k_thread_stack_t *pool_stack_alloc(void)
+{
+#ifdef CONFIG_DYNAMIC_THREAD
+	return k_thread_stack_alloc(CONFIG_NINEP_TCP_SESSION_STACK_SIZE, 0);
+#else
+	LOG_ERR("Creating a pool needs CONFIG_DYNAMIC_THREAD "
+	        "(or use NINEP_SESSION_POOL_TCP_DEFINE)");
+	return NULL;
+#endif
+}
+
+static void pool_stack_free(k_thread_stack_t *stack)
+{
+#ifdef CONFIG_DYNAMIC_THREAD
+	if (stack) {
+		(void)k_thread_stack_free(stack);
+	}
+#endif
+}
+
+struct ninep_session_pool_tcp *ninep_session_pool_tcp_create(
+	const struct ninep_session_pool_tcp_config *config)
+{
+	struct ninep_session_pool_tcp *tcp_pool;
+	int n;
+
+	if (!config || !config->fs_ops || config->max_sessions <= 0 ||
+	    config->rx_buf_size_per_session < TCP_HDR_SIZE) {
+		LOG_ERR("Invalid configuration");
+		return NULL;
+	}
+
+	n = config->max_sessions;
+
+	tcp_pool = k_malloc(sizeof(*tcp_pool));
+	if (!tcp_pool) {
+		LOG_ERR("Failed to allocate TCP pool");
+		return NULL;
+	}
+
+	memset(tcp_pool, 0, sizeof(*tcp_pool));
+
+	tcp_pool->pool = k_malloc(ninep_session_pool_size(n));
+	tcp_pool->rx_buf_pool = k_malloc(n * config->rx_buf_size_per_session);
+	tcp_pool->conns = k_malloc(n * sizeof(struct tcp_session_conn));
+	tcp_pool->pollfds = k_malloc((n + 1) * sizeof(struct zsock_pollfd));
+	tcp_pool->stack = pool_stack_alloc();
+
+	if (!tcp_pool->pool || !tcp_pool->rx_buf_pool || !tcp_pool->conns ||
+	    !tcp_pool->pollfds || !tcp_pool->stack) {
+		LOG_ERR("Failed to allocate TCP pool storage");
+		goto fail;
+	}
+
+	memset(tcp_pool->pool, 0, ninep_session_pool_size(n));
+
+	if (ninep_session_pool_tcp_init_common(tcp_pool, config) < 0) {
+		goto fail;
+	}
+
+	return tcp_pool;
+
+fail:
+	pool_stack_free(tcp_pool->stack);
+	k_free(tcp_pool->pollfds);
+	k_free(tcp_pool->conns);
+	k_free(tcp_pool->rx_buf_pool);
+	k_free(tcp_pool->pool);
+	k_free(tcp_pool);
+	return NULL;
+}
+
+int ninep_session_pool_tcp_start(struct ninep_session_pool_tcp *tcp_pool)
+{
+	int ret;
+
+	if (!tcp_pool) {
+		return -EINVAL;
+	}
+
+	if (tcp_pool->active) {
+		return -EALREADY;
+	}
+
+	ret = tcp_pool_listen(tcp_pool);
+	if (ret < 0) {
+		return ret;
+	}
+
+	tcp_pool->active = true;
+	tcp_pool->tid = k_thread_create(&tcp_pool->thread, tcp_pool->stack,
+	                                CONFIG_NINEP_TCP_SESSION_STACK_SIZE,
+	                                tcp_pool_thread_fn, tcp_pool, NULL, NULL,
+	                                TCP_POOL_THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(tcp_pool->tid, "9p_tcp_pool");
+
+	LOG_INF("TCP session pool listening on port %d (%d sessions)",
+	        tcp_pool->config.port, tcp_pool->config.max_sessions);
+	return 0;
+}
+
+void ninep_session_pool_tcp_stop(struct ninep_session_pool_tcp *tcp_pool)
+{
+	if (!tcp_pool) {
+		return;
+	}
+
+	LOG_INF("Stopping TCP session pool");
+
+	tcp_pool->active = false;
+
+	/* Every session is only ever touched from the pool thread, so once it
+	 * has exited the connections can be torn down without locking. */
+	if (tcp_pool->tid) {
+		k_thread_join(tcp_pool->tid, K_FOREVER);
+		tcp_pool->tid = NULL;
+	}
+
+	for (int i = 0; i < tcp_pool->config.max_sessions; i++) {
+		if (tcp_pool->conns[i].sock >= 0) {
+			tcp_session_drop(&tcp_pool->conns[i]);
+		}
+	}
+
+	if (tcp_pool->listen_sock >= 0) {
+		zsock_close(tcp_pool->listen_sock);
+		tcp_pool->listen_sock = -1;
+	}
+}
+
+void ninep_session_pool_tcp_destroy(struct ninep_session_pool_tcp *tcp_pool)
+{
+	if (!tcp_pool) {
+		return;
+	}
+
+	LOG_INF("Destroying TCP session pool");
+
+	ninep_session_pool_tcp_stop(tcp_pool);
+
+	pool_stack_free(tcp_pool->stack);
+	k_free(tcp_pool->pollfds);
+	k_free(tcp_pool->conns);
+	k_free(tcp_pool->rx_buf_pool);
+	k_free(tcp_pool->pool);
+	k_free(tcp_pool);
+}
+
+int ninep_session_pool_tcp_active(struct ninep_session_pool_tcp *tcp_pool)
+{
+	struct ninep_session_pool *pool;
+	int count = 0;
+
+	if (!tcp_pool) {
+		return 0;
+	}
+
+	pool = tcp_pool->pool;
+
+	k_mutex_lock(&pool->lock, K_FOREVER);
+	for (int i = 0; i < pool->max_sessions; i++) {
+		if (pool->sessions[i].state == NINEP_SESSION_CONNECTED) {
+			count++;
+		}
+	}
+	k_mutex_unlock(&pool->lock);
+
+	return count;
+}
@@ -4,6 +4,7 @@
  */
 
 #include <zephyr/9p/sysfs.h>
+#include <zephyr/9p/node_alloc.h>
 #include <zephyr/9p/protocol.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -13,68 +14,161 @@
 
 LOG_MODULE_REGISTER(ninep_sysfs, CONFIG_NINEP_LOG_LEVEL);
 
-/* Node cache for dynamically created nodes */
+/* Node cache for dynamically created nodes. Nodes are interned by
+ * entry: a walk returns the cached node for its entry if there is one,
+ * and a node no fid holds stays cached, idle, until more than
+ * CONFIG_NINEP_SYSFS_NODE_CACHE are idle; then the least recently used
+ * idle node is freed. The server runs fs ops for different fids in
+ * parallel, so every access to the cache is under node_cache_lock. */
 #define SYSFS_NODE_CACHE_SIZE 32
 
 struct sysfs_node_cache {
-	struct ninep_fs_node nodes[SYSFS_NODE_CACHE_SIZE];
+	struct ninep_fs_node *nodes[SYSFS_NODE_CACHE_SIZE];
 	bool in_use[SYSFS_NODE_CACHE_SIZE];
 	uint32_t last_access[SYSFS_NODE_CACHE_SIZE];  /* For LRU eviction */
-	uint32_t refcount[SYSFS_NODE_CACHE_SIZE];     /* Reference count (open fids) */
+	uint32_t refcount[SYSFS_NODE_CACHE_SIZE];     /* Reference count (fids) */
+	struct ninep_sysfs *owner[SYSFS_NODE_CACHE_SIZE];  /* NULL: detached */
 };
 
 static struct sysfs_node_cache node_cache;
+static K_MUTEX_DEFINE(node_cache_lock);
+
+/* Entries of nodes whose instance was initialized again while fids still
+ * held them: they read as an empty directory or an empty file */
+static struct ninep_sysfs_entry detached_dir = {
+	.path = "",
+	.is_dir = true,
+};
+static struct ninep_sysfs_entry detached_file = {
+	.path = "",
+};
+
+/* Helper: Slot of a cached node, or -1 */
+static int node_slot_locked(struct ninep_fs_node *node)
+{
+	for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
+		if (node_cache.in_use[i] && node_cache.nodes[i] == node) {
+			return i;
+		}
+	}
+	return -1;
+}
 
 /* Helper: Increment node reference count */
 static void incref_node(struct ninep_fs_node *node)
+{
+	k_mutex_lock(&node_cache_lock, K_FOREVER);
+	int i = node_slot_locked(node);
+
+	if (i >= 0) {
+		node_cache.refcount[i]++;
+		LOG_DBG("incref: node=%p name='%s' refcount=%u",
+		        node, node->name, node_cache.refcount[i]);
+	}
+	k_mutex_unlock(&node_cache_lock);
+}
+
+/* Helper: Free the node in slot i and empty the slot */
+static void free_slot_locked(int i)
+{
+	LOG_DBG("Freeing sysfs node: name='%s' idx=%d", node_cache.nodes[i]->name, i);
+	ninep_node_free(node_cache.nodes[i]);
+	node_cache.nodes[i] = NULL;
+	node_cache.in_use[i] = false;
+	node_cache.refcount[i] = 0;
+	node_cache.last_access[i] = 0;
+	node_cache.owner[i] = NULL;
+}
+
+/* Helper: Get the cached node for an entry, taking a reference */
+static struct ninep_fs_node *find_node_locked(struct ninep_sysfs *sysfs,
+                                              struct ninep_sysfs_entry *entry)
 {
 	for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
-		if (node_cache.in_use[i] && &node_cache.nodes[i] == node) {
+		if (node_cache.in_use[i] && node_cache.owner[i] == sysfs &&
+		    node_cache.nodes[i]->data == entry) {
 			node_cache.refcount[i]++;
-			LOG_DBG("incref: node=%p name='%s' refcount=%u",
-			        node, node->name, node_cache.refcount[i]);
-			return;
+			node_cache.last_access[i] = k_uptime_get_32();
+			return node_cache.nodes[i];
 		}
 	}
+	return NULL;
 }
 
-/* Helper: Decrement node reference count */
-static void decref_node(struct ninep_fs_node *node)
+/* Helper: Free least recently used idle nodes down to the idle bound */
+static void trim_idle_locked(void)
 {
-	for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
-		if (node_cache.in_use[i] && &node_cache.nodes[i] == node) {
-			if (node_cache.refcount[i] > 0) {
-				node_cache.refcount[i]--;
-				LOG_DBG("decref: node=%p name='%s' refcount=%u",
-				        node, node->name, node_cache.refcount[i]);
+	for (;;) {
+		uint32_t idle = 0;
+		uint32_t oldest_time = UINT32_MAX;
+		int lru_idx = -1;
+
+		for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
+			if (!node_cache.in_use[i] || node_cache.refcount[i] > 0) {
+				continue;
+			}
+			idle++;
+			if (node_cache.last_access[i] < oldest_time) {
+				oldest_time = node_cache.last_access[i];
+				lru_idx = i;
 			}
+		}
+		if (idle <= CONFIG_NINEP_SYSFS_NODE_CACHE) {
 			return;
 		}
+		free_slot_locked(lru_idx);
 	}
 }
 
-/* Helper: Free a node (mark as not in use) */
-static void free_node(struct ninep_fs_node *node)
+/*
+ * Helper: Drop the cached nodes of an instance being initialized again.
+ * Idle nodes are freed; nodes fids still hold are detached from the
+ * instance and freed on their last clunk. The root, whose entry lives in
+ * the instance itself, is kept for the new instance and returned; NULL
+ * means the instance was never initialized.
+ */
+static struct ninep_fs_node *release_nodes(struct ninep_sysfs *sysfs)
 {
+	struct ninep_fs_node *root = NULL;
+
+	k_mutex_lock(&node_cache_lock, K_FOREVER);
 	for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
-		if (node_cache.in_use[i] && &node_cache.nodes[i] == node) {
-			LOG_DBG("Freeing sysfs node: name='%s' idx=%d", node->name, i);
-			node_cache.in_use[i] = false;
-			node_cache.refcount[i] = 0;
-			node_cache.last_access[i] = 0;
-			return;
+		if (!node_cache.in_use[i] || node_cache.owner[i] != sysfs) {
+			continue;
+		}
+
+		struct ninep_fs_node *node = node_cache.nodes[i];
+
+		if (node == sysfs->root) {
+			root = node;
+		} else if (node_cache.refcount[i] == 0) {
+			free_slot_locked(i);
+		} else {
+			node->data = node->type == NINEP_NODE_DIR ?
+			             &detached_dir : &detached_file;
+			node_cache.owner[i] = NULL;
 		}
 	}
+	k_mutex_unlock(&node_cache_lock);
+	return root;
 }
 
-/* Helper: Allocate a node from cache */
+/* Helper: Get the node for an entry from the cache, allocating it on a miss */
 static struct ninep_fs_node *alloc_node(struct ninep_sysfs *sysfs,
-                                         const char *name,
-                                         bool is_dir)
+                                         struct ninep_sysfs_entry *entry)
 {
 	uint32_t now = k_uptime_get_32();
 	int idx = -1;
 
+	k_mutex_lock(&node_cache_lock, K_FOREVER);
+	struct ninep_fs_node *cached = find_node_locked(sysfs, entry);
+
+	if (cached) {
+		k_mutex_unlock(&node_cache_lock);
+		LOG_DBG("Cached sysfs node: name='%s'", entry->path);
+		return cached;
+	}
+
 	/* First pass: look for free slot */
 	for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
 		if (!node_cache.in_use[i]) {
@@ -104,87 +198,249 @@ static struct ninep_fs_node *alloc_node(struct ninep_sysfs *sysfs,
 			LOG_ERR("Sysfs node cache full (%d entries) and all nodes are referenced! "
 			        "Cannot allocate node '%s'. Increase SYSFS_NODE_CACHE_SIZE or "
 			        "check for resource leaks.",
-			        SYSFS_NODE_CACHE_SIZE, name);
+			        SYSFS_NODE_CACHE_SIZE, entry->path);
+			k_mutex_unlock(&node_cache_lock);
 			return NULL;
 		}
 
 		/* Evict the LRU entry */
-		LOG_WRN("Sysfs node cache full - evicting LRU node: name='%s' last_access=%u",
-		        node_cache.nodes[lru_idx].name, node_cache.last_access[lru_idx]);
+		LOG_DBG("Sysfs node cache full - evicting LRU node: name='%s' last_access=%u",
+		        node_cache.nodes[lru_idx]->name, node_cache.last_access[lru_idx]);
+		free_slot_locked(lru_idx);
 		idx = lru_idx;
 	}
 
-	/* Allocate the node */
-	struct ninep_fs_node *node = &node_cache.nodes[idx];
+	/* Allocate the node; its name is the entry's full path */
+	struct ninep_fs_node *node = ninep_node_alloc(sizeof(*node), entry->path,
+	                                              strlen(entry->path));
 
-	memset(node, 0, sizeof(*node));
-	strncpy(node->name, name, sizeof(node->name) - 1);
-	node->type = is_dir ? NINEP_NODE_DIR : NINEP_NODE_FILE;
-	node->mode = is_dir ? (0755 | NINEP_DMDIR) : 0444;
-	node->qid.path = sysfs->next_qid_path++;
+	if (!node) {
+		k_mutex_unlock(&node_cache_lock);
+		return NULL;
+	}
+	node_cache.nodes[idx] = node;
+	node->data = entry;
+	if (entry->is_dir) {
+		node->type = NINEP_NODE_DIR;
+		node->mode = 0755 | NINEP_DMDIR;
+	} else {
+		node->type = NINEP_NODE_FILE;
+		/* Read-write for owner, read-only for others */
+		node->mode = entry->writable ? 0644 : 0444;
+		node->length = entry->data ? entry->data_len : 0;
+	}
+	node->qid.path = entry->qid_path;
 	node->qid.version = 0;
-	node->qid.type = is_dir ? NINEP_QTDIR : NINEP_QTFILE;
+	node->qid.type = entry->is_dir ? NINEP_QTDIR : NINEP_QTFILE;
 	node_cache.in_use[idx] = true;
 	node_cache.last_access[idx] = now;
-	node_cache.refcount[idx] = 0;
+	node_cache.refcount[idx] = 1;  /* The walking fid's */
+	node_cache.owner[idx] = sysfs;
+	k_mutex_unlock(&node_cache_lock);
 
-	LOG_DBG("Allocated sysfs node: name='%s' idx=%d", name, idx);
+	LOG_DBG("Allocated sysfs node: name='%s' idx=%d", entry->path, idx);
 	return node;
 }
 
-/* Helper: Find entry by path */
-static struct ninep_sysfs_entry *find_entry(struct ninep_sysfs *sysfs,
-                                              const char *path)
+/*
+ * Path trie. Every entry is linked under its parent directory at
+ * registration, with children kept in registration order for listings
+ * and indexed by (parent, name) in sysfs->buckets for walks. Parent
+ * directories nobody registered are "implied" entries on the heap.
+ * Entries are never unlinked, so directory cursors can point at them.
+ */
+
+/* Bucket of child name in directory dir (FNV-1a) */
+static uint32_t child_bucket(const struct ninep_sysfs_entry *dir,
+                             const char *name, size_t len)
 {
-	for (size_t i = 0; i < sysfs->num_entries; i++) {
-		if (strcmp(sysfs->entries[i].path, path) == 0) {
-			return &sysfs->entries[i];
-		}
+	uint32_t h = 2166136261u ^ (uint32_t)(uintptr_t)dir;
+
+	for (size_t i = 0; i < len; i++) {
+		h = (h ^ (uint8_t)name[i]) * 16777619u;
 	}
+	return h % CONFIG_NINEP_SYSFS_HASH_BUCKETS;
+}
+
+static const char *entry_name(const struct ninep_sysfs_entry *entry)
+{
+	return entry->path + entry->name_off;
+}
+
+static struct ninep_sysfs_entry *find_child(struct ninep_sysfs *sysfs,
+                                            const struct ninep_sysfs_entry *dir,
+                                            const char *name, size_t len)
+{
+	struct ninep_sysfs_entry *e = sysfs->buckets[child_bucket(dir, name, len)];
 
+	for (; e; e = e->hash_next) {
+		if (e->parent == dir && e->name_len == len &&
+		    memcmp(entry_name(e), name, len) == 0) {
+			return e;
+		}
+	}
 	return NULL;
 }
 
-/* Helper: Check if path is a child of parent_path */
-static bool is_child_of(const char *path, const char *parent_path,
-                         char *child_name, size_t child_name_size)
+/* Append entry to dir's children */
+static void link_child(struct ninep_sysfs *sysfs, struct ninep_sysfs_entry *dir,
+                       struct ninep_sysfs_entry *entry)
 {
-	size_t parent_len = strlen(parent_path);
+	uint32_t b = child_bucket(dir, entry_name(entry), entry->name_len);
 
-	/* Root directory special case */
-	if (strcmp(parent_path, "/") == 0) {
-		parent_len = 0;
+	entry->parent = dir;
+	entry->next = NULL;
+	if (dir->last_child) {
+		dir->last_child->next = entry;
+	} else {
+		dir->children = entry;
 	}
+	dir->last_child = entry;
+	entry->hash_next = sysfs->buckets[b];
+	sysfs->buckets[b] = entry;
+	entry->qid_path = sysfs->next_qid_path++;
+}
 
-	/* Check if path starts with parent */
-	if (strncmp(path, parent_path, parent_len) != 0) {
-		return false;
+/* Next element of a path: skips slashes, sets *len (0 at the end) */
+static const char *next_elem(const char *p, size_t *len)
+{
+	while (*p == '/') {
+		p++;
 	}
+	*len = strcspn(p, "/");
+	return p;
+}
+
+/* Implied directory for path[0, end), whose last element starts at elem */
+static struct ninep_sysfs_entry *implied_dir(const char *path, size_t end,
+                                             size_t elem, size_t len)
+{
+	struct ninep_sysfs_entry *dir = k_malloc(sizeof(*dir) + end + 1);
 
-	/* Skip parent path and any leading slash */
-	const char *remainder = path + parent_len;
-	if (*remainder == '/') {
-		remainder++;
+	if (!dir) {
+		return NULL;
 	}
+	memset(dir, 0, sizeof(*dir));
+
+	char *copy = (char *)(dir + 1);
+
+	memcpy(copy, path, end);
+	copy[end] = '\0';
+	dir->path = copy;
+	dir->is_dir = true;
+	dir->implied = true;
+	dir->allocated = true;
+	dir->name_off = elem;
+	dir->name_len = len;
+	return dir;
+}
 
-	/* Find the next slash (or end of string) */
-	const char *next_slash = strchr(remainder, '/');
-	size_t name_len;
+/* Free the implied directories of an instance's trie */
+static void free_implied(struct ninep_sysfs *sysfs)
+{
+	for (int b = 0; b < CONFIG_NINEP_SYSFS_HASH_BUCKETS; b++) {
+		struct ninep_sysfs_entry *e = sysfs->buckets[b];
 
-	if (next_slash) {
-		name_len = next_slash - remainder;
-	} else {
-		name_len = strlen(remainder);
+		while (e) {
+			struct ninep_sysfs_entry *next = e->hash_next;
+
+			if (e->allocated) {
+				k_free(e);
+			}
+			e = next;
+		}
+	}
+}
+
+/*
+ * Link a filled-in entry into the trie, creating missing parents.
+ * Returns 0 if linked, 1 if the entry names an implied directory (which
+ * then counts as registered), or a negative errno.
+ */
+static int trie_add(struct ninep_sysfs *sysfs, struct ninep_sysfs_entry *entry)
+{
+	const char *path = entry->path;
+	struct ninep_sysfs_entry *dir = &sysfs->root_entry;
+	struct ninep_sysfs_entry *missing = NULL, **tail = &missing;
+	size_t len, next_len;
+	const char *elem = next_elem(path, &len);
+	const char *next;
+
+	if (len == 0 || strlen(path) > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	/* Descend through the parents that exist */
+	while ((next = next_elem(elem + len, &next_len), next_len != 0)) {
+		struct ninep_sysfs_entry *child = find_child(sysfs, dir, elem, len);
+
+		if (!child) {
+			break;
+		}
+		if (!child->is_dir) {
+			return -ENOTDIR;
+		}
+		dir = child;
+		elem = next;
+		len = next_len;
+	}
+
+	/* Allocate the ones that don't before linking anything */
+	while ((next = next_elem(elem + len, &next_len), next_len != 0)) {
+		struct ninep_sysfs_entry *d = implied_dir(path, elem + len - path,
+		                                          elem - path, len);
+		if (!d) {
+			while (missing) {
+				d = missing->next;
+				k_free(missing);
+				missing = d;
+			}
+			return -ENOMEM;
+		}
+		*tail = d;
+		tail = &d->next;
+		elem = next;
+		len = next_len;
 	}
 
-	/* Copy child name */
-	if (name_len > 0 && name_len < child_name_size) {
-		strncpy(child_name, remainder, name_len);
-		child_name[name_len] = '\0';
-		return true;
+	if (!missing) {
+		struct ninep_sysfs_entry *old = find_child(sysfs, dir, elem, len);
+
+		if (old) {
+			if (old->implied && entry->is_dir) {
+				old->implied = false;
+				return 1;
+			}
+			return -EEXIST;
+		}
 	}
 
-	return false;
+	while (missing) {
+		struct ninep_sysfs_entry *d = missing;
+
+		missing = d->next;
+		link_child(sysfs, dir, d);
+		dir = d;
+	}
+	entry->name_off = elem - path;
+	entry->name_len = len;
+	link_child(sysfs, dir, entry);
+	return 0;
+}
+
+/* Helper: Find entry by path */
+static struct ninep_sysfs_entry *find_entry(struct ninep_sysfs *sysfs,
+                                              const char *path)
+{
+	struct ninep_sysfs_entry *entry = &sysfs->root_entry;
+	size_t len;
+	const char *elem = next_elem(path, &len);
+
+	while (entry && len != 0) {
+		entry = find_child(sysfs, entry, elem, len);
+		elem = next_elem(elem + len, &len);
+	}
+	return entry;
 }
 
 /* Get root */
@@ -201,102 +457,56 @@ static struct ninep_fs_node *sysfs_walk(struct ninep_fs_node *parent,
                                           void *fs_ctx)
 {
 	struct ninep_sysfs *sysfs = fs_ctx;
-	char parent_path[256];
-	char target_path[256];
-	char child_match[64];
+	struct ninep_sysfs_entry *dir = parent->data;
+	struct ninep_sysfs_entry *target;
 
 	/* walk(5): "." stays in the current directory. */
 	if (name_len == 1 && name[0] == '.') {
+		incref_node(parent);
 		return parent;
 	}
 
-	/* Build parent path */
-	if (strcmp(parent->name, "/") == 0) {
-		parent_path[0] = '\0';
-	} else {
-		strncpy(parent_path, parent->name, sizeof(parent_path) - 1);
-		parent_path[sizeof(parent_path) - 1] = '\0';
+	/* Detached nodes belong to no instance any more */
+	if (parent->type != NINEP_NODE_DIR || parent->data == &detached_dir) {
+		return NULL;
 	}
 
-	/* walk(5): ".." goes to the parent directory; at (or above) the root
-	 * it stays at the root. */
 	if (name_len == 2 && name[0] == '.' && name[1] == '.') {
-		if (parent_path[0] == '\0') {
-			return parent;  /* already at root */
-		}
-		char up[256];
-		strncpy(up, parent_path, sizeof(up) - 1);
-		up[sizeof(up) - 1] = '\0';
-		char *slash = strrchr(up, '/');
-		if (!slash || slash == up) {
-			return sysfs->root;  /* parent was a top-level dir */
-		}
-		*slash = '\0';
-		struct ninep_sysfs_entry *pe = find_entry(sysfs, up);
-		return alloc_node(sysfs, up, pe ? pe->is_dir : true);
-	}
-
-	/* Build target path. Entries are registered with a leading slash
-	 * (e.g. "/hello.txt"), so the root-level target must carry one too or
-	 * find_entry() never matches and every top-level walk returns ENOENT. */
-	if (parent_path[0] == '\0') {
-		snprintf(target_path, sizeof(target_path), "/%.*s", name_len, name);
+		/* walk(5): ".." goes to the parent directory; at the root it
+		 * stays at the root. */
+		target = dir->parent ? dir->parent : dir;
 	} else {
-		snprintf(target_path, sizeof(target_path), "%s/%.*s",
-		         parent_path, name_len, name);
+		target = find_child(sysfs, dir, name, name_len);
 	}
 
 	LOG_DBG("Walking: parent='%s', name='%.*s', target='%s'",
-	        parent->name, name_len, name, target_path);
-
-	/* Look for exact match first */
-	struct ninep_sysfs_entry *entry = find_entry(sysfs, target_path);
-
-	if (entry) {
-		/* Found exact entry - create node */
-		struct ninep_fs_node *node = alloc_node(sysfs, target_path,
-		                                          entry->is_dir);
-		if (!node) {
-			LOG_ERR("Node cache full");
-			return NULL;
-		}
+	        parent->name, name_len, name, target ? target->path : "");
 
-		/* Update mode for writable files */
-		if (!entry->is_dir && entry->writable) {
-			node->mode = 0644;  /* Read-write for owner, read-only for others */
-		}
-
-		return node;
+	if (!target) {
+		return NULL;
 	}
-
-	/* Check if this is a directory that has children */
-	for (size_t i = 0; i < sysfs->num_entries; i++) {
-		if (is_child_of(sysfs->entries[i].path, target_path,
-		                child_match, sizeof(child_match))) {
-			/* This path would be a parent - create directory node */
-			struct ninep_fs_node *node = alloc_node(sysfs, target_path, true);
-			if (!node) {
-				LOG_ERR("Node cache full");
-				return NULL;
-			}
-			return node;
-		}
+	if (target == &sysfs->root_entry) {
+		return sysfs->root;
 	}
 
-	LOG_DBG("Path not found: %s", target_path);
-	return NULL;
+	struct ninep_fs_node *node = alloc_node(sysfs, target);
+
+	if (!node) {
+		LOG_ERR("Node cache full");
+	}
+	return node;
 }
 
 /* Open node */
 static int sysfs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 {
-	struct ninep_sysfs *sysfs = fs_ctx;
+	ARG_UNUSED(fs_ctx);
 
 	LOG_DBG("sysfs_open: node->name='%s', mode=0x%02x, node->mode=0%o",
 	        node->name, mode, node->mode);
 
 	/* Find entry to check if writable */
-	struct ninep_sysfs_entry *entry = find_entry(sysfs, node->name);
+	struct ninep_sysfs_entry *entry = node->data;
 
 	LOG_DBG("sysfs_open: entry %s, writable=%d",
 	        entry ? "found" : "NOT FOUND",
@@ -307,8 +517,6 @@ static int sysfs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 		if (mode != NINEP_OREAD && mode != NINEP_OEXEC) {
 			return -EACCES;
 		}
-		/* Success - increment refcount */
-		incref_node(node);
 		return 0;
 	}
 
@@ -317,8 +525,6 @@ static int sysfs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 	uint8_t access_mode = mode & 0x03;  /* Keep only bottom 2 bits */
 
 	if (access_mode == NINEP_OREAD || access_mode == NINEP_OEXEC) {
-		/* Success - increment refcount */
-		incref_node(node);
 		return 0;  /* Read always allowed */
 	}
 
@@ -328,128 +534,98 @@ static int sysfs_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 			        entry, entry ? entry->writable : 0);
 			return -EACCES;  /* Not writable */
 		}
-		/* Success - increment refcount */
-		incref_node(node);
 		return 0;
 	}
 
 	return -EACCES;
 }
 
+/*
+ * Emit stat records for the children of dir starting at *next, in
+ * registration order. Records wholly inside the first skip bytes are
+ * passed over unwritten. Returns the bytes written; *next is left at the
+ * first child not yet listed (NULL after the last), so a later call can
+ * continue from there.
+ */
+static int dir_fill(struct ninep_sysfs_entry *dir,
+                    struct ninep_sysfs_entry **next, uint64_t skip,
+                    uint8_t *buf, uint32_t count)
+{
+	size_t buf_offset = 0;
+	struct ninep_sysfs_entry *e;
+
+	for (e = *next; e; e = e->next) {
+		/* Calculate stat entry size:
+		 * size[2] + type[2] + dev[4] + qid[13] + mode[4] + atime[4] +
+		 * mtime[4] + length[8] + name[2+len] + uid[2+6] + gid[2+6] + muid[2+6]
+		 */
+		size_t stat_size = 2 + 2 + 4 + 13 + 4 + 4 + 4 + 8 +
+		                   (2 + e->name_len) + (2 + 6) + (2 + 6) + (2 + 6);
+
+		/* Skip entries before the requested offset */
+		if (skip >= stat_size) {
+			skip -= stat_size;
+			continue;
+		}
+		skip = 0;
+
+		/* Check if we have space in the buffer */
+		if (buf_offset + stat_size > count) {
+			break;
+		}
+
+		struct ninep_qid child_qid = {
+			.type = e->is_dir ? NINEP_QTDIR : NINEP_QTFILE,
+			.version = 0,
+			.path = e->qid_path,
+		};
+		uint32_t mode = e->is_dir ? (0755 | NINEP_DMDIR) :
+		                (e->writable ? 0644 : 0444);
+		size_t write_offset = 0;
+		int ret = ninep_write_stat(buf + buf_offset, count - buf_offset,
+		                           &write_offset, &child_qid, mode,
+		                           e->data ? e->data_len : 0,
+		                           entry_name(e), e->name_len,
+		                           NULL, NULL, NULL);  /* uid/gid/muid default to "zephyr" */
+		if (ret < 0) {
+			break;
+		}
+		buf_offset += write_offset;
+	}
+
+	*next = e;
+	LOG_DBG("Directory read: %s, %zu bytes", dir->path, buf_offset);
+	return buf_offset;
+}
+
 /* Read from file */
 static int sysfs_read(struct ninep_fs_node *node, uint64_t offset,
                       uint8_t *buf, uint32_t count, const char *uname,
                       void *fs_ctx)
 {
-	struct ninep_sysfs *sysfs = fs_ctx;
+	ARG_UNUSED(fs_ctx);
 
 	if (node->type == NINEP_NODE_DIR) {
 		/* Read directory - list children */
 		LOG_DBG("Reading directory: %s, offset=%llu", node->name, offset);
 
-		char parent_path[256];
-		strncpy(parent_path, node->name, sizeof(parent_path) - 1);
-		parent_path[sizeof(parent_path) - 1] = '\0';
-
-		char child_names[32][64];  /* Track unique child names */
-		int num_children = 0;
-
-		/* Find all unique immediate children */
-		for (size_t i = 0; i < sysfs->num_entries; i++) {
-			char child_name[64];
-
-			if (is_child_of(sysfs->entries[i].path, parent_path,
-			                child_name, sizeof(child_name))) {
-				/* Check if we've seen this child */
-				bool found = false;
-				for (int j = 0; j < num_children; j++) {
-					if (strcmp(child_names[j], child_name) == 0) {
-						found = true;
-						break;
-					}
-				}
-
-				if (!found && num_children < 32) {
-					strncpy(child_names[num_children], child_name, 64);
-					num_children++;
-				}
-			}
-		}
-
-		/* Handle offset - skip entries we've already sent */
-		uint64_t current_offset = 0;
-		size_t buf_offset = 0;
-
-		/* Generate directory entries */
-		for (int i = 0; i < num_children; i++) {
-			char child_path[256];
-
-			/* Build child path - handle root specially */
-			if (strcmp(parent_path, "/") == 0) {
-				/* Root - don't add leading slash */
-				snprintf(child_path, sizeof(child_path), "%s", child_names[i]);
-			} else {
-				snprintf(child_path, sizeof(child_path), "%s/%s",
-				         parent_path, child_names[i]);
-			}
-
-			struct ninep_sysfs_entry *child_entry = find_entry(sysfs, child_path);
-			bool is_dir = child_entry ? child_entry->is_dir : false;
-
-			/* Build qid for this child */
-			struct ninep_qid child_qid;
-			child_qid.type = is_dir ? NINEP_QTDIR : NINEP_QTFILE;
-			child_qid.version = 0;
-			/* Generate unique qid.path based on path string hash */
-			child_qid.path = 0;
-			for (const char *p = child_path; *p; p++) {
-				child_qid.path = child_qid.path * 31 + *p;
-			}
+		struct ninep_sysfs_entry *dir = node->data;
+		struct ninep_sysfs_entry *next = dir->children;
 
-			/* Calculate stat entry size:
-			 * size[2] + type[2] + dev[4] + qid[13] + mode[4] + atime[4] +
-			 * mtime[4] + length[8] + name[2+len] + uid[2+6] + gid[2+6] + muid[2+6]
-			 */
-			uint16_t name_len = strlen(child_names[i]);
-			size_t stat_size = 2 + 2 + 4 + 13 + 4 + 4 + 4 + 8 +
-			                   (2 + name_len) + (2 + 6) + (2 + 6) + (2 + 6);
-
-			/* Skip if this entry is before our requested offset */
-			if (current_offset + stat_size <= offset) {
-				current_offset += stat_size;
-				continue;
-			}
-
-			/* Check if we have space in the buffer */
-			if (buf_offset + stat_size > count) {
-				/* No more space */
-				break;
-			}
+		return dir_fill(dir, &next, offset, buf, count);
+	} else {
+		/* Read file - call generator */
+		struct ninep_sysfs_entry *entry = node->data;
 
-			/* Write the stat structure */
-			size_t write_offset = 0;
-			int ret = ninep_write_stat(buf + buf_offset, count - buf_offset,
-			                           &write_offset, &child_qid,
-			                           is_dir ? (0755 | NINEP_DMDIR) : ((child_entry && child_entry->writable) ? 0644 : 0444),
-			                           0,  /* length */
-			                           child_names[i], name_len,
-			                           NULL, NULL, NULL);  /* uid/gid/muid default to "zephyr" */
-
-			if (ret < 0) {
-				/* Error writing stat */
-				break;
+		if (entry && entry->data) {
+			if (offset >= entry->data_len) {
+				return 0;
 			}
+			uint32_t n = MIN(count, entry->data_len - offset);
 
-			buf_offset += write_offset;
-			current_offset += write_offset;
+			memcpy(buf, entry->data + offset, n);
+			return n;
 		}
-
-		LOG_DBG("Directory read: %d children, %zu bytes", num_children, buf_offset);
-		return buf_offset;
-	} else {
-		/* Read file - call generator */
-		struct ninep_sysfs_entry *entry = find_entry(sysfs, node->name);
-
 		if (!entry || !entry->generator) {
 			return -EIO;
 		}
@@ -461,20 +637,224 @@ static int sysfs_read(struct ninep_fs_node *node, uint64_t offset,
 	}
 }
 
+/*
+ * Snapshots (ninep_sysfs_set_snapshot). A fid's first read of a snapshot
+ * file, and any read at offset 0, runs the generator over the whole file
+ * into a snapshot kept in the fid's cursor; the other reads are served
+ * from it. With a TTL, the newest snapshot is also kept in the entry and
+ * shared by fids that read within the TTL. snapshot_lock protects the
+ * reference counts and entry->snapshot.
+ */
+struct sysfs_snapshot {
+	uint32_t refs;
+	int64_t taken;   /* k_uptime_get() when generated */
+	uint32_t len;
+	uint8_t data[];
+};
+
+static struct k_spinlock snapshot_lock;
+
+static void snapshot_put(struct sysfs_snapshot *snap)
+{
+	k_spinlock_key_t key = k_spin_lock(&snapshot_lock);
+	bool last = --snap->refs == 0;
+
+	k_spin_unlock(&snapshot_lock, key);
+	if (last) {
+		k_free(snap);
+	}
+}
+
+/* Replace the entry's shared snapshot; snap may be NULL */
+static void snapshot_share(struct ninep_sysfs_entry *entry,
+                           struct sysfs_snapshot *snap)
+{
+	k_spinlock_key_t key = k_spin_lock(&snapshot_lock);
+	struct sysfs_snapshot *old = entry->snapshot;
+
+	if (snap) {
+		snap->refs++;
+	}
+	entry->snapshot = snap;
+	k_spin_unlock(&snapshot_lock, key);
+
+	if (old) {
+		snapshot_put(old);
+	}
+}
+
+static struct sysfs_snapshot *snapshot_take(struct ninep_sysfs_entry *entry,
+                                            int *err)
+{
+	int64_t now = k_uptime_get();
+	struct sysfs_snapshot *snap;
+
+	if (entry->snapshot_ttl_ms) {
+		k_spinlock_key_t key = k_spin_lock(&snapshot_lock);
+
+		snap = entry->snapshot;
+		if (snap && now - snap->taken < entry->snapshot_ttl_ms) {
+			snap->refs++;
+			k_spin_unlock(&snapshot_lock, key);
+			return snap;
+		}
+		k_spin_unlock(&snapshot_lock, key);
+	}
+
+	snap = k_malloc(sizeof(*snap) + entry->snapshot_size);
+	if (!snap) {
+		*err = -ENOMEM;
+		return NULL;
+	}
+	snap->refs = 1;
+	snap->taken = now;
+	snap->len = 0;
+
+	/* Generators may return less than asked; go on until end of file */
+	while (snap->len < entry->snapshot_size) {
+		int n = entry->generator(snap->data + snap->len,
+		                         entry->snapshot_size - snap->len,
+		                         snap->len, entry->ctx);
+		if (n < 0) {
+			k_free(snap);
+			*err = n;
+			return NULL;
+		}
+		if (n == 0) {
+			break;
+		}
+		snap->len += n;
+	}
+
+	if (entry->snapshot_ttl_ms) {
+		snapshot_share(entry, snap);
+	}
+	return snap;
+}
+
+/* Read a snapshot file from the fid's snapshot */
+static int sysfs_read_cursor(struct ninep_fs_node *node, uint64_t offset,
+                             uint8_t *buf, uint32_t count,
+                             struct ninep_dir_cursor *cur, const char *uname,
+                             void *fs_ctx)
+{
+	ARG_UNUSED(uname);
+	ARG_UNUSED(fs_ctx);
+	struct sysfs_snapshot *snap = cur->state;
+
+	if (!snap || offset == 0) {
+		if (node->type == NINEP_NODE_DIR) {
+			return -ENOTSUP;
+		}
+
+		struct ninep_sysfs_entry *entry = node->data;
+
+		if (!entry || !entry->snapshot_size || !entry->generator) {
+			return -ENOTSUP;
+		}
+
+		int err = 0;
+		struct sysfs_snapshot *fresh = snapshot_take(entry, &err);
+
+		if (!fresh) {
+			return err;
+		}
+		if (snap) {
+			snapshot_put(snap);
+		}
+		cur->state = snap = fresh;
+	}
+
+	if (offset >= snap->len) {
+		return 0;
+	}
+
+	uint32_t n = MIN(count, snap->len - offset);
+
+	memcpy(buf, snap->data + offset, n);
+	return n;
+}
+
+/* Drop the fid's snapshot (sysfs keeps nothing else in cursors) */
+static void sysfs_releasedir(struct ninep_fs_node *node,
+                             struct ninep_dir_cursor *cur, void *fs_ctx)
+{
+	if (cur->state) {
+		snapshot_put(cur->state);
+		cur->state = NULL;
+	}
+}
+
+/* Read directory entries, resuming from the fid's cursor */
+static int sysfs_readdir(struct ninep_fs_node *node, uint64_t offset,
+                         uint8_t *buf, uint32_t count,
+                         struct ninep_dir_cursor *cur, const char *uname,
+                         void *fs_ctx)
+{
+	ARG_UNUSED(uname);
+	ARG_UNUSED(fs_ctx);
+	struct ninep_sysfs_entry *dir = node->data;
+	struct ninep_sysfs_entry *next = dir->children;
+	uint64_t skip = offset;
+
+	if (node->type != NINEP_NODE_DIR) {
+		return -ENOTDIR;
+	}
+	if (dir == &detached_dir) {
+		return 0;  /* cur->pos may point into a freed trie */
+	}
+
+	/* cur->pos is the next child to list */
+	if (offset != 0 && offset == cur->offset) {
+		next = (struct ninep_sysfs_entry *)cur->pos;
+		skip = 0;
+	}
+
+	int ret = dir_fill(dir, &next, skip, buf, count);
+
+	cur->pos = (uintptr_t)next;
+	return ret;
+}
+
+/* Borrow static file content (zero-copy read) */
+static int sysfs_read_ref(struct ninep_fs_node *node, uint64_t offset,
+                          uint32_t count, const char *uname,
+                          struct ninep_read_ref *ref, void *fs_ctx)
+{
+	ARG_UNUSED(uname);
+	ARG_UNUSED(fs_ctx);
+
+	if (node->type == NINEP_NODE_DIR) {
+		return -ENOTSUP;
+	}
+
+	struct ninep_sysfs_entry *entry = node->data;
+
+	if (!entry || !entry->data) {
+		return -ENOTSUP;  /* Generated content: use read() */
+	}
+
+	if (offset < entry->data_len) {
+		ref->data = entry->data + offset;
+		ref->len = MIN(count, entry->data_len - offset);
+	}
+	return 0;
+}
+
 /* Write to file */
 static int sysfs_write(struct ninep_fs_node *node, uint64_t offset,
                        const uint8_t *buf, uint32_t count, const char *uname,
                        void *fs_ctx)
 {
 	ARG_UNUSED(uname);
-	struct ninep_sysfs *sysfs = fs_ctx;
+	ARG_UNUSED(fs_ctx);
 
 	if (node->type == NINEP_NODE_DIR) {
 		return -EISDIR;
 	}
 
 	/* Find entry */
-	struct ninep_sysfs_entry *entry = find_entry(sysfs, node->name);
+	struct ninep_sysfs_entry *entry = node->data;
 
 	if (!entry || !entry->writer) {
 		return -EIO;
@@ -510,9 +890,16 @@ static int sysfs_stat(struct ninep_fs_node *node, uint8_t *buf,
 }
 
 /* Clunk (release) node */
+/* A cloned fid shares node */
+static void sysfs_ref(struct ninep_fs_node *node, void *fs_ctx)
+{
+	ARG_UNUSED(fs_ctx);
+	incref_node(node);
+}
+
 static int sysfs_clunk(struct ninep_fs_node *node, void *fs_ctx)
 {
-	struct ninep_sysfs *sysfs = fs_ctx;
+	ARG_UNUSED(fs_ctx);
 
 	LOG_DBG("sysfs_clunk: node=%p name='%s'", node, node->name);
 
@@ -522,27 +909,32 @@ static int sysfs_clunk(struct ninep_fs_node *node, void *fs_ctx)
 		return 0;
 	}
 
-	/* Decrement refcount */
-	decref_node(node);
+	struct ninep_sysfs_entry *entry = NULL;
+
+	k_mutex_lock(&node_cache_lock, K_FOREVER);
+	int i = node_slot_locked(node);
+
+	if (i >= 0 && node_cache.refcount[i] > 0 &&
+	    --node_cache.refcount[i] == 0) {
+		if (node_cache.owner[i]) {
+			/* No more references: the node stays cached for the
+			 * next walk unless too many are idle */
+			entry = node->data;
+			node_cache.last_access[i] = k_uptime_get_32();
+			trim_idle_locked();
+		} else {
+			free_slot_locked(i);
+		}
+	}
+	k_mutex_unlock(&node_cache_lock);
+
+	/* Call user-provided clunk callback if present */
+	if (entry && entry->clunk) {
+		LOG_DBG("sysfs_clunk: calling user clunk for '%s'", entry->path);
+		int ret = entry->clunk(entry->ctx);
 
-	/* Check refcount and potentially call clunk callback */
-	for (int i = 0; i < SYSFS_NODE_CACHE_SIZE; i++) {
-		if (node_cache.in_use[i] && &node_cache.nodes[i] == node) {
-			if (node_cache.refcount[i] == 0) {
-				/* Call user-provided clunk callback if present */
-				struct ninep_sysfs_entry *entry = find_entry(sysfs, node->name);
-				if (entry && entry->clunk) {
-					LOG_DBG("sysfs_clunk: calling user clunk for '%s'", node->name);
-					int ret = entry->clunk(entry->ctx);
-					if (ret < 0) {
-						LOG_ERR("sysfs_clunk: user callback failed: %d", ret);
-					}
-				}
-
-				/* No more references - free it */
-				free_node(node);
-			}
-			break;
+		if (ret < 0) {
+			LOG_ERR("sysfs_clunk: user callback failed: %d", ret);
 		}
 	}
 
@@ -555,13 +947,38 @@ static const struct ninep_fs_ops sysfs_ops = {
 	.walk = sysfs_walk,
 	.open = sysfs_open,
 	.read = sysfs_read,
+	.read_ref = sysfs_read_ref,
+	.readdir = sysfs_readdir,
+	.releasedir = sysfs_releasedir,
+	.read_cursor = sysfs_read_cursor,
 	.write = sysfs_write,
 	.stat = sysfs_stat,
 	.clunk = sysfs_clunk,
+	.ref = sysfs_ref,
 	.create = NULL,
 	.remove = NULL,
 };
 
+/* Link the next slot, filled in by a register function, into the trie */
+static int add_entry(struct ninep_sysfs *sysfs, struct ninep_sysfs_entry *entry)
+{
+	entry->children = NULL;
+	entry->last_child = NULL;
+	entry->implied = false;
+	entry->allocated = false;
+
+	int ret = trie_add(sysfs, entry);
+
+	if (ret < 0) {
+		LOG_ERR("Cannot register %s: %d", entry->path, ret);
+		return ret;
+	}
+	if (ret == 0) {
+		sysfs->num_entries++;
+	}
+	return 0;
+}
+
 /* Public API */
 
 int ninep_sysfs_init(struct ninep_sysfs *sysfs,
@@ -572,16 +989,24 @@ int ninep_sysfs_init(struct ninep_sysfs *sysfs,
 		return -EINVAL;
 	}
 
+	/* Free what an earlier instance at this address left behind */
+	struct ninep_fs_node *root = release_nodes(sysfs);
+
+	if (root) {
+		free_implied(sysfs);
+	}
 	memset(sysfs, 0, sizeof(*sysfs));
-	memset(&node_cache, 0, sizeof(node_cache));
 
 	sysfs->entries = entries;
 	sysfs->num_entries = 0;
 	sysfs->max_entries = max_entries;
 	sysfs->next_qid_path = 1;
+	sysfs->root_entry.path = "/";
+	sysfs->root_entry.is_dir = true;
+	sysfs->root_entry.qid_path = sysfs->next_qid_path++;
 
-	/* Create root node */
-	sysfs->root = alloc_node(sysfs, "/", true);
+	/* Create root node, or keep the earlier instance's */
+	sysfs->root = root ? root : alloc_node(sysfs, &sysfs->root_entry);
 	if (!sysfs->root) {
 		return -ENOMEM;
 	}
@@ -610,15 +1035,61 @@ int ninep_sysfs_register_file(struct ninep_sysfs *sysfs,
 	entry->writer = NULL;
 	entry->clunk = NULL;
 	entry->ctx = ctx;
+	entry->data = NULL;
+	entry->data_len = 0;
 	entry->is_dir = false;
 	entry->writable = false;
+	entry->snapshot_size = 0;
+	entry->snapshot_ttl_ms = 0;
+	entry->snapshot = NULL;
+
+	int ret = add_entry(sysfs, entry);
 
-	sysfs->num_entries++;
+	if (ret < 0) {
+		return ret;
+	}
 
 	LOG_DBG("Registered file: %s", path);
 	return 0;
 }
 
+int ninep_sysfs_register_static_file(struct ninep_sysfs *sysfs,
+                                      const char *path,
+                                      const void *data, size_t len)
+{
+	if (!sysfs || !path || (!data && len > 0)) {
+		return -EINVAL;
+	}
+
+	if (sysfs->num_entries >= sysfs->max_entries) {
+		return -ENOMEM;
+	}
+
+	struct ninep_sysfs_entry *entry = &sysfs->entries[sysfs->num_entries];
+
+	entry->path = path;
+	entry->generator = NULL;
+	entry->writer = NULL;
+	entry->clunk = NULL;
+	entry->ctx = NULL;
+	entry->data = data ? data : (const uint8_t *)"";  /* non-NULL marks static */
+	entry->data_len = len;
+	entry->is_dir = false;
+	entry->writable = false;
+	entry->snapshot_size = 0;
+	entry->snapshot_ttl_ms = 0;
+	entry->snapshot = NULL;
+
+	int ret = add_entry(sysfs, entry);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	LOG_DBG("Registered static file: %s (%zu bytes)", path, len);
+	return 0;
+}
+
 int ninep_sysfs_register_writable_file(struct ninep_sysfs *sysfs,
                                         const char *path,
                                         ninep_sysfs_generator_t generator,
@@ -650,15 +1121,48 @@ int ninep_sysfs_register_writable_file_ex(struct ninep_sysfs *sysfs,
 	entry->writer = writer;
 	entry->clunk = clunk;
 	entry->ctx = ctx;
+	entry->data = NULL;
+	entry->data_len = 0;
 	entry->is_dir = false;
 	entry->writable = (writer != NULL);
+	entry->snapshot_size = 0;
+	entry->snapshot_ttl_ms = 0;
+	entry->snapshot = NULL;
 
-	sysfs->num_entries++;
+	int ret = add_entry(sysfs, entry);
+
+	if (ret < 0) {
+		return ret;
+	}
 
 	LOG_DBG("Registered writable file: %s (clunk=%s)", path, clunk ? "yes" : "no");
 	return 0;
 }
 
+int ninep_sysfs_set_snapshot(struct ninep_sysfs *sysfs, const char *path,
+                             size_t max_len, uint32_t ttl_ms)
+{
+	if (!sysfs || !path) {
+		return -EINVAL;
+	}
+
+	struct ninep_sysfs_entry *entry = find_entry(sysfs, path);
+
+	if (!entry) {
+		return -ENOENT;
+	}
+	if (!entry->generator) {
+		return -EINVAL;  /* Directory or static file */
+	}
+
+	entry->snapshot_size = max_len;
+	entry->snapshot_ttl_ms = max_len ? ttl_ms : 0;
+	snapshot_share(entry, NULL);
+
+	LOG_DBG("Snapshot for %s: %zu bytes, ttl %u ms", path, max_len, ttl_ms);
+	return 0;
+}
+
 int ninep_sysfs_register_dir(struct ninep_sysfs *sysfs, const char *path)
 {
 	if (!sysfs || !path) {
@@ -676,10 +1180,19 @@ int ninep_sysfs_register_dir(struct ninep_sysfs *sysfs, const char *path)
 	entry->writer = NULL;
 	entry->clunk = NULL;
 	entry->ctx = NULL;
+	entry->data = NULL;
+	entry->data_len = 0;
 	entry->is_dir = true;
 	entry->writable = false;
+	entry->snapshot_size = 0;
+	entry->snapshot_ttl_ms = 0;
+	entry->snapshot = NULL;
 
-	sysfs->num_entries++;
+	int ret = add_entry(sysfs, entry);
+
+	if (ret < 0) {
+		return ret;
+	}
 
 	LOG_DBG("Registered directory: %s", path);
 	return 0;
@@ -439,14 +439,25 @@ static int l2cap_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
 	return 0;
 }
 
-static int l2cap_send(struct ninep_transport *transport, const uint8_t *buf,
-                      size_t len)
+/*
+ * Scatter-gather send. The stack keeps the SDU after bt_l2cap_chan_send()
+ * returns, so the pieces are gathered straight into the TX net_buf: one
+ * copy from the caller's buffers (e.g. the filesystem's read buffer)
+ * instead of first assembling the message elsewhere.
+ */
+static int l2cap_sendv(struct ninep_transport *transport,
+                       const struct ninep_iovec *iov, int iovcnt)
 {
 	struct l2cap_transport_data *data = transport->priv_data;
 	struct net_buf *msg_buf;
+	size_t len = 0;
 	int ret;
 
-	LOG_INF(">>> L2CAP SEND: %zu bytes, type=0x%02x", len, buf[4]);
+	for (int i = 0; i < iovcnt; i++) {
+		len += iov[i].len;
+	}
+
+	LOG_INF(">>> L2CAP SEND: %zu bytes in %d pieces", len, iovcnt);
 
 	if (!data) {
 		LOG_ERR("L2CAP send: no transport data");
@@ -470,8 +481,16 @@ static int l2cap_send(struct ninep_transport *transport, const uint8_t *buf,
 	/* Reserve L2CAP SDU headroom */
 	net_buf_reserve(msg_buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
 
-	/* Copy message data to net_buf */
-	net_buf_add_mem(msg_buf, buf, len);
+	if (net_buf_tailroom(msg_buf) < len) {
+		LOG_ERR("Message of %zu bytes exceeds TX buffer", len);
+		net_buf_unref(msg_buf);
+		return -EMSGSIZE;
+	}
+
+	/* Gather message pieces into the net_buf */
+	for (int i = 0; i < iovcnt; i++) {
+		net_buf_add_mem(msg_buf, iov[i].base, iov[i].len);
+	}
 
 	LOG_INF("L2CAP send: %zu bytes", len);
 
@@ -487,6 +506,14 @@ static int l2cap_send(struct ninep_transport *transport, const uint8_t *buf,
 	return len;
 }
 
+static int l2cap_send(struct ninep_transport *transport, const uint8_t *buf,
+                      size_t len)
+{
+	struct ninep_iovec iov = { .base = buf, .len = len };
+
+	return l2cap_sendv(transport, &iov, 1);
+}
+
 static int l2cap_start(struct ninep_transport *transport)
 {
 	struct l2cap_transport_data *data = transport->priv_data;
@@ -582,6 +609,7 @@ static const struct ninep_transport_ops l2cap_transport_ops = {
 	.start = l2cap_start,
 	.stop = l2cap_stop,
 	.get_mtu = l2cap_get_mtu,
+	.sendv = l2cap_sendv,
 };
 
 int ninep_transport_l2cap_init(struct ninep_transport *transport,
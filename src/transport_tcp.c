@@ -16,18 +16,144 @@ LOG_MODULE_REGISTER(ninep_tcp_transport, CONFIG_NINEP_LOG_LEVEL);
 #define TCP_RECV_THREAD_STACK_SIZE 4096
 #define TCP_RECV_THREAD_PRIORITY 5
 
+/* How long the receive thread blocks in zsock_poll() before re-checking
+ * data->active, so tcp_stop() can join it promptly. */
+#define TCP_POLL_TIMEOUT_MS 100
+
+/* 9P size[4] type[1] tag[2] */
+#define TCP_HDR_SIZE 7
+
+/* Most pieces a single sendv() call accepts (header + data + slack) */
+#define TCP_SENDV_MAX_IOV 4
+
 struct tcp_transport_data {
 	int listen_sock;
 	int client_sock;
 	uint16_t port;
 	uint8_t *rx_buf;
 	size_t rx_buf_size;
+	/* Framing window into rx_buf: bytes [rx_head, rx_tail) have been
+	 * received but not yet delivered. Complete messages are handed to
+	 * recv_cb straight out of rx_buf; only a trailing partial message is
+	 * ever moved, and only when it would not fit before the end. */
+	size_t rx_head;
+	size_t rx_tail;
 	k_tid_t recv_tid;
 	bool active;
 	struct k_thread recv_thread;
 	k_thread_stack_t recv_stack[K_KERNEL_STACK_LEN(TCP_RECV_THREAD_STACK_SIZE)];
 };
 
+/* Wait up to TCP_POLL_TIMEOUT_MS for sock to become readable.
+ * Returns >0 if readable, 0 on timeout, negative errno on failure. */
+static int tcp_wait_readable(int sock)
+{
+	struct zsock_pollfd pfd = {
+		.fd = sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	int ret = zsock_poll(&pfd, 1, TCP_POLL_TIMEOUT_MS);
+
+	if (ret < 0) {
+		return -errno;
+	}
+	if (ret > 0 && (pfd.revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL))) {
+		return -EIO;
+	}
+	/* POLLHUP is reported as readable: recv() then returns 0 (EOF). */
+	return ret;
+}
+
+static void tcp_log_peer(const struct sockaddr_storage *client_addr)
+{
+	char addr_str[INET6_ADDRSTRLEN];
+
+	if (client_addr->ss_family == AF_INET6) {
+		const struct sockaddr_in6 *addr6 =
+			(const struct sockaddr_in6 *)client_addr;
+		zsock_inet_ntop(AF_INET6, &addr6->sin6_addr,
+		               addr_str, sizeof(addr_str));
+		LOG_INF("Client connected from [%s]:%d",
+		        addr_str, ntohs(addr6->sin6_port));
+	} else {
+		const struct sockaddr_in *addr4 =
+			(const struct sockaddr_in *)client_addr;
+		zsock_inet_ntop(AF_INET, &addr4->sin_addr,
+		               addr_str, sizeof(addr_str));
+		LOG_INF("Client connected from %s:%d",
+		        addr_str, ntohs(addr4->sin_port));
+	}
+}
+
+static void tcp_drop_client(struct tcp_transport_data *data)
+{
+	zsock_close(data->client_sock);
+	data->client_sock = -1;
+	data->rx_head = 0;
+	data->rx_tail = 0;
+}
+
+/*
+ * Deliver every complete 9P message sitting in [rx_head, rx_tail).
+ *
+ * Messages are passed to recv_cb in place — no copy — so a burst of
+ * back-to-back requests read by one zsock_recv() is dispatched in a single
+ * wakeup. Afterwards the window is reset when empty, or a trailing partial
+ * message is moved to the front of rx_buf if the rest of it would not fit
+ * before the end of the buffer.
+ *
+ * Returns 0, or -EMSGSIZE / -EINVAL if the stream cannot be framed (the
+ * caller drops the connection: 9P has no way to resynchronise).
+ */
+static int tcp_frame_messages(struct ninep_transport *transport,
+                              struct tcp_transport_data *data)
+{
+	size_t need = TCP_HDR_SIZE;
+
+	while (data->rx_tail - data->rx_head >= TCP_HDR_SIZE) {
+		const uint8_t *msg = &data->rx_buf[data->rx_head];
+		size_t avail = data->rx_tail - data->rx_head;
+		struct ninep_msg_header hdr;
+
+		if (ninep_parse_header(msg, avail, &hdr) < 0) {
+			LOG_WRN("Invalid header, dropping connection");
+			return -EINVAL;
+		}
+		if (hdr.size > data->rx_buf_size) {
+			LOG_WRN("Message of %u bytes exceeds RX buffer (%zu)",
+			        hdr.size, data->rx_buf_size);
+			return -EMSGSIZE;
+		}
+		if (avail < hdr.size) {
+			need = hdr.size;
+			break;
+		}
+
+		LOG_DBG("Complete message received: size=%u type=%u tag=%u",
+		        hdr.size, hdr.type, hdr.tag);
+
+		if (transport->recv_cb) {
+			transport->recv_cb(transport, msg, hdr.size,
+			                   transport->user_data);
+		}
+		data->rx_head += hdr.size;
+	}
+
+	if (data->rx_head == data->rx_tail) {
+		data->rx_head = 0;
+		data->rx_tail = 0;
+	} else if (data->rx_head + need > data->rx_buf_size) {
+		size_t pending = data->rx_tail - data->rx_head;
+
+		memmove(data->rx_buf, &data->rx_buf[data->rx_head], pending);
+		data->rx_head = 0;
+		data->rx_tail = pending;
+	}
+
+	return 0;
+}
+
 static void tcp_recv_thread_fn(void *arg1, void *arg2, void *arg3)
 {
 	ARG_UNUSED(arg2);
@@ -35,9 +161,6 @@ static void tcp_recv_thread_fn(void *arg1, void *arg2, void *arg3)
 
 	struct ninep_transport *transport = arg1;
 	struct tcp_transport_data *data = transport->priv_data;
-	size_t rx_offset = 0;
-	uint32_t expected_size = 0;
-	bool header_received = false;
 
 	LOG_INF("TCP receive thread started");
 
@@ -47,13 +170,16 @@ static void tcp_recv_thread_fn(void *arg1, void *arg2, void *arg3)
 			struct sockaddr_storage client_addr;
 			socklen_t client_addr_len = sizeof(client_addr);
 
-			LOG_INF("Waiting for client connection on port %d", data->port);
+			if (tcp_wait_readable(data->listen_sock) <= 0) {
+				continue;
+			}
+
+			LOG_INF("Accepting client connection on port %d", data->port);
 			data->client_sock = zsock_accept(data->listen_sock,
 			                            (struct sockaddr *)&client_addr,
 			                            &client_addr_len);
 			if (data->client_sock < 0) {
 				if (errno == EAGAIN || errno == EWOULDBLOCK) {
-					k_sleep(K_MSEC(100));
 					continue;
 				}
 				LOG_ERR("Accept failed: %d", errno);
@@ -61,90 +187,47 @@ static void tcp_recv_thread_fn(void *arg1, void *arg2, void *arg3)
 				continue;
 			}
 
-			/* Log client connection with address */
-			char addr_str[INET6_ADDRSTRLEN];
-			if (client_addr.ss_family == AF_INET6) {
-				struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)&client_addr;
-				zsock_inet_ntop(AF_INET6, &addr6->sin6_addr,
-				               addr_str, sizeof(addr_str));
-				LOG_INF("Client connected from [%s]:%d",
-				        addr_str, ntohs(addr6->sin6_port));
-			} else {
-				struct sockaddr_in *addr4 = (struct sockaddr_in *)&client_addr;
-				zsock_inet_ntop(AF_INET, &addr4->sin_addr,
-				               addr_str, sizeof(addr_str));
-				LOG_INF("Client connected from %s:%d",
-				        addr_str, ntohs(addr4->sin_port));
-			}
+			tcp_log_peer(&client_addr);
 
 			/* Reset receive state for new connection */
-			rx_offset = 0;
-			expected_size = 0;
-			header_received = false;
+			data->rx_head = 0;
+			data->rx_tail = 0;
 		}
 
-		/* Read data from client */
-		uint8_t byte;
-		int ret = zsock_recv(data->client_sock, &byte, 1, 0);
+		int ret = tcp_wait_readable(data->client_sock);
+
+		if (ret == 0) {
+			continue;
+		}
+		if (ret < 0) {
+			LOG_ERR("Poll error: %d", ret);
+			tcp_drop_client(data);
+			continue;
+		}
+
+		/* Read as much as the socket has, up to the end of rx_buf.
+		 * tcp_frame_messages() guarantees room for at least the rest
+		 * of the message currently being assembled. */
+		ret = zsock_recv(data->client_sock, &data->rx_buf[data->rx_tail],
+		                 data->rx_buf_size - data->rx_tail, 0);
 
 		if (ret < 0) {
 			if (errno == EAGAIN || errno == EWOULDBLOCK) {
-				k_sleep(K_MSEC(10));
 				continue;
 			}
 			LOG_ERR("Receive error: %d", errno);
-			zsock_close(data->client_sock);
-			data->client_sock = -1;
+			tcp_drop_client(data);
 			continue;
 		} else if (ret == 0) {
 			LOG_INF("Client disconnected");
-			zsock_close(data->client_sock);
-			data->client_sock = -1;
+			tcp_drop_client(data);
 			continue;
 		}
 
-		/* Store received byte */
-		if (rx_offset < data->rx_buf_size) {
-			data->rx_buf[rx_offset++] = byte;
-		} else {
-			/* Buffer overflow - reset */
-			LOG_WRN("RX buffer overflow, resetting");
-			rx_offset = 0;
-			header_received = false;
-			continue;
-		}
-
-		/* Parse header if we have enough bytes */
-		if (!header_received && rx_offset >= 7) {
-			struct ninep_msg_header hdr;
-
-			if (ninep_parse_header(data->rx_buf, rx_offset, &hdr) == 0) {
-				expected_size = hdr.size;
-				header_received = true;
-				LOG_DBG("Header received: size=%u type=%u tag=%u",
-				        hdr.size, hdr.type, hdr.tag);
-			} else {
-				/* Invalid header - reset */
-				LOG_WRN("Invalid header, resetting");
-				rx_offset = 0;
-				continue;
-			}
-		}
-
-		/* Check if we have a complete message */
-		if (header_received && rx_offset >= expected_size) {
-			LOG_DBG("Complete message received: %u bytes", expected_size);
-
-			/* Deliver complete message */
-			if (transport->recv_cb) {
-				transport->recv_cb(transport, data->rx_buf,
-				                   expected_size, transport->user_data);
-			}
+		data->rx_tail += ret;
 
-			/* Reset for next message */
-			rx_offset = 0;
-			header_received = false;
-			expected_size = 0;
+		if (tcp_frame_messages(transport, data) < 0) {
+			tcp_drop_client(data);
 		}
 	}
 
@@ -171,6 +254,59 @@ static int tcp_send(struct ninep_transport *transport, const uint8_t *buf,
 	return ret;
 }
 
+/* Scatter-gather send: one zsock_sendmsg() per message, resuming after
+ * short sends so a message is never left half-written on the stream. */
+static int tcp_sendv(struct ninep_transport *transport,
+                     const struct ninep_iovec *iov, int iovcnt)
+{
+	struct tcp_transport_data *data = transport->priv_data;
+	struct iovec vec[TCP_SENDV_MAX_IOV];
+	struct msghdr msg = { 0 };
+	size_t total = 0;
+	size_t sent = 0;
+
+	if (data->client_sock < 0) {
+		return -ENOTCONN;
+	}
+	if (iovcnt > TCP_SENDV_MAX_IOV) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < iovcnt; i++) {
+		vec[i].iov_base = (void *)iov[i].base;
+		vec[i].iov_len = iov[i].len;
+		total += iov[i].len;
+	}
+	msg.msg_iov = vec;
+	msg.msg_iovlen = iovcnt;
+
+	while (sent < total) {
+		ssize_t ret = zsock_sendmsg(data->client_sock, &msg, 0);
+
+		if (ret < 0) {
+			LOG_ERR("Sendmsg failed: %d", errno);
+			return -errno;
+		}
+		sent += ret;
+
+		/* Drop the pieces that went out; trim a partly sent one */
+		while (ret > 0) {
+			if ((size_t)ret >= msg.msg_iov->iov_len) {
+				ret -= msg.msg_iov->iov_len;
+				msg.msg_iov++;
+				msg.msg_iovlen--;
+			} else {
+				msg.msg_iov->iov_base = (uint8_t *)msg.msg_iov->iov_base + ret;
+				msg.msg_iov->iov_len -= ret;
+				ret = 0;
+			}
+		}
+	}
+
+	LOG_DBG("Sent %zu bytes (%d pieces)", sent, iovcnt);
+	return sent;
+}
+
 static int tcp_start(struct ninep_transport *transport)
 {
 	struct tcp_transport_data *data = transport->priv_data;
@@ -298,6 +434,7 @@ static const struct ninep_transport_ops tcp_transport_ops = {
 	.send = tcp_send,
 	.start = tcp_start,
 	.stop = tcp_stop,
+	.sendv = tcp_sendv,
 };
 
 int ninep_tcp_transport_init(struct ninep_transport *transport,
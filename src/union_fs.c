@@ -5,9 +5,11 @@
 
 #include <zephyr/9p/union_fs.h>
 #include <zephyr/9p/server.h>
+#include <zephyr/9p/node_alloc.h>
 #include <zephyr/9p/protocol.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <string.h>
 #include <stdint.h>
 
@@ -21,120 +23,273 @@ LOG_MODULE_REGISTER(ninep_union_fs, CONFIG_NINEP_LOG_LEVEL);
 #define MARK_SYNTHETIC(fs, node) \
 	do { (node)->parent = (struct ninep_fs_node *)(fs); } while (0)
 
-/**
- * @brief Find mount point for a given path
- *
- * Performs longest-prefix matching to find the backend that should
- * handle operations for the given path.
- *
- * @param fs Union filesystem instance
- * @param path Path to resolve
- * @param match_len Output: length of matched prefix
- * @return Pointer to mount entry, or NULL if no match
+/*
+ * Mount tree. Each mount path is split into components when it is
+ * mounted, under fs->mount_tree (the "/" component), so a walk from the
+ * union root or a synthetic directory looks its name up among one tree
+ * node's children instead of comparing every mount path. Mounts are
+ * never removed, so neither are tree nodes.
  */
-static struct ninep_union_mount *find_mount_point(struct ninep_union_fs *fs,
-                                                   const char *path,
-                                                   size_t *match_len)
+
+/* Encoded size of a mount point stat record (uid/gid/muid "zephyr") */
+#define MOUNT_STAT_LEN(name_len) (2 + 39 + 2 + (name_len) + 3 * (2 + 6))
+
+/* Next component of a mount path: skips slashes, returns its length */
+static uint16_t next_component(const char **p, const char **name)
 {
-	struct ninep_union_mount *best_match = NULL;
-	size_t longest_match = 0;
-	size_t path_len = strlen(path);
+	const char *s = *p;
 
-	/* Iterate through all mounts to find longest prefix match */
-	for (size_t i = 0; i < fs->num_mounts; i++) {
-		struct ninep_union_mount *mount = &fs->mounts[i];
-		size_t mount_len = strlen(mount->path);
+	while (*s == '/') {
+		s++;
+	}
+	*name = s;
+	while (*s != '\0' && *s != '/') {
+		s++;
+	}
+	*p = s;
+	return s - *name;
+}
 
-		/* Skip if mount path is longer than target path */
-		if (mount_len > path_len) {
-			continue;
+static struct ninep_union_mount_node *tree_child(
+	const struct ninep_union_mount_node *dir, const char *name,
+	uint16_t name_len)
+{
+	for (struct ninep_union_mount_node *c = dir->children; c; c = c->next) {
+		if (c->name_len == name_len &&
+		    memcmp(c->name, name, name_len) == 0) {
+			return c;
+		}
+	}
+	return NULL;
+}
+
+/* Add mount's path to the tree. Missing components are allocated
+ * together before anything is linked, so failure leaves the tree as it
+ * was. Returns -EEXIST if the path is already a mount point. */
+static int tree_add(struct ninep_union_fs *fs, struct ninep_union_mount *mount)
+{
+	struct ninep_union_mount_node *dir = &fs->mount_tree;
+	struct ninep_union_mount_node *child = NULL;
+	const char *p = mount->path;
+	const char *name;
+	uint16_t len;
+
+	while ((len = next_component(&p, &name)) > 0 &&
+	       (child = tree_child(dir, name, len)) != NULL) {
+		dir = child;
+	}
+	if (len == 0) {
+		if (dir->mount) {
+			return -EEXIST;
 		}
+		dir->mount = mount;
+		return 0;
+	}
+
+	const char *rest = p;
+	const char *skip;
+	size_t n = 1;
+
+	while (next_component(&rest, &skip) > 0) {
+		n++;
+	}
+
+	struct ninep_union_mount_node *chain = k_malloc(n * sizeof(*chain));
+
+	if (!chain) {
+		return -ENOMEM;
+	}
+	memset(chain, 0, n * sizeof(*chain));
+	for (size_t i = 0; i < n; i++) {
+		chain[i].name = name;
+		chain[i].name_len = len;
+		chain[i].qid_path = fs->next_qid_path++;
+		if (i + 1 < n) {
+			chain[i].children = &chain[i + 1];
+			len = next_component(&p, &name);
+		}
+	}
+	chain[n - 1].mount = mount;
+
+	/* Append, so listings keep mount order */
+	struct ninep_union_mount_node **tail = &dir->children;
+
+	while (*tail) {
+		tail = &(*tail)->next;
+	}
+	*tail = chain;
+	return 0;
+}
 
-		/* Skip if this mount path is shorter than current best match */
-		if (mount_len < longest_match) {
+/* Stat records for dir's children from byte skip of the listing on, as
+ * many whole ones as fit in len */
+static size_t encode_children(const struct ninep_union_mount_node *dir,
+                              uint64_t skip, uint8_t *buf, size_t len)
+{
+	size_t offset = 0;
+	uint64_t pos = 0;
+
+	for (const struct ninep_union_mount_node *c = dir->children; c;
+	     c = c->next) {
+		if (pos < skip) {
+			pos += MOUNT_STAT_LEN(c->name_len);
 			continue;
 		}
 
-		/* Check if mount path is a prefix of target path */
-		if (strncmp(path, mount->path, mount_len) == 0) {
-			/* Verify path boundary (must be '/' or end of string) */
-			if (mount_len == 1 || /* root mount "/" */
-			    path[mount_len] == '/' ||
-			    path[mount_len] == '\0') {
-				best_match = mount;
-				longest_match = mount_len;
-			}
+		struct ninep_qid qid = {
+			.type = NINEP_QTDIR,
+			.path = c->mount ? c->mount->root->qid.path : c->qid_path,
+		};
+
+		if (ninep_write_stat(buf, len, &offset, &qid, 0755 | NINEP_DMDIR,
+		                     0, c->name, c->name_len,
+		                     NULL, NULL, NULL) < 0) {
+			break;
 		}
 	}
+	return offset;
+}
 
-	if (match_len && best_match) {
-		*match_len = longest_match;
+/* Copy the whole stat records of recs[offset..len) that fit in count */
+static uint32_t copy_records(const uint8_t *recs, size_t len, uint64_t offset,
+                             uint8_t *buf, uint32_t count)
+{
+	size_t end = offset;
+
+	if (offset >= len) {
+		return 0;
 	}
+	while (end < len) {
+		size_t rec = 2 + sys_get_le16(recs + end);
 
-	return best_match;
+		if (end + rec - offset > count) {
+			break;
+		}
+		end += rec;
+	}
+	memcpy(buf, recs + offset, end - offset);
+	return end - offset;
 }
 
-/**
- * @brief Get relative path within a mount point
- *
- * Given a full path and a mount point, returns the path relative
- * to that mount point.
- *
- * Example: path="/dev/led", mount="/dev" -> returns "/led"
- *          path="/files/notes/todo.txt", mount="/files" -> returns "/notes/todo.txt"
- *
- * @param path Full path
- * @param mount_path Mount point path
- * @return Relative path (always starts with '/')
+/*
+ * Node ownership tracking. Entries of fs->node_owners[] are found by node
+ * pointer through fs->owner_buckets[] and kept on one of two LRU lists,
+ * most recently used first: fs->idle for nodes no fid holds and
+ * fs->active for the rest. Eviction takes the tail of the idle list, so
+ * every operation is O(1) however full the table is. Unused entries are
+ * chained through hash_next on fs->owner_free. All of it is protected by
+ * fs->track_lock.
  */
-static const char *get_relative_path(const char *path, const char *mount_path)
+
+static struct ninep_node_owner **owner_bucket(struct ninep_union_fs *fs,
+                                              const struct ninep_fs_node *node)
 {
-	size_t mount_len = strlen(mount_path);
+	uintptr_t key = (uintptr_t)node >> 3;  /* Nodes are at least 8-aligned */
+
+	return &fs->owner_buckets[(uint32_t)(key * 2654435761u) &
+	                          (NINEP_UNION_OWNER_BUCKETS - 1)];
+}
 
-	/* Root mount - return path as-is */
-	if (mount_len == 1 && mount_path[0] == '/') {
-		return path;
+static struct ninep_node_owner *lookup_owner(struct ninep_union_fs *fs,
+                                             const struct ninep_fs_node *node)
+{
+	struct ninep_node_owner *o = *owner_bucket(fs, node);
+
+	while (o && o->node != node) {
+		o = o->hash_next;
 	}
+	return o;
+}
 
-	/* Skip past mount point prefix */
-	const char *rel_path = path + mount_len;
+static struct ninep_node_owner_lru *owner_lru(struct ninep_union_fs *fs,
+                                              struct ninep_node_owner *o)
+{
+	return o->refcount ? &fs->active : &fs->idle;
+}
 
-	/* If relative path is empty, return "/" (mount point root) */
-	if (*rel_path == '\0') {
-		return "/";
+static void lru_unlink(struct ninep_node_owner_lru *lru,
+                       struct ninep_node_owner *o)
+{
+	if (o->lru_prev) {
+		o->lru_prev->lru_next = o->lru_next;
+	} else {
+		lru->head = o->lru_next;
+	}
+	if (o->lru_next) {
+		o->lru_next->lru_prev = o->lru_prev;
+	} else {
+		lru->tail = o->lru_prev;
 	}
+}
 
-	return rel_path;
+static void lru_push(struct ninep_node_owner_lru *lru,
+                     struct ninep_node_owner *o)
+{
+	o->lru_prev = NULL;
+	o->lru_next = lru->head;
+	if (lru->head) {
+		lru->head->lru_prev = o;
+	} else {
+		lru->tail = o;
+	}
+	lru->head = o;
+}
+
+/* Mark o used now, moving it between lists if its refcount changed */
+static void owner_touch(struct ninep_union_fs *fs, struct ninep_node_owner *o,
+                        uint32_t refcount, uint32_t now)
+{
+	lru_unlink(owner_lru(fs, o), o);
+	o->refcount = refcount;
+	o->last_access = now;
+	lru_push(owner_lru(fs, o), o);
+}
+
+static void owner_insert(struct ninep_union_fs *fs, struct ninep_fs_node *node,
+                         struct ninep_union_mount *mount, uint32_t now)
+{
+	struct ninep_node_owner *o = fs->owner_free;
+	struct ninep_node_owner **bucket = owner_bucket(fs, node);
+
+	fs->owner_free = o->hash_next;
+	o->node = node;
+	o->mount = mount;
+	o->last_access = now;
+	o->refcount = 1;  /* Start at 1 since walk created a fid */
+	o->hash_next = *bucket;
+	*bucket = o;
+	lru_push(&fs->active, o);
+	fs->num_node_owners++;
+}
+
+static void owner_remove(struct ninep_union_fs *fs, struct ninep_node_owner *o)
+{
+	struct ninep_node_owner **link = owner_bucket(fs, o->node);
+
+	while (*link != o) {
+		link = &(*link)->hash_next;
+	}
+	*link = o->hash_next;
+	lru_unlink(owner_lru(fs, o), o);
+	o->node = NULL;
+	o->hash_next = fs->owner_free;
+	fs->owner_free = o;
+	fs->num_node_owners--;
 }
 
 /**
- * @brief Find which backend mount owns a given node
- *
- * @param fs Union filesystem instance
- * @param node Node to look up
- * @return Pointer to owning mount, or NULL if node is union root or not found
- */
-/**
- * @brief Register a node as being owned by a specific mount
+ * @brief Stop tracking a node no fid references any more
  */
 static void unregister_node_owner(struct ninep_union_fs *fs,
                                    struct ninep_fs_node *node)
 {
 	k_mutex_lock(&fs->track_lock, K_FOREVER);
-	/* Find and remove the node from tracking */
-	for (size_t i = 0; i < fs->num_node_owners; i++) {
-		if (fs->node_owners[i].node == node) {
-			LOG_DBG("Unregistering node=%p name='%s' (was at index %zu)",
-			        node, node->name, i);
-
-			/* Shift remaining entries down */
-			for (size_t j = i; j < fs->num_node_owners - 1; j++) {
-				fs->node_owners[j] = fs->node_owners[j + 1];
-			}
-			fs->num_node_owners--;
-			k_mutex_unlock(&fs->track_lock);
-			return;
-		}
+	struct ninep_node_owner *o = lookup_owner(fs, node);
+
+	/* The backend may have freed the node: only its address is used */
+	if (o && o->refcount == 0) {
+		LOG_DBG("Unregistering node=%p", node);
+		owner_remove(fs, o);
 	}
 	k_mutex_unlock(&fs->track_lock);
 }
@@ -143,14 +298,14 @@ static void incref_node(struct ninep_union_fs *fs, struct ninep_fs_node *node)
 {
 	k_mutex_lock(&fs->track_lock, K_FOREVER);
 	/* Find the node in tracking table and increment refcount */
-	for (size_t i = 0; i < fs->num_node_owners; i++) {
-		if (fs->node_owners[i].node == node) {
-			fs->node_owners[i].refcount++;
-			LOG_DBG("incref: node=%p name='%s' refcount=%u",
-			        node, node->name, fs->node_owners[i].refcount);
-			k_mutex_unlock(&fs->track_lock);
-			return;
-		}
+	struct ninep_node_owner *o = lookup_owner(fs, node);
+
+	if (o) {
+		owner_touch(fs, o, o->refcount + 1, k_uptime_get_32());
+		LOG_DBG("incref: node=%p name='%s' refcount=%u",
+		        node, node->name, o->refcount);
+		k_mutex_unlock(&fs->track_lock);
+		return;
 	}
 	k_mutex_unlock(&fs->track_lock);
 	LOG_DBG("incref: node=%p name='%s' not in tracking table (mount root or union root)",
@@ -161,19 +316,19 @@ static void decref_node(struct ninep_union_fs *fs, struct ninep_fs_node *node)
 {
 	k_mutex_lock(&fs->track_lock, K_FOREVER);
 	/* Find the node in tracking table and decrement refcount */
-	for (size_t i = 0; i < fs->num_node_owners; i++) {
-		if (fs->node_owners[i].node == node) {
-			if (fs->node_owners[i].refcount > 0) {
-				fs->node_owners[i].refcount--;
-				LOG_DBG("decref: node=%p name='%s' refcount=%u",
-				        node, node->name, fs->node_owners[i].refcount);
-			} else {
-				LOG_WRN("decref: node=%p name='%s' already has refcount=0!",
-				        node, node->name);
-			}
-			k_mutex_unlock(&fs->track_lock);
-			return;
+	struct ninep_node_owner *o = lookup_owner(fs, node);
+
+	if (o) {
+		if (o->refcount > 0) {
+			owner_touch(fs, o, o->refcount - 1, k_uptime_get_32());
+			LOG_DBG("decref: node=%p name='%s' refcount=%u",
+			        node, node->name, o->refcount);
+		} else {
+			LOG_WRN("decref: node=%p name='%s' already has refcount=0!",
+			        node, node->name);
 		}
+		k_mutex_unlock(&fs->track_lock);
+		return;
 	}
 	k_mutex_unlock(&fs->track_lock);
 	LOG_DBG("decref: node=%p name='%s' not in tracking table (mount root or union root)",
@@ -190,42 +345,38 @@ static bool register_node_owner(struct ninep_union_fs *fs,
 	k_mutex_lock(&fs->track_lock, K_FOREVER);
 
 	/* Check if already registered */
-	for (size_t i = 0; i < fs->num_node_owners; i++) {
-		if (fs->node_owners[i].node == node) {
-			/* Already registered - update last_access for LRU.
-			 *
-			 * For intermediate nodes in multi-element walks (like /games/lobby/board),
-			 * we don't want to increment refcount since only the final element's fid
-			 * gets clunked. Intermediate nodes would accumulate refcounts without
-			 * ever being decremented.
-			 *
-			 * However, if refcount == 0, this node was previously clunked and is now
-			 * being walked to again (as a final target). In this case, we MUST
-			 * re-activate it with refcount = 1, otherwise the next clunk will warn
-			 * about decrementing refcount that's already 0. */
-			fs->node_owners[i].mount = mount;
-			fs->node_owners[i].last_access = now;
-			if (fs->node_owners[i].refcount == 0) {
-				/* Node was clunked, now being walked to again - reactivate */
-				fs->node_owners[i].refcount = 1;
-				LOG_DBG("Re-activated node=%p name='%s', refcount=1",
-				        node, node->name);
-			} else {
-				LOG_DBG("Re-registered node=%p name='%s', refcount=%u (unchanged)",
-				        node, node->name, fs->node_owners[i].refcount);
-			}
-			result = true;
-			goto out;
+	struct ninep_node_owner *o = lookup_owner(fs, node);
+
+	if (o) {
+		/* Already registered - update last_access for LRU.
+		 *
+		 * For intermediate nodes in multi-element walks (like /games/lobby/board),
+		 * we don't want to increment refcount since only the final element's fid
+		 * gets clunked. Intermediate nodes would accumulate refcounts without
+		 * ever being decremented.
+		 *
+		 * However, if refcount == 0, this node was previously clunked and is now
+		 * being walked to again (as a final target). In this case, we MUST
+		 * re-activate it with refcount = 1, otherwise the next clunk will warn
+		 * about decrementing refcount that's already 0. */
+		o->mount = mount;
+		if (o->refcount == 0) {
+			/* Node was clunked, now being walked to again - reactivate */
+			owner_touch(fs, o, 1, now);
+			LOG_DBG("Re-activated node=%p name='%s', refcount=1",
+			        node, node->name);
+		} else {
+			owner_touch(fs, o, o->refcount, now);
+			LOG_DBG("Re-registered node=%p name='%s', refcount=%u (unchanged)",
+			        node, node->name, o->refcount);
 		}
+		result = true;
+		goto out;
 	}
 
 	/* Add new entry if space available */
-	if (fs->num_node_owners < ARRAY_SIZE(fs->node_owners)) {
-		fs->node_owners[fs->num_node_owners].node = node;
-		fs->node_owners[fs->num_node_owners].mount = mount;
-		fs->node_owners[fs->num_node_owners].last_access = now;
-		fs->node_owners[fs->num_node_owners].refcount = 1;  /* Start at 1 since walk created a fid */
-		fs->num_node_owners++;
+	if (fs->owner_free) {
+		owner_insert(fs, node, mount, now);
 		LOG_DBG("Registered node=%p name='%s' -> mount '%s' (total=%zu, refcount=1)",
 		        node, node->name, mount->path, fs->num_node_owners);
 		result = true;
@@ -233,57 +384,32 @@ static bool register_node_owner(struct ninep_union_fs *fs,
 	}
 
 	/* Table is full - evict LRU entry
-	 * First pass: prefer nodes with refcount == 0
-	 * Second pass: if all have refcount > 0, evict stale nodes (> 30s old)
-	 *              as a safety valve against leaked intermediate nodes */
-	size_t lru_idx = SIZE_MAX;
-	uint32_t oldest_time = UINT32_MAX;
-	size_t stale_idx = SIZE_MAX;
-	uint32_t stalest_time = UINT32_MAX;
+	 * First choice: the least recently used node with refcount == 0
+	 * Fallback: the least recently used referenced node if it is stale
+	 *           (> 30s old), as a safety valve against leaked intermediate
+	 *           nodes */
 	const uint32_t STALE_THRESHOLD_MS = 30000;  /* 30 seconds */
+	struct ninep_node_owner *victim = fs->idle.tail;
 
-	for (size_t i = 0; i < fs->num_node_owners; i++) {
-		uint32_t age = now - fs->node_owners[i].last_access;
-
-		/* Track LRU among refcount==0 nodes (ideal eviction candidates) */
-		if (fs->node_owners[i].refcount == 0) {
-			if (fs->node_owners[i].last_access < oldest_time) {
-				oldest_time = fs->node_owners[i].last_access;
-				lru_idx = i;
-			}
-		}
-
-		/* Also track oldest node regardless of refcount, for fallback eviction
-		 * of stale leaked nodes (intermediate walk nodes that never got clunked) */
-		if (age > STALE_THRESHOLD_MS && fs->node_owners[i].last_access < stalest_time) {
-			stalest_time = fs->node_owners[i].last_access;
-			stale_idx = i;
-		}
-	}
-
-	/* Prefer refcount==0 eviction, fall back to stale node eviction */
-	if (lru_idx == SIZE_MAX && stale_idx != SIZE_MAX) {
+	if (!victim && fs->active.tail &&
+	    now - fs->active.tail->last_access > STALE_THRESHOLD_MS) {
+		victim = fs->active.tail;
 		LOG_WRN("No refcount=0 nodes to evict, using stale node fallback (age=%u ms, refcount=%u)",
-		        now - stalest_time, fs->node_owners[stale_idx].refcount);
-		lru_idx = stale_idx;
-		oldest_time = stalest_time;
+		        now - victim->last_access, victim->refcount);
 	}
 
-	if (lru_idx == SIZE_MAX) {
+	if (!victim) {
 		/* All nodes are both referenced AND recently accessed - can't evict! */
 		LOG_ERR("Node table full (%zu entries) and no evictable nodes! Cannot register node=%p name='%s'",
 		        fs->num_node_owners, node, node->name);
 
-		/* Dump first 10 entries to diagnose the leak */
-		LOG_ERR("Node table dump (first 10 entries):");
-		for (size_t i = 0; i < 10 && i < fs->num_node_owners; i++) {
+		/* Dump the 10 least recently used entries to diagnose the leak */
+		LOG_ERR("Node table dump (10 least recently used):");
+		o = fs->active.tail;
+		for (size_t i = 0; i < 10 && o; i++, o = o->lru_prev) {
 			LOG_ERR("  [%zu] node=%p name='%s' mount='%s' refcount=%u age=%u ms",
-			        i,
-			        fs->node_owners[i].node,
-			        fs->node_owners[i].node->name,
-			        fs->node_owners[i].mount->path,
-			        fs->node_owners[i].refcount,
-			        now - fs->node_owners[i].last_access);
+			        i, o->node, o->node->name, o->mount->path,
+			        o->refcount, now - o->last_access);
 		}
 
 		result = false;
@@ -291,17 +417,12 @@ static bool register_node_owner(struct ninep_union_fs *fs,
 	}
 
 	LOG_INF("Node table full (%zu entries) - evicting LRU entry: node=%p name='%s' (age=%u ms, refcount=%u)",
-	        fs->num_node_owners,
-	        fs->node_owners[lru_idx].node,
-	        fs->node_owners[lru_idx].node->name,
-	        now - oldest_time,
-	        fs->node_owners[lru_idx].refcount);
+	        fs->num_node_owners, victim->node, victim->node->name,
+	        now - victim->last_access, victim->refcount);
 
 	/* Replace LRU entry with new node */
-	fs->node_owners[lru_idx].node = node;
-	fs->node_owners[lru_idx].mount = mount;
-	fs->node_owners[lru_idx].last_access = now;
-	fs->node_owners[lru_idx].refcount = 1;  /* Start at 1 since walk created a fid */
+	owner_remove(fs, victim);
+	owner_insert(fs, node, mount, now);
 	result = true;
 
 out:
@@ -309,6 +430,13 @@ out:
 	return result;
 }
 
+/**
+ * @brief Find which backend mount owns a given node
+ *
+ * @param fs Union filesystem instance
+ * @param node Node to look up
+ * @return Pointer to owning mount, or NULL if node is union root or not found
+ */
 static struct ninep_union_mount *find_node_owner(struct ninep_union_fs *fs,
                                                    struct ninep_fs_node *node)
 {
@@ -327,18 +455,18 @@ static struct ninep_union_mount *find_node_owner(struct ninep_union_fs *fs,
 	}
 
 	/* First check the ownership tracking table. fs->mounts[] and fs->root
-	 * are init-time-only and don't need the lock; the tracking table
-	 * (node_owners[] / num_node_owners) is mutated concurrently and does. */
+	 * are init-time-only and don't need the lock; the tracking table is
+	 * mutated concurrently and does. */
 	k_mutex_lock(&fs->track_lock, K_FOREVER);
-	for (size_t i = 0; i < fs->num_node_owners; i++) {
-		if (fs->node_owners[i].node == node) {
-			/* Update access timestamp (LRU touch) */
-			fs->node_owners[i].last_access = k_uptime_get_32();
-			struct ninep_union_mount *m = fs->node_owners[i].mount;
-			k_mutex_unlock(&fs->track_lock);
-			LOG_DBG("  Found in tracking table -> mount '%s'", m->path);
-			return m;
-		}
+	struct ninep_node_owner *o = lookup_owner(fs, node);
+
+	if (o) {
+		/* Update access timestamp (LRU touch) */
+		owner_touch(fs, o, o->refcount, k_uptime_get_32());
+		struct ninep_union_mount *m = o->mount;
+		k_mutex_unlock(&fs->track_lock);
+		LOG_DBG("  Found in tracking table -> mount '%s'", m->path);
+		return m;
 	}
 	k_mutex_unlock(&fs->track_lock);
 
@@ -360,6 +488,39 @@ static struct ninep_union_mount *find_node_owner(struct ninep_union_fs *fs,
 	return NULL;
 }
 
+/* Synthetic directory for an intermediate mount path component. The full
+ * path is kept after it, in the same allocator block. */
+struct union_synth {
+	struct ninep_fs_node node;
+	const struct ninep_union_mount_node *dir;
+};
+
+static struct ninep_fs_node *alloc_synthetic(
+	struct ninep_union_fs *fs, const struct ninep_union_mount_node *dir,
+	const char *parent_path)
+{
+	size_t path_len = strlen(parent_path) + 1 + dir->name_len;
+	struct union_synth *synth =
+		(struct union_synth *)ninep_node_alloc(sizeof(*synth) + path_len + 1,
+		                                       dir->name, dir->name_len);
+
+	if (!synth) {
+		return NULL;
+	}
+	synth->dir = dir;
+	synth->node.type = NINEP_NODE_DIR;
+	synth->node.mode = 0555 | NINEP_DMDIR;
+	synth->node.qid.type = NINEP_QTDIR;
+	synth->node.qid.path = dir->qid_path;
+	synth->node.data = synth + 1;
+	snprintf(synth->node.data, path_len + 1, "%s/%.*s", parent_path,
+	         dir->name_len, dir->name);
+	MARK_SYNTHETIC(fs, &synth->node);
+	LOG_DBG("Created synthetic dir for intermediate path: %s",
+	        (const char *)synth->node.data);
+	return &synth->node;
+}
+
 /* Union filesystem operations - delegate to appropriate backend */
 
 static struct ninep_fs_node *union_walk(struct ninep_fs_node *parent,
@@ -370,34 +531,19 @@ static struct ninep_fs_node *union_walk(struct ninep_fs_node *parent,
 
 	/* If parent is the union root, we need to figure out which backend to use */
 	if (parent == fs->root) {
-		/* Build full path */
-		char full_path[256];
-		snprintf(full_path, sizeof(full_path), "/%.*s", name_len, name);
-
-		/* First check if this is an exact mount point match */
-		for (size_t i = 0; i < fs->num_mounts; i++) {
-			if (strcmp(fs->mounts[i].path, full_path) == 0) {
-				/* Walking directly to a mount point - return its root */
-				LOG_DBG("Walk matched mount point '%s', returning root=%p name='%s'",
-				        full_path, fs->mounts[i].root,
-				        fs->mounts[i].root ? fs->mounts[i].root->name : "NULL");
-				/* Mount roots are implicitly owned by their mount, no need to register */
-				return fs->mounts[i].root;
-			}
-		}
-
-		/* Not an exact mount point - find which backend should handle it */
-		size_t match_len;
-		struct ninep_union_mount *mount = find_mount_point(fs, full_path, &match_len);
-
-		if (!mount) {
-			/* No backend handles this path. Check if it's a prefix of a
-			 * deeper mount (e.g., "/portals" when mount is at "/portals/frst") */
-			goto try_synthetic;
+		struct ninep_union_mount_node *child =
+			tree_child(&fs->mount_tree, name, name_len);
+		struct ninep_union_mount *mount = fs->mount_tree.mount;
+
+		/* Walking directly to a mount point - return its root. Mount
+		 * roots are implicitly owned by their mount, no need to register */
+		if (child && child->mount) {
+			LOG_DBG("Walk matched mount point '%s'", child->mount->path);
+			return child->mount->root;
 		}
 
-		/* If matched the "/" mount, delegate to it */
-		if (strcmp(mount->path, "/") == 0) {
+		/* Otherwise the "/" mount, if any, gets the first try */
+		if (mount && mount->fs_ops->walk) {
 			struct ninep_fs_node *node = mount->fs_ops->walk(mount->root, name, name_len,
 			                                                   mount->fs_ctx);
 			if (node) {
@@ -415,114 +561,33 @@ static struct ninep_fs_node *union_walk(struct ninep_fs_node *parent,
 			 * /net/tcp is a separate union mount. Walking to /net returns
 			 * sysfs's node, but walking to a path sysfs doesn't know should
 			 * still check for deeper mount prefixes. */
-			goto try_synthetic;
 		}
 
-		/* For other mounts, get relative path */
-		const char *rel_path = get_relative_path(full_path, mount->path);
-
-		/* Delegate to backend */
-		if (!mount->fs_ops->walk) {
-			return NULL;
-		}
-
-		/* Skip leading '/' in relative path */
-		const char *backend_path = rel_path + 1;
-		uint16_t backend_path_len = strlen(backend_path);
-
-		struct ninep_fs_node *node = mount->fs_ops->walk(mount->root, backend_path,
-		                                                   backend_path_len, mount->fs_ctx);
-		if (node) {
-			if (!register_node_owner(fs, node, mount)) {
-				LOG_ERR("Failed to register node - node table full");
-				/* Backend may need to clunk the node we just walked */
-				if (mount->fs_ops->clunk) {
-					mount->fs_ops->clunk(node, mount->fs_ctx);
-				}
-				return NULL;
-			}
-		}
-		return node;
-
-try_synthetic:
-		/* Check if this is a prefix of a deeper mount path.
-		 * E.g., walking to "/portals" when there's a mount at "/portals/frst".
-		 * Only reached when no backend handled the path. */
-		{
-			size_t full_path_len = strlen(full_path);
-			for (size_t i = 0; i < fs->num_mounts; i++) {
-				if (strlen(fs->mounts[i].path) > full_path_len &&
-				    strncmp(fs->mounts[i].path, full_path, full_path_len) == 0 &&
-				    fs->mounts[i].path[full_path_len] == '/') {
-					struct ninep_fs_node *synth = k_malloc(sizeof(*synth));
-					if (!synth) {
-						return NULL;
-					}
-					memset(synth, 0, sizeof(*synth));
-					memcpy(synth->name, name, name_len < sizeof(synth->name) - 1 ?
-					       name_len : sizeof(synth->name) - 1);
-					synth->type = NINEP_NODE_DIR;
-					synth->mode = 0555 | NINEP_DMDIR;
-					synth->qid.type = NINEP_QTDIR;
-					synth->qid.path = fs->next_qid_path++;
-					synth->data = k_malloc(full_path_len + 1);
-					if (synth->data) {
-						memcpy(synth->data, full_path, full_path_len + 1);
-					}
-					MARK_SYNTHETIC(fs, synth);
-					LOG_DBG("Created synthetic dir for intermediate path: %s", full_path);
-					return synth;
-				}
-			}
+		/* A prefix of a deeper mount path, e.g. "/portals" when there's
+		 * a mount at "/portals/frst" */
+		if (child) {
+			return alloc_synthetic(fs, child, "");
 		}
-		LOG_DBG("No match for path: %s", full_path);
+		LOG_DBG("No match for path: /%.*s", name_len, name);
 		return NULL;
 	} else {
 		/* Check if parent is a synthetic directory node (intermediate path) */
 		if (IS_SYNTHETIC_DIR(fs, parent)) {
-			/* This is a synthetic dir - build full path from stored prefix + name */
-			char full_path[256];
-			snprintf(full_path, sizeof(full_path), "%s/%.*s",
-			         (const char *)parent->data, name_len, name);
-
-			/* Check for exact mount point match */
-			for (size_t i = 0; i < fs->num_mounts; i++) {
-				if (strcmp(fs->mounts[i].path, full_path) == 0) {
-					LOG_DBG("Synthetic walk matched mount point '%s'", full_path);
-					return fs->mounts[i].root;
-				}
-			}
+			const struct union_synth *synth = (const struct union_synth *)parent;
+			struct ninep_union_mount_node *child =
+				tree_child(synth->dir, name, name_len);
 
-			/* Check if this is a prefix of a deeper mount path */
-			size_t full_path_len = strlen(full_path);
-			for (size_t i = 0; i < fs->num_mounts; i++) {
-				if (strlen(fs->mounts[i].path) > full_path_len &&
-				    strncmp(fs->mounts[i].path, full_path, full_path_len) == 0 &&
-				    fs->mounts[i].path[full_path_len] == '/') {
-					/* Create another synthetic directory */
-					struct ninep_fs_node *synth = k_malloc(sizeof(*synth));
-					if (!synth) {
-						return NULL;
-					}
-					memset(synth, 0, sizeof(*synth));
-					memcpy(synth->name, name, name_len < sizeof(synth->name) - 1 ?
-					       name_len : sizeof(synth->name) - 1);
-					synth->type = NINEP_NODE_DIR;
-					synth->mode = 0555 | NINEP_DMDIR;
-					synth->qid.type = NINEP_QTDIR;
-					synth->qid.path = fs->next_qid_path++;
-					synth->data = k_malloc(full_path_len + 1);
-					if (synth->data) {
-						memcpy(synth->data, full_path, full_path_len + 1);
-					}
-					MARK_SYNTHETIC(fs, synth);
-					LOG_DBG("Created synthetic dir for intermediate path: %s", full_path);
-					return synth;
-				}
+			if (!child) {
+				LOG_DBG("Synthetic walk: no mount match for '%s/%.*s'",
+				        (const char *)parent->data, name_len, name);
+				return NULL;
 			}
-
-			LOG_DBG("Synthetic walk: no mount match for '%s'", full_path);
-			return NULL;
+			if (child->mount) {
+				LOG_DBG("Synthetic walk matched mount point '%s'",
+				        child->mount->path);
+				return child->mount->root;
+			}
+			return alloc_synthetic(fs, child, parent->data);
 		}
 
 		/* Parent is not union root - delegate to the backend that owns it */
@@ -563,175 +628,34 @@ static int union_read(struct ninep_fs_node *node, uint64_t offset,
 
 	/* If reading the union root directory */
 	if (node == fs->root) {
-		/* Check if there's a backend mounted at "/" */
-		struct ninep_union_mount *root_mount = NULL;
-		int root_mount_idx = -1;
-		for (size_t i = 0; i < fs->num_mounts; i++) {
-			if (strcmp(fs->mounts[i].path, "/") == 0) {
-				root_mount = &fs->mounts[i];
-				root_mount_idx = i;
-				break;
-			}
-		}
+		struct ninep_union_mount *root_mount = fs->mount_tree.mount;
 
-		/* Count non-root mounts */
-		size_t num_other_mounts = 0;
-		for (size_t i = 0; i < fs->num_mounts; i++) {
-			if (strcmp(fs->mounts[i].path, "/") != 0) {
-				num_other_mounts++;
-			}
+		/* No root mount - serve the mount point listing */
+		if (!root_mount) {
+			return copy_records(fs->root_listing, fs->root_listing_len,
+			                    offset, buf, count);
 		}
-
-		/* If there's a root mount AND no other mounts, just delegate */
-		if (root_mount && num_other_mounts == 0 && root_mount->fs_ops->read) {
-			return root_mount->fs_ops->read(root_mount->root, offset,
-			                                 buf, count, uname, root_mount->fs_ctx);
+		if (!root_mount->fs_ops->read) {
+			return -ENOTSUP;
 		}
 
-		/* If there's a root mount AND other mounts, we need to merge listings */
-		if (root_mount && num_other_mounts > 0) {
-			/* First, get the "/" mount's entries */
-			int ret = root_mount->fs_ops->read(root_mount->root, offset,
-			                                    buf, count, uname, root_mount->fs_ctx);
-
-			if (ret < 0) {
-				return ret;
-			}
-
-			/* Only append mount points on the FIRST read (offset == 0) or
-			 * when sysfs still has data. This prevents infinite loops where
-			 * we keep appending mount points on every paginated read. */
-			if (offset == 0 && ret > 0) {
-				size_t buf_offset = ret;  /* Bytes used by "/" mount's entries */
+		int ret = root_mount->fs_ops->read(root_mount->root, offset,
+		                                    buf, count, uname, root_mount->fs_ctx);
 
-				/* Now append stat entries for mount points */
-				for (size_t i = 0; i < fs->num_mounts; i++) {
-					struct ninep_union_mount *mount = &fs->mounts[i];
-
-					/* Skip root mount */
-					if (strcmp(mount->path, "/") == 0) {
-						continue;
-					}
-
-					/* Extract first path component only (skip leading '/', stop at next '/') */
-					const char *name_start = mount->path + 1;
-					const char *next_slash = strchr(name_start, '/');
-					uint16_t name_len = next_slash ? (uint16_t)(next_slash - name_start) : strlen(name_start);
-					const char *name = name_start;
-
-					/* Create a synthetic QID for this mount point */
-					struct ninep_qid mount_qid = {
-						.type = NINEP_QTDIR,
-						.version = 0,
-						.path = (uint64_t)(uintptr_t)mount  /* Use mount address as unique path */
-					};
-
-					/* Write stat structure for mount point directory */
-					size_t write_offset = 0;
-					int write_ret = ninep_write_stat(buf + buf_offset, count - buf_offset,
-					                                  &write_offset, &mount_qid,
-					                                  0755 | NINEP_DMDIR,  /* Directory mode */
-					                                  0,  /* length */
-					                                  name, name_len,
-					                                  NULL, NULL, NULL);  /* uid/gid/muid default to "zephyr" */
-
-					if (write_ret < 0) {
-						/* No more space - return what we have */
-						break;
-					}
-
-					buf_offset += write_offset;
-				}
-
-				return buf_offset;
-			}
-
-			/* For subsequent reads (offset > 0), just return what sysfs gives us */
+		/* Only append mount points on the FIRST read (offset == 0) or
+		 * when sysfs still has data. This prevents infinite loops where
+		 * we keep appending mount points on every paginated read. */
+		if (ret <= 0 || offset != 0) {
 			return ret;
 		}
-
-		/* No root mount - synthesize directory with mount points only */
-		uint32_t pos = 0;
-
-		/* Skip entries based on offset (simplified) */
-		size_t start_idx = offset / 128; /* rough estimate */
-
-		for (size_t i = start_idx; i < fs->num_mounts && pos < count; i++) {
-			struct ninep_union_mount *mount = &fs->mounts[i];
-
-			/* Skip root mount (already handled above) */
-			if (strcmp(mount->path, "/") == 0) {
-				continue;
-			}
-
-			/* Extract first path component only (skip leading '/', stop at next '/') */
-			const char *name_start = mount->path + 1;
-			const char *next_slash = strchr(name_start, '/');
-
-			/* Simple name output (real implementation would use stat format) */
-			size_t name_len = next_slash ? (next_slash - name_start) : strlen(name_start);
-			if (pos + name_len + 1 > count) {
-				break;
-			}
-
-			memcpy(buf + pos, name_start, name_len);
-			pos += name_len;
-			buf[pos++] = '\n';
-		}
-
-		return pos;
+		return ret + copy_records(fs->root_listing, fs->root_listing_len,
+		                          0, buf + ret, count - ret);
 	}
 
 	/* Check if this is a synthetic directory node */
 	if (IS_SYNTHETIC_DIR(fs, node)) {
-		const char *synth_path = (const char *)node->data;
-		size_t synth_path_len = strlen(synth_path);
-		size_t buf_offset = 0;
-
-		if (offset > 0) {
-			/* Synthetic dirs don't support paginated reads */
-			return 0;
-		}
-
-		/* List child entries: find mounts whose path starts with synth_path + "/" */
-		for (size_t i = 0; i < fs->num_mounts; i++) {
-			const char *mount_path = fs->mounts[i].path;
-			size_t mount_path_len = strlen(mount_path);
-
-			if (mount_path_len > synth_path_len &&
-			    strncmp(mount_path, synth_path, synth_path_len) == 0 &&
-			    mount_path[synth_path_len] == '/') {
-				/* Extract the next path component after synth_path/ */
-				const char *child_start = mount_path + synth_path_len + 1;
-				const char *next_slash = strchr(child_start, '/');
-				uint16_t child_len = next_slash ?
-				    (uint16_t)(next_slash - child_start) : strlen(child_start);
-
-				/* Deduplicate: check if we already emitted this child name */
-				/* (Simple check - scan what we've written so far is complex,
-				 *  but for small mount counts this is fine) */
-
-				struct ninep_qid child_qid = {
-					.type = NINEP_QTDIR,
-					.version = 0,
-					.path = (uint64_t)(uintptr_t)&fs->mounts[i]
-				};
-
-				size_t write_offset = 0;
-				int write_ret = ninep_write_stat(buf + buf_offset,
-				                                  count - buf_offset,
-				                                  &write_offset, &child_qid,
-				                                  0755 | NINEP_DMDIR, 0,
-				                                  child_start, child_len,
-				                                  NULL, NULL, NULL);
-				if (write_ret < 0) {
-					break;
-				}
-				buf_offset += write_offset;
-			}
-		}
-
-		return buf_offset;
+		return encode_children(((struct union_synth *)node)->dir, offset,
+		                       buf, count);
 	}
 
 	/* Find which backend owns this node and delegate */
@@ -789,6 +713,78 @@ static int union_read_deferred(struct ninep_fs_node *node, uint64_t offset,
 	return mount->fs_ops->read(node, offset, buf, count, uname, mount->fs_ctx);
 }
 
+static int union_read_ref(struct ninep_fs_node *node, uint64_t offset,
+                          uint32_t count, const char *uname,
+                          struct ninep_read_ref *ref, void *fs_ctx)
+{
+	struct ninep_union_fs *fs = (struct ninep_union_fs *)fs_ctx;
+
+	/* Merged and synthetic listings are built per read */
+	if (node == fs->root || IS_SYNTHETIC_DIR(fs, node)) {
+		return -ENOTSUP;
+	}
+
+	struct ninep_union_mount *mount = find_node_owner(fs, node);
+
+	if (!mount || !mount->fs_ops->read_ref) {
+		return -ENOTSUP;
+	}
+	return mount->fs_ops->read_ref(node, offset, count, uname, ref,
+	                               mount->fs_ctx);
+}
+
+static int union_readdir(struct ninep_fs_node *node, uint64_t offset,
+                         uint8_t *buf, uint32_t count,
+                         struct ninep_dir_cursor *cur, const char *uname,
+                         void *fs_ctx)
+{
+	struct ninep_union_fs *fs = (struct ninep_union_fs *)fs_ctx;
+
+	/* Merged and synthetic listings are rebuilt on every read */
+	if (node == fs->root || IS_SYNTHETIC_DIR(fs, node)) {
+		return union_read(node, offset, buf, count, uname, fs_ctx);
+	}
+
+	struct ninep_union_mount *mount = find_node_owner(fs, node);
+
+	if (mount && mount->fs_ops->readdir) {
+		return mount->fs_ops->readdir(node, offset, buf, count, cur,
+		                              uname, mount->fs_ctx);
+	}
+	return union_read(node, offset, buf, count, uname, fs_ctx);
+}
+
+static void union_releasedir(struct ninep_fs_node *node,
+                             struct ninep_dir_cursor *cur, void *fs_ctx)
+{
+	struct ninep_union_fs *fs = (struct ninep_union_fs *)fs_ctx;
+	struct ninep_union_mount *mount = find_node_owner(fs, node);
+
+	if (mount && mount->fs_ops->releasedir) {
+		mount->fs_ops->releasedir(node, cur, mount->fs_ctx);
+	}
+}
+
+static int union_read_cursor(struct ninep_fs_node *node, uint64_t offset,
+                             uint8_t *buf, uint32_t count,
+                             struct ninep_dir_cursor *cur, const char *uname,
+                             void *fs_ctx)
+{
+	struct ninep_union_fs *fs = (struct ninep_union_fs *)fs_ctx;
+
+	if (node == fs->root || IS_SYNTHETIC_DIR(fs, node)) {
+		return -ENOTSUP;
+	}
+
+	struct ninep_union_mount *mount = find_node_owner(fs, node);
+
+	if (!mount || !mount->fs_ops->read_cursor) {
+		return -ENOTSUP;
+	}
+	return mount->fs_ops->read_cursor(node, offset, buf, count, cur, uname,
+	                                  mount->fs_ctx);
+}
+
 static int union_stat(struct ninep_fs_node *node, uint8_t *buf,
                        size_t buf_len, void *fs_ctx)
 {
@@ -797,13 +793,7 @@ static int union_stat(struct ninep_fs_node *node, uint8_t *buf,
 	/* If stat on union root */
 	if (node == fs->root) {
 		/* Check if there's a backend mounted at "/" */
-		struct ninep_union_mount *root_mount = NULL;
-		for (size_t i = 0; i < fs->num_mounts; i++) {
-			if (strcmp(fs->mounts[i].path, "/") == 0) {
-				root_mount = &fs->mounts[i];
-				break;
-			}
-		}
+		struct ninep_union_mount *root_mount = fs->mount_tree.mount;
 
 		/* If there's a root mount, delegate directly to it */
 		if (root_mount && root_mount->fs_ops->stat) {
@@ -878,13 +868,7 @@ static int union_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
 	/* If opening the union root directory */
 	if (node == fs->root) {
 		/* Check if there's a backend mounted at "/" */
-		struct ninep_union_mount *root_mount = NULL;
-		for (size_t i = 0; i < fs->num_mounts; i++) {
-			if (strcmp(fs->mounts[i].path, "/") == 0) {
-				root_mount = &fs->mounts[i];
-				break;
-			}
-		}
+		struct ninep_union_mount *root_mount = fs->mount_tree.mount;
 
 		/* If there's a root mount, delegate directly to it */
 		if (root_mount && root_mount->fs_ops->open) {
@@ -1004,7 +988,18 @@ static int union_remove(struct ninep_fs_node *node, void *fs_ctx)
 		return -ENOTSUP;
 	}
 
-	return mount->fs_ops->remove(node, mount->fs_ctx);
+	/* A successful remove drops the fid without a clunk, so its
+	 * reference goes here, before the backend may free the node */
+	decref_node(fs, node);
+
+	int ret = mount->fs_ops->remove(node, mount->fs_ctx);
+
+	if (ret < 0) {
+		incref_node(fs, node);
+		return ret;
+	}
+	unregister_node_owner(fs, node);
+	return ret;
 }
 
 static int union_clunk(struct ninep_fs_node *node, void *fs_ctx)
@@ -1020,8 +1015,7 @@ static int union_clunk(struct ninep_fs_node *node, void *fs_ctx)
 	/* Check if this is a synthetic directory node */
 	if (IS_SYNTHETIC_DIR(fs, node)) {
 		LOG_DBG("Clunking synthetic dir node: %s", (const char *)node->data);
-		k_free(node->data);
-		k_free(node);
+		ninep_node_free(node);
 		return 0;
 	}
 
@@ -1080,19 +1074,7 @@ static int union_clunk(struct ninep_fs_node *node, void *fs_ctx)
 		 * 2. Refcount is now 0 (no more fids reference it)
 		 * If backend returns positive (e.g., 1), it means "I kept the node" */
 		if (ret == 0) {
-			bool should_unregister = false;
-			for (size_t i = 0; i < fs->num_node_owners; i++) {
-				if (fs->node_owners[i].node == node) {
-					if (fs->node_owners[i].refcount == 0) {
-						should_unregister = true;
-					}
-					break;
-				}
-			}
-
-			if (should_unregister) {
-				unregister_node_owner(fs, node);
-			}
+			unregister_node_owner(fs, node);
 		}
 
 		return ret;
@@ -1179,6 +1161,28 @@ static int union_get_path(struct ninep_fs_node *node, char *buf,
 	return n;
 }
 
+/* A cloned fid shares node: count it, and let the owning backend know */
+static void union_ref(struct ninep_fs_node *node, void *fs_ctx)
+{
+	struct ninep_union_fs *fs = (struct ninep_union_fs *)fs_ctx;
+
+	if (IS_SYNTHETIC_DIR(fs, node)) {
+		return;
+	}
+
+	incref_node(fs, node);
+	if (node == fs->root) {
+		return;
+	}
+
+	struct ninep_union_mount *mount = find_node_owner(fs, node);
+
+	if (!mount || node == mount->root || !mount->fs_ops->ref) {
+		return;
+	}
+	mount->fs_ops->ref(node, mount->fs_ctx);
+}
+
 /* Union filesystem operations table */
 static const struct ninep_fs_ops union_fs_ops = {
 	.get_root = union_get_root,
@@ -1186,11 +1190,16 @@ static const struct ninep_fs_ops union_fs_ops = {
 	.open = union_open,
 	.read = union_read,
 	.read_deferred = union_read_deferred,
+	.read_ref = union_read_ref,
+	.readdir = union_readdir,
+	.releasedir = union_releasedir,
+	.read_cursor = union_read_cursor,
 	.write = union_write,
 	.stat = union_stat,
 	.create = union_create,
 	.remove = union_remove,
 	.clunk = union_clunk,
+	.ref = union_ref,
 	.get_path = union_get_path,
 };
 
@@ -1210,14 +1219,17 @@ int ninep_union_fs_init(struct ninep_union_fs *fs,
 	fs->num_mounts = 0;
 	fs->next_qid_path = 1;
 	k_mutex_init(&fs->track_lock);
+	for (size_t i = NINEP_UNION_NODE_OWNERS; i-- > 0;) {
+		fs->node_owners[i].hash_next = fs->owner_free;
+		fs->owner_free = &fs->node_owners[i];
+	}
 
 	/* Create synthetic root node */
-	fs->root = k_malloc(sizeof(struct ninep_fs_node));
+	fs->root = ninep_node_alloc(sizeof(struct ninep_fs_node), "", 0);
 	if (!fs->root) {
 		return -ENOMEM;
 	}
 
-	memset(fs->root, 0, sizeof(*fs->root));
 	fs->root->qid.type = NINEP_QTDIR;
 	fs->root->qid.version = 0;
 	fs->root->qid.path = fs->next_qid_path++;
@@ -1240,12 +1252,22 @@ int ninep_union_fs_mount(struct ninep_union_fs *fs,
 		return -ENOSPC;
 	}
 
-	/* Check for duplicate mount point */
-	for (size_t i = 0; i < fs->num_mounts; i++) {
-		if (strcmp(fs->mounts[i].path, path) == 0) {
-			LOG_ERR("Mount point already exists: %s", path);
-			return -EEXIST;
-		}
+	/* Get root node from backend */
+	if (!fs_ops->get_root) {
+		LOG_ERR("Backend does not provide get_root operation");
+		return -ENOTSUP;
+	}
+
+	/* Room for the root listing with this mount's first component added,
+	 * taken first so nothing can fail once the tree has changed */
+	const char *p = path;
+	const char *first;
+	size_t listing_size = fs->root_listing_len +
+	                      MOUNT_STAT_LEN(next_component(&p, &first));
+	uint8_t *listing = k_malloc(listing_size);
+
+	if (!listing) {
+		return -ENOMEM;
 	}
 
 	/* Add new mount */
@@ -1256,18 +1278,27 @@ int ninep_union_fs_mount(struct ninep_union_fs *fs,
 
 	LOG_INF("Mounting: path='%s' fs_ops=%p fs_ctx=%p", path, (void*)fs_ops, fs_ctx);
 
-	/* Get root node from backend */
-	if (!fs_ops->get_root) {
-		LOG_ERR("Backend does not provide get_root operation");
-		return -ENOTSUP;
-	}
-
 	mount->root = fs_ops->get_root(fs_ctx);
 	if (!mount->root) {
 		LOG_ERR("Backend get_root returned NULL");
+		k_free(listing);
 		return -EINVAL;
 	}
 
+	int ret = tree_add(fs, mount);
+
+	if (ret < 0) {
+		if (ret == -EEXIST) {
+			LOG_ERR("Mount point already exists: %s", path);
+		}
+		k_free(listing);
+		return ret;
+	}
+
+	fs->root_listing_len = encode_children(&fs->mount_tree, 0, listing,
+	                                       listing_size);
+	k_free(fs->root_listing);
+	fs->root_listing = listing;
 	fs->num_mounts++;
 
 	LOG_INF("Mounted backend at '%s' (%zu/%zu mounts)",
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Asynchronous Client Request Tests
+ *
+ * - Many reads outstanding from one thread, each completed by callback
+ * - Completion raised through a k_poll_signal
+ * - An Rerror completes the request and frees its new fid
+ * - Cancel completes an unanswered request with -ECANCELED
+ * - The blocking calls still work alongside async requests
+ * - Benchmark: BENCH_READS sequential blocking reads against the same
+ *   reads pipelined, over a link with LINK_LATENCY_MS of delay
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_CLIENT) && defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/client.h>
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <string.h>
+#include "latency_loopback.h"
+
+#define LINK_LATENCY_MS  5
+#define NUM_READS        8
+#define BENCH_READS      32
+#define READ_SIZE        64
+#define WAIT_TIMEOUT     K_MSEC(5000)
+
+static struct latency_session session;
+static struct ninep_client *const client = &session.client;
+static struct latency_loopback *const link = &session.link;
+static struct ninep_ramfs ramfs;
+static uint8_t content[READ_SIZE * BENCH_READS];
+static uint8_t bufs[BENCH_READS][READ_SIZE];
+static struct ninep_client_req reqs[BENCH_READS];
+static uint32_t root_fid;
+static uint32_t file_fid;
+
+static K_SEM_DEFINE(completions, 0, BENCH_READS);
+static atomic_t done_calls;
+
+static void count_done(struct ninep_client *c, struct ninep_client_req *req)
+{
+	ARG_UNUSED(c);
+	ARG_UNUSED(req);
+
+	atomic_inc(&done_calls);
+	k_sem_give(&completions);
+}
+
+static void wait_completions(int n)
+{
+	for (int i = 0; i < n; i++) {
+		zassert_equal(k_sem_take(&completions, WAIT_TIMEOUT), 0,
+		              "request %d never completed", i);
+	}
+}
+
+/* Issue n reads of READ_SIZE at consecutive offsets, all outstanding */
+static void submit_reads(int n)
+{
+	for (int i = 0; i < n; i++) {
+		ninep_client_req_init(&reqs[i], count_done, NULL);
+		zassert_true(ninep_client_read_async(client, file_fid,
+		                                     i * READ_SIZE, bufs[i],
+		                                     READ_SIZE, &reqs[i]) >= 0);
+	}
+}
+
+/* Test: reads issued back to back complete in any order, each once */
+ZTEST(client_async, test_pipelined_reads)
+{
+	atomic_set(&done_calls, 0);
+	submit_reads(NUM_READS);
+	zassert_true(link->max_in_flight > 1, "reads were not pipelined");
+	wait_completions(NUM_READS);
+	zassert_equal(atomic_get(&done_calls), NUM_READS);
+
+	for (int i = 0; i < NUM_READS; i++) {
+		zassert_true(reqs[i].complete);
+		zassert_equal(reqs[i].result, READ_SIZE);
+		zassert_mem_equal(bufs[i], content + i * READ_SIZE, READ_SIZE);
+		zassert_is_null(reqs[i].entry, "tag %d not released", i);
+	}
+}
+
+#ifdef CONFIG_POLL
+/* Test: a k_poll_signal is raised with the result */
+ZTEST(client_async, test_poll_signal)
+{
+	struct k_poll_signal signal;
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	unsigned int signaled;
+	int result;
+
+	k_poll_signal_init(&signal);
+	ninep_client_req_init(&reqs[0], NULL, NULL);
+	reqs[0].signal = &signal;
+	zassert_true(ninep_client_read_async(client, file_fid, 0, bufs[0], 16,
+	                                     &reqs[0]) >= 0);
+	zassert_equal(k_poll(&event, 1, WAIT_TIMEOUT), 0);
+	k_poll_signal_check(&signal, &signaled, &result);
+	zassert_true(signaled);
+	zassert_equal(result, 16);
+	zassert_true(reqs[0].complete);
+}
+#endif /* CONFIG_POLL */
+
+/* Test: an Rerror completes the request and the new fid is freed */
+ZTEST(client_async, test_error_reply)
+{
+	ninep_client_req_init(&reqs[0], count_done, NULL);
+	zassert_true(ninep_client_walk_async(client, root_fid, "missing",
+	                                     &reqs[0]) >= 0);
+	wait_completions(1);
+	zassert_equal(reqs[0].result, -ENOENT);
+
+	bool in_use = false;
+
+	for (size_t i = 0; i < client->max_fids; i++) {
+		if (client->fids[i].fid == reqs[0].fid && client->fids[i].in_use) {
+			in_use = true;
+		}
+	}
+	zassert_false(in_use, "failed walk kept its fid");
+}
+
+/* Test: cancelling an unanswered request completes it with -ECANCELED */
+ZTEST(client_async, test_cancel)
+{
+	atomic_set(&done_calls, 0);
+
+	/* With the link down neither the read nor the flush is answered */
+	latency_loopback_stop(link);
+	ninep_client_req_init(&reqs[0], count_done, NULL);
+	zassert_true(ninep_client_read_async(client, file_fid, 0, bufs[0],
+	                                     READ_SIZE, &reqs[0]) >= 0);
+	zassert_false(reqs[0].complete);
+
+	zassert_equal(ninep_client_cancel(client, &reqs[0]), 0);
+	zassert_true(reqs[0].complete);
+	zassert_equal(reqs[0].result, -ECANCELED);
+	zassert_equal(atomic_get(&done_calls), 1);
+	zassert_equal(ninep_client_cancel(client, &reqs[0]), -EALREADY);
+	zassert_equal(atomic_get(&done_calls), 1);
+	k_sem_reset(&completions);
+}
+
+/* Test: blocking calls run over the same path as async ones */
+ZTEST(client_async, test_blocking_alongside)
+{
+	uint8_t buf[READ_SIZE];
+
+	ninep_client_req_init(&reqs[0], count_done, NULL);
+	zassert_true(ninep_client_read_async(client, file_fid, READ_SIZE,
+	                                     bufs[0], READ_SIZE, &reqs[0]) >= 0);
+	zassert_equal(ninep_client_read(client, file_fid, 0, buf, sizeof(buf)),
+	              sizeof(buf));
+	zassert_mem_equal(buf, content, sizeof(buf));
+	wait_completions(1);
+	zassert_equal(reqs[0].result, READ_SIZE);
+	zassert_mem_equal(bufs[0], content + READ_SIZE, READ_SIZE);
+}
+
+/* Benchmark: pipelining hides the link latency */
+ZTEST(client_async, test_pipelined_read_cost)
+{
+	int64_t start = k_uptime_get();
+
+	link->max_in_flight = 0;
+	for (int i = 0; i < BENCH_READS; i++) {
+		zassert_equal(ninep_client_read(client, file_fid, i * READ_SIZE,
+		                                bufs[i], READ_SIZE), READ_SIZE);
+	}
+
+	int64_t sequential = k_uptime_get() - start;
+	int n = MIN(BENCH_READS, (int)client->max_tags);
+
+	zassert_equal(link->max_in_flight, 1);
+
+	link->max_in_flight = 0;
+	start = k_uptime_get();
+	submit_reads(n);
+	wait_completions(n);
+
+	int64_t pipelined = k_uptime_get() - start;
+
+	for (int i = 0; i < n; i++) {
+		zassert_equal(reqs[i].result, READ_SIZE);
+	}
+
+	TC_PRINT("%d ms link: %d blocking reads %lld ms, %d pipelined reads "
+	         "%lld ms\n", LINK_LATENCY_MS, BENCH_READS, sequential, n,
+	         pipelined);
+
+	/* Every pipelined read shares one round trip of the link */
+	zassert_equal(link->max_in_flight, n, "reads were not pipelined");
+}
+
+/* Per-test setup: a fresh link, server and client, with the file open */
+static void client_async_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_reset(&completions);
+	latency_session_start(&session, LINK_LATENCY_MS,
+	                      CONFIG_NINEP_MAX_MESSAGE_SIZE,
+	                      ninep_ramfs_get_ops(), &ramfs);
+	root_fid = session.root_fid;
+	zassert_equal(ninep_client_walk(client, root_fid, &file_fid,
+	                                "f"), 0);
+	zassert_equal(ninep_client_open(client, file_fid, NINEP_OREAD), 0);
+	link->max_in_flight = 0;
+}
+
+static void client_async_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	latency_session_stop(&session);
+}
+
+static void *client_async_setup(void)
+{
+	for (size_t i = 0; i < sizeof(content); i++) {
+		content[i] = (uint8_t)(i * 7 + 1);
+	}
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root, "f",
+	                                         content, sizeof(content)));
+	return NULL;
+}
+
+ZTEST_SUITE(client_async, NULL, client_async_setup, client_async_before,
+            client_async_after, NULL);
+
+#endif /* CONFIG_NINEP_CLIENT && CONFIG_NINEP_SERVER */
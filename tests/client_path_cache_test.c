@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Client Path Cache Tests
+ *
+ * - A repeated walk is a zero-element clone: no server walk at all, and
+ *   differently spelled paths share an entry
+ * - Without in-order execution a miss sends its clone only after the walk
+ * - Remove, an Rerror on a clone and clunking the base fid drop entries;
+ *   a failed walk counts against the fid it walked from, and entries
+ *   below a dropped one or walked from a clone of it go with it
+ * - A full cache evicts its least recently used entry; a low fid pool
+ *   clunks cached fids before a walk fails
+ * - Turning the cache off clunks every cached fid
+ * - Benchmark: server walk steps and time per poll of a four-element
+ *   path, with and without the cache
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_CLIENT) && defined(CONFIG_NINEP_SERVER) && \
+	CONFIG_NINEP_CLIENT_PATH_CACHE > 0
+
+#include <zephyr/9p/client.h>
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <stdio.h>
+#include <string.h>
+#include "latency_loopback.h"
+
+#define NUM_FILES   (CONFIG_NINEP_CLIENT_PATH_CACHE + 2)
+#define BENCH_REPS  50
+
+static struct latency_session session;
+static struct ninep_client *const client = &session.client;
+static struct latency_loopback *const link = &session.link;
+static struct ninep_ramfs ramfs;
+static struct ninep_fs_ops shaped_ops;
+static uint32_t root_fid;
+static int server_walks;
+static bool fail_opens;
+
+static const char temp[] = "21.5\n";
+
+/* ramfs with walk steps counted and opens failing on request */
+static struct ninep_fs_node *shaped_walk(struct ninep_fs_node *dir,
+                                         const char *name, uint16_t len,
+                                         void *fs_ctx)
+{
+	server_walks++;
+	return ninep_ramfs_get_ops()->walk(dir, name, len, fs_ctx);
+}
+
+static int shaped_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
+{
+	if (fail_opens) {
+		return -EACCES;
+	}
+	return ninep_ramfs_get_ops()->open ?
+	       ninep_ramfs_get_ops()->open(node, mode, fs_ctx) : 0;
+}
+
+static int cached_entries(void)
+{
+	int n = 0;
+
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		n += client->path_cache[i].in_use &&
+		     !client->path_cache[i].stale;
+	}
+	return n;
+}
+
+/* Walk, open, read and clunk path, as a dashboard poll does */
+static void poll_path(const char *path)
+{
+	uint8_t buf[16];
+	uint32_t fid;
+
+	zassert_equal(ninep_client_walk(client, root_fid, &fid, path), 0);
+	zassert_equal(ninep_client_open(client, fid, NINEP_OREAD), 0);
+	zassert_equal(ninep_client_read(client, fid, 0, buf, sizeof(buf)),
+	              sizeof(temp) - 1);
+	zassert_mem_equal(buf, temp, sizeof(temp) - 1);
+	zassert_equal(ninep_client_clunk(client, fid), 0);
+}
+
+/* Test: the second walk of a path is a clone, however it is spelled */
+ZTEST(client_path_cache, test_hit_is_clone)
+{
+	int fids = latency_session_fids(&session);
+
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(client->path_cache_misses, 1);
+	zassert_equal(server_walks, 4);
+	zassert_equal(latency_session_fids(&session), fids + 1,
+	              "walked fid not kept");
+
+	poll_path("/sys//bus/./sensor/temp/");
+	zassert_equal(client->path_cache_hits, 1);
+	zassert_equal(server_walks, 4, "a hit walked on the server");
+	zassert_equal(latency_session_fids(&session), fids + 1);
+
+	/* ".." is left to the server */
+	poll_path("sys/bus/../bus/sensor/temp");
+	zassert_equal(client->path_cache_hits, 1);
+	zassert_equal(client->path_cache_misses, 1);
+}
+
+/* Test: without in-order execution a miss clones only after its walk */
+ZTEST(client_path_cache, test_miss_unordered)
+{
+	uint32_t fid;
+	int fids = latency_session_fids(&session);
+
+	/* A delay long enough for a burst to be seen in flight together */
+	session.link.latency_ms = 5;
+	session.client_config.in_order = false;
+	session.link.max_in_flight = 0;
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(client->path_cache_misses, 1);
+	zassert_equal(server_walks, 4);
+	zassert_equal(session.link.max_in_flight, 1, "clone sent before walk");
+	zassert_equal(latency_session_fids(&session), fids + 1);
+
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(client->path_cache_hits, 1);
+
+	/* A failed walk sends no clone and leaves nothing behind */
+	zassert_equal(ninep_client_walk(client, root_fid, &fid, "sys/nope"),
+	              -ENOENT);
+	zassert_equal(latency_session_fids(&session), fids + 1);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: remove, an Rerror and a clunked base each drop their entry */
+ZTEST(client_path_cache, test_invalidation)
+{
+	uint32_t fid, dir;
+	int fids = latency_session_fids(&session);
+
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root, "gone",
+	                                         NULL, 0));
+	zassert_equal(ninep_client_walk(client, root_fid, &fid, "gone"), 0);
+	zassert_equal(ninep_client_clunk(client, fid), 0);
+	zassert_equal(ninep_client_walk(client, root_fid, &fid, "gone"), 0);
+	zassert_equal(client->path_cache_hits, 1);
+	zassert_equal(ninep_client_remove(client, fid), 0);
+	zassert_equal(ninep_client_walk(client, root_fid, &fid, "gone"),
+	              -ENOENT);
+	zassert_equal(cached_entries(), 0);
+	zassert_equal(latency_session_fids(&session), fids,
+	              "cached fid of a removed file kept");
+
+	/* An Rerror on a clone drops the entry it came from */
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(ninep_client_walk(client, root_fid, &fid,
+	                                "sys/bus/sensor/temp"), 0);
+	fail_opens = true;
+	zassert_equal(ninep_client_open(client, fid, NINEP_OREAD), -EACCES);
+	fail_opens = false;
+	zassert_equal(ninep_client_clunk(client, fid), 0);
+	zassert_equal(cached_entries(), 0);
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(client->path_cache_misses, 4);
+
+	/* Entries walked from a fid go when it is clunked */
+	zassert_equal(ninep_client_walk(client, root_fid, &dir, "sys/bus"), 0);
+	zassert_equal(ninep_client_walk(client, dir, &fid, "sensor/temp"), 0);
+	zassert_equal(cached_entries(), 3);
+	zassert_equal(ninep_client_clunk(client, fid), 0);
+	zassert_equal(ninep_client_clunk(client, dir), 0);
+	zassert_equal(cached_entries(), 2);
+}
+
+/* Test: a failed walk from a clone drops the entry the clone came from */
+ZTEST(client_path_cache, test_walk_error_on_clone)
+{
+	uint32_t dir, fid;
+
+	zassert_equal(ninep_client_walk(client, root_fid, &dir, "sys/bus"), 0);
+	zassert_equal(ninep_client_clunk(client, dir), 0);
+	zassert_equal(ninep_client_walk(client, root_fid, &dir, "sys/bus"), 0);
+	zassert_equal(client->path_cache_hits, 1);
+	zassert_equal(cached_entries(), 1);
+
+	zassert_equal(ninep_client_walk(client, dir, &fid, "missing"), -ENOENT);
+	zassert_equal(cached_entries(), 0, "entry of the walked clone kept");
+	zassert_equal(ninep_client_clunk(client, dir), 0);
+}
+
+/* Test: dropping an entry drops the entries that depend on it */
+ZTEST(client_path_cache, test_dependent_entries)
+{
+	uint32_t dir, fid;
+
+	/* Longer paths from the same base */
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(ninep_client_walk(client, root_fid, &dir, "sys/bus"), 0);
+	zassert_equal(ninep_client_clunk(client, dir), 0);
+	zassert_equal(cached_entries(), 2);
+	zassert_equal(ninep_client_walk(client, root_fid, &dir, "sys/bus"), 0);
+	fail_opens = true;
+	zassert_equal(ninep_client_open(client, dir, NINEP_OREAD), -EACCES);
+	fail_opens = false;
+	zassert_equal(ninep_client_clunk(client, dir), 0);
+	zassert_equal(cached_entries(), 0, "path below a dropped entry kept");
+
+	/* Paths walked from a clone of it */
+	zassert_equal(ninep_client_walk(client, root_fid, &dir, "sys"), 0);
+	zassert_equal(ninep_client_walk(client, dir, &fid, "bus/sensor"), 0);
+	zassert_equal(ninep_client_clunk(client, fid), 0);
+	zassert_equal(cached_entries(), 2);
+	fail_opens = true;
+	zassert_equal(ninep_client_open(client, dir, NINEP_OREAD), -EACCES);
+	fail_opens = false;
+	zassert_equal(cached_entries(), 0, "path walked from a bad clone kept");
+	zassert_equal(ninep_client_clunk(client, dir), 0);
+}
+
+/* Test: a full cache evicts the least recently used entry */
+ZTEST(client_path_cache, test_lru_eviction)
+{
+	char path[8];
+
+	for (int i = 0; i < CONFIG_NINEP_CLIENT_PATH_CACHE; i++) {
+		snprintf(path, sizeof(path), "f%02d", i);
+		poll_path(path);
+	}
+	zassert_equal(cached_entries(), CONFIG_NINEP_CLIENT_PATH_CACHE);
+
+	/* Touch f00, so f01 is now the oldest */
+	poll_path("f00");
+	snprintf(path, sizeof(path), "f%02d", CONFIG_NINEP_CLIENT_PATH_CACHE);
+	poll_path(path);
+	zassert_equal(client->path_cache_evictions, 1);
+	zassert_equal(cached_entries(), CONFIG_NINEP_CLIENT_PATH_CACHE);
+
+	uint32_t hits = client->path_cache_hits;
+
+	poll_path("f00");
+	zassert_equal(client->path_cache_hits, hits + 1,
+	              "recent entry evicted");
+	poll_path("f01");
+	zassert_equal(client->path_cache_hits, hits + 1, "oldest entry kept");
+}
+
+/* Test: a low fid pool is refilled from the cache, not failed */
+ZTEST(client_path_cache, test_low_fid_pool)
+{
+	static uint32_t held[CONFIG_NINEP_MAX_FIDS];
+	char path[8];
+	int n = client->max_fids - latency_session_fids(&session);
+	int walked = 0;
+
+	/* Fill the cache, then take every fid the caller could have had */
+	for (int i = 0; i < NUM_FILES; i++) {
+		snprintf(path, sizeof(path), "f%02d", i);
+		poll_path(path);
+	}
+	zassert_true(cached_entries() > 0);
+	while (walked < n) {
+		snprintf(path, sizeof(path), "f%02d", walked % NUM_FILES);
+		if (ninep_client_walk(client, root_fid, &held[walked], path) < 0) {
+			break;
+		}
+		walked++;
+	}
+	zassert_equal(walked, n, "cache kept fids the caller needed");
+	zassert_equal(cached_entries(), 0);
+	zassert_equal(ninep_client_walk(client, root_fid, &held[0], "f00"),
+	              -ENOMEM);
+
+	for (int i = 0; i < walked; i++) {
+		zassert_equal(ninep_client_clunk(client, held[i]), 0);
+	}
+}
+
+/* Test: turning the cache off clunks everything it held */
+ZTEST(client_path_cache, test_disable)
+{
+	int fids = latency_session_fids(&session);
+
+	poll_path("sys/bus/sensor/temp");
+	poll_path("f00");
+	zassert_equal(latency_session_fids(&session), fids + 2);
+	zassert_equal(ninep_client_path_cache_enable(client, false), 0);
+	zassert_equal(latency_session_fids(&session), fids);
+
+	int walks = server_walks;
+
+	poll_path("sys/bus/sensor/temp");
+	zassert_equal(server_walks - walks, 4);
+	zassert_equal(latency_session_fids(&session), fids);
+}
+
+/* Benchmark: a poll of a deep path with and without the cache */
+ZTEST(client_path_cache, test_poll_cost)
+{
+	int walks[2];
+	int64_t ms[2];
+
+	for (int round = 0; round < 2; round++) {
+		zassert_equal(ninep_client_path_cache_enable(client, round == 1), 0);
+		poll_path("sys/bus/sensor/temp");
+
+		int before = server_walks;
+		int64_t start = k_uptime_get();
+
+		for (int i = 0; i < BENCH_REPS; i++) {
+			poll_path("sys/bus/sensor/temp");
+		}
+		ms[round] = k_uptime_get() - start;
+		walks[round] = (server_walks - before) / BENCH_REPS;
+	}
+
+	TC_PRINT("poll of a 4-element path: uncached %d server walk steps, "
+	         "%lld ms/%d; cached %d steps, %lld ms/%d\n", walks[0], ms[0],
+	         BENCH_REPS, walks[1], ms[1], BENCH_REPS);
+	zassert_equal(walks[0], 4);
+	zassert_equal(walks[1], 0);
+}
+
+static void client_path_cache_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	server_walks = 0;
+	fail_opens = false;
+	latency_session_start(&session, 0, CONFIG_NINEP_MAX_MESSAGE_SIZE,
+	                      &shaped_ops, &ramfs);
+	root_fid = session.root_fid;
+	zassert_equal(ninep_client_path_cache_enable(client, true), 0);
+}
+
+static void client_path_cache_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	latency_session_stop(&session);
+}
+
+static void *client_path_cache_setup(void)
+{
+	struct ninep_fs_node *dir;
+	char name[8];
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	dir = ninep_ramfs_create_dir(&ramfs, ramfs.root, "sys");
+	dir = ninep_ramfs_create_dir(&ramfs, dir, "bus");
+	dir = ninep_ramfs_create_dir(&ramfs, dir, "sensor");
+	zassert_not_null(dir);
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, dir, "temp", temp,
+	                                                sizeof(temp) - 1));
+	for (int i = 0; i < NUM_FILES; i++) {
+		snprintf(name, sizeof(name), "f%02d", i);
+		zassert_not_null(ninep_ramfs_create_static_file(&ramfs, ramfs.root,
+		                                                name, temp,
+		                                                sizeof(temp) - 1));
+	}
+
+	shaped_ops = *ninep_ramfs_get_ops();
+	shaped_ops.walk = shaped_walk;
+	shaped_ops.open = shaped_open;
+	return NULL;
+}
+
+ZTEST_SUITE(client_path_cache, NULL, client_path_cache_setup,
+            client_path_cache_before, client_path_cache_after, NULL);
+
+#endif /* CONFIG_NINEP_CLIENT && CONFIG_NINEP_SERVER && path cache */
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Path Operation Tests
+ *
+ * - read_path and write_path send their four requests in one burst to a
+ *   server that runs them in order, and one at a time to any other
+ * - A failed walk, open or read returns that link's error, and every fid
+ *   the walk established is clunked on both sides
+ * - Benchmark: read_path against walk/open/read/clunk calls over a
+ *   LINK_LATENCY_MS link
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_CLIENT) && defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/client.h>
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <string.h>
+#include "latency_loopback.h"
+
+#define LINK_LATENCY_MS  5
+#define BENCH_REPS       10
+
+static struct latency_session session;
+static struct ninep_client *const client = &session.client;
+static struct latency_loopback *const link = &session.link;
+static struct ninep_ramfs ramfs;
+static struct ninep_fs_ops shaped_ops;
+static uint32_t root_fid;
+static int server_clunks;
+static uint8_t ctl[64];
+static uint32_t ctl_len;
+
+static const char temp[] = "21.5\n";
+
+/* ramfs, except that "bad_open" cannot be opened, "bad_read" cannot be
+ * read, writes land in ctl[] and clunks of files are counted (a walk also
+ * lets go of the directories it passes through) */
+static int shaped_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
+{
+	if (strcmp(node->name, "bad_open") == 0) {
+		return -EACCES;
+	}
+	return ninep_ramfs_get_ops()->open ?
+	       ninep_ramfs_get_ops()->open(node, mode, fs_ctx) : 0;
+}
+
+static int shaped_read(struct ninep_fs_node *node, uint64_t offset,
+                       uint8_t *buf, uint32_t count, const char *uname,
+                       void *fs_ctx)
+{
+	if (strcmp(node->name, "bad_read") == 0) {
+		return -EIO;
+	}
+	return ninep_ramfs_get_ops()->read(node, offset, buf, count, uname,
+	                                   fs_ctx);
+}
+
+static int shaped_write(struct ninep_fs_node *node, uint64_t offset,
+                        const uint8_t *buf, uint32_t count, const char *uname,
+                        void *fs_ctx)
+{
+	count = MIN(count, sizeof(ctl));
+	memcpy(ctl, buf, count);
+	ctl_len = count;
+	return count;
+}
+
+static int shaped_clunk(struct ninep_fs_node *node, void *fs_ctx)
+{
+	if (!(node->qid.type & NINEP_QTDIR)) {
+		server_clunks++;
+	}
+	return ninep_ramfs_get_ops()->clunk ?
+	       ninep_ramfs_get_ops()->clunk(node, fs_ctx) : 0;
+}
+
+/* Test: a read by path is one burst of four requests */
+ZTEST(client_path, test_read_path)
+{
+	uint8_t buf[32];
+	uint32_t before = link->requests;
+	int fids = latency_session_fids(&session);
+
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/temp", buf,
+	                                     sizeof(buf)), sizeof(temp) - 1);
+	zassert_mem_equal(buf, temp, sizeof(temp) - 1);
+	zassert_equal(link->requests - before, 4);
+	zassert_equal(link->max_in_flight, 4,
+	              "chain was not sent in one burst");
+	zassert_equal(server_clunks, 1);
+	zassert_equal(latency_session_fids(&session), fids);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: each failing link is reported, and the fid is always clunked */
+ZTEST(client_path, test_mid_chain_errors)
+{
+	uint8_t buf[32];
+	int fids = latency_session_fids(&session);
+
+	/* The walk fails: no fid exists, on either side */
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/missing", buf,
+	                                     sizeof(buf)), -ENOENT);
+	zassert_equal(server_clunks, 0);
+	zassert_equal(latency_session_fids(&session), fids);
+
+	/* The open or read fails: the walked fid is clunked */
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/bad_open",
+	                                     buf, sizeof(buf)), -EACCES);
+	zassert_equal(server_clunks, 1);
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/bad_read",
+	                                     buf, sizeof(buf)), -EIO);
+	zassert_equal(server_clunks, 2);
+	zassert_equal(latency_session_fids(&session), fids);
+	zassert_equal(latency_session_tags(&session), 0);
+
+	/* The client still works afterwards */
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/temp", buf,
+	                                     sizeof(buf)), sizeof(temp) - 1);
+}
+
+/* Test: without in-order execution each link waits for the one before */
+ZTEST(client_path, test_read_path_unordered)
+{
+	uint8_t buf[32];
+	uint32_t before = link->requests;
+	int fids = latency_session_fids(&session);
+
+	session.client_config.in_order = false;
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/temp", buf,
+	                                     sizeof(buf)), sizeof(temp) - 1);
+	zassert_mem_equal(buf, temp, sizeof(temp) - 1);
+	zassert_equal(link->requests - before, 4);
+	zassert_equal(link->max_in_flight, 1, "a link went out early");
+
+	/* A failed open stops the chain: no Tread, but the fid is clunked */
+	before = link->requests;
+	zassert_equal(ninep_client_read_path(client, root_fid, "s/bad_open",
+	                                     buf, sizeof(buf)), -EACCES);
+	zassert_equal(link->requests - before, 3);
+	zassert_equal(server_clunks, 2);
+	zassert_equal(latency_session_fids(&session), fids);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: a write by path reaches the file and clunks it */
+ZTEST(client_path, test_write_path)
+{
+	static const char cmd[] = "reset";
+	uint32_t before = link->requests;
+
+	zassert_equal(ninep_client_write_path(client, root_fid, "s/ctl",
+	                                      (const uint8_t *)cmd,
+	                                      sizeof(cmd) - 1), sizeof(cmd) - 1);
+	zassert_equal(ctl_len, sizeof(cmd) - 1);
+	zassert_mem_equal(ctl, cmd, ctl_len);
+	zassert_equal(link->requests - before, 4);
+	zassert_equal(server_clunks, 1);
+
+	/* A read-only open cannot be written */
+	zassert_true(ninep_client_write_path(client, root_fid, "s/bad_open",
+	                                     (const uint8_t *)cmd, 1) < 0);
+	zassert_equal(server_clunks, 2);
+}
+
+/* Benchmark: one burst against four round trips */
+ZTEST(client_path, test_read_path_cost)
+{
+	uint8_t buf[32];
+	uint32_t fid;
+	uint32_t before = link->requests;
+	int64_t start = k_uptime_get();
+
+	link->max_in_flight = 0;
+	for (int i = 0; i < BENCH_REPS; i++) {
+		zassert_equal(ninep_client_walk(client, root_fid, &fid, "s/temp"), 0);
+		zassert_equal(ninep_client_open(client, fid, NINEP_OREAD), 0);
+		zassert_equal(ninep_client_read(client, fid, 0, buf, sizeof(buf)),
+		              sizeof(temp) - 1);
+		zassert_equal(ninep_client_clunk(client, fid), 0);
+	}
+
+	int64_t calls = k_uptime_get() - start;
+
+	zassert_equal(link->requests - before, 4 * BENCH_REPS);
+	zassert_equal(link->max_in_flight, 1);
+
+	before = link->requests;
+	link->max_in_flight = 0;
+	start = k_uptime_get();
+	for (int i = 0; i < BENCH_REPS; i++) {
+		zassert_equal(ninep_client_read_path(client, root_fid, "s/temp",
+		                                     buf, sizeof(buf)),
+		              sizeof(temp) - 1);
+	}
+
+	int64_t burst = k_uptime_get() - start;
+
+	TC_PRINT("%d ms link: walk+open+read+clunk %lld ms/op, read_path "
+	         "%lld ms/op\n", LINK_LATENCY_MS, calls / BENCH_REPS,
+	         burst / BENCH_REPS);
+
+	/* The same requests, but one round trip each time instead of four */
+	zassert_equal(link->requests - before, 4 * BENCH_REPS);
+	zassert_equal(link->max_in_flight, 4, "read_path was not one burst");
+}
+
+static void client_path_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	server_clunks = 0;
+	ctl_len = 0;
+	latency_session_start(&session, LINK_LATENCY_MS,
+	                      CONFIG_NINEP_MAX_MESSAGE_SIZE, &shaped_ops,
+	                      &ramfs);
+	root_fid = session.root_fid;
+}
+
+static void client_path_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	latency_session_stop(&session);
+}
+
+static void *client_path_setup(void)
+{
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+
+	struct ninep_fs_node *s = ninep_ramfs_create_dir(&ramfs, ramfs.root, "s");
+
+	zassert_not_null(s);
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, s, "temp", temp,
+	                                                sizeof(temp) - 1));
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, s, "bad_open",
+	                                                temp, 1));
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, s, "bad_read",
+	                                                temp, 1));
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, s, "ctl", NULL, 0));
+
+	shaped_ops = *ninep_ramfs_get_ops();
+	shaped_ops.open = shaped_open;
+	shaped_ops.read = shaped_read;
+	shaped_ops.read_ref = NULL;
+	shaped_ops.write = shaped_write;
+	shaped_ops.clunk = shaped_clunk;
+	return NULL;
+}
+
+ZTEST_SUITE(client_path, NULL, client_path_setup, client_path_before,
+            client_path_after, NULL);
+
+#endif /* CONFIG_NINEP_CLIENT && CONFIG_NINEP_SERVER */
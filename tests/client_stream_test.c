@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Streaming Read Tests
+ *
+ * - Windowed reads reassemble in order, from aligned and unaligned offsets
+ * - A short read ends the stream; nothing past end of file is delivered
+ * - The sink sees chunks in offset order, and its error stops the read
+ * - A duplicate reply to a read the sink holds is dropped
+ * - One Tread per iounit, and every tag is free afterwards
+ * - Benchmark: STREAM_SIZE bytes over a LINK_LATENCY_MS link with window
+ *   1, 2, 4 and 8; each window is kept full
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_CLIENT) && defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/client.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <string.h>
+#include "latency_loopback.h"
+
+#define LINK_LATENCY_MS  5
+#define MSIZE            1024
+#define STREAM_SIZE      (64 * 1024)
+
+static struct latency_session session;
+static struct ninep_client *const client = &session.client;
+static struct latency_loopback *const link = &session.link;
+static struct ninep_ramfs ramfs;
+static uint8_t content[STREAM_SIZE];
+static uint8_t out[STREAM_SIZE];
+static uint32_t root_fid;
+static uint32_t file_fid;
+static uint32_t iounit;
+
+struct sink_log {
+	uint64_t next;   /* Offset the next chunk must start at */
+	int chunks;
+	int stop_after;  /* Fail on this chunk, or 0 */
+};
+
+static int log_sink(const uint8_t *data, uint32_t len, uint64_t offset,
+                    void *user_data)
+{
+	struct sink_log *log = user_data;
+
+	zassert_equal(offset, log->next, "chunk out of order");
+	zassert_mem_equal(data, content + offset, len);
+	log->next = offset + len;
+	if (++log->chunks == log->stop_after) {
+		return -ECANCELED;
+	}
+	return 0;
+}
+
+/* Test: the data comes back whole and in order for any window */
+ZTEST(client_stream, test_reassembly)
+{
+	static const unsigned int windows[] = { 1, 3, 8 };
+
+	for (int i = 0; i < ARRAY_SIZE(windows); i++) {
+		memset(out, 0, sizeof(out));
+		zassert_equal(ninep_client_read_stream(client, file_fid, 0, out,
+		                                       STREAM_SIZE, windows[i]),
+		              STREAM_SIZE);
+		zassert_mem_equal(out, content, STREAM_SIZE);
+
+		memset(out, 0, sizeof(out));
+		zassert_equal(ninep_client_read_stream(client, file_fid, 100, out,
+		                                       5000, windows[i]), 5000);
+		zassert_mem_equal(out, content + 100, 5000);
+	}
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: the first short read ends the stream */
+ZTEST(client_stream, test_stops_at_eof)
+{
+	uint64_t start = STREAM_SIZE - 1500;
+
+	memset(out, 0, sizeof(out));
+	zassert_equal(ninep_client_read_stream(client, file_fid, start, out,
+	                                       sizeof(out), 8), 1500);
+	zassert_mem_equal(out, content + start, 1500);
+	zassert_equal(out[1500], 0, "data delivered past end of file");
+
+	zassert_equal(ninep_client_read_stream(client, file_fid, STREAM_SIZE,
+	                                       out, 100, 4), 0);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: chunks reach the sink in order; the sink's error stops the read */
+ZTEST(client_stream, test_sink)
+{
+	struct sink_log log = { 0 };
+
+	zassert_equal(ninep_client_read_stream_sink(client, file_fid, 0,
+	                                            STREAM_SIZE, log_sink, &log,
+	                                            8), STREAM_SIZE);
+	zassert_equal(log.next, STREAM_SIZE);
+
+	log = (struct sink_log){ .stop_after = 3 };
+	zassert_equal(ninep_client_read_stream_sink(client, file_fid, 0,
+	                                            STREAM_SIZE, log_sink, &log,
+	                                            8), -ECANCELED);
+	zassert_equal(log.chunks, 3);
+	zassert_equal(latency_session_tags(&session), 0,
+	              "tags leaked after a stopped read");
+
+	/* Reading on an unknown fid fails at the first Tread */
+	log = (struct sink_log){ 0 };
+	zassert_true(ninep_client_read_stream_sink(client, 9999, 0, 4096,
+	                                           log_sink, &log, 4) < 0);
+	zassert_equal(log.chunks, 0);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Replays a garbage Rread to every answered tag, as a duplicate reply
+ * to a resent request would arrive, then checks the data it was given */
+static int replay_sink(const uint8_t *data, uint32_t len, uint64_t offset,
+                       void *user_data)
+{
+	static uint8_t fake[11 + 64];
+	int *replayed = user_data;
+
+	memset(&fake[11], 0xee, 64);
+	k_mutex_lock(&client->lock, K_FOREVER);
+	for (size_t i = 0; i < client->max_tags; i++) {
+		struct ninep_tag_entry *e = &client->tags[i];
+
+		if (e->in_use && e->complete) {
+			int n = ninep_build_rread(fake, sizeof(fake), e->tag, 64);
+
+			link->client.recv_cb(&link->client, fake, n,
+			                     link->client.user_data);
+			(*replayed)++;
+		}
+	}
+	k_mutex_unlock(&client->lock);
+
+	return memcmp(data, content + offset, len) == 0 ? 0 : -EBADMSG;
+}
+
+/* Test: a late reply does not overwrite a read the sink is consuming */
+ZTEST(client_stream, test_duplicate_reply_to_held_read)
+{
+	int replayed = 0;
+
+	zassert_equal(ninep_client_read_stream_sink(client, file_fid, 0,
+	                                            STREAM_SIZE, replay_sink,
+	                                            &replayed, 4), STREAM_SIZE);
+	zassert_true(replayed > 0);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: each Tread asks for one iounit */
+ZTEST(client_stream, test_iounit_chunks)
+{
+	uint32_t before = link->requests;
+
+	zassert_true(iounit > 0 && iounit <= MSIZE - 11);
+	zassert_equal(ninep_client_read_stream(client, file_fid, 0, out,
+	                                       STREAM_SIZE, 4), STREAM_SIZE);
+
+	/* The last Tread can come back short at end of file */
+	uint32_t chunks = (STREAM_SIZE + iounit - 1) / iounit;
+
+	zassert_true(link->requests - before >= chunks);
+	zassert_true(link->requests - before <= chunks + 1);
+	zassert_true(link->max_in_flight >= 4);
+}
+
+/* Benchmark: throughput grows with the window over a slow link */
+ZTEST(client_stream, test_window_throughput)
+{
+	static const unsigned int windows[] = { 1, 2, 4, 8 };
+
+	for (int i = 0; i < ARRAY_SIZE(windows); i++) {
+		link->max_in_flight = 0;
+
+		int64_t start = k_uptime_get();
+
+		zassert_equal(ninep_client_read_stream(client, file_fid, 0, out,
+		                                       STREAM_SIZE, windows[i]),
+		              STREAM_SIZE);
+
+		int64_t ms = MAX(k_uptime_get() - start, 1);
+
+		TC_PRINT("%d KiB, %d ms link, window %u: %lld ms, %lld KiB/s\n",
+		         STREAM_SIZE / 1024, LINK_LATENCY_MS, windows[i], ms,
+		         (int64_t)STREAM_SIZE * 1000 / 1024 / ms);
+
+		/* The timing is only reported; the window is what is checked */
+		zassert_equal(link->max_in_flight,
+		              MIN(windows[i], CONFIG_NINEP_CLIENT_MAX_WINDOW),
+		              "window %u not kept full", windows[i]);
+	}
+}
+
+static void client_stream_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	latency_session_start(&session, LINK_LATENCY_MS, MSIZE,
+	                      ninep_ramfs_get_ops(), &ramfs);
+	root_fid = session.root_fid;
+	zassert_equal(ninep_client_walk(client, root_fid, &file_fid, "f"), 0);
+
+	int ret = latency_session_open(&session, file_fid, NINEP_OREAD);
+
+	zassert_true(ret >= 0, "open failed: %d", ret);
+	iounit = ret;
+	link->max_in_flight = 0;
+}
+
+static void client_stream_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	latency_session_stop(&session);
+}
+
+static void *client_stream_setup(void)
+{
+	for (size_t i = 0; i < sizeof(content); i++) {
+		content[i] = (uint8_t)(i * 13 + (i >> 8));
+	}
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, ramfs.root, "f",
+	                                                content, sizeof(content)));
+	return NULL;
+}
+
+ZTEST_SUITE(client_stream, NULL, client_stream_setup, client_stream_before,
+            client_stream_after, NULL);
+
+#endif /* CONFIG_NINEP_CLIENT && CONFIG_NINEP_SERVER */
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Streaming Write Tests
+ *
+ * - Windowed writes land whole for any window, one Twrite per iounit
+ * - Short Rwrites have their tails sent again; a zero-byte Rwrite fails
+ * - With two failing chunks the lower offset's error is returned, and
+ *   everything below it was written
+ * - Benchmark: STREAM_SIZE bytes over a LINK_LATENCY_MS link with window
+ *   1, 2, 4 and 8; each window is kept full
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_CLIENT) && defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/client.h>
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <string.h>
+#include "latency_loopback.h"
+
+#define LINK_LATENCY_MS  5
+#define MSIZE            1024
+#define STREAM_SIZE      (32 * 1024)
+
+static struct latency_session session;
+static struct ninep_client *const client = &session.client;
+static struct latency_loopback *const link = &session.link;
+static struct ninep_ramfs ramfs;
+static struct ninep_fs_ops shaped_ops;
+static uint8_t content[STREAM_SIZE];
+static uint32_t root_fid;
+static uint32_t file_fid;
+static uint32_t iounit;
+
+/* The file's data: writes land here, shaped by the fields below */
+static struct {
+	uint8_t data[STREAM_SIZE];
+	uint32_t short_limit;  /* Accept at most this much per Twrite, or 0 */
+	bool stall;            /* Accept nothing */
+	uint64_t fail_at[2];   /* Fail the Twrite covering these offsets... */
+	int fail_err[2];       /* ...with these errors (0 = unused) */
+} disk;
+
+static int shaped_write(struct ninep_fs_node *node, uint64_t offset,
+                        const uint8_t *buf, uint32_t count, const char *uname,
+                        void *fs_ctx)
+{
+	for (int i = 0; i < ARRAY_SIZE(disk.fail_err); i++) {
+		if (disk.fail_err[i] && disk.fail_at[i] >= offset &&
+		    disk.fail_at[i] < offset + count) {
+			return disk.fail_err[i];
+		}
+	}
+	if (offset + count > sizeof(disk.data)) {
+		return -ENOSPC;
+	}
+	if (disk.stall) {
+		return 0;
+	}
+	if (disk.short_limit && count > disk.short_limit) {
+		count = disk.short_limit;
+	}
+	memcpy(&disk.data[offset], buf, count);
+	return count;
+}
+
+/* Test: the data lands whole for any window, one Twrite per iounit */
+ZTEST(client_write_stream, test_window_write)
+{
+	static const unsigned int windows[] = { 1, 3, 8 };
+
+	for (int i = 0; i < ARRAY_SIZE(windows); i++) {
+		uint32_t before = link->requests;
+
+		memset(disk.data, 0, sizeof(disk.data));
+		zassert_equal(ninep_client_write_stream(client, file_fid, 0,
+		                                        content, STREAM_SIZE,
+		                                        windows[i]), STREAM_SIZE);
+		zassert_mem_equal(disk.data, content, STREAM_SIZE);
+		zassert_equal(link->requests - before,
+		              (STREAM_SIZE + iounit - 1) / iounit);
+	}
+
+	/* An unaligned piece in the middle */
+	memset(disk.data, 0, sizeof(disk.data));
+	zassert_equal(ninep_client_write_stream(client, file_fid, 777,
+	                                        content + 777, 5000, 4), 5000);
+	zassert_mem_equal(disk.data + 777, content + 777, 5000);
+	zassert_equal(disk.data[776], 0);
+	zassert_equal(disk.data[777 + 5000], 0);
+	zassert_true(link->max_in_flight >= 4);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: short Rwrites are completed by sending the tail again */
+ZTEST(client_write_stream, test_short_writes)
+{
+	uint32_t before = link->requests;
+
+	disk.short_limit = 100;
+	zassert_equal(ninep_client_write_stream(client, file_fid, 0, content,
+	                                        STREAM_SIZE, 8), STREAM_SIZE);
+	zassert_mem_equal(disk.data, content, STREAM_SIZE);
+	zassert_equal(link->requests - before, STREAM_SIZE / 100 + 1);
+
+	/* No progress at all is an error, not a loop */
+	disk.stall = true;
+	zassert_equal(ninep_client_write_stream(client, file_fid, 0, content,
+	                                        STREAM_SIZE, 4), -EIO);
+	zassert_equal(latency_session_tags(&session), 0);
+}
+
+/* Test: a failure part way returns the bytes below the lowest failure */
+ZTEST(client_write_stream, test_first_error)
+{
+	disk.fail_at[0] = 5 * iounit;
+	disk.fail_err[0] = -EACCES;
+	disk.fail_at[1] = 2 * iounit;
+	disk.fail_err[1] = -ENOSPC;
+
+	zassert_equal(ninep_client_write_stream(client, file_fid, 0, content,
+	                                        STREAM_SIZE, 8), 2 * iounit);
+	zassert_mem_equal(disk.data, content, 2 * iounit);
+	zassert_equal(latency_session_tags(&session), 0,
+	              "tags leaked after a failed write");
+
+	/* With the lower failure gone, the count runs up to the higher one */
+	disk.fail_err[1] = 0;
+	zassert_equal(ninep_client_write_stream(client, file_fid, 0, content,
+	                                        STREAM_SIZE, 8), 5 * iounit);
+	zassert_mem_equal(disk.data, content, 5 * iounit);
+
+	/* Failing at the first byte written reports the error */
+	zassert_equal(ninep_client_write_stream(client, file_fid, 5 * iounit,
+	                                        content, STREAM_SIZE, 8),
+	              -EACCES);
+}
+
+/* Benchmark: throughput grows with the window over a slow link */
+ZTEST(client_write_stream, test_window_throughput)
+{
+	static const unsigned int windows[] = { 1, 2, 4, 8 };
+
+	for (int i = 0; i < ARRAY_SIZE(windows); i++) {
+		link->max_in_flight = 0;
+
+		int64_t start = k_uptime_get();
+
+		zassert_equal(ninep_client_write_stream(client, file_fid, 0,
+		                                        content, STREAM_SIZE,
+		                                        windows[i]), STREAM_SIZE);
+
+		int64_t ms = MAX(k_uptime_get() - start, 1);
+
+		TC_PRINT("%d KiB, %d ms link, window %u: %lld ms, %lld KiB/s\n",
+		         STREAM_SIZE / 1024, LINK_LATENCY_MS, windows[i], ms,
+		         (int64_t)STREAM_SIZE * 1000 / 1024 / ms);
+
+		/* The timing is only reported; the window is what is checked */
+		zassert_equal(link->max_in_flight,
+		              MIN(windows[i], CONFIG_NINEP_CLIENT_MAX_WINDOW),
+		              "window %u not kept full", windows[i]);
+	}
+}
+
+static void client_write_stream_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&disk, 0, sizeof(disk));
+	latency_session_start(&session, LINK_LATENCY_MS, MSIZE, &shaped_ops,
+	                      &ramfs);
+	root_fid = session.root_fid;
+	zassert_equal(ninep_client_walk(client, root_fid, &file_fid, "f"), 0);
+
+	int ret = latency_session_open(&session, file_fid, NINEP_OWRITE);
+
+	zassert_true(ret > 0 && ret <= MSIZE - 23, "open gave %d", ret);
+	iounit = ret;
+	link->max_in_flight = 0;
+}
+
+static void client_write_stream_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	latency_session_stop(&session);
+}
+
+static void *client_write_stream_setup(void)
+{
+	for (size_t i = 0; i < sizeof(content); i++) {
+		content[i] = (uint8_t)(i * 29 + (i >> 9) + 1);
+	}
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root, "f",
+	                                         NULL, 0));
+	shaped_ops = *ninep_ramfs_get_ops();
+	shaped_ops.write = shaped_write;
+	return NULL;
+}
+
+ZTEST_SUITE(client_write_stream, NULL, client_write_stream_setup,
+            client_write_stream_before, client_write_stream_after, NULL);
+
+#endif /* CONFIG_NINEP_CLIENT && CONFIG_NINEP_SERVER */
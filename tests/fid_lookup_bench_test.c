@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Server FID Table Tests and Lookup Benchmark
+ *
+ * - Fids survive heavy allocate/clunk churn (exercises hash index
+ *   deletion) and a full table refuses further fids
+ * - Benchmark: per-request lookup cost with 16, 256 and 1024 live fids,
+ *   against a reference linear scan (the previous find_fid()) over the
+ *   same fids. Sizes above CONFIG_NINEP_SERVER_MAX_FIDS - 1 are skipped.
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#define ROOT_FID     0
+#define BENCH_ITERS  4096
+
+static struct ninep_transport transport;
+static struct ninep_server server;
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry sysfs_entries[2];
+
+/* Last reply sent by the server */
+static uint8_t reply_buf[256];
+static size_t reply_len;
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(t);
+
+	reply_len = MIN(len, sizeof(reply_buf));
+	memcpy(reply_buf, buf, reply_len);
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops mock_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+static uint8_t process(const uint8_t *msg, int len)
+{
+	zassert_true(len > 0, "message build failed");
+	reply_len = 0;
+	ninep_server_process_message(&server, msg, len);
+	return reply_len >= 7 ? reply_buf[4] : 0;
+}
+
+/* Spread fid numbers out; real clients rarely use 1..N */
+static uint32_t fid_num(int i)
+{
+	return 0x100 + (uint32_t)i * 37;
+}
+
+static void new_session(void)
+{
+	uint8_t msg[64];
+	int len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                               CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+
+	zassert_equal(process(msg, len), NINEP_RVERSION);
+
+	len = ninep_build_tattach(msg, sizeof(msg), 1, ROOT_FID, NINEP_NOFID,
+	                          "bench", 5, "", 0);
+	zassert_equal(process(msg, len), NINEP_RATTACH);
+}
+
+/* Clone the root into fid; returns the reply type */
+static uint8_t clone_fid(uint32_t fid)
+{
+	uint8_t msg[32];
+	int len = ninep_build_twalk(msg, sizeof(msg), 2, ROOT_FID, fid,
+	                            0, NULL, NULL);
+
+	return process(msg, len);
+}
+
+static uint8_t clunk_fid(uint32_t fid)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tclunk(msg, sizeof(msg), 3, fid);
+
+	return process(msg, len);
+}
+
+static uint8_t stat_fid(uint32_t fid)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tstat(msg, sizeof(msg), 4, fid);
+
+	return process(msg, len);
+}
+
+/* Test: the table stays consistent across interleaved allocs and clunks */
+ZTEST(fid_lookup, test_fid_churn)
+{
+	int n = MIN(CONFIG_NINEP_SERVER_MAX_FIDS - 1, 200);
+
+	new_session();
+	for (int i = 0; i < n; i++) {
+		zassert_equal(clone_fid(fid_num(i)), NINEP_RWALK, "clone %d", i);
+	}
+	zassert_equal(clone_fid(fid_num(0)), NINEP_RERROR,
+	              "duplicate fid accepted");
+
+	/* Clunk every third fid, then reuse the freed slots for new numbers */
+	for (int i = 0; i < n; i += 3) {
+		zassert_equal(clunk_fid(fid_num(i)), NINEP_RCLUNK);
+	}
+	for (int i = 0; i < n; i++) {
+		zassert_equal(stat_fid(fid_num(i)),
+		              (i % 3 == 0) ? NINEP_RERROR : NINEP_RSTAT,
+		              "fid %d lost after clunks", i);
+	}
+	for (int i = 0; i < n; i += 3) {
+		zassert_equal(clone_fid(fid_num(n + i)), NINEP_RWALK);
+	}
+	for (int i = 0; i < n; i++) {
+		uint32_t fid = (i % 3 == 0) ? fid_num(n + i) : fid_num(i);
+
+		zassert_equal(stat_fid(fid), NINEP_RSTAT, "fid %d missing", i);
+	}
+}
+
+/* Test: allocation fails cleanly when every slot is taken */
+ZTEST(fid_lookup, test_fid_table_full)
+{
+	new_session();
+	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_FIDS - 1; i++) {
+		zassert_equal(clone_fid(fid_num(i)), NINEP_RWALK, "clone %d", i);
+	}
+	zassert_equal(clone_fid(0xFFFF0000), NINEP_RERROR,
+	              "fid allocated beyond MAX_FIDS");
+
+	/* A clunk frees exactly one slot */
+	zassert_equal(clunk_fid(fid_num(0)), NINEP_RCLUNK);
+	zassert_equal(clone_fid(0xFFFF0000), NINEP_RWALK);
+	zassert_equal(stat_fid(0xFFFF0000), NINEP_RSTAT);
+}
+
+/*
+ * Reference: the linear lookup the server used before the hash index,
+ * run over a mirror of the same fid numbers.
+ */
+static struct {
+	uint32_t fid;
+	bool in_use;
+} ref_fids[CONFIG_NINEP_SERVER_MAX_FIDS];
+
+static int ref_find(uint32_t fid)
+{
+	for (int i = 0; i < CONFIG_NINEP_SERVER_MAX_FIDS; i++) {
+		if (ref_fids[i].in_use && ref_fids[i].fid == fid) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* Twstat with an empty stat: the server rejects it right after looking
+ * up the fid, so the request is little more than parsing plus lookup. */
+static int build_twstat(uint8_t *buf, uint32_t fid)
+{
+	sys_put_le32(13, &buf[0]);
+	buf[4] = NINEP_TWSTAT;
+	sys_put_le16(5, &buf[5]);
+	sys_put_le32(fid, &buf[7]);
+	sys_put_le16(0, &buf[11]);
+	return 13;
+}
+
+static uint32_t ns_per_iter(uint32_t cycles)
+{
+	return (uint32_t)(k_cyc_to_ns_floor64(cycles) / BENCH_ITERS);
+}
+
+static void bench_size(int nfids)
+{
+	uint8_t msg[32];
+	volatile int sink = 0;
+
+	new_session();
+	memset(ref_fids, 0, sizeof(ref_fids));
+	ref_fids[0].fid = ROOT_FID;
+	ref_fids[0].in_use = true;
+	for (int i = 0; i < nfids; i++) {
+		zassert_equal(clone_fid(fid_num(i)), NINEP_RWALK);
+		ref_fids[i + 1].fid = fid_num(i);
+		ref_fids[i + 1].in_use = true;
+	}
+
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITERS; i++) {
+		int len = build_twstat(msg, fid_num(i % nfids));
+
+		ninep_server_process_message(&server, msg, len);
+	}
+	uint32_t server_ns = ns_per_iter(k_cycle_get_32() - start);
+
+	/* Reference linear scan over the same fids */
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_ITERS; i++) {
+		sink += ref_find(fid_num(i % nfids));
+	}
+	uint32_t scan_ns = ns_per_iter(k_cycle_get_32() - start);
+
+	/* Misses cost a full scan before, one short probe now */
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_ITERS; i++) {
+		int len = build_twstat(msg, 0xFFFF0000 + i);
+
+		ninep_server_process_message(&server, msg, len);
+	}
+	uint32_t miss_ns = ns_per_iter(k_cycle_get_32() - start);
+
+	TC_PRINT("%5d fids: Twstat %6u ns/req (miss %6u ns/req), "
+	         "linear-scan lookup alone %6u ns\n",
+	         nfids, server_ns, miss_ns, scan_ns);
+}
+
+/* Benchmark: request cost as the number of live fids grows */
+ZTEST(fid_lookup, test_lookup_cost_by_table_size)
+{
+	static const int sizes[] = { 16, 256, 1024 };
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		if (sizes[i] > CONFIG_NINEP_SERVER_MAX_FIDS - 1) {
+			TC_PRINT("%5d fids: skipped (CONFIG_NINEP_SERVER_MAX_FIDS=%d)\n",
+			         sizes[i], CONFIG_NINEP_SERVER_MAX_FIDS);
+			continue;
+		}
+		bench_size(sizes[i]);
+	}
+}
+
+static void *fid_lookup_setup(void)
+{
+	struct ninep_server_config config = {
+		.fs_ops = ninep_sysfs_get_ops(),
+		.fs_ctx = &sysfs,
+	};
+
+	transport.ops = &mock_ops;
+
+	zassert_equal(ninep_sysfs_init(&sysfs, sysfs_entries,
+	                               ARRAY_SIZE(sysfs_entries)), 0);
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+
+	return NULL;
+}
+
+static void fid_lookup_teardown(void *f)
+{
+	ninep_server_cleanup(&server);
+}
+
+ZTEST_SUITE(fid_lookup, NULL, fid_lookup_setup, NULL, NULL,
+            fid_lookup_teardown);
+
+#endif /* CONFIG_NINEP_SERVER */
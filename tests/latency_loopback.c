@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "latency_loopback.h"
+#include <zephyr/ztest.h>
+#include <string.h>
+
+#define LINK_STACK_SIZE  8192
+#define OPEN_TIMEOUT     K_MSEC(2000)
+
+static K_THREAD_STACK_DEFINE(link_stack, LINK_STACK_SIZE);
+
+static int client_send(struct ninep_transport *transport, const uint8_t *buf,
+                       size_t len)
+{
+	struct latency_loopback *lb = CONTAINER_OF(transport, struct latency_loopback,
+	                                           client);
+
+	if (len > sizeof(lb->msgs[0].buf)) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&lb->lock, K_FOREVER);
+	if (lb->count == LATENCY_LOOPBACK_SLOTS) {
+		k_mutex_unlock(&lb->lock);
+		return -ENOBUFS;
+	}
+
+	struct latency_loopback_msg *msg =
+		&lb->msgs[(lb->head + lb->count) % LATENCY_LOOPBACK_SLOTS];
+
+	msg->due = k_uptime_get() + lb->latency_ms;
+	msg->len = len;
+	memcpy(msg->buf, buf, len);
+	lb->count++;
+	lb->requests++;
+	lb->in_flight++;
+	if (lb->in_flight > lb->max_in_flight) {
+		lb->max_in_flight = lb->in_flight;
+	}
+	k_condvar_broadcast(&lb->cv);
+	k_mutex_unlock(&lb->lock);
+	return len;
+}
+
+/* Replies reach the client immediately, from the link thread */
+static int server_send(struct ninep_transport *transport, const uint8_t *buf,
+                       size_t len)
+{
+	struct latency_loopback *lb = CONTAINER_OF(transport, struct latency_loopback,
+	                                           server);
+
+	/* Before the client sees the reply, so it can refill its window */
+	k_mutex_lock(&lb->lock, K_FOREVER);
+	if (lb->in_flight > 0) {
+		lb->in_flight--;
+	}
+	k_mutex_unlock(&lb->lock);
+
+	if (lb->client.recv_cb) {
+		lb->client.recv_cb(&lb->client, buf, len, lb->client.user_data);
+	}
+	return len;
+}
+
+static int link_start(struct ninep_transport *transport)
+{
+	return 0;
+}
+
+static int link_stop(struct ninep_transport *transport)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops client_ops = {
+	.send = client_send,
+	.start = link_start,
+	.stop = link_stop,
+};
+
+static const struct ninep_transport_ops server_ops = {
+	.send = server_send,
+	.start = link_start,
+	.stop = link_stop,
+};
+
+static void link_thread(void *p1, void *p2, void *p3)
+{
+	struct latency_loopback *lb = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_mutex_lock(&lb->lock, K_FOREVER);
+	while (lb->running) {
+		if (lb->count == 0) {
+			k_condvar_wait(&lb->cv, &lb->lock, K_FOREVER);
+			continue;
+		}
+
+		struct latency_loopback_msg *msg = &lb->msgs[lb->head];
+		int64_t wait = msg->due - k_uptime_get();
+
+		if (wait > 0) {
+			k_mutex_unlock(&lb->lock);
+			k_msleep(wait);
+			k_mutex_lock(&lb->lock, K_FOREVER);
+			continue;
+		}
+
+		/* The slot stays taken until the server is done with it */
+		k_mutex_unlock(&lb->lock);
+		if (lb->server.recv_cb) {
+			lb->server.recv_cb(&lb->server, msg->buf, msg->len,
+			                   lb->server.user_data);
+		}
+		k_mutex_lock(&lb->lock, K_FOREVER);
+		lb->head = (lb->head + 1) % LATENCY_LOOPBACK_SLOTS;
+		lb->count--;
+	}
+	k_mutex_unlock(&lb->lock);
+}
+
+void latency_loopback_init(struct latency_loopback *lb, uint32_t latency_ms)
+{
+	memset(lb, 0, sizeof(*lb));
+	lb->client.ops = &client_ops;
+	lb->server.ops = &server_ops;
+	lb->latency_ms = latency_ms;
+	lb->running = true;
+	k_mutex_init(&lb->lock);
+	k_condvar_init(&lb->cv);
+	k_thread_create(&lb->thread, link_stack, K_THREAD_STACK_SIZEOF(link_stack),
+	                link_thread, lb, NULL, NULL, K_PRIO_PREEMPT(4), 0,
+	                K_NO_WAIT);
+}
+
+void latency_loopback_stop(struct latency_loopback *lb)
+{
+	k_mutex_lock(&lb->lock, K_FOREVER);
+	lb->running = false;
+	k_condvar_broadcast(&lb->cv);
+	k_mutex_unlock(&lb->lock);
+	k_thread_join(&lb->thread, K_FOREVER);
+}
+
+void latency_session_start(struct latency_session *s, uint32_t latency_ms,
+                           uint32_t msize, const struct ninep_fs_ops *fs_ops,
+                           void *fs_ctx)
+{
+	latency_loopback_init(&s->link, latency_ms);
+
+	s->server_config = (struct ninep_server_config){
+		.fs_ops = fs_ops,
+		.fs_ctx = fs_ctx,
+		.max_message_size = msize,
+		.version = "9P2000",
+	};
+	zassert_equal(ninep_server_init(&s->server, &s->server_config,
+	                                &s->link.server), 0);
+	zassert_equal(ninep_server_start(&s->server), 0);
+
+	s->client_config = (struct ninep_client_config){
+		.max_message_size = msize,
+		.version = "9P2000",
+		.timeout_ms = 2000,
+		/* The link thread hands the server one request at a time */
+		.in_order = true,
+	};
+	zassert_equal(ninep_client_init(&s->client, &s->client_config,
+	                                &s->link.client), 0);
+	zassert_equal(ninep_client_version(&s->client), 0);
+	zassert_equal(ninep_client_attach(&s->client, &s->root_fid, NINEP_NOFID,
+	                                  "user", ""), 0);
+	s->link.max_in_flight = 0;
+}
+
+void latency_session_stop(struct latency_session *s)
+{
+	if (s->link.running) {
+		latency_loopback_stop(&s->link);
+	}
+	ninep_server_stop(&s->server);
+	ninep_server_cleanup(&s->server);
+}
+
+static void open_done(struct ninep_client *client, struct ninep_client_req *req)
+{
+	ARG_UNUSED(client);
+
+	k_sem_give(req->user_data);
+}
+
+int latency_session_open(struct latency_session *s, uint32_t fid,
+                         uint8_t mode)
+{
+	struct ninep_client_req req;
+	struct k_sem done;
+	int ret;
+
+	k_sem_init(&done, 0, 1);
+	ninep_client_req_init(&req, open_done, &done);
+	ret = ninep_client_open_async(&s->client, fid, mode, &req);
+	if (ret < 0) {
+		return ret;
+	}
+	if (k_sem_take(&done, OPEN_TIMEOUT) != 0) {
+		ninep_client_cancel(&s->client, &req);
+		return -ETIMEDOUT;
+	}
+	return req.result < 0 ? req.result : (int)req.iounit;
+}
+
+int latency_session_tags(const struct latency_session *s)
+{
+	int n = 0;
+
+	for (size_t i = 0; i < s->client.max_tags; i++) {
+		n += s->client.tags[i].in_use;
+	}
+	return n;
+}
+
+int latency_session_fids(const struct latency_session *s)
+{
+	int n = 0;
+
+	for (size_t i = 0; i < s->client.max_fids; i++) {
+		n += s->client.fids[i].in_use;
+	}
+	return n;
+}
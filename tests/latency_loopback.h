@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Loopback transport pair with an injected round-trip delay, for
+ * measuring request pipelining without a real link.
+ */
+
+#ifndef NINEP_TESTS_LATENCY_LOOPBACK_H_
+#define NINEP_TESTS_LATENCY_LOOPBACK_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/9p/transport.h>
+#include <zephyr/9p/client.h>
+#include <zephyr/9p/server.h>
+
+/* Requests that can be in flight on the link at once */
+#define LATENCY_LOOPBACK_SLOTS  (CONFIG_NINEP_MAX_TAGS + 2)
+
+struct latency_loopback_msg {
+	int64_t due;  /* Uptime (ms) at which the server sees it */
+	size_t len;
+	uint8_t buf[CONFIG_NINEP_MAX_MESSAGE_SIZE];
+};
+
+/**
+ * Client-to-server messages are held for latency_ms, then handed to the
+ * server in order on the link's own thread; replies go straight back to
+ * the client from there.  Several requests sent back to back share one
+ * delay, as on a real link.
+ */
+struct latency_loopback {
+	struct ninep_transport client;  /* For ninep_client_init() */
+	struct ninep_transport server;  /* For ninep_server_init() */
+	uint32_t latency_ms;
+
+	/* Counters since init; a request is in flight until it is answered */
+	uint32_t requests;
+	uint32_t in_flight;
+	uint32_t max_in_flight;
+
+	struct latency_loopback_msg msgs[LATENCY_LOOPBACK_SLOTS];
+	int head;
+	int count;
+	struct k_mutex lock;
+	struct k_condvar cv;
+	struct k_thread thread;
+	bool running;
+};
+
+/**
+ * Set up the pair and start its thread.  Call before initializing the
+ * client and server on it.
+ */
+void latency_loopback_init(struct latency_loopback *lb, uint32_t latency_ms);
+
+/** Stop the link thread, dropping anything still in flight */
+void latency_loopback_stop(struct latency_loopback *lb);
+
+/**
+ * A server and a client on a latency_loopback, with the version
+ * negotiated and the client attached, as the client tests start.
+ */
+struct latency_session {
+	struct latency_loopback link;
+	struct ninep_server server;
+	struct ninep_client client;
+	uint32_t root_fid;
+
+	/* Kept here: both sides hold on to their configuration */
+	struct ninep_server_config server_config;
+	struct ninep_client_config client_config;
+};
+
+/**
+ * Start the link, serve fs_ops over it and attach the client, with
+ * messages of up to msize bytes.  Asserts on failure.
+ */
+void latency_session_start(struct latency_session *s, uint32_t latency_ms,
+                           uint32_t msize, const struct ninep_fs_ops *fs_ops,
+                           void *fs_ctx);
+
+/** Stop the link, if still running, and the server */
+void latency_session_stop(struct latency_session *s);
+
+/**
+ * Open fid through the async call, which reports the iounit.
+ *
+ * @return The iounit, or negative error code
+ */
+int latency_session_open(struct latency_session *s, uint32_t fid,
+                         uint8_t mode);
+
+/** Tags the client has in use */
+int latency_session_tags(const struct latency_session *s);
+
+/** Fids the client has in use */
+int latency_session_fids(const struct latency_session *s);
+
+#endif /* NINEP_TESTS_LATENCY_LOOPBACK_H_ */
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Namespace Thread Mapping Tests
+ *
+ * - A forked thread finds its namespace on its first lookup
+ * - Destroying a child leaves the parent thread's namespace in place
+ * - A thread sees its new namespace after ns_set_current
+ * - Benchmark: ns_get_current cycles, and ns_open/ns_close from 1 and
+ *   NUM_THREADS threads at once
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NAMESPACE) && defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/namespace/namespace.h>
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <string.h>
+
+#define NUM_THREADS   8
+#define OPENS         200
+#define BENCH_REPS    1000
+#define STACK_SIZE    2048
+#define WAIT_TIMEOUT  K_MSEC(5000)
+
+static struct ninep_ramfs ramfs;
+static struct ninep_server server;
+static struct thread_namespace *main_ns;
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread threads[NUM_THREADS];
+static K_SEM_DEFINE(go, 0, NUM_THREADS);
+static K_SEM_DEFINE(done, 0, NUM_THREADS);
+static struct thread_namespace *seen_ns[NUM_THREADS];
+static int seen_count[NUM_THREADS];
+static atomic_t open_failures;
+
+static void forked_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	struct ns_entry *found[2];
+
+	k_sem_take(&go, K_FOREVER);
+	seen_ns[0] = ns_get_current();
+	seen_count[0] = ns_walk("/data/f", found, ARRAY_SIZE(found));
+	k_sem_give(&done);
+}
+
+/* Test: a forked thread's first lookup finds the forked namespace */
+ZTEST(namespace_thread, test_fork_and_destroy)
+{
+	seen_ns[0] = NULL;
+	k_thread_create(&threads[0], stacks[0], K_THREAD_STACK_SIZEOF(stacks[0]),
+	                forked_fn, NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0,
+	                K_NO_WAIT);
+	zassert_equal(ns_fork(&threads[0]), 0);
+	k_sem_give(&go);
+	zassert_equal(k_sem_take(&done, WAIT_TIMEOUT), 0);
+	k_thread_join(&threads[0], WAIT_TIMEOUT);
+
+	zassert_not_null(seen_ns[0]);
+	zassert_not_equal(seen_ns[0], main_ns);
+	zassert_true(seen_ns[0]->is_cow);
+	zassert_equal(seen_count[0], 1, "fork lost the parent's mounts");
+
+	/* The child's last reference does not take the parent with it */
+	zassert_equal(ns_destroy(&threads[0]), 0);
+	zassert_equal(ns_destroy(&threads[0]), -ENOENT);
+	zassert_equal(ns_get_current(), main_ns);
+
+	struct ns_entry *found[2];
+
+	zassert_equal(ns_walk("/data/f", found, ARRAY_SIZE(found)), 1);
+}
+
+/* Test: ns_set_current takes effect on the next lookup */
+ZTEST(namespace_thread, test_set_current)
+{
+	zassert_equal(ns_create(main_ns), 0);
+
+	struct thread_namespace *child = ns_get_current();
+
+	zassert_not_equal(child, main_ns);
+	zassert_equal(child->parent, main_ns);
+	zassert_equal(ns_set_current(main_ns), 0);
+	zassert_equal(ns_get_current(), main_ns);
+	zassert_equal(ns_set_current(NULL), -EINVAL);
+
+	/* Only the thread's mapping referenced the child; free it */
+	zassert_equal(ns_set_current(child), 0);
+	zassert_equal(ns_destroy(k_current_get()), 0);
+	zassert_is_null(ns_get_current());
+	zassert_equal(ns_set_current(main_ns), 0);
+	zassert_equal(ns_get_current(), main_ns);
+}
+
+static void opener_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (ns_create(p1) < 0) {
+		atomic_inc(&open_failures);
+	}
+	k_sem_take(&go, K_FOREVER);
+	for (int i = 0; i < OPENS; i++) {
+		int fd = ns_open("/data/f", FS_O_READ);
+
+		if (fd < 0 || ns_close(fd) < 0) {
+			atomic_inc(&open_failures);
+		}
+	}
+	ns_destroy(k_current_get());
+	k_sem_give(&done);
+}
+
+/* Run OPENS ns_open/ns_close pairs on each of n threads at once */
+static uint32_t concurrent_opens(int n)
+{
+	atomic_set(&open_failures, 0);
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i],
+		                K_THREAD_STACK_SIZEOF(stacks[i]), opener_fn,
+		                main_ns, NULL, NULL, K_PRIO_PREEMPT(5), 0,
+		                K_NO_WAIT);
+	}
+
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < n; i++) {
+		k_sem_give(&go);
+	}
+	for (int i = 0; i < n; i++) {
+		zassert_equal(k_sem_take(&done, WAIT_TIMEOUT), 0);
+	}
+
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	for (int i = 0; i < n; i++) {
+		k_thread_join(&threads[i], WAIT_TIMEOUT);
+	}
+	zassert_equal(atomic_get(&open_failures), 0);
+	return cycles / (n * OPENS);
+}
+
+/* Benchmark: lookups and opens from many threads at once */
+ZTEST(namespace_thread, test_concurrent_open_cost)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_REPS; i++) {
+		zassert_equal(ns_get_current(), main_ns);
+	}
+
+	uint32_t lookup = (k_cycle_get_32() - start) / BENCH_REPS;
+	uint32_t one = concurrent_opens(1);
+	uint32_t many = concurrent_opens(NUM_THREADS);
+
+	TC_PRINT("ns_get_current: %u cycles; ns_open+ns_close: 1 thread %u "
+	         "cycles/op, %d threads %u cycles/op\n", lookup, one,
+	         NUM_THREADS, many);
+}
+
+static void *namespace_thread_setup(void)
+{
+	zassert_equal(ns_init(), 0);
+	if (!ns_get_current()) {
+		zassert_equal(ns_create(NULL), 0);
+	}
+	main_ns = ns_get_current();
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root, "f",
+	                                         "data", 4));
+	server.config.fs_ops = ninep_ramfs_get_ops();
+	server.config.fs_ctx = &ramfs;
+	zassert_equal(ns_mount_server(&server, "/data", 0), 0);
+	return NULL;
+}
+
+ZTEST_SUITE(namespace_thread, NULL, namespace_thread_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NAMESPACE && CONFIG_NINEP_SERVER */
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Namespace Mount Tree Tests
+ *
+ * - A walk returns the longest mount point first, each union stack in
+ *   BEFORE/AFTER order, then every mount point above it
+ * - Mount points match whole components only
+ * - REPLACE and unmount publish the expected stacks
+ * - A lookup completes while namespace locks are held, and a COW child
+ *   sees its parent's mounts until it mounts something itself
+ * - Entries from a walk inside ns_walk_begin/end outlive their unmount
+ * - Benchmark: ns_walk cycles with 1 and BENCH_MOUNTS mounts
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NAMESPACE
+
+#include <zephyr/namespace/namespace.h>
+#include <zephyr/9p/server.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MOUNTS       64
+#define BENCH_REPS         1000
+#define READER_STACK_SIZE  2048
+#define READER_TIMEOUT     K_MSEC(1000)
+
+/* Servers are only compared by address here */
+static struct ninep_server servers[8];
+static struct ninep_server bench_servers[BENCH_MOUNTS];
+
+static K_THREAD_STACK_DEFINE(reader_stack, READER_STACK_SIZE);
+static struct k_thread reader_thread;
+static K_SEM_DEFINE(reader_ready, 0, 1);
+static K_SEM_DEFINE(reader_go, 0, 1);
+static K_SEM_DEFINE(reader_done, 0, 1);
+static struct thread_namespace *reader_ns;
+static struct ns_entry *reader_found[4];
+static int reader_count;
+
+/* Test: the longest mount point first, each stack in priority order */
+ZTEST(namespace_tree, test_union_order)
+{
+	struct ns_entry *found[8];
+
+	zassert_equal(ns_mount_server(&servers[0], "/", 0), 0);
+	zassert_equal(ns_mount_server(&servers[1], "/a", NS_FLAG_AFTER), 0);
+	zassert_equal(ns_mount_server(&servers[2], "/a", NS_FLAG_BEFORE), 0);
+	zassert_equal(ns_mount_server(&servers[3], "/a/", NS_FLAG_AFTER), 0);
+	zassert_equal(ns_mount_server(&servers[4], "/a/b", 0), 0);
+
+	zassert_equal(ns_walk("/a/b/c", found, ARRAY_SIZE(found)), 5);
+	zassert_equal(found[0]->server, &servers[4]);
+	zassert_equal(found[1]->server, &servers[2]);
+	zassert_equal(found[2]->server, &servers[1]);
+	zassert_equal(found[3]->server, &servers[3]);
+	zassert_equal(found[4]->server, &servers[0]);
+	zassert_true(found[2]->priority < found[3]->priority);
+
+	/* Only whole components match */
+	zassert_equal(ns_walk("/ab", found, ARRAY_SIZE(found)), 1);
+	zassert_equal(found[0]->server, &servers[0]);
+	zassert_equal(ns_walk("/a/./b/../b", found, ARRAY_SIZE(found)), 5);
+
+	/* max_entries keeps the highest priority entries */
+	zassert_equal(ns_walk("/a/b", found, 2), 2);
+	zassert_equal(found[0]->server, &servers[4]);
+	zassert_equal(found[1]->server, &servers[2]);
+}
+
+/* Test: REPLACE leaves one entry; unmount removes the first */
+ZTEST(namespace_tree, test_replace_and_unmount)
+{
+	struct ns_entry *found[8];
+
+	zassert_equal(ns_mount_server(&servers[0], "/x", 0), 0);
+	zassert_equal(ns_mount_server(&servers[1], "/x", 0), 0);
+	zassert_equal(ns_mount_server(&servers[2], "/x", NS_FLAG_REPLACE), 0);
+	zassert_equal(ns_walk("/x/y", found, ARRAY_SIZE(found)), 1);
+	zassert_equal(found[0]->server, &servers[2]);
+
+	zassert_equal(ns_mount_server(&servers[3], "/x", 0), 0);
+	zassert_equal(ns_unmount("/x", NULL), 0);
+	zassert_equal(ns_walk("/x", found, ARRAY_SIZE(found)), 1);
+	zassert_equal(found[0]->server, &servers[3]);
+	zassert_equal(ns_unmount("/x", NULL), 0);
+	zassert_equal(ns_walk("/x", found, ARRAY_SIZE(found)), 0);
+	zassert_equal(ns_unmount("/x", NULL), -ENOENT);
+	zassert_equal(ns_unmount("/never", NULL), -ENOENT);
+}
+
+static void reader_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	zassert_equal(ns_create(p1), 0);
+	reader_ns = ns_get_current();
+	k_sem_give(&reader_ready);
+
+	k_sem_take(&reader_go, K_FOREVER);
+	reader_count = ns_walk("/r/file", reader_found, ARRAY_SIZE(reader_found));
+	k_sem_give(&reader_done);
+
+	/* Mounting breaks COW: the parent's later mounts are not seen */
+	k_sem_take(&reader_go, K_FOREVER);
+	zassert_equal(ns_mount_server(&servers[6], "/own", 0), 0);
+	k_sem_give(&reader_done);
+
+	k_sem_take(&reader_go, K_FOREVER);
+	reader_count = ns_walk("/r/file", reader_found, ARRAY_SIZE(reader_found));
+	k_sem_give(&reader_done);
+}
+
+/* Test: lookups never wait for a namespace lock */
+ZTEST(namespace_tree, test_lookup_does_not_block)
+{
+	struct thread_namespace *ns = ns_get_current();
+
+	zassert_equal(ns_mount_server(&servers[0], "/r", 0), 0);
+	k_thread_create(&reader_thread, reader_stack,
+	                K_THREAD_STACK_SIZEOF(reader_stack), reader_fn,
+	                ns, NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	zassert_equal(k_sem_take(&reader_ready, READER_TIMEOUT), 0);
+	zassert_not_null(reader_ns);
+
+	/* Mounted after the fork, and found while both locks are held */
+	zassert_equal(ns_mount_server(&servers[5], "/r", NS_FLAG_BEFORE), 0);
+	k_mutex_lock(&ns->lock, K_FOREVER);
+	k_mutex_lock(&reader_ns->lock, K_FOREVER);
+	k_sem_give(&reader_go);
+	int ret = k_sem_take(&reader_done, READER_TIMEOUT);
+
+	k_mutex_unlock(&reader_ns->lock);
+	k_mutex_unlock(&ns->lock);
+	zassert_equal(ret, 0, "lookup waited for a lock");
+	zassert_equal(reader_count, 2);
+	zassert_equal(reader_found[0]->server, &servers[5]);
+	zassert_equal(reader_found[1]->server, &servers[0]);
+
+	k_sem_give(&reader_go);
+	zassert_equal(k_sem_take(&reader_done, READER_TIMEOUT), 0);
+	zassert_equal(ns_mount_server(&servers[7], "/r", NS_FLAG_BEFORE), 0);
+	k_sem_give(&reader_go);
+	zassert_equal(k_sem_take(&reader_done, READER_TIMEOUT), 0);
+	zassert_equal(reader_count, 2, "COW copy followed the parent");
+	zassert_equal(reader_found[0]->server, &servers[5]);
+	k_thread_join(&reader_thread, READER_TIMEOUT);
+}
+
+/* Test: an unmounted entry stays readable until the walk section ends */
+ZTEST(namespace_tree, test_walk_section)
+{
+	struct ns_entry *found[2];
+
+	zassert_equal(ns_mount_server(&servers[0], "/s", 0), 0);
+	ns_walk_begin();
+	zassert_equal(ns_walk("/s/f", found, ARRAY_SIZE(found)), 1);
+	zassert_equal(ns_unmount("/s", NULL), 0);
+	zassert_equal(found[0]->server, &servers[0]);
+	zassert_equal(strcmp(found[0]->path, "/s"), 0);
+	ns_walk_end();
+	zassert_equal(ns_walk("/s/f", found, ARRAY_SIZE(found)), 0);
+}
+
+/* Benchmark: walk cost does not grow with the number of mounts */
+ZTEST(namespace_tree, test_walk_cost)
+{
+	static char paths[BENCH_MOUNTS][16];
+	struct ns_entry *found[4];
+	uint32_t cycles[2];
+
+	for (int round = 0; round < 2; round++) {
+		int first = round ? 1 : 0;
+		int last = round ? BENCH_MOUNTS : 1;
+
+		for (int i = first; i < last; i++) {
+			snprintf(paths[i], sizeof(paths[i]), "/m%02d/x", i);
+			zassert_equal(ns_mount_server(&bench_servers[i], paths[i], 0), 0);
+		}
+
+		const char *path = paths[last - 1];
+		uint32_t start = k_cycle_get_32();
+
+		for (int i = 0; i < BENCH_REPS; i++) {
+			zassert_equal(ns_walk(path, found, ARRAY_SIZE(found)), 1);
+		}
+		cycles[round] = (k_cycle_get_32() - start) / BENCH_REPS;
+	}
+
+	TC_PRINT("ns_walk: 1 mount %u cycles, %d mounts %u cycles\n",
+	         cycles[0], BENCH_MOUNTS, cycles[1]);
+}
+
+static void *namespace_tree_setup(void)
+{
+	zassert_equal(ns_init(), 0);
+	if (!ns_get_current()) {
+		zassert_equal(ns_create(NULL), 0);
+	}
+	return NULL;
+}
+
+static void namespace_tree_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(ns_clear(), 0);
+}
+
+ZTEST_SUITE(namespace_tree, NULL, namespace_tree_setup, namespace_tree_before,
+            NULL, NULL);
+
+#endif /* CONFIG_NAMESPACE */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Filesystem Node Allocator Tests
+ *
+ * - Nodes come from the smallest size class their struct plus name fits
+ * - A full class, or a node bigger than every class, falls back to the heap
+ * - Names longer than the old 64-byte array are kept whole
+ * - Walk/clunk churn leaves the allocator where it started
+ * - Benchmark: node alloc/free against k_malloc/k_free
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NINEP_SERVER
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/node_alloc.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/union_fs.h>
+#include <string.h>
+
+#define CHURN_REPS  1000
+#define BENCH_REPS  1000
+
+/* Long enough to fill a block of the largest class */
+static char long_name[4 * CONFIG_NINEP_NODE_BLOCK_SIZE];
+
+/* Name that makes a bare node exactly fill a block of block_size bytes */
+static size_t name_len_for(size_t block_size)
+{
+	return block_size - sizeof(struct ninep_fs_node) - 1;
+}
+
+/* Test: each node takes the smallest class it fits */
+ZTEST(node_alloc, test_size_classes)
+{
+	struct ninep_node_alloc_stats before, during, after;
+	struct ninep_fs_node *nodes[NINEP_NODE_ALLOC_CLASSES + 1];
+
+	ninep_node_alloc_get_stats(&before);
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		nodes[i] = ninep_node_alloc(sizeof(struct ninep_fs_node), long_name,
+		                            name_len_for(before.classes[i].block_size));
+		zassert_not_null(nodes[i]);
+	}
+	/* One byte too many for the largest class */
+	nodes[NINEP_NODE_ALLOC_CLASSES] = ninep_node_alloc(
+		sizeof(struct ninep_fs_node), long_name,
+		name_len_for(before.classes[NINEP_NODE_ALLOC_CLASSES - 1].block_size) + 1);
+
+	ninep_node_alloc_get_stats(&during);
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		if (before.classes[i].in_use < before.classes[i].blocks) {
+			zassert_equal(during.classes[i].in_use,
+			              before.classes[i].in_use + 1,
+			              "class %d not used", i);
+		}
+	}
+#ifdef CONFIG_NINEP_NODE_HEAP_FALLBACK
+	zassert_not_null(nodes[NINEP_NODE_ALLOC_CLASSES]);
+	zassert_true(during.heap_in_use > before.heap_in_use);
+#else
+	zassert_is_null(nodes[NINEP_NODE_ALLOC_CLASSES]);
+	zassert_equal(during.failures, before.failures + 1);
+#endif
+
+	for (int i = 0; i <= NINEP_NODE_ALLOC_CLASSES; i++) {
+		ninep_node_free(nodes[i]);
+	}
+	ninep_node_alloc_get_stats(&after);
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		zassert_equal(after.classes[i].in_use, before.classes[i].in_use);
+		zassert_true(after.classes[i].high_water >=
+		             during.classes[i].in_use);
+	}
+	zassert_equal(after.heap_in_use, before.heap_in_use);
+}
+
+/* Test: the name is stored whole, after the caller's struct */
+ZTEST(node_alloc, test_name_and_payload)
+{
+	struct payload_node {
+		struct ninep_fs_node node;
+		uint32_t extra[4];
+	} *pn;
+
+	pn = (struct payload_node *)ninep_node_alloc(sizeof(*pn), long_name,
+	                                             NINEP_NODE_NAME_MAX);
+	zassert_not_null(pn);
+	zassert_equal(strlen(pn->node.name), NINEP_NODE_NAME_MAX);
+	zassert_equal(strncmp(pn->node.name, long_name, NINEP_NODE_NAME_MAX), 0);
+	zassert_true(pn->node.name >= (const char *)(pn + 1));
+	for (int i = 0; i < ARRAY_SIZE(pn->extra); i++) {
+		zassert_equal(pn->extra[i], 0);
+	}
+	zassert_is_null(pn->node.parent);
+	ninep_node_free(&pn->node);
+
+	/* Name need not be NUL-terminated */
+	struct ninep_fs_node *node = ninep_node_alloc(sizeof(*node), "abcdef", 3);
+
+	zassert_not_null(node);
+	zassert_equal(strcmp(node->name, "abc"), 0);
+	ninep_node_free(node);
+	ninep_node_free(NULL);
+}
+
+/* Test: a full class goes to the heap, never to a larger class */
+ZTEST(node_alloc, test_full_class)
+{
+	struct ninep_node_alloc_stats before, full, after;
+	static struct ninep_fs_node *held[CONFIG_NINEP_NODE_BLOCKS_SMALL + 1];
+	int n = 0;
+
+	ninep_node_alloc_get_stats(&before);
+	if (before.classes[0].blocks == 0) {
+		ztest_test_skip();
+	}
+
+	size_t len = name_len_for(before.classes[0].block_size);
+	uint32_t free_blocks = before.classes[0].blocks - before.classes[0].in_use;
+
+	for (uint32_t i = 0; i <= free_blocks; i++) {
+		held[n] = ninep_node_alloc(sizeof(struct ninep_fs_node),
+		                           long_name, len);
+		if (held[n]) {
+			n++;
+		}
+	}
+
+	ninep_node_alloc_get_stats(&full);
+	zassert_equal(full.classes[0].in_use, full.classes[0].blocks);
+	zassert_equal(full.classes[0].high_water, full.classes[0].blocks);
+	zassert_equal(full.classes[1].in_use, before.classes[1].in_use);
+#ifdef CONFIG_NINEP_NODE_HEAP_FALLBACK
+	zassert_equal(n, free_blocks + 1);
+	zassert_equal(full.heap_in_use, before.heap_in_use + 1);
+	zassert_equal(full.failures, before.failures);
+#else
+	zassert_equal(n, free_blocks);
+	zassert_equal(full.failures, before.failures + 1);
+#endif
+
+	while (n > 0) {
+		ninep_node_free(held[--n]);
+	}
+	ninep_node_alloc_get_stats(&after);
+	zassert_equal(after.classes[0].in_use, before.classes[0].in_use);
+	zassert_equal(after.heap_in_use, before.heap_in_use);
+}
+
+/* Test: ramfs names past the old 63-character limit survive walk */
+ZTEST(node_alloc, test_ramfs_long_name)
+{
+	static struct ninep_ramfs ramfs;
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+	char name[100];
+
+	memset(name, 'x', sizeof(name) - 1);
+	name[sizeof(name) - 1] = '\0';
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	struct ninep_fs_node *file = ninep_ramfs_create_file(&ramfs, ramfs.root,
+	                                                     name, NULL, 0);
+	zassert_not_null(file);
+	zassert_equal(strcmp(file->name, name), 0);
+
+	struct ninep_fs_node *node = ops->walk(ramfs.root, name, strlen(name),
+	                                       &ramfs);
+	zassert_equal(node, file);
+	zassert_equal(ops->remove(node, &ramfs), 0);
+}
+
+/* Test: walking through a union's synthetic directories and clunking them
+ * returns every block */
+ZTEST(node_alloc, test_walk_clunk_churn)
+{
+	static struct ninep_union_fs fs;
+	static struct ninep_union_mount mounts[2];
+	static struct ninep_ramfs ramfs;
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+	struct ninep_node_alloc_stats before, after;
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_equal(ninep_union_fs_init(&fs, mounts, ARRAY_SIZE(mounts)), 0);
+	zassert_equal(ninep_union_fs_mount(&fs, "/a/b", ninep_ramfs_get_ops(),
+	                                   &ramfs), 0);
+
+	ninep_node_alloc_get_stats(&before);
+	for (int i = 0; i < CHURN_REPS; i++) {
+		struct ninep_fs_node *a = ops->walk(fs.root, "a", 1, &fs);
+
+		zassert_not_null(a);
+		zassert_equal(strcmp(a->name, "a"), 0);
+		ops->clunk(a, &fs);
+	}
+	ninep_node_alloc_get_stats(&after);
+
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		zassert_equal(after.classes[i].in_use, before.classes[i].in_use);
+	}
+	zassert_equal(after.heap_in_use, before.heap_in_use);
+	zassert_equal(after.heap_high_water, before.heap_high_water,
+	              "churn went to the heap");
+}
+
+/* Benchmark: node alloc/free against the heap */
+ZTEST(node_alloc, test_alloc_cost)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_REPS; i++) {
+		struct ninep_fs_node *node = ninep_node_alloc(
+			sizeof(struct ninep_fs_node), "node", 4);
+
+		zassert_not_null(node);
+		ninep_node_free(node);
+	}
+	uint32_t slab = (k_cycle_get_32() - start) / BENCH_REPS;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_REPS; i++) {
+		struct ninep_fs_node *node = k_malloc(sizeof(*node));
+
+		zassert_not_null(node);
+		memset(node, 0, sizeof(*node));
+		k_free(node);
+	}
+	uint32_t heap = (k_cycle_get_32() - start) / BENCH_REPS;
+
+	TC_PRINT("node alloc+free: allocator %u cycles, k_malloc %u cycles\n",
+	         slab, heap);
+}
+
+static void *node_alloc_setup(void)
+{
+	memset(long_name, 'n', sizeof(long_name));
+	return NULL;
+}
+
+ZTEST_SUITE(node_alloc, NULL, node_alloc_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER */
@@ -0,0 +1,530 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Interned Node Cache Tests
+ *
+ * sysfs:
+ * - Repeated walks of a path return the same node and qid
+ * - The clunk callback still runs when the last fid goes; the node stays
+ * - Two instances never share nodes for the same path
+ * - Initializing an instance again frees its nodes; a node a fid holds
+ *   goes on its last clunk
+ * - Walks and clunks from several threads keep the reference counts
+ * - Idle nodes are bounded by CONFIG_NINEP_SYSFS_NODE_CACHE
+ *
+ * passthrough_fs over littlefs on the native_sim flash simulator:
+ * - Repeated and multi-element walks reuse nodes without fs_stat()
+ * - Writes, creates and removes through 9P invalidate cached nodes
+ * - Idle nodes are bounded by CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE
+ * - Benchmark: walk+clunk cost on a cache miss against a hit
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NINEP_SERVER
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/9p/node_alloc.h>
+#include <stdio.h>
+#include <string.h>
+
+#define REINITS       20
+#define NUM_THREADS   4
+#define THREAD_REPS   500
+#define STACK_SIZE    2048
+
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs other_sysfs;
+static struct ninep_sysfs reinit_sysfs;
+static struct ninep_sysfs_entry entries[8];
+static struct ninep_sysfs_entry other_entries[4];
+static struct ninep_sysfs_entry reinit_entries[4];
+static struct ninep_sysfs bound_sysfs;
+static struct ninep_sysfs_entry bound_entries[8];
+static const char *const bound_files[] = {
+	"/f0", "/f1", "/f2", "/f3", "/f4", "/f5", "/f6", "/f7",
+};
+static int clunks;
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread threads[NUM_THREADS];
+static atomic_t walk_failures;
+
+static int gen_value(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
+{
+	if (offset > 0) {
+		return 0;
+	}
+	return snprintf((char *)buf, buf_size, "42\n");
+}
+
+static int write_value(const uint8_t *buf, uint32_t count, uint64_t offset,
+                       void *ctx)
+{
+	return count;
+}
+
+static int count_clunk(void *ctx)
+{
+	clunks++;
+	return 0;
+}
+
+/* Test: a polled path keeps one node and one qid */
+ZTEST(sysfs_node_cache, test_repeated_walks)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *first = ops->walk(sysfs.root, "value", 5, &sysfs);
+
+	zassert_not_null(first);
+	uint64_t qid_path = first->qid.path;
+
+	ops->clunk(first, &sysfs);
+	for (int i = 0; i < 100; i++) {
+		struct ninep_fs_node *node = ops->walk(sysfs.root, "value", 5, &sysfs);
+
+		zassert_equal(node, first, "walk %d allocated a new node", i);
+		zassert_equal(node->qid.path, qid_path);
+		ops->clunk(node, &sysfs);
+	}
+
+	/* Through an intermediate directory as well */
+	struct ninep_fs_node *dir = ops->walk(sysfs.root, "dev", 3, &sysfs);
+	struct ninep_fs_node *leaf = ops->walk(dir, "led", 3, &sysfs);
+
+	zassert_not_null(leaf);
+	zassert_equal(ops->walk(sysfs.root, "dev", 3, &sysfs), dir);
+	zassert_equal(ops->walk(dir, "led", 3, &sysfs), leaf);
+	for (int i = 0; i < 2; i++) {
+		ops->clunk(leaf, &sysfs);
+		ops->clunk(dir, &sysfs);
+	}
+}
+
+/* Test: the clunk callback runs once the last fid is gone */
+ZTEST(sysfs_node_cache, test_clunk_callback)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *a = ops->walk(sysfs.root, "ctl", 3, &sysfs);
+	struct ninep_fs_node *b = ops->walk(sysfs.root, "ctl", 3, &sysfs);
+
+	zassert_equal(a, b);
+	clunks = 0;
+	ops->clunk(a, &sysfs);
+	zassert_equal(clunks, 0, "callback with a fid still open");
+	ops->clunk(b, &sysfs);
+	zassert_equal(clunks, 1);
+
+	/* "." is another fid on the same node */
+	a = ops->walk(sysfs.root, "ctl", 3, &sysfs);
+	b = ops->walk(a, ".", 1, &sysfs);
+	zassert_equal(a, b);
+	ops->clunk(b, &sysfs);
+	zassert_equal(clunks, 1);
+	ops->clunk(a, &sysfs);
+	zassert_equal(clunks, 2);
+
+	zassert_equal(ops->walk(sysfs.root, "ctl", 3, &sysfs), a);
+	ops->clunk(a, &sysfs);
+}
+
+/* Test: instances are cached apart */
+ZTEST(sysfs_node_cache, test_instances_apart)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *mine = ops->walk(sysfs.root, "value", 5, &sysfs);
+	struct ninep_fs_node *theirs = ops->walk(other_sysfs.root, "value", 5,
+	                                         &other_sysfs);
+
+	zassert_not_null(mine);
+	zassert_not_null(theirs);
+	zassert_not_equal(mine, theirs);
+	ops->clunk(mine, &sysfs);
+	ops->clunk(theirs, &other_sysfs);
+}
+
+static uint32_t nodes_in_use(void)
+{
+	struct ninep_node_alloc_stats stats;
+	uint32_t n;
+
+	ninep_node_alloc_get_stats(&stats);
+	n = stats.heap_in_use;
+	for (int i = 0; i < NINEP_NODE_ALLOC_CLASSES; i++) {
+		n += stats.classes[i].in_use;
+	}
+	return n;
+}
+
+static void reinit(void)
+{
+	zassert_equal(ninep_sysfs_init(&reinit_sysfs, reinit_entries,
+	                               ARRAY_SIZE(reinit_entries)), 0);
+	zassert_equal(ninep_sysfs_register_file(&reinit_sysfs, "/a/b/value",
+	                                        gen_value, NULL), 0);
+}
+
+static void walk_and_reinit(void)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *a = ops->walk(reinit_sysfs.root, "a", 1,
+	                                    &reinit_sysfs);
+	struct ninep_fs_node *b = ops->walk(a, "b", 1, &reinit_sysfs);
+
+	zassert_not_null(b);
+	ops->clunk(b, &reinit_sysfs);
+	ops->clunk(a, &reinit_sysfs);
+	reinit();
+}
+
+/* Test: initializing again frees the earlier instance's nodes */
+ZTEST(sysfs_node_cache, test_reinit_frees)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	uint8_t buf[16];
+
+	/* The first round may push other instances' idle nodes out */
+	reinit();
+	walk_and_reinit();
+
+	uint32_t before = nodes_in_use();
+
+	for (int i = 0; i < REINITS; i++) {
+		walk_and_reinit();
+	}
+	zassert_equal(nodes_in_use(), before, "re-init leaked nodes");
+
+	/* A held node outlives the instance, empty, until its clunk */
+	struct ninep_fs_node *a = ops->walk(reinit_sysfs.root, "a", 1,
+	                                    &reinit_sysfs);
+	struct ninep_fs_node *b = ops->walk(a, "b", 1, &reinit_sysfs);
+	struct ninep_fs_node *value = ops->walk(b, "value", 5, &reinit_sysfs);
+
+	zassert_not_null(value);
+	ops->clunk(value, &reinit_sysfs);
+	ops->clunk(a, &reinit_sysfs);
+	reinit();
+	zassert_equal(nodes_in_use(), before + 1);
+	zassert_is_null(ops->walk(b, "value", 5, &reinit_sysfs));
+	zassert_equal(ops->read(b, 0, buf, sizeof(buf), NULL, &reinit_sysfs), 0);
+	ops->clunk(b, &reinit_sysfs);
+	zassert_equal(nodes_in_use(), before);
+}
+
+static void churn_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *led = p1;
+
+	for (int i = 0; i < THREAD_REPS; i++) {
+		struct ninep_fs_node *dir = ops->walk(sysfs.root, "dev", 3, &sysfs);
+		struct ninep_fs_node *node = dir ?
+			ops->walk(dir, "led", 3, &sysfs) : NULL;
+
+		if (node != led) {
+			atomic_inc(&walk_failures);
+		}
+		if (node) {
+			ops->clunk(node, &sysfs);
+		}
+		if (dir) {
+			ops->clunk(dir, &sysfs);
+		}
+	}
+}
+
+/* Test: concurrent walks and clunks never free a held node */
+ZTEST(sysfs_node_cache, test_concurrent_walks)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *dir = ops->walk(sysfs.root, "dev", 3, &sysfs);
+	struct ninep_fs_node *led = ops->walk(dir, "led", 3, &sysfs);
+	uint32_t before = nodes_in_use();
+
+	zassert_not_null(led);
+	atomic_set(&walk_failures, 0);
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i],
+		                K_THREAD_STACK_SIZEOF(stacks[i]), churn_fn, led,
+		                NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	}
+	for (int i = 0; i < NUM_THREADS; i++) {
+		zassert_equal(k_thread_join(&threads[i], K_MSEC(10000)), 0);
+	}
+	zassert_equal(atomic_get(&walk_failures), 0, "held node replaced");
+	zassert_equal(nodes_in_use(), before);
+
+	/* The test's own references are intact */
+	zassert_equal(ops->walk(dir, "led", 3, &sysfs), led);
+	ops->clunk(led, &sysfs);
+	ops->clunk(led, &sysfs);
+	ops->clunk(dir, &sysfs);
+}
+
+/* Test: idle nodes stay within the bound; held ones are never evicted */
+ZTEST(sysfs_node_cache, test_idle_bound)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *held = ops->walk(bound_sysfs.root, "f0", 2,
+	                                       &bound_sysfs);
+	uint32_t before = nodes_in_use();
+
+	zassert_not_null(held);
+	for (int i = 1; i < ARRAY_SIZE(bound_files); i++) {
+		struct ninep_fs_node *node = ops->walk(bound_sysfs.root,
+		                                       bound_files[i] + 1, 2,
+		                                       &bound_sysfs);
+
+		zassert_not_null(node);
+		ops->clunk(node, &bound_sysfs);
+		zassert_true(nodes_in_use() <= before + CONFIG_NINEP_SYSFS_NODE_CACHE,
+		             "%u idle nodes kept", nodes_in_use() - before);
+	}
+
+	zassert_equal(ops->walk(bound_sysfs.root, "f0", 2, &bound_sysfs), held,
+	              "held node evicted");
+	ops->clunk(held, &bound_sysfs);
+	ops->clunk(held, &bound_sysfs);
+}
+
+static void *sysfs_node_cache_setup(void)
+{
+	zassert_equal(ninep_sysfs_init(&sysfs, entries, ARRAY_SIZE(entries)), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/value", gen_value,
+	                                        NULL), 0);
+	zassert_equal(ninep_sysfs_register_writable_file_ex(&sysfs, "/ctl",
+	                                                    gen_value, write_value,
+	                                                    count_clunk, NULL), 0);
+	zassert_equal(ninep_sysfs_register_dir(&sysfs, "/dev"), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/dev/led", gen_value,
+	                                        NULL), 0);
+
+	zassert_equal(ninep_sysfs_init(&other_sysfs, other_entries,
+	                               ARRAY_SIZE(other_entries)), 0);
+	zassert_equal(ninep_sysfs_register_file(&other_sysfs, "/value", gen_value,
+	                                        NULL), 0);
+
+	zassert_equal(ninep_sysfs_init(&bound_sysfs, bound_entries,
+	                               ARRAY_SIZE(bound_entries)), 0);
+	for (int i = 0; i < ARRAY_SIZE(bound_files); i++) {
+		zassert_equal(ninep_sysfs_register_file(&bound_sysfs,
+		                                        bound_files[i], gen_value,
+		                                        NULL), 0);
+	}
+	return NULL;
+}
+
+ZTEST_SUITE(sysfs_node_cache, NULL, sysfs_node_cache_setup, NULL, NULL, NULL);
+
+#if defined(CONFIG_NINEP_FS_PASSTHROUGH) && defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+
+#include <zephyr/9p/passthrough_fs.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+
+#define MOUNT_POINT "/lfs"
+#define NUM_FILES   (CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE + 4)
+#define BENCH_REPS  8
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t lfs_mount = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FIXED_PARTITION_ID(storage_partition),
+	.mnt_point = MOUNT_POINT,
+};
+
+static struct ninep_passthrough_fs pfs;
+
+static void write_file(const char *name, const char *data)
+{
+	struct fs_file_t file;
+	char path[64];
+
+	snprintf(path, sizeof(path), MOUNT_POINT "/%s", name);
+	fs_file_t_init(&file);
+	zassert_equal(fs_open(&file, path, FS_O_CREATE | FS_O_WRITE | FS_O_TRUNC), 0);
+	zassert_equal(fs_write(&file, data, strlen(data)), strlen(data));
+	zassert_equal(fs_close(&file), 0);
+}
+
+static struct ninep_fs_node *walk(struct ninep_fs_node *parent, const char *name)
+{
+	return ninep_passthrough_fs_get_ops()->walk(parent, name, strlen(name),
+	                                             &pfs);
+}
+
+static void clunk(struct ninep_fs_node *node)
+{
+	ninep_passthrough_fs_get_ops()->clunk(node, &pfs);
+}
+
+/* Test: walking a path again reuses its node without an fs_stat() */
+ZTEST(passthrough_node_cache, test_repeated_walks)
+{
+	if (CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE == 0) {
+		ztest_test_skip();
+	}
+
+	struct ninep_fs_node *first = walk(pfs.root, "polled");
+
+	zassert_not_null(first);
+	zassert_equal(pfs.node_misses, 1);
+	clunk(first);
+
+	for (int i = 0; i < 100; i++) {
+		struct ninep_fs_node *node = walk(pfs.root, "polled");
+
+		zassert_equal(node, first);
+		clunk(node);
+	}
+	zassert_equal(pfs.node_misses, 1);
+	zassert_equal(pfs.node_hits, 100);
+
+	/* Concurrent fids share the node */
+	struct ninep_fs_node *a = walk(pfs.root, "polled");
+	struct ninep_fs_node *b = walk(pfs.root, "polled");
+
+	zassert_equal(a, b);
+	clunk(a);
+	clunk(b);
+}
+
+/* Test: intermediate directories of a multi-element walk are reused */
+ZTEST(passthrough_node_cache, test_multi_element_walk)
+{
+	uint32_t misses;
+
+	if (CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE == 0) {
+		ztest_test_skip();
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		struct ninep_fs_node *dir = walk(pfs.root, "sub");
+		struct ninep_fs_node *file = walk(dir, "inner");
+
+		zassert_not_null(file);
+		clunk(dir);  /* As the server does with intermediate nodes */
+		clunk(file);
+		if (pass == 0) {
+			misses = pfs.node_misses;
+		}
+	}
+	zassert_equal(pfs.node_misses, misses, "second walk went to fs_stat()");
+}
+
+/* Test: changes through 9P are seen by the next walk */
+ZTEST(passthrough_node_cache, test_invalidation)
+{
+	const struct ninep_fs_ops *ops = ninep_passthrough_fs_get_ops();
+	struct ninep_fs_node *node = walk(pfs.root, "changing");
+
+	zassert_not_null(node);
+	zassert_equal(node->length, 3);
+	zassert_equal(ops->open(node, NINEP_OWRITE, &pfs), 0);
+	zassert_equal(ops->write(node, 3, (const uint8_t *)"more", 4, "test",
+	                         &pfs), 4);
+	clunk(node);
+
+	node = walk(pfs.root, "changing");
+	zassert_equal(node->length, 7, "write not seen by the cached node");
+
+	/* Removed: the next walk goes to the filesystem and fails */
+	zassert_equal(ops->remove(node, &pfs), 0);
+	zassert_is_null(walk(pfs.root, "changing"));
+
+	/* Recreated through 9P: walks find the new node */
+	struct ninep_fs_node *created = NULL;
+
+	zassert_equal(ops->create(pfs.root, "changing", 8, 0644, NINEP_OWRITE,
+	                          "test", &created, &pfs), 0);
+	zassert_not_null(created);
+	zassert_equal(created->length, 0);
+	zassert_equal(walk(pfs.root, "changing"), created);
+	clunk(created);
+	clunk(created);
+}
+
+/* Test: idle nodes are bounded, held nodes are never evicted */
+ZTEST(passthrough_node_cache, test_idle_bound)
+{
+	char name[16];
+	struct ninep_fs_node *held = walk(pfs.root, "f0");
+
+	zassert_not_null(held);
+	for (int i = 1; i < NUM_FILES; i++) {
+		snprintf(name, sizeof(name), "f%d", i);
+		struct ninep_fs_node *node = walk(pfs.root, name);
+
+		zassert_not_null(node);
+		clunk(node);
+		zassert_true(pfs.idle_nodes <= CONFIG_NINEP_FS_PASSTHROUGH_NODE_CACHE);
+	}
+
+	uint32_t misses = pfs.node_misses;
+
+	zassert_equal(walk(pfs.root, "f0"), held, "held node evicted");
+	zassert_equal(pfs.node_misses, misses);
+	clunk(held);
+	clunk(held);
+}
+
+/* Benchmark: walk+clunk of a file, first walk against repeated ones */
+ZTEST(passthrough_node_cache, test_walk_cost)
+{
+	char name[16];
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < NUM_FILES; i++) {
+		snprintf(name, sizeof(name), "f%d", i);
+		clunk(walk(pfs.root, name));
+	}
+	uint32_t cold = (k_cycle_get_32() - start) / NUM_FILES;
+
+	start = k_cycle_get_32();
+	for (int rep = 0; rep < BENCH_REPS; rep++) {
+		clunk(walk(pfs.root, "polled"));
+	}
+	uint32_t warm = (k_cycle_get_32() - start) / BENCH_REPS;
+
+	TC_PRINT("passthrough walk+clunk: fs_stat %u cycles, cached %u cycles\n",
+	         cold, warm);
+}
+
+static void *passthrough_node_cache_setup(void)
+{
+	char name[16];
+	int ret;
+
+	ret = fs_mount(&lfs_mount);
+	zassert_true(ret == 0 || ret == -EBUSY, "mount failed: %d", ret);
+	ret = fs_mkdir(MOUNT_POINT "/sub");
+	zassert_true(ret == 0 || ret == -EEXIST, "mkdir failed: %d", ret);
+	write_file("sub/inner", "i");
+	write_file("polled", "p");
+	for (int i = 0; i < NUM_FILES; i++) {
+		snprintf(name, sizeof(name), "f%d", i);
+		write_file(name, "f");
+	}
+	return NULL;
+}
+
+/* Fresh instance per test */
+static void passthrough_node_cache_before(void *f)
+{
+	write_file("changing", "abc");
+	zassert_equal(ninep_passthrough_fs_init(&pfs, MOUNT_POINT), 0);
+}
+
+ZTEST_SUITE(passthrough_node_cache, NULL, passthrough_node_cache_setup,
+            passthrough_node_cache_before, NULL, NULL);
+
+#endif /* CONFIG_NINEP_FS_PASSTHROUGH && CONFIG_FILE_SYSTEM_LITTLEFS */
+
+#endif /* CONFIG_NINEP_SERVER */
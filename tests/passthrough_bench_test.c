@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Passthrough Open-Handle Tests and Streaming Benchmark
+ *
+ * Runs passthrough_fs over littlefs on the native_sim flash simulator
+ * (storage_partition):
+ * - Sequential and random-offset Treads return the file's bytes
+ * - Data written through one fid is visible to a fid opened afterwards
+ * - More open fids than CONFIG_NINEP_FS_PASSTHROUGH_OPEN_FILES still read
+ *   correctly as handles are evicted and reopened
+ * - More directory fids than littlefs has directories all list fully
+ *   when read in turn, and a finished listing keeps no directory open
+ * - Benchmark: Tread/Twrite streaming throughput with cached handles
+ *   against the previous open/seek/io/close per request
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER) && defined(CONFIG_NINEP_FS_PASSTHROUGH) && \
+	defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/passthrough_fs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MOUNT_POINT  "/lfs"
+#define ROOT_FID     0
+#define FILE_FID     1
+#define OTHER_FID    2
+#define FILE_SIZE    8192  /* Small enough for the native_sim partition */
+#define CHUNK        512
+#define BENCH_REPS   16
+#define NUM_SMALL    (CONFIG_NINEP_FS_PASSTHROUGH_OPEN_FILES + 2)
+#define NUM_LISTED   (CONFIG_FS_LITTLEFS_NUM_DIRS + 1)
+#define DIR_FILES    3
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t lfs_mount = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FIXED_PARTITION_ID(storage_partition),
+	.mnt_point = MOUNT_POINT,
+};
+
+static struct ninep_transport transport;
+static struct ninep_server server;
+static struct ninep_passthrough_fs pfs;
+
+/* passthrough_fs with the previous open/seek/io/close per request */
+static struct ninep_fs_ops uncached_ops;
+
+static uint8_t pattern[FILE_SIZE];
+static uint8_t reply_buf[CHUNK + 64];
+static size_t reply_len;
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(t);
+
+	reply_len = MIN(len, sizeof(reply_buf));
+	memcpy(reply_buf, buf, reply_len);
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops mock_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+/* Test files all live in the root, so the node name gives the path */
+static int uncached_io(struct ninep_fs_node *node, uint64_t offset,
+                       uint8_t *rbuf, const uint8_t *wbuf, uint32_t count)
+{
+	struct fs_file_t file;
+	char path[64];
+	ssize_t n;
+	int ret;
+
+	snprintf(path, sizeof(path), MOUNT_POINT "/%s", node->name);
+	fs_file_t_init(&file);
+	ret = fs_open(&file, path, rbuf ? FS_O_READ : FS_O_WRITE);
+	if (ret < 0) {
+		return ret;
+	}
+	ret = fs_seek(&file, offset, FS_SEEK_SET);
+	if (ret < 0) {
+		fs_close(&file);
+		return ret;
+	}
+	n = rbuf ? fs_read(&file, rbuf, count) : fs_write(&file, wbuf, count);
+	fs_close(&file);
+	return n;
+}
+
+static int uncached_read(struct ninep_fs_node *node, uint64_t offset,
+                         uint8_t *buf, uint32_t count, const char *uname,
+                         void *fs_ctx)
+{
+	return uncached_io(node, offset, buf, NULL, count);
+}
+
+static int uncached_write(struct ninep_fs_node *node, uint64_t offset,
+                          const uint8_t *buf, uint32_t count,
+                          const char *uname, void *fs_ctx)
+{
+	return uncached_io(node, offset, NULL, buf, count);
+}
+
+static int uncached_open(struct ninep_fs_node *node, uint8_t mode, void *fs_ctx)
+{
+	return 0;
+}
+
+static uint8_t process(const uint8_t *msg, int len)
+{
+	zassert_true(len > 0, "message build failed");
+	reply_len = 0;
+	ninep_server_process_message(&server, msg, len);
+	return reply_len >= 7 ? reply_buf[4] : 0;
+}
+
+static void start_server(const struct ninep_fs_ops *ops)
+{
+	struct ninep_server_config config = {
+		.fs_ops = ops,
+		.fs_ctx = &pfs,
+	};
+	uint8_t msg[64];
+	int len;
+
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+
+	len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                           CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+	zassert_equal(process(msg, len), NINEP_RVERSION);
+	len = ninep_build_tattach(msg, sizeof(msg), 1, ROOT_FID, NINEP_NOFID,
+	                          "test", 4, "", 0);
+	zassert_equal(process(msg, len), NINEP_RATTACH);
+}
+
+/* Walk fid to name in the root and open it with mode */
+static void open_file(uint32_t fid, const char *name, uint8_t mode)
+{
+	uint8_t msg[64];
+	uint16_t name_len = strlen(name);
+	int len = ninep_build_twalk(msg, sizeof(msg), 2, ROOT_FID, fid,
+	                            1, &name, &name_len);
+
+	zassert_equal(process(msg, len), NINEP_RWALK, "walk %s", name);
+	len = ninep_build_topen(msg, sizeof(msg), 3, fid, mode);
+	zassert_equal(process(msg, len), NINEP_ROPEN, "open %s", name);
+}
+
+static void clunk(uint32_t fid)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tclunk(msg, sizeof(msg), 4, fid);
+
+	zassert_equal(process(msg, len), NINEP_RCLUNK);
+}
+
+/* Tread; returns the Rread count, payload left at reply_buf[11] */
+static uint32_t read_fid(uint32_t fid, uint64_t offset, uint32_t count)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tread(msg, sizeof(msg), 5, fid, offset, count);
+
+	zassert_equal(process(msg, len), NINEP_RREAD);
+	return sys_get_le32(&reply_buf[7]);
+}
+
+static uint32_t write_fid(uint32_t fid, uint64_t offset, const uint8_t *data,
+                          uint32_t count)
+{
+	static uint8_t msg[CHUNK + 64];
+	int len = ninep_build_twrite(msg, sizeof(msg), 6, fid, offset, count, data);
+
+	zassert_equal(process(msg, len), NINEP_RWRITE);
+	return sys_get_le32(&reply_buf[7]);
+}
+
+static void write_file(const char *name, const uint8_t *data, size_t len)
+{
+	struct fs_file_t file;
+	char path[64];
+
+	snprintf(path, sizeof(path), MOUNT_POINT "/%s", name);
+	fs_file_t_init(&file);
+	zassert_equal(fs_open(&file, path, FS_O_CREATE | FS_O_WRITE | FS_O_TRUNC), 0);
+	zassert_equal(fs_write(&file, data, len), len);
+	zassert_equal(fs_close(&file), 0);
+}
+
+/* Test: sequential and out-of-order reads both return the right bytes */
+ZTEST(passthrough_bench, test_read_offsets)
+{
+	static const uint32_t offsets[] = { 4096, 100, 8000, 0, 513 };
+
+	start_server(ninep_passthrough_fs_get_ops());
+	open_file(FILE_FID, "data", NINEP_OREAD);
+
+	for (uint32_t off = 0; off < FILE_SIZE; off += CHUNK) {
+		zassert_equal(read_fid(FILE_FID, off, CHUNK), CHUNK);
+		zassert_mem_equal(&reply_buf[11], &pattern[off], CHUNK, "at %u", off);
+	}
+	zassert_equal(read_fid(FILE_FID, FILE_SIZE, CHUNK), 0);
+
+	for (int i = 0; i < ARRAY_SIZE(offsets); i++) {
+		uint32_t want = MIN(CHUNK, FILE_SIZE - offsets[i]);
+
+		zassert_equal(read_fid(FILE_FID, offsets[i], CHUNK), want);
+		zassert_mem_equal(&reply_buf[11], &pattern[offsets[i]], want);
+	}
+
+	ninep_server_cleanup(&server);
+}
+
+/* Test: writes held in an open handle are seen by a later fid */
+ZTEST(passthrough_bench, test_write_visible_to_new_fid)
+{
+	static const uint8_t data[] = "written through fid 1";
+	uint8_t msg[32];
+	int len;
+
+	write_file("scratch", (const uint8_t *)"0123456789", 10);
+	start_server(ninep_passthrough_fs_get_ops());
+
+	open_file(FILE_FID, "scratch", NINEP_ORDWR);
+	zassert_equal(write_fid(FILE_FID, 4, data, sizeof(data)), sizeof(data));
+
+	/* Same fid reads its own write */
+	zassert_equal(read_fid(FILE_FID, 0, 4), 4);
+	zassert_mem_equal(&reply_buf[11], "0123", 4);
+
+	/* A new walk sees the new length, a new open the new bytes */
+	open_file(OTHER_FID, "scratch", NINEP_OREAD);
+	len = ninep_build_tstat(msg, sizeof(msg), 7, OTHER_FID);
+	zassert_equal(process(msg, len), NINEP_RSTAT);
+	zassert_equal(sys_get_le64(&reply_buf[9 + 2 + 2 + 4 + 13 + 4 + 4 + 4]),
+	              4 + sizeof(data));
+	zassert_equal(read_fid(OTHER_FID, 4, sizeof(data)), sizeof(data));
+	zassert_mem_equal(&reply_buf[11], data, sizeof(data));
+
+	clunk(FILE_FID);
+	clunk(OTHER_FID);
+	ninep_server_cleanup(&server);
+}
+
+/* Test: round-robin reads over more files than there are handles */
+ZTEST(passthrough_bench, test_handle_eviction)
+{
+	char name[16];
+
+	for (int i = 0; i < NUM_SMALL; i++) {
+		snprintf(name, sizeof(name), "small%d", i);
+		write_file(name, &pattern[i * 64], 64);
+	}
+
+	start_server(ninep_passthrough_fs_get_ops());
+	for (int i = 0; i < NUM_SMALL; i++) {
+		snprintf(name, sizeof(name), "small%d", i);
+		open_file(10 + i, name, NINEP_OREAD);
+	}
+
+	for (int off = 0; off < 64; off += 16) {
+		for (int i = 0; i < NUM_SMALL; i++) {
+			zassert_equal(read_fid(10 + i, off, 16), 16);
+			zassert_mem_equal(&reply_buf[11], &pattern[i * 64 + off], 16,
+			                  "file %d offset %d", i, off);
+		}
+	}
+
+	ninep_server_cleanup(&server);
+}
+
+/* Test: interleaved listings of more directories than littlefs can open */
+ZTEST(passthrough_bench, test_dir_listings)
+{
+	uint64_t off[NUM_LISTED] = { 0 };
+	int seen[NUM_LISTED] = { 0 };
+	bool done[NUM_LISTED] = { 0 };
+	int left = NUM_LISTED;
+	char name[24];
+
+	for (int i = 0; i < NUM_LISTED; i++) {
+		snprintf(name, sizeof(name), MOUNT_POINT "/dir%d", i);
+		int ret = fs_mkdir(name);
+
+		zassert_true(ret == 0 || ret == -EEXIST, "mkdir failed: %d", ret);
+		for (int j = 0; j < DIR_FILES; j++) {
+			snprintf(name, sizeof(name), "dir%d/f%d", i, j);
+			write_file(name, pattern, 1);
+		}
+	}
+
+	start_server(ninep_passthrough_fs_get_ops());
+	for (int i = 0; i < NUM_LISTED; i++) {
+		snprintf(name, sizeof(name), "dir%d", i);
+		open_file(20 + i, name, NINEP_OREAD);
+	}
+
+	/* One record per Tread, round robin, so every listing stays open */
+	while (left > 0) {
+		for (int i = 0; i < NUM_LISTED; i++) {
+			if (done[i]) {
+				continue;
+			}
+
+			uint32_t n = read_fid(20 + i, off[i], 80);
+
+			if (n == 0) {
+				done[i] = true;
+				left--;
+				continue;
+			}
+			for (uint32_t p = 0; p < n;
+			     p += 2 + sys_get_le16(&reply_buf[11 + p])) {
+				seen[i]++;
+			}
+			off[i] += n;
+		}
+	}
+
+	for (int i = 0; i < NUM_LISTED; i++) {
+		zassert_equal(seen[i], DIR_FILES, "dir%d listed %d entries", i,
+		              seen[i]);
+	}
+	for (int i = 0; i < CONFIG_NINEP_FS_PASSTHROUGH_OPEN_DIRS; i++) {
+		zassert_is_null(pfs.dirs[i].cur, "finished listing kept open");
+	}
+
+	ninep_server_cleanup(&server);
+}
+
+/* KiB/s for BENCH_REPS passes over the file in CHUNK-sized requests */
+static uint32_t stream_kib_s(const struct ninep_fs_ops *ops, bool write)
+{
+	start_server(ops);
+	open_file(FILE_FID, "data", write ? NINEP_OWRITE : NINEP_OREAD);
+
+	uint32_t start = k_cycle_get_32();
+
+	for (int rep = 0; rep < BENCH_REPS; rep++) {
+		for (uint32_t off = 0; off < FILE_SIZE; off += CHUNK) {
+			uint32_t n = write ?
+				write_fid(FILE_FID, off, &pattern[off], CHUNK) :
+				read_fid(FILE_FID, off, CHUNK);
+
+			zassert_equal(n, CHUNK);
+		}
+	}
+	uint64_t us = k_cyc_to_us_floor64(k_cycle_get_32() - start);
+
+	clunk(FILE_FID);
+	ninep_server_cleanup(&server);
+
+	return us ? (uint32_t)((uint64_t)FILE_SIZE * BENCH_REPS * 1000000 /
+	                       1024 / us) : 0;
+}
+
+/* Benchmark: streaming a file with and without cached handles */
+ZTEST(passthrough_bench, test_stream_throughput)
+{
+	uint32_t read_before = stream_kib_s(&uncached_ops, false);
+	uint32_t read_after = stream_kib_s(ninep_passthrough_fs_get_ops(), false);
+	uint32_t write_before = stream_kib_s(&uncached_ops, true);
+	uint32_t write_after = stream_kib_s(ninep_passthrough_fs_get_ops(), true);
+
+	TC_PRINT("%d-byte requests over a %d-byte file:\n", CHUNK, FILE_SIZE);
+	TC_PRINT("  Tread:  open/close per request %6u KiB/s, cached %6u KiB/s\n",
+	         read_before, read_after);
+	TC_PRINT("  Twrite: open/close per request %6u KiB/s, cached %6u KiB/s\n",
+	         write_before, write_after);
+}
+
+static void *passthrough_bench_setup(void)
+{
+	int ret;
+
+	transport.ops = &mock_ops;
+
+	for (int i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = (uint8_t)(i * 31 + 7);
+	}
+
+	ret = fs_mount(&lfs_mount);
+	zassert_true(ret == 0 || ret == -EBUSY, "mount failed: %d", ret);
+	write_file("data", pattern, sizeof(pattern));
+
+	zassert_equal(ninep_passthrough_fs_init(&pfs, MOUNT_POINT), 0);
+
+	uncached_ops = *ninep_passthrough_fs_get_ops();
+	uncached_ops.open = uncached_open;
+	uncached_ops.read = uncached_read;
+	uncached_ops.write = uncached_write;
+	uncached_ops.clunk = NULL;
+
+	return NULL;
+}
+
+ZTEST_SUITE(passthrough_bench, NULL, passthrough_bench_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER && CONFIG_NINEP_FS_PASSTHROUGH && CONFIG_FILE_SYSTEM_LITTLEFS */
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Passthrough qid Tests
+ *
+ * Runs passthrough_fs over littlefs on the native_sim flash simulator:
+ * - A file has the same qid.path in Rwalk, Rstat and directory listings,
+ *   across separate walks
+ * - qid.version changes on write, create and remove, never on read
+ * - A path hashing onto a qid.path held by another path is moved off it
+ * - Versions of files evicted from the version table never go backwards
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER) && defined(CONFIG_NINEP_FS_PASSTHROUGH) && \
+	defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/passthrough_fs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MOUNT_POINT "/lfs"
+#define ROOT_FID    0
+#define FID_A       1
+#define FID_B       2
+#define DIR_FID     3
+
+/* Offsets in an Rstat / a stat record */
+#define RSTAT_STAT   9
+#define STAT_QID     (2 + 2 + 4)
+#define STAT_NAME    (STAT_QID + 13 + 4 + 4 + 4 + 8)
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t lfs_mount = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FIXED_PARTITION_ID(storage_partition),
+	.mnt_point = MOUNT_POINT,
+};
+
+static struct ninep_transport transport;
+static struct ninep_server server;
+static struct ninep_passthrough_fs pfs;
+
+static uint8_t reply_buf[2048];
+static size_t reply_len;
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(t);
+
+	reply_len = MIN(len, sizeof(reply_buf));
+	memcpy(reply_buf, buf, reply_len);
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops mock_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+static uint8_t process(const uint8_t *msg, int len)
+{
+	zassert_true(len > 0, "message build failed");
+	reply_len = 0;
+	ninep_server_process_message(&server, msg, len);
+	return reply_len >= 7 ? reply_buf[4] : 0;
+}
+
+static void write_file(const char *name, const char *data)
+{
+	struct fs_file_t file;
+	char path[64];
+
+	snprintf(path, sizeof(path), MOUNT_POINT "/%s", name);
+	fs_file_t_init(&file);
+	zassert_equal(fs_open(&file, path, FS_O_CREATE | FS_O_WRITE | FS_O_TRUNC), 0);
+	zassert_equal(fs_write(&file, data, strlen(data)), strlen(data));
+	zassert_equal(fs_close(&file), 0);
+}
+
+/* Walk fid to name in the root; returns the qid from Rwalk */
+static struct ninep_qid walk(uint32_t fid, const char *name)
+{
+	struct ninep_qid qid;
+	uint8_t msg[64];
+	uint16_t name_len = strlen(name);
+	int len = ninep_build_twalk(msg, sizeof(msg), 2, ROOT_FID, fid,
+	                            1, &name, &name_len);
+
+	zassert_equal(process(msg, len), NINEP_RWALK, "walk %s", name);
+	zassert_equal(sys_get_le16(&reply_buf[7]), 1);
+	qid.type = reply_buf[9];
+	qid.version = sys_get_le32(&reply_buf[10]);
+	qid.path = sys_get_le64(&reply_buf[14]);
+	return qid;
+}
+
+static struct ninep_qid stat_qid(uint32_t fid)
+{
+	struct ninep_qid qid;
+	uint8_t msg[32];
+	int len = ninep_build_tstat(msg, sizeof(msg), 3, fid);
+	const uint8_t *q = &reply_buf[RSTAT_STAT + STAT_QID];
+
+	zassert_equal(process(msg, len), NINEP_RSTAT);
+	qid.type = q[0];
+	qid.version = sys_get_le32(&q[1]);
+	qid.path = sys_get_le64(&q[5]);
+	return qid;
+}
+
+/* qid of name in a full listing of the root */
+static struct ninep_qid listed_qid(const char *name)
+{
+	struct ninep_qid qid = { 0 };
+	uint8_t msg[64];
+	int len = ninep_build_twalk(msg, sizeof(msg), 4, ROOT_FID, DIR_FID,
+	                            0, NULL, NULL);
+	size_t off = 0;
+	bool found = false;
+
+	zassert_equal(process(msg, len), NINEP_RWALK);
+	len = ninep_build_topen(msg, sizeof(msg), 5, DIR_FID, NINEP_OREAD);
+	zassert_equal(process(msg, len), NINEP_ROPEN);
+	len = ninep_build_tread(msg, sizeof(msg), 6, DIR_FID, 0,
+	                        sizeof(reply_buf) - 11);
+	zassert_equal(process(msg, len), NINEP_RREAD);
+
+	const uint8_t *data = &reply_buf[11];
+	uint32_t count = sys_get_le32(&reply_buf[7]);
+
+	while (off + 2 <= count) {
+		const uint8_t *rec = &data[off];
+		uint16_t name_len = sys_get_le16(&rec[STAT_NAME]);
+
+		if (name_len == strlen(name) &&
+		    memcmp(&rec[STAT_NAME + 2], name, name_len) == 0) {
+			qid.type = rec[STAT_QID];
+			qid.version = sys_get_le32(&rec[STAT_QID + 1]);
+			qid.path = sys_get_le64(&rec[STAT_QID + 5]);
+			found = true;
+		}
+		off += 2 + sys_get_le16(rec);
+	}
+	zassert_true(found, "%s not listed", name);
+
+	len = ninep_build_tclunk(msg, sizeof(msg), 7, DIR_FID);
+	zassert_equal(process(msg, len), NINEP_RCLUNK);
+	return qid;
+}
+
+static void open_fid(uint32_t fid, uint8_t mode)
+{
+	uint8_t msg[32];
+	int len = ninep_build_topen(msg, sizeof(msg), 8, fid, mode);
+
+	zassert_equal(process(msg, len), NINEP_ROPEN);
+}
+
+static void write_fid(uint32_t fid, const char *data)
+{
+	uint8_t msg[128];
+	int len = ninep_build_twrite(msg, sizeof(msg), 9, fid, 0, strlen(data),
+	                             (const uint8_t *)data);
+
+	zassert_equal(process(msg, len), NINEP_RWRITE);
+}
+
+static void clunk(uint32_t fid)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tclunk(msg, sizeof(msg), 10, fid);
+
+	zassert_equal(process(msg, len), NINEP_RCLUNK);
+}
+
+/* Test: walk, stat and listing agree, and a second walk gives the same */
+ZTEST(passthrough_qid, test_qid_path_stable)
+{
+	struct ninep_qid a = walk(FID_A, "alpha");
+	struct ninep_qid b = walk(FID_B, "alpha");
+	struct ninep_qid other = walk(DIR_FID, "beta");
+
+	zassert_equal(a.type, NINEP_QTFILE);
+	zassert_equal(a.path, b.path, "two walks, two qids");
+	zassert_equal(a.path, stat_qid(FID_A).path);
+	zassert_not_equal(a.path, other.path);
+	clunk(DIR_FID);
+
+	zassert_equal(listed_qid("alpha").path, a.path);
+	zassert_equal(listed_qid("beta").path, other.path);
+
+	/* Listings do not renumber */
+	zassert_equal(listed_qid("alpha").path, a.path);
+}
+
+/* Test: writes bump qid.version everywhere; reads do not */
+ZTEST(passthrough_qid, test_version_bumped_on_write)
+{
+	struct ninep_qid before = walk(FID_A, "alpha");
+	uint8_t msg[32];
+	int len;
+
+	walk(FID_B, "alpha");
+	open_fid(FID_A, NINEP_ORDWR);
+	len = ninep_build_tread(msg, sizeof(msg), 11, FID_A, 0, 16);
+	zassert_equal(process(msg, len), NINEP_RREAD);
+	zassert_equal(stat_qid(FID_B).version, before.version, "read bumped version");
+
+	write_fid(FID_A, "changed");
+	uint32_t v1 = stat_qid(FID_A).version;
+
+	zassert_not_equal(v1, before.version);
+	zassert_equal(stat_qid(FID_B).version, v1, "other fid sees old version");
+	zassert_equal(listed_qid("alpha").version, v1);
+	zassert_equal(walk(DIR_FID, "alpha").version, v1);
+	clunk(DIR_FID);
+
+	write_fid(FID_A, "again");
+	zassert_not_equal(stat_qid(FID_B).version, v1);
+	zassert_equal(stat_qid(FID_B).path, before.path, "write changed qid.path");
+}
+
+/* Test: remove and recreate under the same name changes qid.version */
+ZTEST(passthrough_qid, test_recreate_changes_version)
+{
+	uint8_t msg[64];
+	struct ninep_qid old;
+	int len;
+
+	write_file("gamma", "first");
+	old = walk(FID_A, "gamma");
+	len = ninep_build_tremove(msg, sizeof(msg), 12, FID_A);
+	zassert_equal(process(msg, len), NINEP_RREMOVE);
+
+	write_file("gamma", "second");
+	struct ninep_qid now = walk(FID_A, "gamma");
+
+	zassert_equal(now.path, old.path);
+	zassert_not_equal(now.version, old.version,
+	                  "recreated file looks unchanged");
+}
+
+/* FNV-1a 64, as the server derives qid.path */
+static uint64_t fnv1a(const char *s)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+
+	while (*s) {
+		h = (h ^ (uint8_t)*s++) * 0x100000001b3ULL;
+	}
+	return h;
+}
+
+/* Test: a path whose hash is taken by another path gets its own qid */
+ZTEST(passthrough_qid, test_collision_rehashed)
+{
+	uint64_t h = fnv1a("/delta");
+	struct ninep_passthrough_qid_slot *slot =
+		&pfs.qid_slots[h % CONFIG_NINEP_FS_PASSTHROUGH_QID_SLOTS];
+
+	uint8_t msg[32];
+	int len;
+
+	write_file("delta", "d");
+	zassert_equal(walk(FID_A, "delta").path, h);
+
+	/* Drop the interned node so the next walk derives the qid again */
+	len = ninep_build_tremove(msg, sizeof(msg), 13, FID_A);
+	zassert_equal(process(msg, len), NINEP_RREMOVE);
+	write_file("delta", "d");
+
+	/* Pretend another path was issued the same value */
+	slot->check ^= 0x5a5a5a5a;
+	struct ninep_qid moved = walk(FID_B, "delta");
+
+	zassert_not_equal(moved.path, h, "collision not detected");
+	zassert_not_equal(moved.path, 0);
+	clunk(FID_B);
+	zassert_equal(walk(FID_B, "delta").path, moved.path,
+	              "rehashed qid not stable");
+}
+
+/* Test: files pushed out of the version table never reuse an old version */
+ZTEST(passthrough_qid, test_evicted_versions_monotonic)
+{
+	const int n = CONFIG_NINEP_FS_PASSTHROUGH_QID_VERSIONS + 2;
+	uint32_t first;
+	char name[16];
+
+	/* Write "v0" via 9P, then enough other files to evict it */
+	for (int i = 0; i < n; i++) {
+		snprintf(name, sizeof(name), "v%d", i);
+		write_file(name, "x");
+		walk(FID_A, name);
+		open_fid(FID_A, NINEP_OWRITE);
+		write_fid(FID_A, "y");
+		if (i == 0) {
+			first = stat_qid(FID_A).version;
+		}
+		clunk(FID_A);
+	}
+
+	uint32_t later = walk(FID_A, "v0").version;
+
+	zassert_true(later >= first, "version went back: %u < %u", later, first);
+	clunk(FID_A);
+
+	/* Writing it again still moves it forward */
+	walk(FID_A, "v0");
+	open_fid(FID_A, NINEP_OWRITE);
+	write_fid(FID_A, "z");
+	zassert_true(stat_qid(FID_A).version > later);
+}
+
+static void *passthrough_qid_setup(void)
+{
+	int ret;
+
+	transport.ops = &mock_ops;
+
+	ret = fs_mount(&lfs_mount);
+	zassert_true(ret == 0 || ret == -EBUSY, "mount failed: %d", ret);
+	write_file("alpha", "a");
+	write_file("beta", "b");
+
+	return NULL;
+}
+
+/* Fresh passthrough instance and session per test */
+static void passthrough_qid_before(void *f)
+{
+	struct ninep_server_config config = {
+		.fs_ops = ninep_passthrough_fs_get_ops(),
+		.fs_ctx = &pfs,
+	};
+	uint8_t msg[64];
+	int len;
+
+	zassert_equal(ninep_passthrough_fs_init(&pfs, MOUNT_POINT), 0);
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+
+	len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                           CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+	zassert_equal(process(msg, len), NINEP_RVERSION);
+	len = ninep_build_tattach(msg, sizeof(msg), 1, ROOT_FID, NINEP_NOFID,
+	                          "test", 4, "", 0);
+	zassert_equal(process(msg, len), NINEP_RATTACH);
+}
+
+static void passthrough_qid_after(void *f)
+{
+	ninep_server_cleanup(&server);
+}
+
+ZTEST_SUITE(passthrough_qid, NULL, passthrough_qid_setup,
+            passthrough_qid_before, passthrough_qid_after, NULL);
+
+#endif /* CONFIG_NINEP_SERVER && CONFIG_NINEP_FS_PASSTHROUGH && CONFIG_FILE_SYSTEM_LITTLEFS */
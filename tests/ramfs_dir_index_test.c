@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * ramfs Directory Index Tests
+ *
+ * - Every entry of a large directory is found by walk, before and after
+ *   the index is built and while it grows
+ * - Listings keep the same order once the directory is indexed
+ * - Removed entries are gone from the index; names can be reused
+ * - Benchmark: walk cost in a large directory with and without the index
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER) && CONFIG_HEAP_MEM_POOL_SIZE >= 131072
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ENTRIES     256
+#define NAME_LEN    8
+#define WALK_REPS   8
+
+static struct ninep_ramfs ramfs;
+static struct ninep_fs_node *dir;
+static uint8_t list_buf[1024];
+
+static void entry_name(char *name, int i)
+{
+	snprintf(name, NAME_LEN, "n%03d", i);
+}
+
+/* Walk name in dir; returns the node (reference dropped again) */
+static struct ninep_fs_node *lookup(const char *name)
+{
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+	struct ninep_fs_node *node = ops->walk(dir, name, strlen(name), &ramfs);
+
+	if (node) {
+		ops->clunk(node, &ramfs);
+	}
+	return node;
+}
+
+/* Fill names with dir's listing, in order; returns the entry count */
+static int list(char names[][NAME_LEN], int max)
+{
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+	struct ninep_dir_cursor cur = { 0 };
+	uint64_t offset = 0;
+	int count = 0;
+
+	for (;;) {
+		int n = ops->readdir(dir, offset, list_buf, sizeof(list_buf),
+		                     &cur, "test", &ramfs);
+
+		zassert_true(n >= 0);
+		if (n == 0) {
+			return count;
+		}
+		for (int off = 0; off < n; ) {
+			uint16_t nlen = sys_get_le16(&list_buf[off + 41]);
+
+			zassert_true(count < max && nlen < NAME_LEN);
+			memcpy(names[count], &list_buf[off + 43], nlen);
+			names[count][nlen] = '\0';
+			count++;
+			off += sys_get_le16(&list_buf[off]) + 2;
+		}
+		offset += n;
+		cur.offset = offset;
+	}
+}
+
+/* Fresh ramfs with an empty dir */
+static void start(uint32_t index_min)
+{
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	ramfs.dir_index_min = index_min;
+	dir = ninep_ramfs_create_dir(&ramfs, ramfs.root, "d");
+	zassert_not_null(dir);
+}
+
+static void populate(int from, int to)
+{
+	char name[NAME_LEN];
+
+	for (int i = from; i < to; i++) {
+		entry_name(name, i);
+		zassert_not_null(ninep_ramfs_create_file(&ramfs, dir, name,
+		                                         NULL, 0));
+	}
+}
+
+/* Test: walk finds every entry while the index is built and grows */
+ZTEST(ramfs_dir_index, test_walk_finds_all)
+{
+	char name[NAME_LEN];
+
+	start(16);
+	for (int i = 0; i < ENTRIES; i++) {
+		populate(i, i + 1);
+		/* Check a spread of entries at every size */
+		for (int j = 0; j <= i; j += 1 + i / 8) {
+			entry_name(name, j);
+			struct ninep_fs_node *node = lookup(name);
+
+			zassert_not_null(node, "%s missing at %d entries", name,
+			                 i + 1);
+			zassert_equal(strcmp(node->name, name), 0);
+		}
+	}
+	for (int i = 0; i < ENTRIES; i++) {
+		entry_name(name, i);
+		zassert_not_null(lookup(name), "%s missing", name);
+	}
+	zassert_is_null(lookup("n999"));
+	zassert_is_null(lookup("n00"));
+	zassert_is_null(lookup("n0000"));
+}
+
+/* Test: building the index does not change the listing */
+ZTEST(ramfs_dir_index, test_listing_order_stable)
+{
+	static char before[ENTRIES][NAME_LEN];
+	static char after[ENTRIES][NAME_LEN];
+	char name[NAME_LEN];
+
+	start(16);
+	populate(0, ENTRIES);
+	zassert_equal(list(before, ENTRIES), ENTRIES);
+
+	/* Newest first, as without an index */
+	entry_name(name, ENTRIES - 1);
+	zassert_equal(strcmp(before[0], name), 0);
+
+	zassert_not_null(lookup("n000"), "index build failed");
+	zassert_equal(list(after, ENTRIES), ENTRIES);
+	zassert_mem_equal(before, after, sizeof(before));
+}
+
+/* Test: removed entries leave the index and their names can be reused */
+ZTEST(ramfs_dir_index, test_remove_and_reuse)
+{
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+	char name[NAME_LEN];
+
+	start(16);
+	populate(0, ENTRIES);
+	zassert_not_null(lookup("n000"));
+
+	for (int i = 0; i < ENTRIES; i += 3) {
+		entry_name(name, i);
+		struct ninep_fs_node *node = ops->walk(dir, name, strlen(name),
+		                                       &ramfs);
+
+		zassert_not_null(node);
+		zassert_equal(ops->remove(node, &ramfs), 0);
+	}
+	for (int i = 0; i < ENTRIES; i++) {
+		entry_name(name, i);
+		if (i % 3 == 0) {
+			zassert_is_null(lookup(name), "%s still found", name);
+		} else {
+			zassert_not_null(lookup(name), "%s lost", name);
+		}
+	}
+
+	entry_name(name, 0);
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, dir, name, NULL, 0));
+	zassert_not_null(lookup(name));
+}
+
+/* Average cycles per walk over every entry, WALK_REPS times */
+static uint32_t walk_cycles(void)
+{
+	char name[NAME_LEN];
+	uint32_t start_cyc = k_cycle_get_32();
+
+	for (int rep = 0; rep < WALK_REPS; rep++) {
+		for (int i = 0; i < ENTRIES; i++) {
+			entry_name(name, i);
+			zassert_not_null(lookup(name));
+		}
+	}
+	return (k_cycle_get_32() - start_cyc) / (WALK_REPS * ENTRIES);
+}
+
+/* Benchmark: walk in a large directory, linear scan against the index */
+ZTEST(ramfs_dir_index, test_walk_cost)
+{
+	struct ninep_ramfs_stats unindexed, indexed;
+
+	start(0);
+	populate(0, ENTRIES);
+	ninep_ramfs_get_stats(&ramfs, &unindexed);
+	uint32_t linear = walk_cycles();
+
+	ramfs.dir_index_min = 16;
+	uint32_t hashed = walk_cycles();
+
+	ninep_ramfs_get_stats(&ramfs, &indexed);
+
+	TC_PRINT("walk in a %d-entry directory: scan %u cycles, index %u cycles\n",
+	         ENTRIES, linear, hashed);
+	TC_PRINT("  index memory: %zu bytes\n",
+	         indexed.meta_bytes - unindexed.meta_bytes);
+}
+
+/* Free the directory so the next test starts with the heap it had */
+static void ramfs_dir_index_after(void *f)
+{
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+
+	while (dir->children) {
+		struct ninep_fs_node *child = dir->children;
+
+		ops->ref(child, &ramfs);
+		zassert_equal(ops->remove(child, &ramfs), 0);
+	}
+	ops->ref(dir, &ramfs);
+	zassert_equal(ops->remove(dir, &ramfs), 0);
+}
+
+ZTEST_SUITE(ramfs_dir_index, NULL, NULL, NULL, ramfs_dir_index_after, NULL);
+
+#endif /* CONFIG_NINEP_SERVER && CONFIG_HEAP_MEM_POOL_SIZE >= 131072 */
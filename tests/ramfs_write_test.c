@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Writable ramfs Tests and Benchmark
+ *
+ * - Tcreate/Twrite/Tread round trip across chunk boundaries, with holes
+ * - Truncation through OTRUNC and ninep_ramfs_truncate()
+ * - Tremove while another fid still holds the file
+ * - -ENOSPC at the instance budget and when the chunk slab runs out
+ * - Static files stay read-only; create_file content moves on first write
+ * - Directory cursors survive a remove between Treads
+ * - Benchmark: Twrite/Tread throughput and memory held per small file
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER) && CONFIG_NINEP_RAMFS_CHUNKS >= 8
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ROOT_FID     0
+#define FILE_FID     1
+#define OTHER_FID    2
+#define DIR_FID      3
+#define CHUNK        CONFIG_NINEP_RAMFS_CHUNK_SIZE
+#define IO_SIZE      512
+#define FILE_SIZE    (CHUNK * (CONFIG_NINEP_RAMFS_CHUNKS / 2))
+#define BENCH_REPS   16
+#define BENCH_FILES  8
+
+static struct ninep_transport transport;
+static struct ninep_server server;
+static struct ninep_ramfs ramfs;
+
+static uint8_t pattern[FILE_SIZE];
+static uint8_t msg_buf[IO_SIZE + 64];
+static uint8_t reply_buf[IO_SIZE + 64];
+static size_t reply_len;
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(t);
+
+	reply_len = MIN(len, sizeof(reply_buf));
+	memcpy(reply_buf, buf, reply_len);
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops mock_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+static uint8_t process(const uint8_t *msg, int len)
+{
+	zassert_true(len > 0, "message build failed");
+	reply_len = 0;
+	ninep_server_process_message(&server, msg, len);
+	return reply_len >= 7 ? reply_buf[4] : 0;
+}
+
+/* Fresh ramfs and session with ROOT_FID attached */
+static void start(void)
+{
+	struct ninep_server_config config = {
+		.fs_ops = ninep_ramfs_get_ops(),
+		.fs_ctx = &ramfs,
+	};
+	int len;
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+
+	len = ninep_build_tversion(msg_buf, sizeof(msg_buf), NINEP_NOTAG,
+	                           CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+	zassert_equal(process(msg_buf, len), NINEP_RVERSION);
+	len = ninep_build_tattach(msg_buf, sizeof(msg_buf), 1, ROOT_FID,
+	                          NINEP_NOFID, "test", 4, "", 0);
+	zassert_equal(process(msg_buf, len), NINEP_RATTACH);
+}
+
+static uint8_t walk(uint32_t fid, uint32_t newfid, const char *name)
+{
+	uint16_t name_len = name ? strlen(name) : 0;
+	int len = ninep_build_twalk(msg_buf, sizeof(msg_buf), 2, fid, newfid,
+	                            name ? 1 : 0, &name, &name_len);
+
+	return process(msg_buf, len);
+}
+
+static uint8_t open_fid(uint32_t fid, uint8_t mode)
+{
+	int len = ninep_build_topen(msg_buf, sizeof(msg_buf), 3, fid, mode);
+
+	return process(msg_buf, len);
+}
+
+/* Clone ROOT_FID into fid and create name there, open for mode */
+static uint8_t create(uint32_t fid, const char *name, uint32_t perm,
+                      uint8_t mode)
+{
+	zassert_equal(walk(ROOT_FID, fid, NULL), NINEP_RWALK);
+
+	int len = ninep_build_tcreate(msg_buf, sizeof(msg_buf), 4, fid, name,
+	                              strlen(name), perm, mode);
+
+	return process(msg_buf, len);
+}
+
+/* Twrite; returns the Rwrite count or -1 on Rerror */
+static int write_fid(uint32_t fid, uint64_t offset, const uint8_t *data,
+                     uint32_t count)
+{
+	int len = ninep_build_twrite(msg_buf, sizeof(msg_buf), 5, fid, offset,
+	                             count, data);
+
+	if (process(msg_buf, len) != NINEP_RWRITE) {
+		return -1;
+	}
+	return sys_get_le32(&reply_buf[7]);
+}
+
+/* Tread; the payload is at reply_buf[11] */
+static int read_fid(uint32_t fid, uint64_t offset, uint32_t count)
+{
+	int len = ninep_build_tread(msg_buf, sizeof(msg_buf), 6, fid, offset,
+	                            count);
+
+	zassert_equal(process(msg_buf, len), NINEP_RREAD);
+	return sys_get_le32(&reply_buf[7]);
+}
+
+static uint8_t remove_fid(uint32_t fid)
+{
+	int len = ninep_build_tremove(msg_buf, sizeof(msg_buf), 7, fid);
+
+	return process(msg_buf, len);
+}
+
+static void clunk(uint32_t fid)
+{
+	int len = ninep_build_tclunk(msg_buf, sizeof(msg_buf), 8, fid);
+
+	zassert_equal(process(msg_buf, len), NINEP_RCLUNK);
+}
+
+/* File length from Rstat */
+static uint64_t stat_length(uint32_t fid)
+{
+	int len = ninep_build_tstat(msg_buf, sizeof(msg_buf), 9, fid);
+
+	zassert_equal(process(msg_buf, len), NINEP_RSTAT);
+	return sys_get_le64(&reply_buf[9 + 33]);
+}
+
+/* Compare [offset, offset + count) of fid with expected */
+static void check_content(uint32_t fid, uint64_t offset,
+                          const uint8_t *expected, uint32_t count)
+{
+	while (count) {
+		int n = read_fid(fid, offset, MIN(count, IO_SIZE));
+
+		zassert_true(n > 0, "short file at %u", (uint32_t)offset);
+		zassert_mem_equal(&reply_buf[11], expected, n,
+		                  "content differs at %u", (uint32_t)offset);
+		offset += n;
+		expected += n;
+		count -= n;
+	}
+}
+
+/* Write pattern[offset, offset + count) in IO_SIZE pieces */
+static void write_pattern(uint32_t fid, uint32_t offset, uint32_t count)
+{
+	for (uint32_t done = 0; done < count; done += IO_SIZE) {
+		uint32_t n = MIN(IO_SIZE, count - done);
+
+		zassert_equal(write_fid(fid, offset + done,
+		                        &pattern[offset + done], n), n);
+	}
+}
+
+/* Test: created files read back what was written, across chunks */
+ZTEST(ramfs_write, test_create_write_read)
+{
+	static const uint8_t zeros[CHUNK];
+	struct ninep_ramfs_stats stats;
+	uint32_t hole_at = CHUNK * 3;
+
+	start();
+	zassert_equal(create(FILE_FID, "f", 0644, NINEP_ORDWR), NINEP_RCREATE);
+
+	/* Unaligned write spanning chunks */
+	zassert_equal(write_fid(FILE_FID, 7, &pattern[7], CHUNK + 10),
+	              CHUNK + 10);
+	check_content(FILE_FID, 7, &pattern[7], CHUNK + 10);
+	zassert_equal(read_fid(FILE_FID, 0, 7), 7);
+	zassert_mem_equal(&reply_buf[11], zeros, 7, "gap before first write");
+
+	/* Writing past the end leaves a hole that reads as zeros and holds
+	 * no chunk */
+	zassert_equal(write_fid(FILE_FID, hole_at, pattern, 16), 16);
+	zassert_equal(stat_length(FILE_FID), hole_at + 16);
+	check_content(FILE_FID, CHUNK * 2, zeros, CHUNK);
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.chunk_bytes, 3 * CHUNK, "hole was allocated");
+
+	/* Visible to a second fid */
+	zassert_equal(walk(ROOT_FID, OTHER_FID, "f"), NINEP_RWALK);
+	zassert_equal(open_fid(OTHER_FID, NINEP_OREAD), NINEP_ROPEN);
+	check_content(OTHER_FID, hole_at, pattern, 16);
+
+	/* Names already taken, and "." / "..", are refused */
+	zassert_equal(create(DIR_FID, "f", 0644, NINEP_OWRITE), NINEP_RERROR);
+	clunk(DIR_FID);
+	zassert_equal(create(DIR_FID, "..", 0644, NINEP_OWRITE), NINEP_RERROR);
+	clunk(DIR_FID);
+
+	/* Directories can be created and then populated */
+	zassert_equal(create(DIR_FID, "d", NINEP_DMDIR | 0755, NINEP_OREAD),
+	              NINEP_RCREATE);
+	clunk(DIR_FID);
+	zassert_equal(walk(ROOT_FID, DIR_FID, "d"), NINEP_RWALK);
+	int len = ninep_build_tcreate(msg_buf, sizeof(msg_buf), 4, DIR_FID,
+	                              "g", 1, 0644, NINEP_OWRITE);
+	zassert_equal(process(msg_buf, len), NINEP_RCREATE);
+
+}
+
+/* Test: OTRUNC and ninep_ramfs_truncate() */
+ZTEST(ramfs_write, test_truncate)
+{
+	static const uint8_t zeros[CHUNK];
+	struct ninep_ramfs_stats stats;
+	struct ninep_fs_node *node;
+
+	start();
+	zassert_equal(create(FILE_FID, "t", 0644, NINEP_OWRITE), NINEP_RCREATE);
+	write_pattern(FILE_FID, 0, CHUNK * 4);
+	clunk(FILE_FID);
+
+	node = ninep_ramfs_get_ops()->walk(ramfs.root, "t", 1, &ramfs);
+	zassert_not_null(node);
+
+	/* Shrink into the middle of a chunk, then grow again: the cut-off
+	 * bytes come back as zeros */
+	zassert_equal(ninep_ramfs_truncate(&ramfs, node, CHUNK + 5), 0);
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.chunk_bytes, 2 * CHUNK);
+	zassert_equal(ninep_ramfs_truncate(&ramfs, node, CHUNK * 3), 0);
+
+	zassert_equal(walk(ROOT_FID, FILE_FID, "t"), NINEP_RWALK);
+	zassert_equal(open_fid(FILE_FID, NINEP_OREAD), NINEP_ROPEN);
+	zassert_equal(stat_length(FILE_FID), CHUNK * 3);
+	check_content(FILE_FID, 0, pattern, CHUNK + 5);
+	check_content(FILE_FID, CHUNK + 5, zeros, CHUNK - 5);
+	check_content(FILE_FID, CHUNK * 2, zeros, CHUNK);
+	clunk(FILE_FID);
+
+	/* Opening with OTRUNC empties the file and frees its chunks */
+	zassert_equal(walk(ROOT_FID, FILE_FID, "t"), NINEP_RWALK);
+	zassert_equal(open_fid(FILE_FID, NINEP_OWRITE | NINEP_OTRUNC),
+	              NINEP_ROPEN);
+	zassert_equal(stat_length(FILE_FID), 0);
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.chunk_bytes, 0);
+	clunk(FILE_FID);
+
+	zassert_equal(ninep_ramfs_truncate(&ramfs, ramfs.root, 0), -EISDIR);
+	ninep_ramfs_get_ops()->clunk(node, &ramfs);
+}
+
+/* Test: a removed file stays readable through fids that still hold it */
+ZTEST(ramfs_write, test_remove_while_open)
+{
+	struct ninep_ramfs_stats before, stats;
+
+	start();
+	ninep_ramfs_get_stats(&ramfs, &before);
+	zassert_equal(create(FILE_FID, "r", 0644, NINEP_ORDWR), NINEP_RCREATE);
+	write_pattern(FILE_FID, 0, CHUNK * 2);
+
+	zassert_equal(walk(ROOT_FID, OTHER_FID, "r"), NINEP_RWALK);
+	zassert_equal(remove_fid(OTHER_FID), NINEP_RREMOVE);
+	zassert_equal(walk(ROOT_FID, OTHER_FID, "r"), NINEP_RERROR,
+	              "removed file still in its directory");
+
+	/* The open fid reads the data it had; writes are refused */
+	check_content(FILE_FID, 0, pattern, CHUNK * 2);
+	zassert_equal(write_fid(FILE_FID, 0, pattern, 1), -1);
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.nodes, before.nodes + 1);
+
+	/* The node and its chunks go with the last fid */
+	clunk(FILE_FID);
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.nodes, before.nodes);
+	zassert_equal(stats.chunk_bytes, 0);
+	zassert_equal(stats.meta_bytes, before.meta_bytes);
+
+	/* Non-empty directories and the root cannot be removed */
+	zassert_equal(create(DIR_FID, "d", NINEP_DMDIR | 0755, NINEP_OREAD),
+	              NINEP_RCREATE);
+	clunk(DIR_FID);
+	zassert_not_null(ninep_ramfs_create_file(&ramfs,
+	                 ninep_ramfs_get_ops()->walk(ramfs.root, "d", 1, &ramfs),
+	                 "x", NULL, 0));
+	zassert_equal(walk(ROOT_FID, DIR_FID, "d"), NINEP_RWALK);
+	zassert_equal(remove_fid(DIR_FID), NINEP_RERROR);
+	zassert_equal(walk(ROOT_FID, OTHER_FID, NULL), NINEP_RWALK);
+	zassert_equal(remove_fid(OTHER_FID), NINEP_RERROR);
+
+}
+
+/* Test: writes beyond the byte budget or the slab fail with ENOSPC */
+ZTEST(ramfs_write, test_budget)
+{
+	struct ninep_ramfs_stats stats;
+
+	start();
+	ramfs.max_bytes = CHUNK * 2;
+	zassert_equal(create(FILE_FID, "b", 0644, NINEP_OWRITE), NINEP_RCREATE);
+
+	zassert_equal(write_fid(FILE_FID, 0, pattern, CHUNK), CHUNK);
+	/* Needs two more chunks; nothing is allocated for a refused write */
+	zassert_equal(write_fid(FILE_FID, CHUNK, pattern, CHUNK + 1), -1);
+	zassert_equal(stat_length(FILE_FID), CHUNK);
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.chunk_bytes, CHUNK);
+	zassert_equal(write_fid(FILE_FID, CHUNK, pattern, CHUNK), CHUNK);
+
+	/* Overwriting held chunks needs no more budget */
+	zassert_equal(write_fid(FILE_FID, 3, pattern, CHUNK), CHUNK);
+	clunk(FILE_FID);
+
+	zassert_equal(walk(ROOT_FID, FILE_FID, "b"), NINEP_RWALK);
+	zassert_equal(remove_fid(FILE_FID), NINEP_RREMOVE);
+
+	/* Without an instance budget the shared slab is the limit */
+	ramfs.max_bytes = 0;
+	zassert_equal(create(FILE_FID, "s", 0644, NINEP_OWRITE), NINEP_RCREATE);
+	for (int i = 0; i < CONFIG_NINEP_RAMFS_CHUNKS; i++) {
+		zassert_equal(write_fid(FILE_FID, i * CHUNK, pattern, 1), 1);
+	}
+	zassert_equal(write_fid(FILE_FID, CONFIG_NINEP_RAMFS_CHUNKS * CHUNK,
+	                        pattern, 1), -1, "slab overcommitted");
+	zassert_equal(remove_fid(FILE_FID), NINEP_RREMOVE);
+	zassert_equal(create(FILE_FID, "s", 0644, NINEP_OWRITE), NINEP_RCREATE);
+	zassert_equal(write_fid(FILE_FID, 0, pattern, 1), 1, "chunks not freed");
+
+}
+
+/* Test: static files are read-only; copied files move to chunks */
+ZTEST(ramfs_write, test_static_and_copied_files)
+{
+	const char *hello = "hello, world";
+	struct ninep_ramfs_stats stats;
+
+	start();
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, ramfs.root,
+	                                                "static", pattern, 64));
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root, "copied",
+	                                         hello, strlen(hello)));
+
+	zassert_equal(walk(ROOT_FID, FILE_FID, "static"), NINEP_RWALK);
+	zassert_equal(open_fid(FILE_FID, NINEP_OWRITE), NINEP_RERROR);
+	zassert_equal(open_fid(FILE_FID, NINEP_OREAD | NINEP_OTRUNC),
+	              NINEP_RERROR);
+	zassert_equal(open_fid(FILE_FID, NINEP_OREAD), NINEP_ROPEN);
+	zassert_equal(write_fid(FILE_FID, 0, pattern, 1), -1);
+	check_content(FILE_FID, 0, pattern, 64);
+	clunk(FILE_FID);
+
+	/* Patch the middle of a copied file: the rest survives the move */
+	zassert_equal(walk(ROOT_FID, FILE_FID, "copied"), NINEP_RWALK);
+	zassert_equal(open_fid(FILE_FID, NINEP_ORDWR), NINEP_ROPEN);
+	zassert_equal(write_fid(FILE_FID, 5, (const uint8_t *)";", 1), 1);
+	check_content(FILE_FID, 0, (const uint8_t *)"hello; world",
+	              strlen(hello));
+	ninep_ramfs_get_stats(&ramfs, &stats);
+	zassert_equal(stats.chunk_bytes, CHUNK);
+
+}
+
+/* Test: a directory listing continues correctly after a remove */
+ZTEST(ramfs_write, test_readdir_after_remove)
+{
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+	struct ninep_dir_cursor cur = { 0 };
+	static uint8_t buf[512];
+	char name[8];
+	int first, rest;
+
+	start();
+	for (int i = 0; i < 4; i++) {
+		snprintf(name, sizeof(name), "e%d", i);
+		zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root,
+		                                         name, NULL, 0));
+	}
+
+	/* One entry, then remove the one the cursor points at next */
+	first = ops->readdir(ramfs.root, 0, buf, 80, &cur, "test", &ramfs);
+	zassert_true(first > 0);
+	zassert_not_equal(cur.pos, 0);
+
+	struct ninep_fs_node *next = (struct ninep_fs_node *)cur.pos;
+
+	zassert_equal(walk(ROOT_FID, FILE_FID, next->name), NINEP_RWALK);
+	zassert_equal(remove_fid(FILE_FID), NINEP_RREMOVE);
+
+	cur.offset = first;
+	rest = ops->readdir(ramfs.root, first, buf, sizeof(buf), &cur, "test",
+	                    &ramfs);
+	zassert_true(rest > 0);
+
+	/* Whatever is listed now is a live child, read from a rescan */
+	uint32_t entries = 0;
+
+	for (int off = 0; off < rest; ) {
+		uint16_t size = sys_get_le16(&buf[off]);
+		uint16_t nlen = sys_get_le16(&buf[off + 41]);
+
+		zassert_not_null(ops->walk(ramfs.root,
+		                           (const char *)&buf[off + 43], nlen,
+		                           &ramfs), "listed a removed entry");
+		off += size + 2;
+		entries++;
+	}
+	zassert_equal(entries, 2);
+
+}
+
+/* KiB/s for BENCH_REPS passes over a FILE_SIZE file in IO_SIZE requests */
+static uint32_t stream_kib_s(bool write)
+{
+	uint32_t start_cyc = k_cycle_get_32();
+
+	for (int rep = 0; rep < BENCH_REPS; rep++) {
+		for (uint32_t off = 0; off < FILE_SIZE; off += IO_SIZE) {
+			uint32_t n = MIN(IO_SIZE, FILE_SIZE - off);
+
+			if (write) {
+				zassert_equal(write_fid(FILE_FID, off,
+				                        &pattern[off], n), n);
+			} else {
+				zassert_equal(read_fid(FILE_FID, off, n), n);
+			}
+		}
+	}
+	uint64_t us = k_cyc_to_us_floor64(k_cycle_get_32() - start_cyc);
+
+	return us ? (uint32_t)((uint64_t)FILE_SIZE * BENCH_REPS * 1000000 /
+	                       1024 / us) : 0;
+}
+
+/* Benchmark: streaming throughput and memory held per small file */
+ZTEST(ramfs_write, test_bench)
+{
+	struct ninep_ramfs_stats empty, stats;
+	char name[8];
+
+	start();
+	zassert_equal(create(FILE_FID, "big", 0644, NINEP_ORDWR), NINEP_RCREATE);
+
+	uint32_t write_first = stream_kib_s(true);
+	uint32_t write_over = stream_kib_s(true);
+	uint32_t read = stream_kib_s(false);
+
+	zassert_equal(remove_fid(FILE_FID), NINEP_RREMOVE);
+
+	ninep_ramfs_get_stats(&ramfs, &empty);
+	for (int i = 0; i < BENCH_FILES; i++) {
+		snprintf(name, sizeof(name), "s%d", i);
+		zassert_equal(create(FILE_FID, name, 0644, NINEP_OWRITE),
+		              NINEP_RCREATE);
+		zassert_equal(write_fid(FILE_FID, 0, pattern, 16), 16);
+		clunk(FILE_FID);
+	}
+	ninep_ramfs_get_stats(&ramfs, &stats);
+
+	size_t meta = (stats.meta_bytes - empty.meta_bytes) / BENCH_FILES;
+	size_t data = (stats.chunk_bytes - empty.chunk_bytes) / BENCH_FILES;
+
+	TC_PRINT("%d-byte requests over a %d-byte file, %d-byte chunks:\n",
+	         IO_SIZE, FILE_SIZE, CHUNK);
+	TC_PRINT("  Twrite: %6u KiB/s (allocating), %6u KiB/s (overwrite)\n",
+	         write_first, write_over);
+	TC_PRINT("  Tread:  %6u KiB/s\n", read);
+	TC_PRINT("  16-byte file: %zu bytes of node/table + %zu bytes of chunk\n",
+	         meta, data);
+
+}
+
+static void *ramfs_write_setup(void)
+{
+	for (int i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = (uint8_t)(i * 13 + 5);
+	}
+	transport.ops = &mock_ops;
+	return NULL;
+}
+
+/* Remove everything under dir so the next test starts with a full slab */
+static void clear_dir(struct ninep_fs_node *dir)
+{
+	const struct ninep_fs_ops *ops = ninep_ramfs_get_ops();
+
+	while (dir->children) {
+		struct ninep_fs_node *child = dir->children;
+
+		clear_dir(child);
+		ops->ref(child, &ramfs);
+		zassert_equal(ops->remove(child, &ramfs), 0);
+	}
+}
+
+static void ramfs_write_after(void *f)
+{
+	ninep_server_cleanup(&server);
+	clear_dir(ramfs.root);
+}
+
+ZTEST_SUITE(ramfs_write, NULL, ramfs_write_setup, NULL, ramfs_write_after,
+            NULL);
+
+#endif /* CONFIG_NINEP_SERVER && CONFIG_NINEP_RAMFS_CHUNKS >= 8 */
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Zero-Copy Read Tests (read_ref fs op)
+ *
+ * - Static sysfs files and ramfs files are sent straight from their
+ *   storage when the transport has sendv
+ * - Without sendv the same reads are copied into the response buffer
+ * - Generated files and directories fall back to read()
+ * - The release callback runs once per Tread, after the reply is sent
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#define ROOT_FID 0
+#define FILE_FID 1
+
+static struct ninep_transport transport;
+static struct ninep_server sysfs_server;
+static struct ninep_server ramfs_server;
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry sysfs_entries[4];
+static struct ninep_ramfs ramfs;
+
+static uint8_t asset[300];
+
+/* Last reply, gathered; and the data piece of the last sendv */
+static uint8_t reply_buf[512];
+static size_t reply_len;
+static const void *sent_data;
+static int sendv_calls;
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(t);
+
+	reply_len = MIN(len, sizeof(reply_buf));
+	memcpy(reply_buf, buf, reply_len);
+	sent_data = NULL;
+	return 0;
+}
+
+static int mock_sendv(struct ninep_transport *t,
+                      const struct ninep_iovec *iov, int iovcnt)
+{
+	ARG_UNUSED(t);
+
+	reply_len = 0;
+	for (int i = 0; i < iovcnt; i++) {
+		zassert_true(reply_len + iov[i].len <= sizeof(reply_buf));
+		memcpy(&reply_buf[reply_len], iov[i].base, iov[i].len);
+		reply_len += iov[i].len;
+	}
+	sent_data = iovcnt > 1 ? iov[1].base : NULL;
+	sendv_calls++;
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops copy_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+static const struct ninep_transport_ops sg_ops = {
+	.send = mock_send,
+	.sendv = mock_sendv,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+/* ramfs with a release callback, to check when borrowed data is returned */
+static struct ninep_fs_ops counting_ops;
+static int releases;
+static int replies_at_release;
+
+static void count_release(void *arg)
+{
+	zassert_equal_ptr(arg, &ramfs);
+	replies_at_release = sendv_calls;
+	releases++;
+}
+
+static int counting_read_ref(struct ninep_fs_node *node, uint64_t offset,
+                             uint32_t count, const char *uname,
+                             struct ninep_read_ref *ref, void *fs_ctx)
+{
+	int ret = ninep_ramfs_get_ops()->read_ref(node, offset, count, uname,
+	                                          ref, fs_ctx);
+
+	if (ret == 0) {
+		ref->release = count_release;
+		ref->release_arg = fs_ctx;
+	}
+	return ret;
+}
+
+static uint8_t process(struct ninep_server *server, const uint8_t *msg, int len)
+{
+	zassert_true(len > 0, "message build failed");
+	reply_len = 0;
+	ninep_server_process_message(server, msg, len);
+	return reply_len >= 7 ? reply_buf[4] : 0;
+}
+
+/* New session with FILE_FID walked to name and opened for reading */
+static void open_file(struct ninep_server *server, const char *name)
+{
+	uint8_t msg[64];
+	uint16_t name_len = strlen(name);
+	int len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                               CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+
+	zassert_equal(process(server, msg, len), NINEP_RVERSION);
+	len = ninep_build_tattach(msg, sizeof(msg), 1, ROOT_FID, NINEP_NOFID,
+	                          "test", 4, "", 0);
+	zassert_equal(process(server, msg, len), NINEP_RATTACH);
+	len = ninep_build_twalk(msg, sizeof(msg), 2, ROOT_FID, FILE_FID,
+	                        1, &name, &name_len);
+	zassert_equal(process(server, msg, len), NINEP_RWALK, "walk %s", name);
+	len = ninep_build_topen(msg, sizeof(msg), 3, FILE_FID, NINEP_OREAD);
+	zassert_equal(process(server, msg, len), NINEP_ROPEN);
+}
+
+/* Tread on fid; returns the Rread count and points *data at the payload */
+static int read_fid(struct ninep_server *server, uint32_t fid,
+                    uint64_t offset, uint32_t count, const uint8_t **data)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tread(msg, sizeof(msg), 4, fid, offset, count);
+
+	zassert_equal(process(server, msg, len), NINEP_RREAD);
+	*data = &reply_buf[11];
+	return sys_get_le32(&reply_buf[7]);
+}
+
+/* Test: a static sysfs file goes out from its own storage */
+ZTEST(read_ref, test_static_sysfs_sendv_zero_copy)
+{
+	const uint8_t *data;
+	int n;
+
+	transport.ops = &sg_ops;
+	open_file(&sysfs_server, "asset");
+
+	n = read_fid(&sysfs_server, FILE_FID, 5, 100, &data);
+	zassert_equal(n, 100);
+	zassert_equal_ptr(sent_data, &asset[5], "data was copied");
+	zassert_mem_equal(data, &asset[5], 100);
+
+	/* Short read at the tail, then EOF */
+	n = read_fid(&sysfs_server, FILE_FID, 250, 100, &data);
+	zassert_equal(n, 50);
+	zassert_mem_equal(data, &asset[250], 50);
+	n = read_fid(&sysfs_server, FILE_FID, sizeof(asset), 100, &data);
+	zassert_equal(n, 0);
+}
+
+/* Test: without sendv the borrowed data is copied into the reply once */
+ZTEST(read_ref, test_static_sysfs_copy_fallback)
+{
+	const uint8_t *data;
+	int n;
+
+	transport.ops = &copy_ops;
+	open_file(&sysfs_server, "asset");
+
+	n = read_fid(&sysfs_server, FILE_FID, 0, 64, &data);
+	zassert_equal(n, 64);
+	zassert_mem_equal(data, asset, 64);
+	zassert_equal(reply_len, 11 + 64);
+}
+
+/* Test: generated sysfs files and directories still use read() */
+ZTEST(read_ref, test_generated_and_dirs_fall_back)
+{
+	const uint8_t *data;
+	uint8_t msg[32];
+	int len;
+
+	transport.ops = &sg_ops;
+	open_file(&sysfs_server, "version");
+	zassert_equal(read_fid(&sysfs_server, FILE_FID, 0, 64, &data), 3);
+	zassert_mem_equal(data, "1.0", 3);
+
+	/* Directory listing of the root */
+	len = ninep_build_topen(msg, sizeof(msg), 5, ROOT_FID, NINEP_OREAD);
+	zassert_equal(process(&sysfs_server, msg, len), NINEP_ROPEN);
+	zassert_true(read_fid(&sysfs_server, ROOT_FID, 0, 512, &data) > 0,
+	             "empty root listing");
+}
+
+/* Test: ramfs files, copied or static, are read in place */
+ZTEST(read_ref, test_ramfs_read_in_place)
+{
+	const uint8_t *data;
+	int n;
+
+	transport.ops = &sg_ops;
+	open_file(&ramfs_server, "copied");
+	n = read_fid(&ramfs_server, FILE_FID, 10, 20, &data);
+	zassert_equal(n, 20);
+	zassert_not_null(sent_data, "no zero-copy piece");
+	zassert_mem_equal(data, &asset[10], 20);
+
+	open_file(&ramfs_server, "static");
+	n = read_fid(&ramfs_server, FILE_FID, 0, 200, &data);
+	zassert_equal(n, 200);
+	zassert_equal_ptr(sent_data, asset);
+	zassert_equal(releases, 0, "ramfs data needs no release");
+}
+
+/* Test: release runs once per Tread, after the reply went out */
+ZTEST(read_ref, test_release_after_send)
+{
+	static struct ninep_server server;
+	struct ninep_server_config config = {
+		.fs_ops = &counting_ops,
+		.fs_ctx = &ramfs,
+	};
+	const uint8_t *data;
+
+	transport.ops = &sg_ops;
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+	open_file(&server, "static");
+
+	releases = 0;
+	sendv_calls = 0;
+	zassert_equal(read_fid(&server, FILE_FID, 0, 16, &data), 16);
+	zassert_equal(read_fid(&server, FILE_FID, sizeof(asset), 16, &data), 0);
+	zassert_equal(releases, 2);
+	zassert_equal(replies_at_release, 2, "released before the reply was sent");
+
+	ninep_server_cleanup(&server);
+}
+
+static int gen_version(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	if (offset > 0 || buf_size < 3) {
+		return 0;
+	}
+	memcpy(buf, "1.0", 3);
+	return 3;
+}
+
+static void *read_ref_setup(void)
+{
+	struct ninep_server_config sysfs_config = {
+		.fs_ops = ninep_sysfs_get_ops(),
+		.fs_ctx = &sysfs,
+	};
+	struct ninep_server_config ramfs_config = {
+		.fs_ops = ninep_ramfs_get_ops(),
+		.fs_ctx = &ramfs,
+	};
+
+	for (int i = 0; i < sizeof(asset); i++) {
+		asset[i] = (uint8_t)(i * 7 + 1);
+	}
+
+	transport.ops = &copy_ops;
+
+	zassert_equal(ninep_sysfs_init(&sysfs, sysfs_entries,
+	                               ARRAY_SIZE(sysfs_entries)), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/asset",
+	                                               asset, sizeof(asset)), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/version",
+	                                        gen_version, NULL), 0);
+	zassert_equal(ninep_server_init(&sysfs_server, &sysfs_config,
+	                                &transport), 0);
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root, "copied",
+	                                         asset, sizeof(asset)));
+	zassert_not_null(ninep_ramfs_create_static_file(&ramfs, ramfs.root,
+	                                                "static", asset,
+	                                                sizeof(asset)));
+	zassert_equal(ninep_server_init(&ramfs_server, &ramfs_config,
+	                                &transport), 0);
+
+	counting_ops = *ninep_ramfs_get_ops();
+	counting_ops.read_ref = counting_read_ref;
+
+	return NULL;
+}
+
+static void read_ref_teardown(void *f)
+{
+	ninep_server_cleanup(&sysfs_server);
+	ninep_server_cleanup(&ramfs_server);
+}
+
+ZTEST_SUITE(read_ref, NULL, read_ref_setup, NULL, NULL, read_ref_teardown);
+
+#endif /* CONFIG_NINEP_SERVER */
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Directory Cursor Tests (readdir fs op)
+ *
+ * - Sequential reads through a per-fid cursor list every entry exactly
+ *   once, byte-identical to the rescanning read() path
+ * - A read at offset 0 (or any non-sequential offset) starts over
+ * - sysfs lists implied directories once, as directories
+ * - releasedir runs when a fid holding cursor state is clunked
+ * - Benchmark: listing a large ramfs directory with and without cursors
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ROOT_FID     0
+#define DIR_FID      1
+#define NUM_FILES    128
+#define CHUNK        512   /* Tread count: a handful of records per read */
+#define LISTING_MAX  (NUM_FILES * 64)
+
+static struct ninep_transport transport;
+static struct ninep_server server;
+static struct ninep_ramfs ramfs;
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry sysfs_entries[8];
+static char file_names[NUM_FILES][16];
+
+/* ramfs without readdir: every directory read rescans */
+static struct ninep_fs_ops rescan_ops;
+/* ramfs whose cursors carry state, to observe releasedir */
+static struct ninep_fs_ops stateful_ops;
+static int releasedir_calls;
+static int cursor_token;
+
+static uint8_t reply_buf[CONFIG_NINEP_MAX_MESSAGE_SIZE];
+static size_t reply_len;
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(t);
+
+	reply_len = MIN(len, sizeof(reply_buf));
+	memcpy(reply_buf, buf, reply_len);
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops mock_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+static int stateful_readdir(struct ninep_fs_node *node, uint64_t offset,
+                            uint8_t *buf, uint32_t count,
+                            struct ninep_dir_cursor *cur, const char *uname,
+                            void *fs_ctx)
+{
+	cur->state = &cursor_token;
+	return ninep_ramfs_get_ops()->readdir(node, offset, buf, count, cur,
+	                                      uname, fs_ctx);
+}
+
+static void stateful_releasedir(struct ninep_fs_node *node,
+                                struct ninep_dir_cursor *cur, void *fs_ctx)
+{
+	zassert_equal_ptr(cur->state, &cursor_token);
+	releasedir_calls++;
+}
+
+static uint8_t process(const uint8_t *msg, int len)
+{
+	zassert_true(len > 0, "message build failed");
+	reply_len = 0;
+	ninep_server_process_message(&server, msg, len);
+	return reply_len >= 7 ? reply_buf[4] : 0;
+}
+
+static void start_server(const struct ninep_fs_ops *ops, void *ctx)
+{
+	struct ninep_server_config config = {
+		.fs_ops = ops,
+		.fs_ctx = ctx,
+	};
+	uint8_t msg[64];
+	int len;
+
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+
+	len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                           CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+	zassert_equal(process(msg, len), NINEP_RVERSION);
+	len = ninep_build_tattach(msg, sizeof(msg), 1, ROOT_FID, NINEP_NOFID,
+	                          "test", 4, "", 0);
+	zassert_equal(process(msg, len), NINEP_RATTACH);
+}
+
+/* Walk DIR_FID to path (NULL = root) and open it */
+static void open_dir(const char *path)
+{
+	uint8_t msg[64];
+	uint16_t name_len = path ? strlen(path) : 0;
+	int len = ninep_build_twalk(msg, sizeof(msg), 2, ROOT_FID, DIR_FID,
+	                            path ? 1 : 0, &path, &name_len);
+
+	zassert_equal(process(msg, len), NINEP_RWALK);
+	len = ninep_build_topen(msg, sizeof(msg), 3, DIR_FID, NINEP_OREAD);
+	zassert_equal(process(msg, len), NINEP_ROPEN);
+}
+
+static void clunk_dir(void)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tclunk(msg, sizeof(msg), 4, DIR_FID);
+
+	zassert_equal(process(msg, len), NINEP_RCLUNK);
+}
+
+/* One Tread on DIR_FID; copies the data to out and returns its length */
+static uint32_t read_dir(uint64_t offset, uint8_t *out)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tread(msg, sizeof(msg), 5, DIR_FID, offset, CHUNK);
+
+	zassert_equal(process(msg, len), NINEP_RREAD);
+
+	uint32_t n = sys_get_le32(&reply_buf[7]);
+
+	memcpy(out, &reply_buf[11], n);
+	return n;
+}
+
+/* Read the whole directory sequentially into out; returns total bytes */
+static size_t list_dir(uint8_t *out, size_t out_size)
+{
+	size_t total = 0;
+	uint32_t n;
+
+	do {
+		zassert_true(total + CHUNK <= out_size, "listing too large");
+		n = read_dir(total, &out[total]);
+		total += n;
+	} while (n > 0);
+
+	return total;
+}
+
+/* Names of the stat records in a listing, as "a,b,c," */
+static int listing_names(const uint8_t *buf, size_t len, char *names,
+                         size_t names_size, uint32_t *modes)
+{
+	size_t off = 0;
+	size_t pos = 0;
+	int n = 0;
+
+	names[0] = '\0';
+	while (off + 2 <= len) {
+		uint16_t size = sys_get_le16(&buf[off]);
+		uint16_t name_len = sys_get_le16(&buf[off + 41]);
+
+		if (modes) {
+			modes[n] = sys_get_le32(&buf[off + 2 + 2 + 4 + 13]);
+		}
+		pos += snprintf(&names[pos], names_size - pos, "%.*s,",
+		                name_len, &buf[off + 43]);
+		off += 2 + size;
+		n++;
+	}
+	zassert_equal(off, len, "listing has a partial record");
+	return n;
+}
+
+/* Test: a cursor listing matches the rescanning listing byte for byte */
+ZTEST(readdir, test_cursor_listing_matches_rescan)
+{
+	static uint8_t with_cursor[LISTING_MAX];
+	static uint8_t rescanned[LISTING_MAX];
+	static char names[LISTING_MAX];
+	size_t a, b;
+
+	start_server(ninep_ramfs_get_ops(), &ramfs);
+	open_dir(NULL);
+	a = list_dir(with_cursor, sizeof(with_cursor));
+	ninep_server_cleanup(&server);
+
+	start_server(&rescan_ops, &ramfs);
+	open_dir(NULL);
+	b = list_dir(rescanned, sizeof(rescanned));
+	ninep_server_cleanup(&server);
+
+	zassert_equal(a, b, "listing sizes differ");
+	zassert_mem_equal(with_cursor, rescanned, a);
+	zassert_equal(listing_names(with_cursor, a, names, sizeof(names), NULL),
+	              NUM_FILES);
+	for (int i = 0; i < NUM_FILES; i++) {
+		char key[20];
+
+		snprintf(key, sizeof(key), "%s,", file_names[i]);
+		zassert_not_null(strstr(names, key), "%s missing", file_names[i]);
+	}
+}
+
+/* Test: rereading from offset 0, or jumping, restarts the scan */
+ZTEST(readdir, test_restart_and_nonsequential_offsets)
+{
+	static uint8_t first[CHUNK], second[CHUNK], buf[CHUNK];
+	uint32_t n1, n2;
+
+	start_server(ninep_ramfs_get_ops(), &ramfs);
+	open_dir(NULL);
+
+	n1 = read_dir(0, first);
+	n2 = read_dir(n1, second);
+	zassert_true(n1 > 0 && n2 > 0);
+	read_dir(n1 + n2, buf);
+
+	/* Rewind, then continue: the same first two chunks */
+	zassert_equal(read_dir(0, buf), n1);
+	zassert_mem_equal(buf, first, n1);
+	zassert_equal(read_dir(n1, buf), n2);
+	zassert_mem_equal(buf, second, n2);
+
+	/* Jump back to an offset the cursor has already passed */
+	read_dir(n1 + n2, buf);
+	zassert_equal(read_dir(n1, buf), n2);
+	zassert_mem_equal(buf, second, n2);
+
+	ninep_server_cleanup(&server);
+}
+
+/* Test: sysfs lists each child once; implied directories are directories */
+ZTEST(readdir, test_sysfs_children)
+{
+	static uint8_t listing[1024];
+	char names[256];
+	uint32_t modes[8];
+	size_t len;
+	int n;
+
+	start_server(ninep_sysfs_get_ops(), &sysfs);
+
+	open_dir(NULL);
+	len = list_dir(listing, sizeof(listing));
+	n = listing_names(listing, len, names, sizeof(names), modes);
+	zassert_equal(n, 3, "root: %s", names);
+	zassert_equal(strcmp(names, "dev,sys,version,"), 0, "root: %s", names);
+	zassert_true(modes[0] & NINEP_DMDIR, "dev not a directory");
+	zassert_true(modes[1] & NINEP_DMDIR, "sys not a directory");
+	zassert_false(modes[2] & NINEP_DMDIR, "version is a file");
+	clunk_dir();
+
+	open_dir("sys");
+	len = list_dir(listing, sizeof(listing));
+	n = listing_names(listing, len, names, sizeof(names), NULL);
+	zassert_equal(strcmp(names, "uptime,net,clock,"), 0, "sys: %s", names);
+
+	ninep_server_cleanup(&server);
+}
+
+/* Test: cursor state is handed back on clunk */
+ZTEST(readdir, test_releasedir_on_clunk)
+{
+	uint8_t buf[CHUNK];
+
+	releasedir_calls = 0;
+	start_server(&stateful_ops, &ramfs);
+
+	open_dir(NULL);
+	clunk_dir();
+	zassert_equal(releasedir_calls, 0, "no state to release yet");
+
+	open_dir(NULL);
+	read_dir(0, buf);
+	clunk_dir();
+	zassert_equal(releasedir_calls, 1);
+
+	/* Session reset releases live cursors too */
+	open_dir(NULL);
+	read_dir(0, buf);
+	ninep_server_cleanup(&server);
+	zassert_equal(releasedir_calls, 2);
+}
+
+static uint32_t time_listing_us(const struct ninep_fs_ops *ops, int reps)
+{
+	static uint8_t listing[LISTING_MAX];
+
+	start_server(ops, &ramfs);
+
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < reps; i++) {
+		open_dir(NULL);
+		list_dir(listing, sizeof(listing));
+		clunk_dir();
+	}
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start) / reps;
+
+	ninep_server_cleanup(&server);
+	return us;
+}
+
+/* Benchmark: full listing of a NUM_FILES-entry directory */
+ZTEST(readdir, test_listing_cost)
+{
+	uint32_t rescan_us = time_listing_us(&rescan_ops, 8);
+	uint32_t cursor_us = time_listing_us(ninep_ramfs_get_ops(), 8);
+
+	TC_PRINT("%d entries, %d-byte reads: rescan %u us, cursor %u us\n",
+	         NUM_FILES, CHUNK, rescan_us, cursor_us);
+}
+
+static void *readdir_setup(void)
+{
+	transport.ops = &mock_ops;
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	for (int i = 0; i < NUM_FILES; i++) {
+		snprintf(file_names[i], sizeof(file_names[i]), "file%03d.txt", i);
+		zassert_not_null(ninep_ramfs_create_file(&ramfs, ramfs.root,
+		                                         file_names[i], "x", 1));
+	}
+
+	rescan_ops = *ninep_ramfs_get_ops();
+	rescan_ops.readdir = NULL;
+	stateful_ops = *ninep_ramfs_get_ops();
+	stateful_ops.readdir = stateful_readdir;
+	stateful_ops.releasedir = stateful_releasedir;
+
+	/* "/sys" is implied by its files, "/dev" by both an entry and files */
+	zassert_equal(ninep_sysfs_init(&sysfs, sysfs_entries,
+	                               ARRAY_SIZE(sysfs_entries)), 0);
+	zassert_equal(ninep_sysfs_register_dir(&sysfs, "/dev"), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/sys/uptime",
+	                                               "1", 1), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/dev/led",
+	                                               "0", 1), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/sys/net/up",
+	                                               "1", 1), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/sys/clock",
+	                                               "0", 1), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/version",
+	                                               "1.0", 3), 0);
+	zassert_equal(ninep_sysfs_register_static_file(&sysfs, "/sys/net/rx",
+	                                               "0", 1), 0);
+
+	return NULL;
+}
+
+ZTEST_SUITE(readdir, NULL, readdir_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER */
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Server Concurrent Dispatch Tests
+ *
+ * Drives ninep_server_process_message() from several threads at once:
+ * - A Tread blocked in the filesystem does not delay a Tstat on another fid
+ * - Requests on the same fid still execute in order
+ * - Tflush of a request that is still executing suppresses its reply
+ * - Tflush is answered while every response buffer is in use
+ * - Tflush of a request still waiting for a response buffer keeps it
+ *   from running
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/protocol.h>
+#include <string.h>
+
+#if CONFIG_NINEP_SERVER_TX_BUFS > 1
+
+#define WORKER_STACK_SIZE 4096
+#define NUM_WORKERS       (CONFIG_NINEP_SERVER_TX_BUFS + 1)
+#define BLOCK_TIMEOUT     K_MSEC(1000)
+
+#define ROOT_FID 0
+#define SLOW_FID 1
+#define FAST_FID 2
+
+/* Mock transport: records the (tag, type) of every reply */
+struct reply_rec {
+	uint16_t tag;
+	uint8_t type;
+};
+
+static struct ninep_transport transport;
+static struct ninep_server server;
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry sysfs_entries[4];
+
+static struct reply_rec replies[32];
+static int num_replies;
+static K_MUTEX_DEFINE(replies_lock);
+
+/* The "slow" file's generator parks until the test releases it */
+static K_SEM_DEFINE(slow_entered, 0, 1);
+static K_SEM_DEFINE(slow_release, 0, 1);
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, NUM_WORKERS,
+                                   WORKER_STACK_SIZE);
+static struct k_thread worker_threads[NUM_WORKERS];
+static uint8_t worker_msgs[NUM_WORKERS][64];
+static int worker_lens[NUM_WORKERS];
+
+static int mock_send(struct ninep_transport *t, const uint8_t *buf, size_t len)
+{
+	struct ninep_msg_header hdr;
+
+	ARG_UNUSED(t);
+	if (ninep_parse_header(buf, len, &hdr) < 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&replies_lock, K_FOREVER);
+	if (num_replies < ARRAY_SIZE(replies)) {
+		replies[num_replies].tag = hdr.tag;
+		replies[num_replies].type = hdr.type;
+		num_replies++;
+	}
+	k_mutex_unlock(&replies_lock);
+
+	return 0;
+}
+
+static int mock_start(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static int mock_stop(struct ninep_transport *t)
+{
+	return 0;
+}
+
+static const struct ninep_transport_ops mock_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+};
+
+/* Type of the reply to tag, or 0 if none has been sent */
+static uint8_t reply_type(uint16_t tag)
+{
+	uint8_t type = 0;
+
+	k_mutex_lock(&replies_lock, K_FOREVER);
+	for (int i = 0; i < num_replies; i++) {
+		if (replies[i].tag == tag) {
+			type = replies[i].type;
+		}
+	}
+	k_mutex_unlock(&replies_lock);
+
+	return type;
+}
+
+static int reply_count(uint16_t tag)
+{
+	int n = 0;
+
+	k_mutex_lock(&replies_lock, K_FOREVER);
+	for (int i = 0; i < num_replies; i++) {
+		if (replies[i].tag == tag) {
+			n++;
+		}
+	}
+	k_mutex_unlock(&replies_lock);
+
+	return n;
+}
+
+static int gen_slow(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	k_sem_give(&slow_entered);
+	k_sem_take(&slow_release, K_FOREVER);
+
+	if (offset > 0 || buf_size < 4) {
+		return 0;
+	}
+	memcpy(buf, "slow", 4);
+	return 4;
+}
+
+static int gen_fast(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	if (offset > 0 || buf_size < 4) {
+		return 0;
+	}
+	memcpy(buf, "fast", 4);
+	return 4;
+}
+
+/* Process one message on the calling thread and return the reply type */
+static uint8_t transact(const uint8_t *msg, int len)
+{
+	struct ninep_msg_header hdr;
+
+	zassert_true(len > 0, "message build failed");
+	ninep_parse_header(msg, len, &hdr);
+	ninep_server_process_message(&server, msg, len);
+	return reply_type(hdr.tag);
+}
+
+static void walk(uint16_t tag, uint32_t newfid, const char *name)
+{
+	uint8_t msg[64];
+	uint16_t name_len = strlen(name);
+	int len = ninep_build_twalk(msg, sizeof(msg), tag, ROOT_FID, newfid,
+	                            1, &name, &name_len);
+
+	zassert_equal(transact(msg, len), NINEP_RWALK, "walk %s failed", name);
+}
+
+static void open_fid(uint16_t tag, uint32_t fid)
+{
+	uint8_t msg[32];
+	int len = ninep_build_topen(msg, sizeof(msg), tag, fid, NINEP_OREAD);
+
+	zassert_equal(transact(msg, len), NINEP_ROPEN, "open fid %u failed", fid);
+}
+
+static void worker_fn(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	ninep_server_process_message(&server, worker_msgs[idx], worker_lens[idx]);
+}
+
+/* Run a message on worker thread idx */
+static void start_worker(int idx, const uint8_t *msg, int len)
+{
+	zassert_true(len > 0 && len <= sizeof(worker_msgs[idx]));
+	memcpy(worker_msgs[idx], msg, len);
+	worker_lens[idx] = len;
+
+	k_thread_create(&worker_threads[idx], worker_stacks[idx],
+	                K_THREAD_STACK_SIZEOF(worker_stacks[idx]),
+	                worker_fn, INT_TO_POINTER(idx), NULL, NULL,
+	                K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+}
+
+/* Park a Tread on the slow fid in worker 0 */
+static void start_blocked_read(uint16_t tag)
+{
+	uint8_t msg[32];
+	int len = ninep_build_tread(msg, sizeof(msg), tag, SLOW_FID, 0, 64);
+
+	start_worker(0, msg, len);
+	zassert_equal(k_sem_take(&slow_entered, BLOCK_TIMEOUT), 0,
+	              "read never reached the filesystem");
+}
+
+/* Test: a Tstat on another fid is answered while a Tread is blocked */
+ZTEST(server_concurrency, test_blocked_read_does_not_delay_tstat)
+{
+	uint8_t msg[32];
+
+	start_blocked_read(10);
+
+	int64_t start = k_uptime_get();
+	int len = ninep_build_tstat(msg, sizeof(msg), 11, FAST_FID);
+
+	zassert_equal(transact(msg, len), NINEP_RSTAT,
+	              "Tstat not answered while a read is blocked");
+	int64_t elapsed = k_uptime_get() - start;
+
+	zassert_equal(reply_type(10), 0, "blocked read answered early");
+	TC_PRINT("Tstat answered in %lld ms behind a blocked Tread\n", elapsed);
+
+	k_sem_give(&slow_release);
+	zassert_equal(k_thread_join(&worker_threads[0], BLOCK_TIMEOUT), 0);
+	zassert_equal(reply_type(10), NINEP_RREAD, "blocked read never answered");
+}
+
+/* Test: a second request on the busy fid waits for the first to finish */
+ZTEST(server_concurrency, test_same_fid_requests_serialized)
+{
+	uint8_t msg[32];
+
+	start_blocked_read(20);
+
+	int len = ninep_build_tstat(msg, sizeof(msg), 21, SLOW_FID);
+
+	start_worker(1, msg, len);
+	k_sleep(K_MSEC(100));
+	zassert_equal(reply_type(21), 0, "Tstat overtook a request on its fid");
+
+	k_sem_give(&slow_release);
+	zassert_equal(k_thread_join(&worker_threads[0], BLOCK_TIMEOUT), 0);
+	zassert_equal(k_thread_join(&worker_threads[1], BLOCK_TIMEOUT), 0);
+	zassert_equal(reply_type(20), NINEP_RREAD);
+	zassert_equal(reply_type(21), NINEP_RSTAT);
+}
+
+/* Test: flushing an executing request answers Rflush and drops its reply */
+ZTEST(server_concurrency, test_flush_suppresses_executing_reply)
+{
+	uint8_t msg[32];
+
+	start_blocked_read(30);
+
+	int len = ninep_build_tflush(msg, sizeof(msg), 31, 30);
+
+	zassert_equal(transact(msg, len), NINEP_RFLUSH);
+
+	k_sem_give(&slow_release);
+	zassert_equal(k_thread_join(&worker_threads[0], BLOCK_TIMEOUT), 0);
+	zassert_equal(reply_count(30), 0,
+	              "reply to flushed tag sent after Rflush");
+}
+
+/* Test: Tflush gets through while all response buffers are held */
+ZTEST(server_concurrency, test_flush_with_all_buffers_busy)
+{
+	uint8_t msg[32];
+	int len;
+
+	/* The read parks in the filesystem; the Tstats on its fid hold the
+	 * remaining buffers while they wait for it */
+	start_blocked_read(40);
+	for (int i = 1; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		len = ninep_build_tstat(msg, sizeof(msg), 40 + i, SLOW_FID);
+		start_worker(i, msg, len);
+	}
+	k_sleep(K_MSEC(100));
+
+	len = ninep_build_tflush(msg, sizeof(msg), 60, 40);
+	start_worker(NUM_WORKERS - 1, msg, len);
+	zassert_equal(k_thread_join(&worker_threads[NUM_WORKERS - 1],
+	                            BLOCK_TIMEOUT), 0,
+	              "Tflush waited for a response buffer");
+	zassert_equal(reply_type(60), NINEP_RFLUSH);
+
+	k_sem_give(&slow_release);
+	for (int i = 0; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		zassert_equal(k_thread_join(&worker_threads[i], BLOCK_TIMEOUT), 0);
+	}
+	zassert_equal(reply_count(40), 0,
+	              "reply to flushed tag sent after Rflush");
+}
+
+/* Test: a request flushed while it waits for a buffer never runs */
+ZTEST(server_concurrency, test_flush_of_request_waiting_for_buffer)
+{
+	uint8_t msg[32];
+	int len;
+
+	start_blocked_read(50);
+	for (int i = 1; i < CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		len = ninep_build_tstat(msg, sizeof(msg), 50 + i, SLOW_FID);
+		start_worker(i, msg, len);
+	}
+	k_sleep(K_MSEC(100));
+
+	/* Every buffer is held: this one waits before it has a slot */
+	len = ninep_build_tstat(msg, sizeof(msg), 70, FAST_FID);
+	start_worker(CONFIG_NINEP_SERVER_TX_BUFS, msg, len);
+	k_sleep(K_MSEC(100));
+
+	len = ninep_build_tflush(msg, sizeof(msg), 71, 70);
+	zassert_equal(transact(msg, len), NINEP_RFLUSH);
+
+	k_sem_give(&slow_release);
+	for (int i = 0; i <= CONFIG_NINEP_SERVER_TX_BUFS; i++) {
+		zassert_equal(k_thread_join(&worker_threads[i], BLOCK_TIMEOUT), 0);
+	}
+	zassert_equal(reply_count(70), 0,
+	              "request flushed while waiting answered after Rflush");
+	zassert_equal(reply_type(50), NINEP_RREAD);
+}
+
+static void *server_concurrency_setup(void)
+{
+	struct ninep_server_config config = {
+		.fs_ops = ninep_sysfs_get_ops(),
+		.fs_ctx = &sysfs,
+	};
+
+	transport.ops = &mock_ops;
+
+	zassert_equal(ninep_sysfs_init(&sysfs, sysfs_entries,
+	                               ARRAY_SIZE(sysfs_entries)), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/slow", gen_slow, NULL), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/fast", gen_fast, NULL), 0);
+	zassert_equal(ninep_server_init(&server, &config, &transport), 0);
+
+	return NULL;
+}
+
+/* Fresh session per test: Tversion clunks every fid */
+static void server_concurrency_before(void *f)
+{
+	uint8_t msg[64];
+	int len;
+
+	k_sem_reset(&slow_entered);
+	k_sem_reset(&slow_release);
+	num_replies = 0;
+
+	len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                           CONFIG_NINEP_MAX_MESSAGE_SIZE, "9P2000", 6);
+	zassert_equal(transact(msg, len), NINEP_RVERSION);
+
+	len = ninep_build_tattach(msg, sizeof(msg), 1, ROOT_FID, NINEP_NOFID,
+	                          "test", 4, "", 0);
+	zassert_equal(transact(msg, len), NINEP_RATTACH);
+
+	walk(2, SLOW_FID, "slow");
+	walk(3, FAST_FID, "fast");
+	open_fid(4, SLOW_FID);
+	num_replies = 0;
+}
+
+static void server_concurrency_teardown(void *f)
+{
+	ninep_server_cleanup(&server);
+}
+
+ZTEST_SUITE(server_concurrency, NULL, server_concurrency_setup,
+            server_concurrency_before, NULL, server_concurrency_teardown);
+
+#endif /* CONFIG_NINEP_SERVER_TX_BUFS > 1 */
+
+#endif /* CONFIG_NINEP_SERVER */
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * TCP Session Pool Integration Tests
+ *
+ * Tests the multi-client TCP session pool over localhost:
+ * - Several clients served concurrently on one port
+ * - Each connection has its own fid space
+ * - Connections beyond max_sessions are closed, not left hanging
+ * - A disconnected session's slot is reused
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/9p/session_pool_tcp.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/net_if.h>
+
+LOG_MODULE_REGISTER(session_pool_tcp_test, LOG_LEVEL_INF);
+
+#define POOL_PORT        9567
+#define POOL_SESSIONS    2
+#define POOL_RX_BUF_SIZE 1024
+#define RECV_TIMEOUT_MS  2000
+
+NINEP_SESSION_POOL_TCP_DEFINE(test_pool, POOL_SESSIONS, POOL_RX_BUF_SIZE);
+
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry sysfs_entries[4];
+
+static int connect_client(void)
+{
+	struct sockaddr_in addr;
+	struct zsock_timeval tv = {
+		.tv_sec = RECV_TIMEOUT_MS / 1000,
+	};
+	int sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+	zassert_true(sock >= 0, "socket failed: %d", errno);
+	zsock_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(POOL_PORT);
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	zassert_equal(zsock_connect(sock, (struct sockaddr *)&addr,
+	                            sizeof(addr)), 0,
+	              "connect failed: %d", errno);
+	return sock;
+}
+
+/* Send one T-message and return the type of the R-message, or -errno
+ * (0 if the server closed the connection) */
+static int transact(int sock, const uint8_t *msg, int len)
+{
+	uint8_t rx[256];
+	size_t got = 0;
+	struct ninep_msg_header hdr = {0};
+
+	zassert_equal(zsock_send(sock, msg, len, 0), len, "send failed");
+
+	while (got < 7 || got < hdr.size) {
+		int n = zsock_recv(sock, &rx[got], sizeof(rx) - got, 0);
+
+		if (n <= 0) {
+			return n < 0 ? -errno : 0;
+		}
+		got += n;
+		if (got >= 7) {
+			ninep_parse_header(rx, got, &hdr);
+		}
+	}
+
+	return hdr.type;
+}
+
+static int do_version(int sock)
+{
+	uint8_t msg[64];
+	int len = ninep_build_tversion(msg, sizeof(msg), NINEP_NOTAG,
+	                               POOL_RX_BUF_SIZE, "9P2000", 6);
+
+	return transact(sock, msg, len);
+}
+
+static int do_attach(int sock, uint32_t fid)
+{
+	uint8_t msg[64];
+	int len = ninep_build_tattach(msg, sizeof(msg), 1, fid, NINEP_NOFID,
+	                              "test", 4, "", 0);
+
+	return transact(sock, msg, len);
+}
+
+static void wait_active(int expected)
+{
+	for (int i = 0; i < 50; i++) {
+		if (ninep_session_pool_tcp_active(&test_pool) == expected) {
+			return;
+		}
+		k_sleep(K_MSEC(20));
+	}
+	zassert_equal(ninep_session_pool_tcp_active(&test_pool), expected);
+}
+
+/* Test: two clients attach with the same fid number at the same time */
+ZTEST(session_pool_tcp, test_concurrent_clients_independent_fids)
+{
+	int a = connect_client();
+	int b = connect_client();
+
+	zassert_equal(do_version(a), NINEP_RVERSION);
+	zassert_equal(do_version(b), NINEP_RVERSION);
+
+	/* fid 0 on each connection: would collide if the server were shared */
+	zassert_equal(do_attach(a, 0), NINEP_RATTACH);
+	zassert_equal(do_attach(b, 0), NINEP_RATTACH);
+	wait_active(2);
+
+	zsock_close(a);
+	zsock_close(b);
+	wait_active(0);
+}
+
+/* Test: a connection over the limit is closed; a freed slot is reused */
+ZTEST(session_pool_tcp, test_connection_limit)
+{
+	int a = connect_client();
+	int b = connect_client();
+
+	zassert_equal(do_version(a), NINEP_RVERSION);
+	zassert_equal(do_version(b), NINEP_RVERSION);
+
+	int c = connect_client();
+
+	zassert_equal(do_version(c), 0, "over-limit client should see EOF");
+	zsock_close(c);
+
+	/* Existing sessions are unaffected */
+	zassert_equal(do_attach(b, 7), NINEP_RATTACH);
+
+	zsock_close(a);
+	wait_active(1);
+
+	int d = connect_client();
+
+	zassert_equal(do_version(d), NINEP_RVERSION);
+	zassert_equal(do_attach(d, 7), NINEP_RATTACH);
+
+	zsock_close(b);
+	zsock_close(d);
+	wait_active(0);
+}
+
+static void *session_pool_tcp_setup(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct ninep_session_pool_tcp_config config = {
+		.port = POOL_PORT,
+		.max_sessions = POOL_SESSIONS,
+		.rx_buf_size_per_session = POOL_RX_BUF_SIZE,
+		.fs_ops = (struct ninep_fs_ops *)ninep_sysfs_get_ops(),
+		.fs_context = &sysfs,
+	};
+
+	zassert_not_null(iface, "No network interface");
+	for (int i = 0; i < 50 && !net_if_is_up(iface); i++) {
+		k_sleep(K_MSEC(100));
+	}
+
+	zassert_equal(ninep_sysfs_init(&sysfs, sysfs_entries,
+	                               ARRAY_SIZE(sysfs_entries)), 0);
+	zassert_equal(ninep_session_pool_tcp_init(&test_pool, &config), 0);
+	zassert_equal(ninep_session_pool_tcp_start(&test_pool), 0);
+	k_sleep(K_MSEC(200));
+
+	return NULL;
+}
+
+static void session_pool_tcp_teardown(void *f)
+{
+	ninep_session_pool_tcp_stop(&test_pool);
+}
+
+ZTEST_SUITE(session_pool_tcp, NULL, session_pool_tcp_setup,
+            NULL, NULL, session_pool_tcp_teardown);
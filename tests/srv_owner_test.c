@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * /srv Node Ownership Tests
+ *
+ * - A walk below a service runs only that service's walk, whichever
+ *   position it has among the posted services
+ * - Reads and clunks reach the owning service; a cloned fid keeps the
+ *   node tracked until both are clunked
+ * - Removing a service forgets its nodes, also while its root is being
+ *   fetched
+ * - A full node table fails the walk and hands the node back
+ * - Creating a file moves the fid's entry from the directory to the file
+ * - Benchmark: backend walks and cycles for a deep walk among
+ *   NUM_SERVICES services
+ */
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NINEP_SERVER) && defined(CONFIG_SRV_REGISTRY)
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/namespace/srv.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_SERVICES  12
+#define BENCH_REPS    1000
+
+/* A ramfs whose operations are counted */
+struct counted_fs {
+	struct ninep_ramfs ramfs;
+	int walks;
+	int clunks;
+};
+
+static struct counted_fs services[NUM_SERVICES];
+static struct ninep_server servers[NUM_SERVICES];
+static struct counted_fs spare;
+static struct ninep_server spare_server;
+static struct ninep_fs_ops counted_ops;
+static uint8_t buf[256];
+
+static bool remove_in_get_root;
+
+static struct ninep_fs_node *counted_get_root(void *ctx)
+{
+	/* As if another thread removed the service meanwhile */
+	if (remove_in_get_root) {
+		remove_in_get_root = false;
+		zassert_equal(srv_remove("spare"), 0);
+	}
+	return ninep_ramfs_get_ops()->get_root(&((struct counted_fs *)ctx)->ramfs);
+}
+
+static struct ninep_fs_node *counted_walk(struct ninep_fs_node *dir,
+                                          const char *name, uint16_t name_len,
+                                          void *ctx)
+{
+	struct counted_fs *cfs = ctx;
+
+	cfs->walks++;
+	return ninep_ramfs_get_ops()->walk(dir, name, name_len, &cfs->ramfs);
+}
+
+static int counted_read(struct ninep_fs_node *node, uint64_t offset,
+                        uint8_t *out, uint32_t count, const char *uname,
+                        void *ctx)
+{
+	return ninep_ramfs_get_ops()->read(node, offset, out, count, uname,
+	                                   &((struct counted_fs *)ctx)->ramfs);
+}
+
+static int counted_stat(struct ninep_fs_node *node, uint8_t *out,
+                        size_t len, void *ctx)
+{
+	return ninep_ramfs_get_ops()->stat(node, out, len,
+	                                   &((struct counted_fs *)ctx)->ramfs);
+}
+
+static int counted_clunk(struct ninep_fs_node *node, void *ctx)
+{
+	((struct counted_fs *)ctx)->clunks++;
+	return 0;
+}
+
+static int counted_create(struct ninep_fs_node *dir, const char *name,
+                          uint16_t name_len, uint32_t perm, uint8_t mode,
+                          const char *uname, struct ninep_fs_node **child,
+                          void *ctx)
+{
+	return ninep_ramfs_get_ops()->create(dir, name, name_len, perm, mode,
+	                                     uname, child,
+	                                     &((struct counted_fs *)ctx)->ramfs);
+}
+
+static int total_walks(void)
+{
+	int n = 0;
+
+	for (int i = 0; i < NUM_SERVICES; i++) {
+		n += services[i].walks;
+	}
+	return n;
+}
+
+static struct ninep_fs_node *walk(struct ninep_fs_node *dir, const char *name)
+{
+	return srv_get_fs_ops()->walk(dir, name, strlen(name), NULL);
+}
+
+static struct ninep_fs_node *srv_root(void)
+{
+	return srv_get_fs_ops()->get_root(NULL);
+}
+
+/* Test: a deep walk only runs the owning service's walk */
+ZTEST(srv_owner, test_direct_dispatch)
+{
+	const struct ninep_fs_ops *ops = srv_get_fs_ops();
+
+	/* svc00 was posted first, so it is last in the registry list */
+	for (int i = 0; i < NUM_SERVICES; i += NUM_SERVICES - 1) {
+		char name[8];
+
+		snprintf(name, sizeof(name), "svc%02d", i);
+		struct ninep_fs_node *root = walk(srv_root(), name);
+
+		zassert_equal(root, services[i].ramfs.root);
+
+		int before = total_walks();
+		int own = services[i].walks;
+		struct ninep_fs_node *d = walk(root, "d");
+		struct ninep_fs_node *f = walk(d, "f");
+
+		zassert_not_null(f);
+		zassert_equal(services[i].walks - own, 2);
+		zassert_equal(total_walks() - before, 2, "other services walked");
+		zassert_is_null(walk(d, "missing"));
+		zassert_equal(total_walks() - before, 3);
+
+		zassert_equal(ops->read(f, 0, buf, sizeof(buf), NULL, NULL), 3);
+		zassert_mem_equal(buf, name + 3, 2);
+		zassert_true(ops->stat(f, buf, sizeof(buf), NULL) > 0);
+
+		int clunks = services[i].clunks;
+
+		ops->clunk(f, NULL);
+		ops->clunk(d, NULL);
+		ops->clunk(root, NULL);
+		zassert_equal(services[i].clunks - clunks, 3);
+		zassert_equal(ops->stat(f, buf, sizeof(buf), NULL), -ENOENT);
+	}
+}
+
+/* Test: a cloned fid keeps the node until both fids are clunked */
+ZTEST(srv_owner, test_ref_and_clunk)
+{
+	const struct ninep_fs_ops *ops = srv_get_fs_ops();
+	struct ninep_fs_node *root = walk(srv_root(), "svc03");
+	struct ninep_fs_node *d = walk(root, "d");
+
+	zassert_not_null(d);
+	ops->ref(d, NULL);
+	ops->clunk(d, NULL);
+	zassert_true(ops->stat(d, buf, sizeof(buf), NULL) > 0);
+	ops->clunk(d, NULL);
+	zassert_equal(ops->stat(d, buf, sizeof(buf), NULL), -ENOENT);
+
+	/* Walking from a node no longer tracked finds no service */
+	zassert_is_null(walk(d, "f"));
+	ops->clunk(root, NULL);
+}
+
+/* Test: removing a service forgets its nodes */
+ZTEST(srv_owner, test_remove_service)
+{
+	const struct ninep_fs_ops *ops = srv_get_fs_ops();
+
+	zassert_equal(srv_post("spare", &spare_server), 0);
+
+	struct ninep_fs_node *root = walk(srv_root(), "spare");
+	struct ninep_fs_node *d = walk(root, "d");
+
+	zassert_not_null(d);
+	zassert_equal(srv_remove("spare"), 0);
+	zassert_equal(ops->stat(d, buf, sizeof(buf), NULL), -ENOENT);
+	zassert_is_null(walk(d, "f"));
+
+	int clunks = spare.clunks;
+
+	zassert_equal(ops->clunk(d, NULL), 0);
+	zassert_equal(ops->clunk(root, NULL), 0);
+	zassert_equal(spare.clunks, clunks, "clunk reached a removed service");
+}
+
+/* Test: a service removed while its root is fetched is not tracked */
+ZTEST(srv_owner, test_remove_during_get_root)
+{
+	zassert_equal(srv_post("spare", &spare_server), 0);
+
+	remove_in_get_root = true;
+	zassert_is_null(walk(srv_root(), "spare"));
+	zassert_false(remove_in_get_root, "get_root was not called");
+	zassert_equal(srv_remove("spare"), -ENOENT);
+}
+
+/* Test: with the node table full a walk fails and the node goes back */
+ZTEST(srv_owner, test_table_full)
+{
+	const struct ninep_fs_ops *ops = srv_get_fs_ops();
+	static struct ninep_fs_node *held[CONFIG_SRV_MAX_NODES];
+	static const char *const steps[] = { NULL, "d", "f" };
+	int n = 0;
+
+	/* Each service has three nodes: its root, d and f */
+	if (NUM_SERVICES * 3 <= CONFIG_SRV_MAX_NODES) {
+		ztest_test_skip();
+	}
+
+	for (int i = 0; n < CONFIG_SRV_MAX_NODES; i++) {
+		char name[8];
+
+		snprintf(name, sizeof(name), "svc%02d", i / 3);
+		held[n] = walk(i % 3 ? held[n - 1] : srv_root(),
+		               i % 3 ? steps[i % 3] : name);
+		zassert_not_null(held[n], "walk %d failed early", n);
+		n++;
+	}
+
+	/* The next new node is refused; a walk below a service returns it */
+	int svc = n / 3;
+	int clunks = services[svc].clunks;
+
+	if (n % 3) {
+		zassert_is_null(walk(held[n - 1], steps[n % 3]));
+		zassert_equal(services[svc].clunks, clunks + 1);
+	} else {
+		char name[8];
+
+		snprintf(name, sizeof(name), "svc%02d", svc);
+		zassert_is_null(walk(srv_root(), name));
+	}
+
+	/* A node already tracked only gains a reference */
+	struct ninep_fs_node *again = walk(held[0], "d");
+
+	zassert_equal(again, held[1]);
+	ops->clunk(again, NULL);
+
+	while (n > 0) {
+		ops->clunk(held[--n], NULL);
+	}
+	zassert_equal(ops->stat(held[1], buf, sizeof(buf), NULL), -ENOENT);
+}
+
+/* Test: each create releases the directory's entry */
+ZTEST(srv_owner, test_create_releases_dir)
+{
+	const struct ninep_fs_ops *ops = srv_get_fs_ops();
+
+	for (int i = 0; i < CONFIG_SRV_MAX_NODES + 2; i++) {
+		char name[8];
+		struct ninep_fs_node *root = walk(srv_root(), "svc05");
+		struct ninep_fs_node *d = walk(root, "d");
+		struct ninep_fs_node *child = NULL;
+
+		zassert_not_null(d, "walk %d failed: table full", i);
+		snprintf(name, sizeof(name), "c%02d", i);
+		zassert_equal(ops->create(d, name, strlen(name), 0644,
+		                          NINEP_OREAD, NULL, &child, NULL), 0);
+		zassert_not_null(child);
+		zassert_equal(ops->stat(child, buf, sizeof(buf), NULL) > 0, true);
+
+		/* The fid now holds child; d went with the create */
+		ops->clunk(child, NULL);
+		ops->clunk(root, NULL);
+		zassert_equal(ops->stat(d, buf, sizeof(buf), NULL), -ENOENT);
+	}
+}
+
+/* Benchmark: a deep walk into the last service in the list */
+ZTEST(srv_owner, test_walk_cost)
+{
+	const struct ninep_fs_ops *ops = srv_get_fs_ops();
+	struct ninep_fs_node *root = walk(srv_root(), "svc00");
+	struct ninep_fs_node *d = walk(root, "d");
+	int before = total_walks();
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_REPS; i++) {
+		struct ninep_fs_node *f = walk(d, "f");
+
+		zassert_not_null(f);
+		ops->clunk(f, NULL);
+	}
+
+	uint32_t cycles = (k_cycle_get_32() - start) / BENCH_REPS;
+
+	TC_PRINT("/srv deep walk with %d services: %u cycles, %d backend walks "
+	         "per walk\n", NUM_SERVICES, cycles,
+	         (total_walks() - before) / BENCH_REPS);
+	zassert_equal(total_walks() - before, BENCH_REPS);
+	ops->clunk(d, NULL);
+	ops->clunk(root, NULL);
+}
+
+static void setup_service(struct counted_fs *cfs, struct ninep_server *server,
+                          const char *content)
+{
+	zassert_equal(ninep_ramfs_init(&cfs->ramfs), 0);
+
+	struct ninep_fs_node *d = ninep_ramfs_create_dir(&cfs->ramfs,
+	                                                 cfs->ramfs.root, "d");
+
+	zassert_not_null(d);
+	zassert_not_null(ninep_ramfs_create_file(&cfs->ramfs, d, "f", content,
+	                                         strlen(content)));
+	server->config.fs_ops = &counted_ops;
+	server->config.fs_ctx = cfs;
+}
+
+static void *srv_owner_setup(void)
+{
+	counted_ops.get_root = counted_get_root;
+	counted_ops.walk = counted_walk;
+	counted_ops.read = counted_read;
+	counted_ops.stat = counted_stat;
+	counted_ops.clunk = counted_clunk;
+	counted_ops.create = counted_create;
+
+	zassert_equal(srv_init(), 0);
+	for (int i = 0; i < NUM_SERVICES; i++) {
+		char name[8];
+		char content[4];
+
+		snprintf(name, sizeof(name), "svc%02d", i);
+		snprintf(content, sizeof(content), "%02d\n", i);
+		setup_service(&services[i], &servers[i], content);
+		zassert_equal(srv_post(name, &servers[i]), 0);
+	}
+	setup_service(&spare, &spare_server, "sp\n");
+	return NULL;
+}
+
+ZTEST_SUITE(srv_owner, NULL, srv_owner_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER && CONFIG_SRV_REGISTRY */
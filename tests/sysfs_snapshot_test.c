@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Sysfs Snapshot Tests
+ *
+ * - A snapshot file read in many chunks runs the generator once
+ * - Chunks stay consistent when the content changes mid-read
+ * - A read from offset 0 takes a new snapshot
+ * - With a TTL, fids share a snapshot until it expires
+ * - Files without a snapshot still generate per read
+ * - Benchmark: generator calls and cycles for a chunked read
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NINEP_SERVER
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <string.h>
+
+#define FILE_SIZE   2048
+#define CHUNK_SIZE  200
+#define TTL_MS      50
+
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry entries[8];
+static int gen_calls;
+static uint8_t generation;
+
+/* FILE_SIZE bytes, all equal to the current generation */
+static int gen_table(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
+{
+	gen_calls++;
+	if (offset >= FILE_SIZE) {
+		return 0;
+	}
+
+	size_t n = MIN(buf_size, FILE_SIZE - offset);
+
+	memset(buf, 'a' + generation, n);
+	return n;
+}
+
+struct reader {
+	struct ninep_fs_node *node;
+	struct ninep_dir_cursor cur;
+};
+
+static void reader_open(struct reader *r, const char *name)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+
+	r->node = ops->walk(sysfs.root, name, strlen(name), &sysfs);
+	zassert_not_null(r->node);
+	zassert_equal(ops->open(r->node, NINEP_OREAD, &sysfs), 0);
+	memset(&r->cur, 0, sizeof(r->cur));
+}
+
+static void reader_close(struct reader *r)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+
+	if (r->cur.state) {
+		ops->releasedir(r->node, &r->cur, &sysfs);
+	}
+	ops->clunk(r->node, &sysfs);
+}
+
+/* Read the whole file in CHUNK_SIZE reads the way the server does */
+static int reader_read_all(struct reader *r, uint8_t *out, size_t size)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	size_t total = 0;
+
+	while (total < size) {
+		uint32_t count = MIN(CHUNK_SIZE, size - total);
+		int n = ops->read_cursor(r->node, total, out + total, count,
+		                         &r->cur, NULL, &sysfs);
+
+		if (n == -ENOTSUP) {
+			n = ops->read(r->node, total, out + total, count, NULL,
+			              &sysfs);
+		}
+		zassert_true(n >= 0, "read failed: %d", n);
+		if (n == 0) {
+			break;
+		}
+		total += n;
+	}
+	return total;
+}
+
+static bool all_equal(const uint8_t *buf, size_t len, uint8_t c)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (buf[i] != c) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Test: a chunked read runs the generator once */
+ZTEST(sysfs_snapshot, test_single_generation)
+{
+	static uint8_t out[FILE_SIZE + CHUNK_SIZE];
+	struct reader r;
+
+	reader_open(&r, "snap");
+	gen_calls = 0;
+	zassert_equal(reader_read_all(&r, out, sizeof(out)), FILE_SIZE);
+	zassert_equal(gen_calls, 1, "generator ran %d times", gen_calls);
+	zassert_true(all_equal(out, FILE_SIZE, 'a' + generation));
+	reader_close(&r);
+}
+
+/* Test: content changing between chunks does not tear the read */
+ZTEST(sysfs_snapshot, test_consistent_chunks)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	static uint8_t out[FILE_SIZE];
+	struct reader r;
+	uint8_t first = 'a' + generation;
+	uint32_t total = 0;
+
+	reader_open(&r, "snap");
+	while (total < FILE_SIZE) {
+		int n = ops->read_cursor(r.node, total, out + total, CHUNK_SIZE,
+		                         &r.cur, NULL, &sysfs);
+
+		zassert_true(n > 0);
+		total += n;
+		generation++;
+	}
+	zassert_true(all_equal(out, FILE_SIZE, first));
+
+	/* Rewinding takes a fresh snapshot */
+	zassert_equal(ops->read_cursor(r.node, 0, out, CHUNK_SIZE, &r.cur, NULL,
+	                               &sysfs), CHUNK_SIZE);
+	zassert_true(all_equal(out, CHUNK_SIZE, 'a' + generation));
+	reader_close(&r);
+}
+
+/* Test: fids share a snapshot within the TTL and not after */
+ZTEST(sysfs_snapshot, test_ttl_sharing)
+{
+	static uint8_t out[FILE_SIZE];
+	struct reader a, b, c;
+	uint8_t first = 'a' + generation;
+
+	reader_open(&a, "shared");
+	reader_open(&b, "shared");
+	gen_calls = 0;
+	zassert_equal(reader_read_all(&a, out, sizeof(out)), FILE_SIZE);
+	int calls = gen_calls;
+
+	generation++;
+	zassert_equal(reader_read_all(&b, out, sizeof(out)), FILE_SIZE);
+	zassert_equal(gen_calls, calls, "second fid regenerated");
+	zassert_true(all_equal(out, FILE_SIZE, first));
+	zassert_equal(a.cur.state, b.cur.state);
+
+	/* The shared snapshot outlives the fids that read it */
+	reader_close(&a);
+	reader_close(&b);
+
+	k_msleep(TTL_MS * 2);
+	reader_open(&c, "shared");
+	zassert_equal(reader_read_all(&c, out, sizeof(out)), FILE_SIZE);
+	zassert_true(gen_calls > calls, "expired snapshot reused");
+	zassert_true(all_equal(out, FILE_SIZE, 'a' + generation));
+	reader_close(&c);
+}
+
+/* Test: files without a snapshot keep generating per read */
+ZTEST(sysfs_snapshot, test_plain_unchanged)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	static uint8_t out[FILE_SIZE];
+	struct reader r;
+
+	reader_open(&r, "plain");
+	zassert_equal(ops->read_cursor(r.node, 0, out, CHUNK_SIZE, &r.cur, NULL,
+	                               &sysfs), -ENOTSUP);
+	zassert_is_null(r.cur.state);
+
+	gen_calls = 0;
+	zassert_equal(reader_read_all(&r, out, sizeof(out)), FILE_SIZE);
+	zassert_true(gen_calls > 2);
+	reader_close(&r);
+
+	/* Directories and static files are refused */
+	zassert_equal(ninep_sysfs_set_snapshot(&sysfs, "/dir", 64, 0), -EINVAL);
+	zassert_equal(ninep_sysfs_set_snapshot(&sysfs, "/missing", 64, 0),
+	              -ENOENT);
+}
+
+/* Benchmark: chunked read with and without a snapshot */
+ZTEST(sysfs_snapshot, test_snapshot_cost)
+{
+	static uint8_t out[FILE_SIZE];
+	struct reader r;
+	uint32_t start;
+
+	reader_open(&r, "plain");
+	gen_calls = 0;
+	start = k_cycle_get_32();
+	reader_read_all(&r, out, sizeof(out));
+	uint32_t plain_cycles = k_cycle_get_32() - start;
+	int plain_calls = gen_calls;
+
+	reader_close(&r);
+
+	reader_open(&r, "snap");
+	gen_calls = 0;
+	start = k_cycle_get_32();
+	reader_read_all(&r, out, sizeof(out));
+	uint32_t snap_cycles = k_cycle_get_32() - start;
+	int snap_calls = gen_calls;
+
+	reader_close(&r);
+
+	TC_PRINT("%d-byte file in %d-byte reads: per read %d calls %u cycles, "
+	         "snapshot %d calls %u cycles\n", FILE_SIZE, CHUNK_SIZE,
+	         plain_calls, plain_cycles, snap_calls, snap_cycles);
+	zassert_true(snap_calls < plain_calls);
+}
+
+static void *sysfs_snapshot_setup(void)
+{
+	zassert_equal(ninep_sysfs_init(&sysfs, entries, ARRAY_SIZE(entries)), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/snap", gen_table,
+	                                        NULL), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/shared", gen_table,
+	                                        NULL), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/plain", gen_table,
+	                                        NULL), 0);
+	zassert_equal(ninep_sysfs_register_dir(&sysfs, "/dir"), 0);
+	zassert_equal(ninep_sysfs_set_snapshot(&sysfs, "/snap", FILE_SIZE, 0), 0);
+	zassert_equal(ninep_sysfs_set_snapshot(&sysfs, "/shared", FILE_SIZE,
+	                                       TTL_MS), 0);
+	return NULL;
+}
+
+ZTEST_SUITE(sysfs_snapshot, NULL, sysfs_snapshot_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER */
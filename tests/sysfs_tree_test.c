@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Sysfs Path Tree Tests
+ *
+ * - Parent directories are implied by deeper registrations, listed once
+ * - Registering an implied directory later costs no entry slot
+ * - Duplicate paths and files used as directories are refused
+ * - ".." follows the tree; listing qids match walk qids
+ * - Directories list every child, well past the old 32-child limit
+ * - Benchmark: walk and list in a tree of a few thousand entries
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NINEP_SERVER
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/sysfs.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WIDE_FILES    40
+#define LIST_MAX      4096
+
+#define BENCH_SENSORS 512
+#define BENCH_FILES   4     /* Per sensor */
+#define BENCH_REPS    1000
+
+static struct ninep_sysfs sysfs;
+static struct ninep_sysfs_entry entries[WIDE_FILES + 8];
+static char wide_names[WIDE_FILES][16];
+static uint8_t listing[LIST_MAX];
+
+static int gen_value(uint8_t *buf, size_t buf_size, uint64_t offset, void *ctx)
+{
+	if (offset > 0) {
+		return 0;
+	}
+	return snprintf((char *)buf, buf_size, "1\n");
+}
+
+/* Walk a slash-separated path from the root; NULL if any element fails.
+ * Intermediate nodes are clunked the way the server does. */
+static struct ninep_fs_node *walk_path(struct ninep_sysfs *fs, const char *path)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *node = fs->root;
+
+	while (*path) {
+		const char *end = strchr(path, '/');
+
+		if (!end) {
+			end = path + strlen(path);
+		}
+		struct ninep_fs_node *next = ops->walk(node, path, end - path, fs);
+
+		if (node != fs->root) {
+			ops->clunk(node, fs);
+		}
+		if (!next) {
+			return NULL;
+		}
+		node = next;
+		path = *end ? end + 1 : end;
+	}
+	return node;
+}
+
+/* List a directory in one read; returns the bytes of stat records */
+static int list_dir(struct ninep_fs_node *dir)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+
+	return ops->read(dir, 0, listing, sizeof(listing), NULL, &sysfs);
+}
+
+/* Find name in a listing; returns the record or NULL, counting matches */
+static const uint8_t *find_record(int len, const char *name, int *matches)
+{
+	const uint8_t *found = NULL;
+	int off = 0;
+
+	*matches = 0;
+	while (off + 2 <= len) {
+		uint16_t size = sys_get_le16(&listing[off]);
+		uint16_t name_len = sys_get_le16(&listing[off + 41]);
+
+		if (name_len == strlen(name) &&
+		    memcmp(&listing[off + 43], name, name_len) == 0) {
+			found = &listing[off];
+			(*matches)++;
+		}
+		off += size + 2;
+	}
+	return found;
+}
+
+static int count_records(int len)
+{
+	int n = 0;
+
+	for (int off = 0; off + 2 <= len; off += sys_get_le16(&listing[off]) + 2) {
+		n++;
+	}
+	return n;
+}
+
+/* Test: parents exist without being registered, and are listed once */
+ZTEST(sysfs_tree, test_implied_dirs)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *value = walk_path(&sysfs, "sensors/temp/value");
+	int matches;
+
+	zassert_not_null(value);
+	zassert_equal(value->type, NINEP_NODE_FILE);
+	ops->clunk(value, &sysfs);
+
+	struct ninep_fs_node *temp = walk_path(&sysfs, "sensors/temp");
+
+	zassert_not_null(temp);
+	zassert_equal(temp->type, NINEP_NODE_DIR);
+	ops->clunk(temp, &sysfs);
+
+	int len = list_dir(sysfs.root);
+	const uint8_t *rec = find_record(len, "sensors", &matches);
+
+	zassert_not_null(rec);
+	zassert_equal(matches, 1);
+	zassert_true(sys_get_le32(&rec[21]) & NINEP_DMDIR);
+
+	/* Registering it now only makes it explicit */
+	size_t used = sysfs.num_entries;
+
+	zassert_equal(ninep_sysfs_register_dir(&sysfs, "/sensors"), 0);
+	zassert_equal(sysfs.num_entries, used);
+	len = list_dir(sysfs.root);
+	zassert_not_null(find_record(len, "sensors", &matches));
+	zassert_equal(matches, 1);
+}
+
+/* Test: duplicates and files with children are refused */
+ZTEST(sysfs_tree, test_bad_paths)
+{
+	size_t used = sysfs.num_entries;
+
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/sensors/temp/value",
+	                                        gen_value, NULL), -EEXIST);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/sensors/temp",
+	                                        gen_value, NULL), -EEXIST);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/sensors/temp/value/x",
+	                                        gen_value, NULL), -ENOTDIR);
+	zassert_equal(ninep_sysfs_register_dir(&sysfs, "/"), -EINVAL);
+	zassert_equal(sysfs.num_entries, used);
+
+	zassert_is_null(walk_path(&sysfs, "sensors/temp/nope"));
+	zassert_is_null(walk_path(&sysfs, "sensors/temp/value/x"));
+}
+
+/* Test: ".." goes up the tree and stops at the root */
+ZTEST(sysfs_tree, test_dotdot)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *temp = walk_path(&sysfs, "sensors/temp");
+	struct ninep_fs_node *sensors = walk_path(&sysfs, "sensors");
+
+	zassert_not_null(temp);
+	zassert_not_null(sensors);
+
+	struct ninep_fs_node *up = ops->walk(temp, "..", 2, &sysfs);
+
+	zassert_equal(up, sensors);
+	ops->clunk(up, &sysfs);
+	zassert_equal(ops->walk(sysfs.root, "..", 2, &sysfs), sysfs.root);
+
+	ops->clunk(temp, &sysfs);
+	ops->clunk(sensors, &sysfs);
+}
+
+/* Test: a child's qid is the same in its parent's listing and on walk */
+ZTEST(sysfs_tree, test_listing_qids)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	const char *names[] = { "value", "unit" };
+	struct ninep_fs_node *temp = walk_path(&sysfs, "sensors/temp");
+	int matches;
+
+	zassert_not_null(temp);
+	int len = list_dir(temp);
+
+	zassert_equal(count_records(len), ARRAY_SIZE(names));
+	for (int i = 0; i < ARRAY_SIZE(names); i++) {
+		const uint8_t *rec = find_record(len, names[i], &matches);
+		struct ninep_fs_node *node = ops->walk(temp, names[i],
+		                                       strlen(names[i]), &sysfs);
+
+		zassert_not_null(rec);
+		zassert_not_null(node);
+		zassert_equal(sys_get_le64(&rec[13]), node->qid.path,
+		              "%s qid differs", names[i]);
+		ops->clunk(node, &sysfs);
+	}
+	ops->clunk(temp, &sysfs);
+}
+
+/* Test: a directory lists all of its children, in registration order */
+ZTEST(sysfs_tree, test_wide_directory)
+{
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	struct ninep_fs_node *wide = walk_path(&sysfs, "wide");
+
+	zassert_not_null(wide);
+	int len = list_dir(wide);
+
+	zassert_equal(count_records(len), WIDE_FILES);
+
+	int off = 0;
+
+	for (int i = 0; i < WIDE_FILES; i++) {
+		const char *name = wide_names[i] + strlen("/wide/");
+		uint16_t name_len = sys_get_le16(&listing[off + 41]);
+
+		zassert_equal(name_len, strlen(name));
+		zassert_equal(memcmp(&listing[off + 43], name, name_len), 0,
+		              "record %d out of order", i);
+		off += sys_get_le16(&listing[off]) + 2;
+	}
+
+	/* And the cursor path agrees */
+	struct ninep_dir_cursor cur = { 0 };
+	static uint8_t chunk[256];
+	int total = 0;
+	int n;
+
+	while ((n = ops->readdir(wide, total, chunk, sizeof(chunk), &cur, NULL,
+	                         &sysfs)) > 0) {
+		zassert_equal(memcmp(chunk, &listing[total], n), 0);
+		total += n;
+		cur.offset = total;
+	}
+	zassert_equal(n, 0);
+	zassert_equal(total, len);
+	ops->clunk(wide, &sysfs);
+}
+
+/* Benchmark: walk and list in a large tree */
+ZTEST(sysfs_tree, test_large_tree)
+{
+	static const char *const files[BENCH_FILES] = {
+		"value", "unit", "min", "max"
+	};
+	static struct ninep_sysfs big;
+	const struct ninep_fs_ops *ops = ninep_sysfs_get_ops();
+	size_t count = BENCH_SENSORS * BENCH_FILES;
+	struct ninep_sysfs_entry *table = k_malloc(count * sizeof(*table));
+	char (*paths)[32] = k_malloc(count * sizeof(*paths));
+
+	if (!table || !paths) {
+		k_free(table);
+		k_free(paths);
+		ztest_test_skip();
+	}
+
+	zassert_equal(ninep_sysfs_init(&big, table, count), 0);
+	for (size_t i = 0; i < count; i++) {
+		snprintf(paths[i], sizeof(paths[i]), "/sensors/%zu/%s",
+		         i / BENCH_FILES, files[i % BENCH_FILES]);
+
+		int ret = ninep_sysfs_register_file(&big, paths[i], gen_value,
+		                                    NULL);
+		if (ret == -ENOMEM) {
+			/* Not enough heap for the implied directories */
+			ztest_test_skip();
+		}
+		zassert_equal(ret, 0, "%s: %d", paths[i], ret);
+	}
+	zassert_equal(big.num_entries, count);
+
+	char first[32], last[32];
+
+	snprintf(first, sizeof(first), "sensors/0/value");
+	snprintf(last, sizeof(last), "sensors/%d/max", BENCH_SENSORS - 1);
+
+	uint32_t cycles[2];
+	const char *targets[2] = { first, last };
+
+	for (int t = 0; t < 2; t++) {
+		uint32_t start = k_cycle_get_32();
+
+		for (int i = 0; i < BENCH_REPS; i++) {
+			struct ninep_fs_node *node = walk_path(&big, targets[t]);
+
+			zassert_not_null(node, "%s", targets[t]);
+			ops->clunk(node, &big);
+		}
+		cycles[t] = (k_cycle_get_32() - start) / BENCH_REPS;
+	}
+
+	/* List /sensors through a cursor, a buffer at a time */
+	struct ninep_fs_node *dir = walk_path(&big, "sensors");
+	struct ninep_dir_cursor cur = { 0 };
+	uint64_t offset = 0;
+	int listed = 0;
+	int n;
+	uint32_t start = k_cycle_get_32();
+
+	while ((n = ops->readdir(dir, offset, listing, sizeof(listing), &cur,
+	                         NULL, &big)) > 0) {
+		listed += count_records(n);
+		offset += n;
+		cur.offset = offset;
+	}
+	uint32_t list_cycles = k_cycle_get_32() - start;
+
+	zassert_equal(listed, BENCH_SENSORS);
+	ops->clunk(dir, &big);
+
+	TC_PRINT("%zu entries: walk first %u cycles, last %u cycles; "
+	         "list %d sensors %u cycles\n", count, cycles[0], cycles[1],
+	         listed, list_cycles);
+}
+
+static void *sysfs_tree_setup(void)
+{
+	zassert_equal(ninep_sysfs_init(&sysfs, entries, ARRAY_SIZE(entries)), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/sensors/temp/value",
+	                                        gen_value, NULL), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/sensors/temp/unit",
+	                                        gen_value, NULL), 0);
+	zassert_equal(ninep_sysfs_register_file(&sysfs, "/sensors/hum/value",
+	                                        gen_value, NULL), 0);
+	for (int i = 0; i < WIDE_FILES; i++) {
+		snprintf(wide_names[i], sizeof(wide_names[i]), "/wide/f%02d", i);
+		zassert_equal(ninep_sysfs_register_file(&sysfs, wide_names[i],
+		                                        gen_value, NULL), 0);
+	}
+	return NULL;
+}
+
+ZTEST_SUITE(sysfs_tree, NULL, sysfs_tree_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER */
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * TCP Transport Receive-Path Benchmark
+ *
+ * Streams large Twrite messages over loopback and reports MB/s for:
+ * - the legacy receive loop (one zsock_recv() per byte, 10 ms sleep on
+ *   EAGAIN), reproduced here as a reference reader
+ * - the transport's bulk-read framing path (ninep_tcp_transport_init)
+ *
+ * Also checks that back-to-back messages coalesced into one segment, and
+ * messages split across segments, are framed and delivered intact.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/9p/transport_tcp.h>
+#include <zephyr/9p/protocol.h>
+#include <zephyr/9p/message.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/net_if.h>
+
+LOG_MODULE_REGISTER(tcp_throughput_test, LOG_LEVEL_INF);
+
+#define BENCH_PORT        9565
+#define LEGACY_PORT       9566
+#define BENCH_MSG_SIZE    CONFIG_NINEP_MAX_MESSAGE_SIZE
+#define BENCH_MSG_COUNT   64
+#define BENCH_TIMEOUT_MS  60000
+
+static struct ninep_transport bench_transport;
+static uint8_t tx_msg[BENCH_MSG_SIZE];
+
+/* Receive accounting, shared by both readers */
+static volatile uint32_t rx_msgs;
+static volatile uint64_t rx_bytes;
+static volatile uint32_t rx_bad;
+static uint32_t rx_expected;
+static K_SEM_DEFINE(rx_done_sem, 0, 1);
+
+static void count_message(const uint8_t *buf, size_t len)
+{
+	struct ninep_msg_header hdr;
+
+	if (ninep_parse_header(buf, len, &hdr) < 0 || hdr.size != len ||
+	    hdr.type != NINEP_TWRITE) {
+		rx_bad++;
+	}
+	rx_bytes += len;
+	if (++rx_msgs == rx_expected) {
+		k_sem_give(&rx_done_sem);
+	}
+}
+
+static void bench_recv_cb(struct ninep_transport *transport,
+                          const uint8_t *buf, size_t len, void *user_data)
+{
+	ARG_UNUSED(transport);
+	ARG_UNUSED(user_data);
+
+	count_message(buf, len);
+}
+
+static void reset_counters(uint32_t expected)
+{
+	rx_msgs = 0;
+	rx_bytes = 0;
+	rx_bad = 0;
+	rx_expected = expected;
+	k_sem_reset(&rx_done_sem);
+}
+
+/* Build one Twrite filling the whole message; returns its size */
+static int build_twrite(uint8_t *buf, size_t buf_len, uint16_t tag)
+{
+	static uint8_t payload[BENCH_MSG_SIZE];
+	uint32_t count = buf_len - 23;
+
+	for (uint32_t i = 0; i < count; i++) {
+		payload[i] = (uint8_t)i;
+	}
+	return ninep_build_twrite(buf, buf_len, tag, 1, 0, count, payload);
+}
+
+static int connect_loopback(uint16_t port)
+{
+	struct sockaddr_in addr;
+	int sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+	zassert_true(sock >= 0, "socket failed: %d", errno);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	zassert_equal(zsock_connect(sock, (struct sockaddr *)&addr,
+	                            sizeof(addr)), 0,
+	              "connect failed: %d", errno);
+	return sock;
+}
+
+static void send_all(int sock, const uint8_t *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t n = zsock_send(sock, buf, len, 0);
+
+		zassert_true(n > 0, "send failed: %d", errno);
+		buf += n;
+		len -= n;
+	}
+}
+
+/* Stream BENCH_MSG_COUNT Twrites and return throughput in KB/s */
+static uint32_t stream_twrites(uint16_t port, int msg_len)
+{
+	int sock = connect_loopback(port);
+	int64_t start = k_uptime_get();
+
+	for (int i = 0; i < BENCH_MSG_COUNT; i++) {
+		send_all(sock, tx_msg, msg_len);
+	}
+
+	zassert_equal(k_sem_take(&rx_done_sem, K_MSEC(BENCH_TIMEOUT_MS)), 0,
+	              "only %u/%u messages delivered", rx_msgs, rx_expected);
+
+	int64_t elapsed = k_uptime_get() - start;
+
+	zsock_close(sock);
+	zassert_equal(rx_bad, 0, "%u malformed deliveries", rx_bad);
+	zassert_equal(rx_bytes, (uint64_t)msg_len * BENCH_MSG_COUNT);
+
+	if (elapsed <= 0) {
+		elapsed = 1;
+	}
+	return (uint32_t)(rx_bytes * 1000 / 1024 / elapsed);
+}
+
+/*
+ * Reference reader: the pre-framing receive loop, kept here only so the
+ * benchmark can report a before/after figure from the same build.
+ */
+static K_THREAD_STACK_DEFINE(legacy_stack, 4096);
+static struct k_thread legacy_thread;
+static int legacy_listen_sock = -1;
+static uint8_t legacy_rx_buf[BENCH_MSG_SIZE];
+
+static void legacy_reader_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	int sock = zsock_accept(legacy_listen_sock, NULL, NULL);
+	size_t rx_offset = 0;
+	uint32_t expected_size = 0;
+	bool header_received = false;
+
+	while (sock >= 0 && rx_msgs < rx_expected) {
+		uint8_t byte;
+		int ret = zsock_recv(sock, &byte, 1, 0);
+
+		if (ret < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				k_sleep(K_MSEC(10));
+				continue;
+			}
+			break;
+		} else if (ret == 0) {
+			break;
+		}
+
+		legacy_rx_buf[rx_offset++] = byte;
+
+		if (!header_received && rx_offset >= 7) {
+			struct ninep_msg_header hdr;
+
+			ninep_parse_header(legacy_rx_buf, rx_offset, &hdr);
+			expected_size = hdr.size;
+			header_received = true;
+		}
+		if (header_received && rx_offset >= expected_size) {
+			count_message(legacy_rx_buf, expected_size);
+			rx_offset = 0;
+			header_received = false;
+		}
+	}
+
+	if (sock >= 0) {
+		zsock_close(sock);
+	}
+}
+
+static void start_legacy_reader(void)
+{
+	struct sockaddr_in addr;
+	int opt = 1;
+
+	legacy_listen_sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(legacy_listen_sock >= 0, "socket failed: %d", errno);
+	zsock_setsockopt(legacy_listen_sock, SOL_SOCKET, SO_REUSEADDR,
+	                 &opt, sizeof(opt));
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = INADDR_ANY;
+	addr.sin_port = htons(LEGACY_PORT);
+	zassert_equal(zsock_bind(legacy_listen_sock, (struct sockaddr *)&addr,
+	                         sizeof(addr)), 0, "bind failed: %d", errno);
+	zassert_equal(zsock_listen(legacy_listen_sock, 1), 0);
+
+	k_thread_create(&legacy_thread, legacy_stack,
+	                K_THREAD_STACK_SIZEOF(legacy_stack),
+	                legacy_reader_fn, NULL, NULL, NULL,
+	                5, 0, K_NO_WAIT);
+}
+
+static void start_bench_transport(void)
+{
+	struct ninep_tcp_config config = {
+		.port = BENCH_PORT,
+		.rx_buf_size = BENCH_MSG_SIZE,
+	};
+
+	zassert_equal(ninep_tcp_transport_init(&bench_transport, &config,
+	                                       bench_recv_cb, NULL), 0);
+	zassert_equal(ninep_transport_start(&bench_transport), 0);
+	k_sleep(K_MSEC(200));
+}
+
+/* Test: small messages coalesced into one send, and one message split
+ * across several sends, are all delivered exactly once and intact */
+ZTEST(tcp_throughput, test_framing_coalesced_and_split)
+{
+	uint8_t burst[8 * 64];
+	size_t burst_len = 0;
+
+	start_bench_transport();
+
+	/* Eight 64-byte Twrites back to back in a single segment */
+	for (int i = 0; i < 8; i++) {
+		int n = build_twrite(&burst[burst_len], 64, i);
+
+		zassert_equal(n, 64);
+		burst_len += n;
+	}
+
+	reset_counters(8 + 1);
+
+	int sock = connect_loopback(BENCH_PORT);
+
+	send_all(sock, burst, burst_len);
+
+	/* One full-size Twrite dribbled out in uneven pieces */
+	int msg_len = build_twrite(tx_msg, sizeof(tx_msg), 99);
+	size_t sent = 0;
+	size_t piece = 3;
+
+	while (sent < (size_t)msg_len) {
+		size_t n = MIN(piece, msg_len - sent);
+
+		send_all(sock, &tx_msg[sent], n);
+		sent += n;
+		piece = piece * 3 + 1;
+		k_sleep(K_MSEC(5));
+	}
+
+	zassert_equal(k_sem_take(&rx_done_sem, K_MSEC(5000)), 0,
+	              "only %u/%u messages delivered", rx_msgs, rx_expected);
+	zassert_equal(rx_bad, 0, "%u malformed deliveries", rx_bad);
+
+	zsock_close(sock);
+	ninep_transport_stop(&bench_transport);
+}
+
+/* Benchmark: large Twrite stream, legacy byte-at-a-time vs bulk framing */
+ZTEST(tcp_throughput, test_twrite_stream_throughput)
+{
+	int msg_len = build_twrite(tx_msg, sizeof(tx_msg), 1);
+
+	zassert_true(msg_len > 0);
+
+	reset_counters(BENCH_MSG_COUNT);
+	start_legacy_reader();
+	uint32_t legacy_kbps = stream_twrites(LEGACY_PORT, msg_len);
+
+	k_thread_join(&legacy_thread, K_SECONDS(5));
+	zsock_close(legacy_listen_sock);
+
+	reset_counters(BENCH_MSG_COUNT);
+	start_bench_transport();
+	uint32_t bulk_kbps = stream_twrites(BENCH_PORT, msg_len);
+
+	ninep_transport_stop(&bench_transport);
+
+	TC_PRINT("Twrite stream, %d x %d bytes:\n", BENCH_MSG_COUNT, msg_len);
+	TC_PRINT("  byte-at-a-time recv: %u.%02u MB/s\n",
+	         legacy_kbps / 1024, (legacy_kbps % 1024) * 100 / 1024);
+	TC_PRINT("  bulk framing recv:   %u.%02u MB/s\n",
+	         bulk_kbps / 1024, (bulk_kbps % 1024) * 100 / 1024);
+}
+
+static void *tcp_throughput_setup(void)
+{
+	struct net_if *iface = net_if_get_default();
+
+	zassert_not_null(iface, "No network interface");
+	for (int i = 0; i < 50 && !net_if_is_up(iface); i++) {
+		k_sleep(K_MSEC(100));
+	}
+	return NULL;
+}
+
+static void tcp_throughput_before(void *f)
+{
+	memset(&bench_transport, 0, sizeof(bench_transport));
+}
+
+static void tcp_throughput_after(void *f)
+{
+	k_sleep(K_MSEC(200));  /* Let sockets fully close */
+}
+
+ZTEST_SUITE(tcp_throughput, NULL, tcp_throughput_setup,
+            tcp_throughput_before, tcp_throughput_after, NULL);
@@ -6,6 +6,7 @@
 #include <zephyr/ztest.h>
 #include <zephyr/9p/transport.h>
 #include <zephyr/9p/protocol.h>
+#include <zephyr/9p/message.h>
 #include <string.h>
 
 /* Mock transport implementation for testing */
@@ -225,4 +226,80 @@ ZTEST(ninep_transport, test_transport_message_roundtrip)
 	zassert_equal(recv_hdr.size, 19, "Wrong size");
 	zassert_equal(recv_hdr.type, NINEP_TVERSION, "Wrong type");
 	zassert_equal(recv_hdr.tag, 1, "Wrong tag");
-}
\ No newline at end of file
+}
+
+/* Transport with a native sendv: gathers the pieces for inspection */
+static uint8_t sendv_buf[64];
+static size_t sendv_len;
+static int sendv_iovcnt;
+
+static int mock_sendv(struct ninep_transport *transport,
+                      const struct ninep_iovec *iov, int iovcnt)
+{
+	sendv_len = 0;
+	sendv_iovcnt = iovcnt;
+	for (int i = 0; i < iovcnt; i++) {
+		if (sendv_len + iov[i].len > sizeof(sendv_buf)) {
+			return -EMSGSIZE;
+		}
+		memcpy(&sendv_buf[sendv_len], iov[i].base, iov[i].len);
+		sendv_len += iov[i].len;
+	}
+	return sendv_len;
+}
+
+static const struct ninep_transport_ops mock_sendv_ops = {
+	.send = mock_send,
+	.start = mock_start,
+	.stop = mock_stop,
+	.sendv = mock_sendv,
+};
+
+ZTEST(ninep_transport, test_transport_sendv_native)
+{
+	struct ninep_transport t = {
+		.ops = &mock_sendv_ops,
+		.priv_data = &mock_data,
+	};
+	uint8_t hdr[11];
+	const uint8_t data[] = "payload";
+	struct ninep_iovec iov[2] = {
+		{ .base = hdr, .len = sizeof(hdr) },
+		{ .base = data, .len = 7 },
+	};
+
+	zassert_equal(ninep_build_rread_hdr(hdr, sizeof(hdr), 9, 7), 11);
+	zassert_true(ninep_transport_has_sendv(&t));
+	zassert_equal(ninep_transport_sendv(&t, iov, 2), 18);
+	zassert_equal(sendv_iovcnt, 2, "pieces were merged before sendv");
+	zassert_equal(mock_data.last_sent_len, 0, "send used instead of sendv");
+
+	/* Header and data arrive as one well-formed Rread */
+	struct ninep_msg_header parsed;
+
+	zassert_equal(ninep_parse_header(sendv_buf, sendv_len, &parsed), 0);
+	zassert_equal(parsed.size, 18);
+	zassert_equal(parsed.type, NINEP_RREAD);
+	zassert_equal(parsed.tag, 9);
+	zassert_mem_equal(&sendv_buf[11], data, 7);
+}
+
+ZTEST(ninep_transport, test_transport_sendv_fallback)
+{
+	uint8_t a[] = {0x01, 0x02};
+	uint8_t b[] = {0x03};
+	struct ninep_iovec iov[2] = {
+		{ .base = a, .len = sizeof(a) },
+		{ .base = b, .len = sizeof(b) },
+	};
+
+	zassert_false(ninep_transport_has_sendv(&test_transport));
+
+	/* A single piece goes through send unchanged */
+	zassert_equal(ninep_transport_sendv(&test_transport, iov, 1), sizeof(a));
+	zassert_equal(mock_data.last_sent_buf, a, "Wrong buffer pointer");
+
+	/* Several pieces need a gather buffer the transport doesn't have */
+	zassert_equal(ninep_transport_sendv(&test_transport, iov, 2), -ENOTSUP);
+	zassert_equal(ninep_transport_sendv(NULL, iov, 1), -EINVAL);
+}
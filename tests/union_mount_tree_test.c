@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Union Mount Tree Tests
+ *
+ * - Walks resolve exact mounts, the "/" mount and synthetic prefixes
+ * - Synthetic directories keep one qid and list their children once, in
+ *   whole records across short reads
+ * - Removing a file drops its owner entry
+ * - The root listing is stat records, one per first component, with or
+ *   without a "/" mount
+ * - Duplicate mount points are refused; a synthetic prefix can be mounted
+ * - Benchmark: walk to a mount point with 1 and 16 mounts
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NINEP_SERVER
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/union_fs.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MOUNTS  16
+#define BENCH_REPS    1000
+
+static struct ninep_union_fs plain;   /* No "/" mount */
+static struct ninep_union_fs rooted;  /* "/" mount plus others */
+static struct ninep_union_mount plain_mounts[4];
+static struct ninep_union_mount rooted_mounts[4];
+static struct ninep_ramfs rfs_root, rfs_a, rfs_z, rfs_w;
+static uint8_t buf[512];
+
+static struct ninep_fs_node *walk(struct ninep_union_fs *fs,
+                                  struct ninep_fs_node *dir, const char *name)
+{
+	return ninep_union_fs_get_ops()->walk(dir, name, strlen(name), fs);
+}
+
+/* Occurrences of name among the stat records in buf[0..len) */
+static int count_name(const uint8_t *recs, int len, const char *name)
+{
+	int n = 0;
+
+	for (int off = 0; off + 2 <= len;) {
+		uint16_t size = recs[off] | (recs[off + 1] << 8);
+		uint16_t name_len = recs[off + 41] | (recs[off + 42] << 8);
+
+		if (name_len == strlen(name) &&
+		    memcmp(recs + off + 43, name, name_len) == 0) {
+			n++;
+		}
+		off += 2 + size;
+	}
+	return n;
+}
+
+/* Test: each kind of root and synthetic walk resolves to the right node */
+ZTEST(union_mount_tree, test_walk_resolution)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+
+	zassert_equal(walk(&plain, plain.root, "a"), rfs_a.root);
+	zassert_is_null(walk(&plain, plain.root, "b"));
+
+	struct ninep_fs_node *x = walk(&plain, plain.root, "x");
+
+	zassert_not_null(x);
+	zassert_equal(strcmp(x->name, "x"), 0);
+	zassert_equal(x->qid.type, NINEP_QTDIR);
+
+	struct ninep_fs_node *y = walk(&plain, x, "y");
+
+	zassert_not_null(y);
+	zassert_equal(walk(&plain, y, "z"), rfs_z.root);
+	zassert_equal(walk(&plain, x, "w"), rfs_w.root);
+	zassert_is_null(walk(&plain, x, "z"));
+	zassert_is_null(walk(&plain, y, "zz"));
+
+	char path[32];
+
+	zassert_equal(ops->get_path(y, path, sizeof(path), &plain), 4);
+	zassert_equal(strcmp(path, "/x/y"), 0);
+
+	/* The same directory has the same qid on every walk */
+	struct ninep_fs_node *x2 = walk(&plain, plain.root, "x");
+
+	zassert_equal(x2->qid.path, x->qid.path);
+	zassert_not_equal(y->qid.path, x->qid.path);
+	ops->clunk(x2, &plain);
+	ops->clunk(y, &plain);
+	ops->clunk(x, &plain);
+
+	/* With a "/" mount: its files first, then synthetic prefixes */
+	struct ninep_fs_node *hello = walk(&rooted, rooted.root, "hello");
+
+	zassert_not_null(hello);
+	zassert_equal(strcmp(hello->name, "hello"), 0);
+	ops->clunk(hello, &rooted);
+	zassert_equal(walk(&rooted, rooted.root, "a"), rfs_a.root);
+	x = walk(&rooted, rooted.root, "x");
+	zassert_not_null(x);
+	zassert_equal(walk(&rooted, x, "w"), rfs_w.root);
+	ops->clunk(x, &rooted);
+	zassert_is_null(walk(&rooted, rooted.root, "missing"));
+}
+
+/* Test: the root listing is stat records, one per first component */
+ZTEST(union_mount_tree, test_root_listing)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+	int n = ops->read(plain.root, 0, buf, sizeof(buf), NULL, &plain);
+
+	zassert_true(n > 0);
+	zassert_equal(count_name(buf, n, "a"), 1);
+	zassert_equal(count_name(buf, n, "x"), 1, "x listed more than once");
+	zassert_equal(ops->read(plain.root, n, buf, sizeof(buf), NULL, &plain), 0);
+
+	/* A short read returns whole records and resumes at the next one */
+	int first = ops->read(plain.root, 0, buf, n - 1, NULL, &plain);
+
+	zassert_true(first > 0 && first < n);
+	zassert_equal(ops->read(plain.root, first, buf, sizeof(buf), NULL,
+	                        &plain), n - first);
+
+	/* The "/" mount's entries come first, then the mount points */
+	n = ops->read(rooted.root, 0, buf, sizeof(buf), NULL, &rooted);
+	zassert_true(n > 0);
+	zassert_equal(count_name(buf, n, "hello"), 1);
+	zassert_equal(count_name(buf, n, "a"), 1);
+	zassert_equal(count_name(buf, n, "x"), 1);
+
+	/* A synthetic directory lists each child once */
+	struct ninep_fs_node *x = walk(&plain, plain.root, "x");
+
+	n = ops->read(x, 0, buf, sizeof(buf), NULL, &plain);
+	zassert_equal(count_name(buf, n, "y"), 1);
+	zassert_equal(count_name(buf, n, "w"), 1);
+	zassert_equal(ops->read(x, n, buf, sizeof(buf), NULL, &plain), 0);
+
+	first = ops->read(x, 0, buf, n - 1, NULL, &plain);
+	zassert_true(first > 0 && first < n);
+	zassert_equal(ops->read(x, first, buf, sizeof(buf), NULL, &plain),
+	              n - first, "synthetic listing lost after a short read");
+	ops->clunk(x, &plain);
+}
+
+/* Test: a removed file's owner entry goes with its fid */
+ZTEST(union_mount_tree, test_remove_unregisters)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+
+	zassert_not_null(ninep_ramfs_create_file(&rfs_a, rfs_a.root, "gone",
+	                                         "x", 1));
+
+	size_t before = plain.num_node_owners;
+	struct ninep_fs_node *a = walk(&plain, plain.root, "a");
+	struct ninep_fs_node *gone = walk(&plain, a, "gone");
+
+	zassert_not_null(gone);
+	zassert_equal(plain.num_node_owners, before + 1);
+	zassert_equal(ops->remove(gone, &plain), 0);
+	zassert_equal(plain.num_node_owners, before, "stale owner entry");
+	ops->clunk(a, &plain);
+}
+
+/* Test: duplicate mount points are refused, synthetic ones can be mounted */
+ZTEST(union_mount_tree, test_mount_rules)
+{
+	static struct ninep_union_fs fs;
+	static struct ninep_union_mount mounts[4];
+	static struct ninep_ramfs rfs;
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+
+	zassert_equal(ninep_ramfs_init(&rfs), 0);
+	zassert_equal(ninep_union_fs_init(&fs, mounts, ARRAY_SIZE(mounts)), 0);
+	zassert_equal(ninep_union_fs_mount(&fs, "/p/q", ninep_ramfs_get_ops(),
+	                                   &rfs_a), 0);
+	zassert_equal(ninep_union_fs_mount(&fs, "/p/q", ninep_ramfs_get_ops(),
+	                                   &rfs), -EEXIST);
+	zassert_equal(fs.num_mounts, 1);
+
+	struct ninep_fs_node *p = walk(&fs, fs.root, "p");
+
+	zassert_not_null(p);
+	ops->clunk(p, &fs);
+
+	/* The synthetic "/p" becomes the new mount's root */
+	zassert_equal(ninep_union_fs_mount(&fs, "/p", ninep_ramfs_get_ops(),
+	                                   &rfs), 0);
+	zassert_equal(walk(&fs, fs.root, "p"), rfs.root);
+
+	int n = ops->read(fs.root, 0, buf, sizeof(buf), NULL, &fs);
+
+	zassert_equal(count_name(buf, n, "p"), 1);
+}
+
+/* Benchmark: walk cost to a mount point does not grow with the mounts */
+ZTEST(union_mount_tree, test_walk_cost)
+{
+	static struct ninep_union_fs fs;
+	static struct ninep_union_mount mounts[BENCH_MOUNTS];
+	static char paths[BENCH_MOUNTS][8];
+	uint32_t cycles[2];
+
+	zassert_equal(ninep_union_fs_init(&fs, mounts, ARRAY_SIZE(mounts)), 0);
+	for (int round = 0; round < 2; round++) {
+		int first = round ? 1 : 0;
+		int last = round ? BENCH_MOUNTS : 1;
+
+		for (int i = first; i < last; i++) {
+			snprintf(paths[i], sizeof(paths[i]), "/m%02d", i);
+			zassert_equal(ninep_union_fs_mount(&fs, paths[i],
+			                                   ninep_ramfs_get_ops(),
+			                                   &rfs_a), 0);
+		}
+
+		const char *name = paths[last - 1] + 1;
+		uint32_t start = k_cycle_get_32();
+
+		for (int i = 0; i < BENCH_REPS; i++) {
+			zassert_equal(walk(&fs, fs.root, name), rfs_a.root);
+		}
+		cycles[round] = (k_cycle_get_32() - start) / BENCH_REPS;
+	}
+
+	TC_PRINT("union walk to last mount: 1 mount %u cycles, %d mounts %u cycles\n",
+	         cycles[0], BENCH_MOUNTS, cycles[1]);
+}
+
+static void *union_mount_tree_setup(void)
+{
+	const struct ninep_fs_ops *ramfs_ops = ninep_ramfs_get_ops();
+
+	zassert_equal(ninep_ramfs_init(&rfs_root), 0);
+	zassert_equal(ninep_ramfs_init(&rfs_a), 0);
+	zassert_equal(ninep_ramfs_init(&rfs_z), 0);
+	zassert_equal(ninep_ramfs_init(&rfs_w), 0);
+	zassert_not_null(ninep_ramfs_create_file(&rfs_root, rfs_root.root,
+	                                         "hello", "hi", 2));
+
+	zassert_equal(ninep_union_fs_init(&plain, plain_mounts,
+	                                  ARRAY_SIZE(plain_mounts)), 0);
+	zassert_equal(ninep_union_fs_mount(&plain, "/a", ramfs_ops, &rfs_a), 0);
+	zassert_equal(ninep_union_fs_mount(&plain, "/x/y/z", ramfs_ops, &rfs_z), 0);
+	zassert_equal(ninep_union_fs_mount(&plain, "/x/w", ramfs_ops, &rfs_w), 0);
+
+	zassert_equal(ninep_union_fs_init(&rooted, rooted_mounts,
+	                                  ARRAY_SIZE(rooted_mounts)), 0);
+	zassert_equal(ninep_union_fs_mount(&rooted, "/", ramfs_ops, &rfs_root), 0);
+	zassert_equal(ninep_union_fs_mount(&rooted, "/a", ramfs_ops, &rfs_a), 0);
+	zassert_equal(ninep_union_fs_mount(&rooted, "/x/w", ramfs_ops, &rfs_w), 0);
+	return NULL;
+}
+
+ZTEST_SUITE(union_mount_tree, NULL, union_mount_tree_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER */
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025 9p4z Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Union Node Ownership Tests
+ *
+ * - Every node walked through a mount is found again by pointer
+ * - Clunked nodes leave the table; nodes a backend keeps stay, idle
+ * - A full table evicts the least recently used idle node, never a
+ *   recently used referenced one
+ * - Benchmark: owner lookup with one live node against a full table
+ */
+
+#include <zephyr/ztest.h>
+
+#ifdef CONFIG_NINEP_SERVER
+
+#include <zephyr/9p/server.h>
+#include <zephyr/9p/ramfs.h>
+#include <zephyr/9p/union_fs.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_FILES   (NINEP_UNION_NODE_OWNERS + 4)
+#define BENCH_REPS  1000
+
+static struct ninep_union_fs fs;
+static struct ninep_union_mount mounts[2];
+static struct ninep_ramfs ramfs;
+static struct ninep_ramfs kept_ramfs;
+static struct ninep_fs_ops keep_ops;  /* ramfs whose clunk keeps the node */
+static struct ninep_fs_node *held[NUM_FILES];
+static bool have_files;
+static uint8_t stat_buf[256];
+
+static int keep_clunk(struct ninep_fs_node *node, void *fs_ctx)
+{
+	return 1;
+}
+
+/* Walk /<mount>/fNNN, holding a fid on the result */
+static struct ninep_fs_node *walk_file(const char *mount, int i)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+	char name[8];
+	struct ninep_fs_node *dir = ops->walk(fs.root, mount, strlen(mount), &fs);
+
+	zassert_not_null(dir);
+	snprintf(name, sizeof(name), "f%03d", i);
+	return ops->walk(dir, name, strlen(name), &fs);
+}
+
+static bool tracked(struct ninep_fs_node *node)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+
+	return ops->stat(node, stat_buf, sizeof(stat_buf), &fs) > 0;
+}
+
+/* Test: walked nodes are tracked, and clunking them empties the table */
+ZTEST(union_owner, test_track_and_clunk)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+	size_t base = fs.num_node_owners;
+	int n = NINEP_UNION_NODE_OWNERS - base;
+
+	if (!have_files) {
+		ztest_test_skip();
+	}
+	for (int i = 0; i < n; i++) {
+		held[i] = walk_file("r", i);
+		zassert_not_null(held[i], "walk %d", i);
+	}
+	zassert_equal(fs.num_node_owners, base + n);
+	for (int i = n - 1; i >= 0; i--) {
+		zassert_true(tracked(held[i]), "node %d lost", i);
+	}
+	for (int i = 0; i < n; i++) {
+		ops->clunk(held[i], &fs);
+	}
+	zassert_equal(fs.num_node_owners, base);
+}
+
+/* Test: a full table evicts the least recently used idle node */
+ZTEST(union_owner, test_evict_idle_lru)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+	size_t base = fs.num_node_owners;
+	int n = NINEP_UNION_NODE_OWNERS - base;
+
+	if (!have_files) {
+		ztest_test_skip();
+	}
+	for (int i = 0; i < n; i++) {
+		held[i] = walk_file("k", i);
+		zassert_not_null(held[i], "walk %d", i);
+	}
+	zassert_equal(fs.num_node_owners, NINEP_UNION_NODE_OWNERS);
+
+	/* The backend keeps both; they stay tracked with no fid */
+	ops->clunk(held[0], &fs);
+	ops->clunk(held[1], &fs);
+	zassert_equal(fs.num_node_owners, NINEP_UNION_NODE_OWNERS);
+
+	/* Use 0 again, leaving 1 the least recently used idle node */
+	zassert_true(tracked(held[0]));
+
+	held[n] = walk_file("k", n);
+	zassert_not_null(held[n]);
+	zassert_true(tracked(held[0]));
+	zassert_false(tracked(held[1]), "wrong node evicted");
+	zassert_true(tracked(held[2]), "referenced node evicted");
+
+	held[n + 1] = walk_file("k", n + 1);
+	zassert_not_null(held[n + 1]);
+	zassert_false(tracked(held[0]));
+
+	/* Nothing idle and nothing stale: the walk fails */
+	zassert_is_null(walk_file("k", n + 2));
+	for (int i = 2; i < n + 2; i++) {
+		zassert_true(tracked(held[i]), "node %d lost", i);
+	}
+
+	/* Clean up for the next test: a clunk that lets the nodes go */
+	keep_ops.clunk = ninep_ramfs_get_ops()->clunk;
+	for (int i = 2; i < n + 2; i++) {
+		ops->clunk(held[i], &fs);
+	}
+	keep_ops.clunk = keep_clunk;
+	zassert_equal(fs.num_node_owners, base);
+}
+
+/* Benchmark: owner lookup cost does not grow with the table */
+ZTEST(union_owner, test_lookup_cost)
+{
+	const struct ninep_fs_ops *ops = ninep_union_fs_get_ops();
+	size_t base = fs.num_node_owners;
+	int n = NINEP_UNION_NODE_OWNERS - base;
+	uint32_t cycles[2];
+
+	if (!have_files) {
+		ztest_test_skip();
+	}
+
+	held[0] = walk_file("r", 0);
+	for (int round = 0; round < 2; round++) {
+		if (round == 1) {
+			for (int i = 1; i < n; i++) {
+				held[i] = walk_file("r", i);
+				zassert_not_null(held[i]);
+			}
+		}
+
+		uint32_t start = k_cycle_get_32();
+
+		for (int i = 0; i < BENCH_REPS; i++) {
+			zassert_true(tracked(held[0]));
+		}
+		cycles[round] = (k_cycle_get_32() - start) / BENCH_REPS;
+	}
+	for (int i = 0; i < n; i++) {
+		ops->clunk(held[i], &fs);
+	}
+
+	TC_PRINT("union stat: 1 live node %u cycles, %d live nodes %u cycles\n",
+	         cycles[0], n, cycles[1]);
+}
+
+static void *union_owner_setup(void)
+{
+	char name[8];
+
+	zassert_equal(ninep_ramfs_init(&ramfs), 0);
+	zassert_equal(ninep_ramfs_init(&kept_ramfs), 0);
+	have_files = true;
+	for (int i = 0; i < NUM_FILES && have_files; i++) {
+		snprintf(name, sizeof(name), "f%03d", i);
+		/* Without enough node memory in this configuration, skip */
+		have_files = ninep_ramfs_create_file(&ramfs, ramfs.root, name,
+		                                     NULL, 0) &&
+		             ninep_ramfs_create_file(&kept_ramfs, kept_ramfs.root,
+		                                     name, NULL, 0);
+	}
+
+	keep_ops = *ninep_ramfs_get_ops();
+	keep_ops.clunk = keep_clunk;
+	zassert_equal(ninep_union_fs_init(&fs, mounts, ARRAY_SIZE(mounts)), 0);
+	zassert_equal(ninep_union_fs_mount(&fs, "/r", ninep_ramfs_get_ops(),
+	                                   &ramfs), 0);
+	zassert_equal(ninep_union_fs_mount(&fs, "/k", &keep_ops,
+	                                   &kept_ramfs), 0);
+	return NULL;
+}
+
+ZTEST_SUITE(union_owner, NULL, union_owner_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NINEP_SERVER */